@@ -1796,6 +1796,23 @@ void CV_SaveVars(UINT8 **p, boolean in_demo)
 	WRITEUINT16(count_p, count);
 }
 
+// Number of bytes CV_SaveVars would write.
+size_t CV_SavedVarsSize(boolean in_demo)
+{
+	consvar_t *cvar;
+	size_t size = sizeof (UINT16);
+
+	for (cvar = consvar_vars; cvar; cvar = cvar->next)
+		if ((cvar->flags & CV_NETVAR) && !CV_IsSetToDefault(cvar))
+		{
+			size += in_demo ? strlen(cvar->name) + 1 : sizeof (UINT16);
+			size += strlen(cvar->string) + 1;
+			size += sizeof (UINT8);
+		}
+
+	return size;
+}
+
 static void CV_LoadVars(UINT8 **p,
 		consvar_t *(*got)(UINT8 **p, char **ret_value, boolean *ret_stealth))
 {
@@ -219,6 +219,7 @@ void CV_SaveVariables(FILE *f);
 
 // load/save gamesate (load and save option and for network join in game)
 void CV_SaveVars(UINT8 **p, boolean in_demo);
+size_t CV_SavedVarsSize(boolean in_demo);
 
 #define CV_SaveNetVars(p) CV_SaveVars(p, false)
 void CV_LoadNetVars(UINT8 **p);
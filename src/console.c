@@ -45,6 +45,10 @@
 
 #define MAXHUDLINES 20
 
+// Explicit screen refreshes are done at most this many times per second,
+// anything printed in between waits for the next one.
+#define CON_REFRESHRATE 30
+
 #ifdef HAVE_THREADS
 I_mutex con_mutex;
 
@@ -58,6 +62,9 @@ I_mutex con_mutex;
 static boolean con_started = false; // console has been initialised
        boolean con_startup = false; // true at game startup
        boolean con_refresh = false; // screen needs refreshing
+       UINT32  con_refreshcount = 0; // explicit screen refreshes done so far
+static precise_t con_lastrefresh = 0; // when the last explicit refresh was done
+static boolean con_refreshpending = false; // text printed since then is not shown yet
 static boolean con_forcepic = true; // at startup toggle console translucency when first off
        boolean con_recalc;          // set true when screen size has changed
 
@@ -512,10 +519,42 @@ void CON_StartRefresh(void)
 
 void CON_StopRefresh(void)
 {
+	CON_FlushRefresh();
+
 	if (con_startup)
 		con_refresh = false;
 }
 
+static void CON_DoRefresh(void)
+{
+#if !defined(__ANDROID__)
+	if (I_AppOnBackground())
+		return;
+
+	CON_Drawer(); // here we display the console text
+	I_FinishUpdate(); // page flip or blit buffer
+	con_refreshcount++;
+#endif
+}
+
+// Shows any console text that is still waiting for an explicit refresh
+void CON_FlushRefresh(void)
+{
+	boolean refresh;
+
+	Lock_state();
+
+	refresh = (con_refresh && con_refreshpending);
+	con_refreshpending = false;
+	if (refresh)
+		con_lastrefresh = I_GetPreciseTime();
+
+	Unlock_state();
+
+	if (refresh)
+		CON_DoRefresh();
+}
+
 // Console input initialization
 //
 static void CON_InputInit(void)
@@ -1579,16 +1618,28 @@ void CONS_Printf(const char *fmt, ...)
 	con_scrollup = 0;
 	refresh = con_refresh;
 
-	Unlock_state();
-
-#if !defined(__ANDROID__)
-	// if not in display loop, force screen update
-	if (refresh && !I_AppOnBackground())
+	// if not in display loop, force screen update,
+	// but not for every single line that gets printed
+	if (refresh)
 	{
-		CON_Drawer(); // here we display the console text
-		I_FinishUpdate(); // page flip or blit buffer
+		precise_t now = I_GetPreciseTime();
+
+		if (now - con_lastrefresh < I_GetPrecisePrecision() / CON_REFRESHRATE)
+		{
+			con_refreshpending = true;
+			refresh = false;
+		}
+		else
+		{
+			con_lastrefresh = now;
+			con_refreshpending = false;
+		}
 	}
-#endif
+
+	Unlock_state();
+
+	if (refresh)
+		CON_DoRefresh();
 }
 
 void CONS_Alert(alerttype_t level, const char *fmt, ...)
@@ -1622,6 +1673,10 @@ void CONS_Alert(alerttype_t level, const char *fmt, ...)
 	// I am lazy and I feel like just letting CONS_Printf take care of things.
 	// Is that okay?
 	CONS_Printf("%s", txt);
+
+	// don't keep errors off the screen
+	if (level == CONS_ERROR)
+		CON_FlushRefresh();
 }
 
 void CONS_Debug(INT32 debugflags, const char *fmt, ...)
@@ -18,6 +18,7 @@ void CON_Init(void);
 
 void CON_StartRefresh(void);
 void CON_StopRefresh(void);
+void CON_FlushRefresh(void);
 
 boolean CON_Responder(event_t *ev);
 
@@ -34,6 +35,9 @@ extern boolean con_startup;
 // needs explicit screen refresh until we are in the main game loop
 extern boolean con_refresh;
 
+// number of explicit screen refreshes done so far
+extern UINT32 con_refreshcount;
+
 // top clip value for view render: do not draw part of view hidden by console
 extern INT32 con_clipviewtop;
 
@@ -1584,7 +1584,7 @@ static boolean SV_SendServerConfig(INT32 node)
 }
 
 #ifndef NONET
-#define SAVEGAMESIZE (768*1024)
+#define SAVEGAMESIZE (768*1024) // initial size, the buffer grows as needed
 
 static boolean SV_ResendingSavegameToAnyone(void)
 {
@@ -1604,25 +1604,18 @@ static void SV_SendSaveGame(INT32 node, boolean resending)
 	UINT8 *buffertosend;
 
 	// first save it in a malloced buffer
-	savebuffer = (UINT8 *)malloc(SAVEGAMESIZE);
-	if (!savebuffer)
+	if (!P_SaveBufferAlloc(SAVEGAMESIZE))
 	{
 		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
 		return;
 	}
 
 	// Leave room for the uncompressed length.
-	save_p = savebuffer + sizeof(UINT32);
+	save_p += sizeof(UINT32);
 
 	P_SaveNetGame(resending);
 
-	length = save_p - savebuffer;
-	if (length > SAVEGAMESIZE)
-	{
-		free(savebuffer);
-		save_p = NULL;
-		I_Error("Savegame buffer overrun");
-	}
+	savebuffer = P_SaveBufferFinish(&length);
 
 	// Allocate space for compressed save: one byte fewer than for the
 	// uncompressed data to ensure that the compression is worthwhile.
@@ -1680,8 +1673,7 @@ static void SV_SavedGame(void)
 	sprintf(tmpsave, "%s" PATHSEP TMPSAVENAME, srb2home);
 
 	// first save it in a malloced buffer
-	save_p = savebuffer = (UINT8 *)malloc(SAVEGAMESIZE);
-	if (!save_p)
+	if (!P_SaveBufferAlloc(SAVEGAMESIZE))
 	{
 		CONS_Alert(CONS_ERROR, M_GetText("No more free memory for savegame\n"));
 		return;
@@ -1689,13 +1681,7 @@ static void SV_SavedGame(void)
 
 	P_SaveNetGame(false);
 
-	length = save_p - savebuffer;
-	if (length > SAVEGAMESIZE)
-	{
-		free(savebuffer);
-		save_p = NULL;
-		I_Error("Savegame buffer overrun");
-	}
+	savebuffer = P_SaveBufferFinish(&length);
 
 	// then save it!
 	if (!FIL_WriteFile(tmpsave, savebuffer, length))
@@ -3735,10 +3721,16 @@ static CV_PossibleValue_t maxsend_cons_t[] = {{0, "MIN"}, {204800, "MAX"}, {0, N
 consvar_t cv_maxsend = CVAR_INIT ("maxsend", "4096", CV_SAVE|CV_NETVAR, maxsend_cons_t, NULL);
 consvar_t cv_noticedownload = CVAR_INIT ("noticedownload", "Off", CV_SAVE|CV_NETVAR, CV_OnOff, NULL);
 
-// Speed of file downloading (in packets per tic)
+// Most file fragments sent to each downloading node in a tic
+// The actual rate follows how fast each node acknowledges them
 static CV_PossibleValue_t downloadspeed_cons_t[] = {{1, "MIN"}, {300, "MAX"}, {0, NULL}};
 consvar_t cv_downloadspeed = CVAR_INIT ("downloadspeed", "16", CV_SAVE|CV_NETVAR, downloadspeed_cons_t, NULL);
 
+// Upload budget shared by everything we send (in kilobytes per second)
+// Downloads only get what the game traffic leaves over
+static CV_PossibleValue_t uploadrate_cons_t[] = {{16, "MIN"}, {65536, "MAX"}, {0, "Unlimited"}, {0, NULL}};
+consvar_t cv_uploadrate = CVAR_INIT ("uploadrate", "1024", CV_SAVE|CV_NETVAR, uploadrate_cons_t, NULL);
+
 static void Got_AddPlayer(UINT8 **p, INT32 playernum);
 
 // called one time at init
@@ -30,7 +30,7 @@ packet versions.
 If you change the struct or the meaning of a field
 therein, increment this number.
 */
-#define PACKETVERSION 4
+#define PACKETVERSION 5
 
 // Network play related stuff.
 // There is a data struct that stores network
@@ -399,7 +399,7 @@ extern tic_t servermaxping;
 
 extern consvar_t cv_netticbuffer, cv_allownewplayer, cv_joinnextround, cv_maxplayers, cv_joindelay, cv_rejointimeout;
 extern consvar_t cv_resynchattempts, cv_blamecfail;
-extern consvar_t cv_maxsend, cv_noticedownload, cv_downloadspeed;
+extern consvar_t cv_maxsend, cv_noticedownload, cv_downloadspeed, cv_uploadrate;
 extern consvar_t cv_dedicatedidletime;
 
 // Used in d_net, the only dependence
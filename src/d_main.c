@@ -119,6 +119,8 @@ static addfilelist_t startuppwads;
 
 static fhandletype_t startuphandletype = FILEHANDLE_STANDARD;
 
+static precise_t startuptime; // when D_SRB2Main started, for -timestartup
+
 //
 // DEMO LOOP
 //
@@ -521,6 +523,7 @@ static void D_Display(void)
 
 			if (!automapactive && !dedicated && cv_renderview.value)
 			{
+				R_ClearMobjInterpolationCache();
 				R_ApplyLevelInterpolators(R_UsingFrameInterpolation() ? rendertimefrac : FRACUNIT);
 				PS_START_TIMING(ps_rendercalltime);
 				if (players[displayplayer].mo || players[displayplayer].playerstate == PST_DEAD)
@@ -716,6 +719,14 @@ static void D_Display(void)
 
 			s[sizeof s - 1] = '\0';
 
+			snprintf(s, sizeof s - 1, "tics %d b/s", netclassbps[NETCLASS_TICS]);
+			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-80, V_YELLOWMAP, s);
+			snprintf(s, sizeof s - 1, "acks %d b/s", netclassbps[NETCLASS_ACKS]);
+			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-70, V_YELLOWMAP, s);
+			snprintf(s, sizeof s - 1, "cmds %d b/s", netclassbps[NETCLASS_TEXTCMDS]);
+			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-60, V_YELLOWMAP, s);
+			snprintf(s, sizeof s - 1, "files %d b/s (%d held)", netclassbps[NETCLASS_FILES], netclassdeferred[NETCLASS_FILES]);
+			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-50, V_YELLOWMAP, s);
 			snprintf(s, sizeof s - 1, "get %d b/s", getbps);
 			V_DrawRightAlignedString(BASEVIDWIDTH, BASEVIDHEIGHT-ST_HEIGHT-40, V_YELLOWMAP, s);
 			snprintf(s, sizeof s - 1, "send %d b/s", sendbps);
@@ -777,9 +788,19 @@ void D_SRB2Loop(void)
 	oldentertics = I_GetTime();
 
 	// end of loading screen: CONS_Printf() will no more call FinishUpdate()
+	CON_FlushRefresh();
 	con_refresh = false;
 	con_startup = false;
 
+	if (M_CheckParm("-timestartup"))
+	{
+		// Report how long startup took and quit, so it can be timed headlessly
+		I_OutputMsg("Startup took %.2f ms, with %u console refreshes\n",
+			(double)(I_GetPreciseTime() - startuptime) * 1000.0 / I_GetPrecisePrecision(),
+			con_refreshcount);
+		I_Quit();
+	}
+
 	// make sure to do a d_display to init mode _before_ load a level
 	SCR_SetMode(); // change video mode
 	SCR_Recalc();
@@ -949,6 +970,7 @@ void D_SRB2Loop(void)
 			M_SaveFrame();
 		if (takescreenshot)
 			M_DoScreenShot();
+		M_UpdateScreenShots(); // report the ones written in the background
 
 		// consoleplayer -> displayplayers (hear sounds from viewpoint)
 		S_UpdateSounds(); // move positional sounds
@@ -1353,6 +1375,8 @@ void D_SRB2Main(void)
 	INT32 pstartmap = 1;
 	boolean autostart = false;
 
+	startuptime = I_GetPreciseTime();
+
 	/* break the version string into version numbers, for netplay */
 	D_ConvertVersionNumbers();
 
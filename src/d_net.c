@@ -96,10 +96,17 @@ INT32 getbps, sendbps;
 float lostpercent, duppercent, gamelostpercent;
 INT32 packetheaderlength;
 
+// per class stats
+static INT64 classbytes[NUMNETCLASSES];
+static INT32 classdeferred[NUMNETCLASSES];
+INT32 netclassbps[NUMNETCLASSES];
+INT32 netclassdeferred[NUMNETCLASSES];
+
 boolean Net_GetNetStat(void)
 {
 	const tic_t t = I_GetTime();
 	static INT64 oldsendbyte = 0;
+	INT32 i;
 	if (statstarttic+STATLENGTH <= t)
 	{
 		const tic_t df = t-statstarttic;
@@ -119,6 +126,14 @@ boolean Net_GetNetStat(void)
 		else
 			gamelostpercent = 0.0f;
 
+		for (i = 0; i < NUMNETCLASSES; i++)
+		{
+			netclassbps[i] = (INT32)(classbytes[i]*TICRATE)/df;
+			netclassdeferred[i] = classdeferred[i];
+			classbytes[i] = 0;
+			classdeferred[i] = 0;
+		}
+
 		ticmiss = ticruned = 0;
 		oldsendbyte = sendbytes;
 		getbytes = 0;
@@ -995,6 +1010,101 @@ static boolean ShouldDropPacket(void)
 #endif
 #endif
 
+// -----------------------------------------------------------------
+// Send shaping
+// -----------------------------------------------------------------
+
+// Everything we send is charged to one token bucket for the whole link,
+// refilled at cv_uploadrate. Tics, acks and text commands always go out
+// at once, even if that puts the bucket in debt, since holding them back
+// is what makes the game lag. File fragments (downloads and gamestate
+// resends) are the only traffic that can wait, so they only get what is
+// left of the bucket. FileSendTicker takes turns between the nodes, so
+// that share is split evenly among everyone downloading.
+#ifndef NONET
+static INT32 linktokens;
+static tic_t linkrefilltic;
+
+/** \brief Gives the priority class of the packet in netbuffer
+*/
+static netclass_t Net_PacketClass(void)
+{
+	switch (netbuffer->packettype)
+	{
+		case PT_CLIENTCMD:
+		case PT_CLIENTMIS:
+		case PT_CLIENT2CMD:
+		case PT_CLIENT2MIS:
+		case PT_NODEKEEPALIVE:
+		case PT_NODEKEEPALIVEMIS:
+		case PT_SERVERTICS:
+			return NETCLASS_TICS;
+		case PT_NOTHING:
+			return NETCLASS_ACKS;
+		case PT_FILEFRAGMENT:
+			return NETCLASS_FILES;
+		default:
+			return NETCLASS_TEXTCMDS;
+	}
+}
+
+/** \brief Tops up the link bucket for the tics that have passed since the last call
+
+	The bucket holds at most two tics worth of bytes, and may owe at most
+	one second worth.
+*/
+static void Net_RefillLink(void)
+{
+	const tic_t t = I_GetTime();
+	const INT32 pertic = cv_uploadrate.value * 1024 / TICRATE;
+	tic_t elapsed = t - linkrefilltic;
+
+	if (!elapsed)
+		return;
+	linkrefilltic = t;
+
+	if (elapsed > TICRATE)
+		elapsed = TICRATE;
+	linktokens += pertic * (INT32)elapsed;
+	if (linktokens > 2 * pertic)
+		linktokens = 2 * pertic;
+}
+
+/** \brief Charges a sent packet to the link bucket
+
+	\param	length	bytes put on the wire
+*/
+static void Net_ChargeLink(INT32 length)
+{
+	const INT32 debt = -(cv_uploadrate.value * 1024);
+
+	linktokens -= length;
+	if (linktokens < debt)
+		linktokens = debt;
+}
+#endif
+
+/** \brief Checks if there is room on the link for file fragments
+
+	\return	true if FileSendTicker may send another fragment this tic
+*/
+boolean Net_CanSendFiles(void)
+{
+#ifdef NONET
+	return true;
+#else
+	if (!cv_uploadrate.value)
+		return true;
+
+	Net_RefillLink();
+	if (linktokens > 0)
+		return true;
+
+	classdeferred[NETCLASS_FILES]++;
+	return false;
+#endif
+}
+
 //
 // HSendPacket
 //
@@ -1068,6 +1178,12 @@ boolean HSendPacket(INT32 node, boolean reliable, UINT8 acknum, size_t packetlen
 
 	netbuffer->checksum = NetbufferChecksum();
 	sendbytes += packetheaderlength + doomcom->datalength; // For stat
+	classbytes[Net_PacketClass()] += packetheaderlength + doomcom->datalength;
+	if (cv_uploadrate.value)
+	{
+		Net_RefillLink();
+		Net_ChargeLink(packetheaderlength + doomcom->datalength);
+	}
 
 #ifdef PACKETDROP
 	// Simulate internet :)
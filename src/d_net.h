@@ -37,6 +37,20 @@ boolean Net_GetNetStat(void);
 extern INT32 getbytes;
 extern INT64 sendbytes; // Realtime updated
 
+// Send priority classes, highest first
+typedef enum
+{
+	NETCLASS_TICS,     // Ticcmds and server tics
+	NETCLASS_ACKS,     // Bare acknowledgements
+	NETCLASS_TEXTCMDS, // Text commands and other control packets
+	NETCLASS_FILES,    // File fragments, held back when the link is full
+	NUMNETCLASSES
+} netclass_t;
+
+extern INT32 netclassbps[NUMNETCLASSES]; // Bytes/s sent per class
+extern INT32 netclassdeferred[NUMNETCLASSES]; // Sends held back per class, over the last stat period
+boolean Net_CanSendFiles(void);
+
 extern SINT8 nodetoplayer[MAXNETNODES];
 extern SINT8 nodetoplayer2[MAXNETNODES]; // Say the numplayer for this node if any (splitscreen)
 extern UINT8 playerpernode[MAXNETNODES]; // Used specially for splitscreen
@@ -50,6 +50,7 @@
 #include "md5.h"
 #include "m_perfstats.h"
 #include "u_list.h"
+#include "p_saveg.h"
 
 #ifdef NETGAME_DEVMODE
 #define CV_RESTRICT CV_NETVAR
@@ -508,6 +509,10 @@ void D_RegisterServerCommands(void)
 	COM_AddCommand("addfolder", Command_Addfolder, COM_LUA);
 	COM_AddCommand("addfile", Command_Addfile, COM_LUA);
 	COM_AddCommand("listwad", Command_ListWADS_f, COM_LUA);
+#ifdef _DEBUG
+	COM_AddCommand("addonindexbench", Command_AddonIndexBench_f, 0);
+	COM_AddCommand("extvarsbench", Command_ExtVarsBench_f, 0);
+#endif
 
 	COM_AddCommand("runsoc", Command_RunSOC, COM_LUA);
 	COM_AddCommand("pause", Command_Pause, COM_LUA);
@@ -612,6 +617,7 @@ void D_RegisterServerCommands(void)
 	CV_RegisterVar(&cv_maxsend);
 	CV_RegisterVar(&cv_noticedownload);
 	CV_RegisterVar(&cv_downloadspeed);
+	CV_RegisterVar(&cv_uploadrate);
 #ifndef NONET
 	CV_RegisterVar(&cv_allownewplayer);
 	CV_RegisterVar(&cv_joinnextround);
@@ -4805,11 +4811,11 @@ static void Command_Togglemodified_f(void)
 	modifiedgame = !modifiedgame;
 }
 
-extern UINT8 *save_p;
 static void Command_Archivetest_f(void)
 {
 	UINT8 *buf;
 	UINT32 i, wrote;
+	size_t length;
 	thinker_t *th;
 	if (gamestate != GS_LEVEL)
 	{
@@ -4824,13 +4830,14 @@ static void Command_Archivetest_f(void)
 			((mobj_t *)th)->mobjnum = i++;
 
 	// allocate buffer
-	buf = save_p = ZZ_Alloc(1024);
+	P_SaveBufferAlloc(1024);
 
 	// test archive
 	CONS_Printf("LUA_Archive...\n");
 	LUA_Archive();
-	WRITEUINT8(save_p, 0x7F);
-	wrote = (UINT32)(save_p-buf);
+	SAVEWRITEUINT8(0x7F);
+	buf = P_SaveBufferFinish(&length);
+	wrote = (UINT32)length;
 
 	// clear Lua state, so we can really see what happens!
 	CONS_Printf("Clearing state!\n");
@@ -4845,7 +4852,7 @@ static void Command_Archivetest_f(void)
 		CONS_Printf("Savegame corrupted. (write %u, read %u)\n", wrote, (UINT32)(save_p-buf));
 
 	// free buffer
-	Z_Free(buf);
+	free(buf);
 	CONS_Printf("Done. No crash.\n");
 }
 #endif
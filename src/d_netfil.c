@@ -66,23 +66,86 @@ typedef struct filetx_s
 	UINT32 size; // Size of the file
 	UINT8 fileid;
 	INT32 node; // Destination
+	boolean lua; // Lua files are rewritten between transfers, so they are never shared
 	struct filetx_s *next; // Next file in the list
 } filetx_t;
 
+// A file being sent, read once and shared by every node downloading it
+typedef struct sendfile_s
+{
+	char *filename;
+	UINT8 *data; // NULL if the file didn't fit in memory, it is read from handle instead
+	FILE *handle;
+	UINT32 size;
+	time_t mtime;
+	INT32 refcount;
+	struct sendfile_s *next;
+} sendfile_t;
+static sendfile_t *sendfiles = NULL;
+
+// A run of acknowledged fragments
+typedef struct
+{
+	UINT32 start; // First fragment
+	UINT32 end; // One past the last fragment
+} ackrange_t;
+
+// A lost fragment that was sent again
+typedef struct
+{
+	UINT32 fragment;
+	UINT32 before; // The next new fragment at the time, see filetran_t::fragment
+} resentfragment_t;
+
 // Current transfers (one for each node)
 typedef struct filetran_s
 {
 	filetx_t *txlist; // Linked list of all files for the node
 	UINT8 iteration;
 	UINT8 ackediteration;
-	UINT32 position; // The current position in the file
-	boolean *ackedfragments;
+	UINT32 fragment; // The next fragment to send
+	const UINT8 *data; // What is being sent if it's in RAM
+	sendfile_t *sendfile; // What is being sent if it's a file
+	// Neither is set if the transfer hasn't started yet
+	UINT32 numfragments;
+	UINT32 ackedfragments; // How many fragments were acknowledged
 	UINT32 ackedsize;
-	FILE *currentfile; // The file currently being sent/received
-	tic_t dontsenduntil;
+	ackrange_t *ackranges; // Acknowledged fragments, sorted and merged
+	UINT32 numackranges;
+	UINT32 maxackranges;
+
+	// Congestion control, counted in fragments
+	UINT32 window; // How many fragments may be unacknowledged at once
+	UINT32 threshold; // The window grows slowly past this
+	UINT32 windowgrowth; // Acknowledgements towards growing the window by one
+	UINT32 inflight; // Fragments sent and not acknowledged yet
+	UINT32 highestacked; // One past the last fragment acknowledged in this pass
+	UINT32 lostline; // Unacknowledged fragments below this are known to be lost
+	UINT32 recover; // Losses below this were already counted for
+	UINT32 resend; // Lost fragments below this were already sent again
+	resentfragment_t *resent; // Fragments sent again and not known to be lost again yet, oldest first
+	UINT32 resenthead, numresent;
+	tic_t timer; // When something was last acknowledged, or first sent
+	UINT8 backoff; // How many timeouts in a row
+	INT32 srtt, rttvar; // Round trip time and its variation, in microseconds
+	boolean timing; // Is rttfragment being timed?
+	UINT32 rttfragment;
+	precise_t rttsent;
+	tic_t tic; // Tic sentthistic counts for
+	INT32 sentthistic;
+
+	// Statistics
+	UINT32 sentbytes;
+	UINT32 resentbytes;
+	tic_t starttic;
 } filetran_t;
 static filetran_t transfer[MAXNETNODES];
 
+// Totals for every transfer since startup, see Command_Downloads_f
+static UINT64 filesentbytes = 0;
+static UINT64 fileresentbytes = 0;
+static precise_t filesendtime = 0;
+
 // Read time of file: stat _stmtime
 // Write time of file: utime
 
@@ -550,6 +613,8 @@ INT32 CL_CheckFiles(void)
 	}
 
 	//now making it here means we've checked the entire list and no FS_NOTCHECKED files remain
+	saveaddonindex(); // keep any MD5s worked out for next time
+
 	if (numwadfiles+filestoload > MAX_WADFILES)
 		return 3;
 	else if (downloadrequired)
@@ -963,11 +1028,137 @@ boolean AddLuaFileToSendQueue(INT32 node, const char *filename)
 
 	DEBFILE(va("Sending Lua file %s to %d\n", filename, node));
 	p->ram = SF_FILE; // It's a file, we need to close it and free its name once we're done sending it
+	p->lua = true;
 	p->next = NULL; // End of list
 	filestosend++;
 	return true;
 }
 
+/** Gets the contents of a file to send, reading it if nobody else is downloading it
+  *
+  * \param filename The file to send
+  * \param shared False to give the caller its own copy, for files that may change
+  * \return The file data
+  * \sa SV_ReleaseSendFile
+  *
+  */
+static sendfile_t *SV_AcquireSendFile(const char *filename, boolean shared)
+{
+	sendfile_t *sf;
+	struct stat fsstat;
+	FILE *handle;
+	long filesize;
+
+	if (stat(filename, &fsstat) < 0)
+		I_Error("File %s does not exist", filename);
+
+	if (shared)
+		for (sf = sendfiles; sf; sf = sf->next)
+			if (!strcmp(sf->filename, filename) && sf->mtime == fsstat.st_mtime
+				&& sf->size == (UINT32)fsstat.st_size)
+			{
+				sf->refcount++;
+				return sf;
+			}
+
+	handle = fopen(filename, "rb");
+	if (!handle)
+		I_Error("File %s does not exist", filename);
+
+	fseek(handle, 0, SEEK_END);
+	filesize = ftell(handle);
+
+	// Nobody wants to transfer a file bigger
+	// than 4GB!
+	if (filesize >= LONG_MAX)
+		I_Error("filesize of %s is too large", filename);
+	if (filesize == -1)
+		I_Error("Error getting filesize of %s", filename);
+
+	sf = calloc(1, sizeof (*sf));
+	if (!sf)
+		I_Error("SV_AcquireSendFile: No more memory\n");
+
+	sf->filename = strdup(filename);
+	if (!sf->filename)
+		I_Error("SV_AcquireSendFile: No more memory\n");
+
+	// If the file doesn't fit in memory, keep it open
+	// and read each fragment from it as it is sent
+	sf->data = malloc(filesize ? filesize : 1);
+	if (sf->data)
+	{
+		fseek(handle, 0, SEEK_SET);
+		if (fread(sf->data, 1, filesize, handle) != (size_t)filesize)
+			I_Error("SV_AcquireSendFile: can't read %s because %s", filename, M_FileError(handle));
+		fclose(handle);
+	}
+	else
+	{
+		DEBFILE(va("Not enough memory to preload %s, streaming it\n", filename));
+		sf->handle = handle;
+	}
+
+	sf->size = (UINT32)filesize;
+	sf->mtime = fsstat.st_mtime;
+	sf->refcount = 1;
+	if (shared)
+	{
+		sf->next = sendfiles;
+		sendfiles = sf;
+	}
+	return sf;
+}
+
+/** Copies part of a file being sent
+  *
+  * \param sf The file data
+  * \param dest Where to copy it
+  * \param position Where to start in the file
+  * \param size How many bytes to copy
+  *
+  */
+static void SV_ReadSendFile(sendfile_t *sf, UINT8 *dest, UINT32 position, size_t size)
+{
+	if (sf->data)
+	{
+		M_Memcpy(dest, &sf->data[position], size);
+		return;
+	}
+
+	fseek(sf->handle, position, SEEK_SET);
+	if (fread(dest, 1, size, sf->handle) != size)
+		I_Error("SV_ReadSendFile: can't read %s byte on %s at %d because %s", sizeu1(size), sf->filename, position, M_FileError(sf->handle));
+}
+
+/** Lets go of a file to send, freeing it once nobody is downloading it anymore
+  *
+  * \param sf The file data
+  * \sa SV_AcquireSendFile
+  *
+  */
+static void SV_ReleaseSendFile(sendfile_t *sf)
+{
+	sendfile_t **prev;
+
+	if (--sf->refcount > 0)
+		return;
+
+	// Unshared files were never in the list
+	for (prev = &sendfiles; *prev; prev = &(*prev)->next)
+		if (*prev == sf)
+		{
+			*prev = sf->next;
+			break;
+		}
+
+	if (sf->handle)
+		fclose(sf->handle);
+	free(sf->filename);
+	free(sf->data);
+	free(sf);
+}
+
 /** Stops sending a file for a node, and removes the file request from the list,
   * either because the file has been fully sent or because the node was disconnected
   *
@@ -976,17 +1167,25 @@ boolean AddLuaFileToSendQueue(INT32 node, const char *filename)
   */
 static void SV_EndFileSend(INT32 node)
 {
-	filetx_t *p = transfer[node].txlist;
+	filetran_t *trans = &transfer[node];
+	filetx_t *p = trans->txlist;
 
 	// Free the file request according to the freemethod
 	// parameter used with AddFileToSendQueue/AddRamToSendQueue
 	switch (p->ram)
 	{
-		case SF_FILE: // It's a file, close it and free its filename
+		case SF_FILE: // It's a file, let go of its data and free its filename
 			if (cv_noticedownload.value)
-				CONS_Printf("Ending file transfer for node %d\n", node);
-			if (transfer[node].currentfile)
-				fclose(transfer[node].currentfile);
+			{
+				if (trans->data || trans->sendfile)
+					CONS_Printf("Ending file transfer for node %d (%uK in %.1fs, %u%% resent)\n", node,
+						trans->sentbytes / 1024, (double)(I_GetTime() - trans->starttic) / TICRATE,
+						(UINT32)(100.0 * trans->resentbytes / max(trans->sentbytes, 1)));
+				else
+					CONS_Printf("Ending file transfer for node %d\n", node);
+			}
+			if (trans->sendfile)
+				SV_ReleaseSendFile(trans->sendfile);
 			free(p->id.filename);
 			break;
 		case SF_Z_RAM: // It's a memory block allocated with Z_Alloc or the likes, use Z_Free
@@ -999,172 +1198,544 @@ static void SV_EndFileSend(INT32 node)
 	}
 
 	// Remove the file request from the list
-	transfer[node].txlist = p->next;
+	trans->txlist = p->next;
 	free(p);
 
 	// Indicate that the transmission is over
-	transfer[node].currentfile = NULL;
-	if (transfer[node].ackedfragments)
-		free(transfer[node].ackedfragments);
-	transfer[node].ackedfragments = NULL;
+	trans->data = NULL;
+	trans->sendfile = NULL;
+	free(trans->ackranges);
+	trans->ackranges = NULL;
+	free(trans->resent);
+	trans->resent = NULL;
+	trans->numackranges = trans->maxackranges = 0;
 
 	filestosend--;
 }
 
 #define FILEFRAGMENTSIZE (software_MAXPACKETLENGTH - (FILETXHEADER + BASEPACKETSIZE))
 
-/** Handles file transmission
+// Congestion window limits, in fragments
+#define FILEWINDOWMIN 4
+#define FILEWINDOWMAX 2048
+
+// How far a fragment may arrive out of order before it is taken as lost
+#define FILEREORDER 3
+
+// Past the threshold, the window grows by one for this many acknowledgements
+#define FILEWINDOWGROWTH 8
+
+/** Starts sending the first file in a node's list
+  *
+  * \param node The destination
   *
   */
-void FileSendTicker(void)
+static void SV_StartFileSend(INT32 node)
 {
-	static INT32 currentnode = 0;
-	filetx_pak *p;
-	size_t fragmentsize;
-	filetx_t *f;
-	INT32 packetsent, ram, i, j;
+	filetran_t *trans = &transfer[node];
+	filetx_t *f = trans->txlist;
 
-	// If someone is taking too long to download, kick them with a timeout
-	// to prevent blocking the rest of the server...
-	if (luafiletransfers)
+	if (!f->ram) // Sending a file
 	{
-		for (i = 1; i < MAXNETNODES; i++)
-		{
-			luafiletransfernodestatus_t status = luafiletransfers->nodestatus[i];
+		trans->sendfile = SV_AcquireSendFile(f->id.filename, !f->lua);
+		f->size = trans->sendfile->size;
+	}
+	else // Sending RAM
+		trans->data = (const UINT8 *)f->id.ram;
+
+	trans->iteration = 1;
+	trans->ackediteration = 0;
+	trans->fragment = 0;
+	trans->numfragments = f->size / FILEFRAGMENTSIZE + (f->size % FILEFRAGMENTSIZE || !f->size);
+	trans->ackedfragments = 0;
+	trans->ackedsize = 0;
+	trans->numackranges = 0;
+
+	trans->window = min(max(cv_downloadspeed.value, FILEWINDOWMIN), FILEWINDOWMAX);
+	trans->threshold = FILEWINDOWMAX;
+	trans->windowgrowth = 0;
+	trans->inflight = 0;
+	trans->highestacked = trans->lostline = trans->recover = trans->resend = 0;
+	trans->resenthead = trans->numresent = 0;
+	trans->resent = malloc(FILEWINDOWMAX * sizeof (*trans->resent));
+	if (!trans->resent)
+		I_Error("SV_StartFileSend: No more memory\n");
+	trans->timer = I_GetTime();
+	trans->backoff = 0;
+	trans->srtt = trans->rttvar = 0;
+	trans->timing = false;
+
+	trans->sentbytes = trans->resentbytes = 0;
+	trans->starttic = I_GetTime();
+}
 
-			if (status != LFTNS_NONE && status != LFTNS_WAITING && status != LFTNS_SENT
-				&& I_GetTime() > luafiletransfers->nodetimeouts[i])
-			{
-				Net_ConnectionTimeout(i);
-			}
+/** Finds the first fragment at or after the given one that hasn't been acknowledged
+  *
+  * \param trans The transfer
+  * \param fragment Where to start looking
+  * \return The fragment, or numfragments if everything after it was acknowledged
+  *
+  */
+static UINT32 SV_NextUnackedFragment(const filetran_t *trans, UINT32 fragment)
+{
+	UINT32 lo = 0, hi = trans->numackranges;
+
+	// Find the first range that ends after the fragment
+	while (lo < hi)
+	{
+		UINT32 mid = (lo + hi) / 2;
+		if (trans->ackranges[mid].end <= fragment)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo < trans->numackranges && trans->ackranges[lo].start <= fragment)
+		fragment = trans->ackranges[lo].end; // Ranges are merged, so this one isn't acknowledged
+
+	return min(fragment, trans->numfragments);
+}
+
+/** Marks a run of fragments as acknowledged
+  *
+  * \param trans The transfer
+  * \param start The first fragment
+  * \param end One past the last fragment
+  * \return How many of them weren't acknowledged before
+  *
+  */
+static UINT32 SV_AckFragments(filetran_t *trans, UINT32 start, UINT32 end)
+{
+	const UINT32 newstart = start, newend = end;
+	UINT32 lo = 0, hi = trans->numackranges, first, last, overlap = 0;
+
+	// Find the first range that ends at or after the start, they can be merged
+	while (lo < hi)
+	{
+		UINT32 mid = (lo + hi) / 2;
+		if (trans->ackranges[mid].end < start)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	// Swallow every range that touches the new one
+	first = last = lo;
+	while (last < trans->numackranges && trans->ackranges[last].start <= end)
+	{
+		ackrange_t *range = &trans->ackranges[last];
+		if (range->end > newstart && range->start < newend)
+			overlap += min(range->end, newend) - max(range->start, newstart);
+		start = min(start, range->start);
+		end = max(end, range->end);
+		last++;
+	}
+
+	if (first == last) // Nothing to merge with, make room for a new range
+	{
+		if (trans->numackranges == trans->maxackranges)
+		{
+			trans->maxackranges = trans->maxackranges ? trans->maxackranges * 2 : 16;
+			trans->ackranges = realloc(trans->ackranges, trans->maxackranges * sizeof (*trans->ackranges));
+			if (!trans->ackranges)
+				I_Error("SV_AckFragments: No more memory\n");
 		}
+		memmove(&trans->ackranges[first + 1], &trans->ackranges[first],
+			(trans->numackranges - first) * sizeof (*trans->ackranges));
+		trans->numackranges++;
+	}
+	else if (last - first > 1) // Several ranges become one
+	{
+		memmove(&trans->ackranges[first + 1], &trans->ackranges[last],
+			(trans->numackranges - last) * sizeof (*trans->ackranges));
+		trans->numackranges -= last - first - 1;
 	}
 
-	if (!filestosend) // No file to send
+	trans->ackranges[first].start = start;
+	trans->ackranges[first].end = end;
+
+	return (newend - newstart) - overlap;
+}
+
+/** Counts the fragments in a run that haven't been acknowledged
+  *
+  * \param trans The transfer
+  * \param start The first fragment
+  * \param end One past the last fragment
+  * \param longest Set to the most unacknowledged fragments in a row
+  * \return How many of them weren't acknowledged
+  *
+  */
+static UINT32 SV_UnackedFragments(const filetran_t *trans, UINT32 start, UINT32 end, UINT32 *longest)
+{
+	UINT32 lo = 0, hi = trans->numackranges, count = 0;
+
+	*longest = 0;
+
+	while (lo < hi)
+	{
+		UINT32 mid = (lo + hi) / 2;
+		if (trans->ackranges[mid].end <= start)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	// Walk the gaps between the acknowledged ranges
+	for (; start < end; lo++)
+	{
+		UINT32 gap = end;
+
+		if (lo < trans->numackranges)
+			gap = min(max(trans->ackranges[lo].start, start), end);
+
+		count += gap - start;
+		*longest = max(*longest, gap - start);
+
+		if (lo >= trans->numackranges)
+			break;
+		start = trans->ackranges[lo].end;
+	}
+
+	return count;
+}
+
+/** Gives how long to wait for an acknowledgement before
+  * taking the fragments still unacknowledged as lost
+  *
+  * \param trans The transfer
+  * \return The timeout in tics
+  *
+  */
+static tic_t SV_FileTimeout(const filetran_t *trans)
+{
+	tic_t timeout;
+
+	if (!trans->srtt) // Not measured yet
+		timeout = TICRATE / 2;
+	else
+		timeout = (tic_t)(((INT64)trans->srtt + 4 * trans->rttvar) * TICRATE / 1000000) + 1;
+
+	timeout = max(timeout, TICRATE / 8) << trans->backoff;
+	return min(timeout, 2 * TICRATE);
+}
+
+/** Updates the round trip time estimate, as TCP does it
+  *
+  * \param trans The transfer
+  * \param sample How long the timed fragment took to be acknowledged, in microseconds
+  *
+  */
+static void SV_FileRoundTrip(filetran_t *trans, INT32 sample)
+{
+	sample = max(sample, 1);
+
+	if (!trans->srtt)
+	{
+		trans->srtt = sample;
+		trans->rttvar = sample / 2;
+	}
+	else
+	{
+		trans->rttvar = (3 * trans->rttvar + abs(trans->srtt - sample)) / 4;
+		trans->srtt = (7 * trans->srtt + sample) / 8;
+	}
+}
+
+/** Grows the window after fragments in flight were acknowledged: by one
+  * for each fragment while below the threshold, then by an eighth of the
+  * window each round trip. Growing by a fixed amount like TCP does would
+  * take minutes to fill a link, when round trips are counted in tics.
+  *
+  * \param trans The transfer
+  * \param acked How many fragments were newly acknowledged
+  *
+  */
+static void SV_FileWindowAck(filetran_t *trans, UINT32 acked)
+{
+	if (!acked)
 		return;
 
-	packetsent = cv_downloadspeed.value;
+	acked = min(acked, trans->inflight);
+	trans->inflight -= acked;
+	trans->timer = I_GetTime();
+	trans->backoff = 0;
 
-	netbuffer->packettype = PT_FILEFRAGMENT;
+	if (trans->window < trans->threshold)
+		trans->window = min(trans->window + acked, trans->threshold);
+	else
+	{
+		trans->windowgrowth += acked;
+		trans->window += trans->windowgrowth / FILEWINDOWGROWTH;
+		trans->windowgrowth %= FILEWINDOWGROWTH;
+	}
+
+	trans->window = min(trans->window, FILEWINDOWMAX);
+}
+
+/** Shrinks the window by a quarter after fragments were lost. Only
+  * done once for everything sent before the loss was noticed.
+  *
+  * \param trans The transfer
+  *
+  */
+static void SV_FileWindowLoss(filetran_t *trans)
+{
+	trans->threshold = max(trans->window - trans->window / 4, FILEWINDOWMIN);
+	trans->window = trans->threshold;
+	trans->windowgrowth = 0;
+	trans->recover = trans->fragment;
+}
 
-	// (((sendbytes-nowsentbyte)*TICRATE)/(I_GetTime()-starttime)<(UINT32)net_bandwidth)
-	while (packetsent-- && filestosend != 0)
+/** Takes everything still in flight as lost, after nothing
+  * was acknowledged for too long
+  *
+  * \param trans The transfer
+  *
+  */
+static void SV_FileTimedOut(filetran_t *trans)
+{
+	SV_FileWindowLoss(trans);
+	trans->inflight = 0;
+	trans->lostline = trans->fragment;
+	trans->timer = I_GetTime();
+	trans->timing = false;
+	if (trans->backoff < 2)
+		trans->backoff++;
+}
+
+/** Takes the fragments left behind by later acknowledgements as lost.
+  * A full queue somewhere on the way drops fragments in a row, while a
+  * fragment lost here and there doesn't mean we are sending too fast,
+  * so only the former shrinks the window.
+  *
+  * \param trans The transfer
+  *
+  */
+static void SV_FileCheckLosses(filetran_t *trans)
+{
+	UINT32 lostline, lost, longest;
+
+	// Fragments sent again can be lost again too, and sent a third time
+	while (trans->numresent)
 	{
-		for (i = currentnode, j = 0; j < MAXNETNODES;
-			i = (i+1) % MAXNETNODES, j++)
+		resentfragment_t *resent = &trans->resent[trans->resenthead];
+
+		if (trans->highestacked <= resent->before + FILEREORDER)
+			break;
+
+		if (SV_NextUnackedFragment(trans, resent->fragment) == resent->fragment)
 		{
-			if (transfer[i].txlist)
-				break;
+			trans->inflight -= min(1, trans->inflight);
+			trans->resend = min(trans->resend, resent->fragment);
 		}
-		// no transfer to do
-		if (j >= MAXNETNODES)
-			I_Error("filestosend=%d but no file to send found\n", filestosend);
 
-		currentnode = (i+1) % MAXNETNODES;
-		f = transfer[i].txlist;
-		ram = f->ram;
+		trans->resenthead = (trans->resenthead + 1) % FILEWINDOWMAX;
+		trans->numresent--;
+	}
 
-		// Open the file if it isn't open yet, or
-		if (!transfer[i].currentfile)
-		{
-			if (!ram) // Sending a file
-			{
-				long filesize;
+	if (trans->highestacked <= trans->lostline + FILEREORDER)
+		return;
 
-				transfer[i].currentfile =
-					fopen(f->id.filename, "rb");
+	lostline = trans->highestacked - FILEREORDER;
+	lost = SV_UnackedFragments(trans, trans->lostline, lostline, &longest);
 
-				if (!transfer[i].currentfile)
-					I_Error("File %s does not exist",
-						f->id.filename);
+	if (lost)
+	{
+		trans->inflight -= min(lost, trans->inflight);
+		if (longest > 1 && lostline > trans->recover)
+			SV_FileWindowLoss(trans);
+
+		// Don't wait for an acknowledgement that isn't coming
+		if (trans->timing && trans->rttfragment < lostline
+			&& SV_NextUnackedFragment(trans, trans->rttfragment) == trans->rttfragment)
+			trans->timing = false;
+	}
 
-				fseek(transfer[i].currentfile, 0, SEEK_END);
-				filesize = ftell(transfer[i].currentfile);
+	trans->lostline = lostline;
+}
 
-				// Nobody wants to transfer a file bigger
-				// than 4GB!
-				if (filesize >= LONG_MAX)
-					I_Error("filesize of %s is too large", f->id.filename);
-				if (filesize == -1)
-					I_Error("Error getting filesize of %s", f->id.filename);
+/** Sends the next file fragment to a node, if its window allows it
+  *
+  * \param node The destination
+  * \return True if a fragment was sent
+  *
+  */
+static boolean SV_SendFileFragment(INT32 node)
+{
+	filetran_t *trans = &transfer[node];
+	filetx_t *f = trans->txlist;
+	filetx_pak *p = &netbuffer->u.filetxpak;
+	tic_t t = I_GetTime();
+	UINT32 fragment, position;
+	size_t fragmentsize;
+	boolean resent;
 
-				f->size = (UINT32)filesize;
-				fseek(transfer[i].currentfile, 0, SEEK_SET);
-			}
-			else // Sending RAM
-				transfer[i].currentfile = (FILE *)1; // Set currentfile to a non-null value to indicate that it is open
+	// Open the file if it isn't open yet
+	if (!trans->data && !trans->sendfile)
+		SV_StartFileSend(node);
 
-			transfer[i].iteration = 1;
-			transfer[i].ackediteration = 0;
-			transfer[i].position = 0;
-			transfer[i].ackedsize = 0;
+	// cv_downloadspeed caps a single tic for each node
+	if (trans->tic != t)
+	{
+		trans->tic = t;
+		trans->sentthistic = 0;
+	}
+	if (trans->sentthistic >= cv_downloadspeed.value)
+		return false;
 
-			transfer[i].ackedfragments = calloc(f->size / FILEFRAGMENTSIZE + 1, sizeof(*transfer[i].ackedfragments));
-			if (!transfer[i].ackedfragments)
-				I_Error("FileSendTicker: No more memory\n");
+	// Nothing acknowledged for too long, whatever is still in flight is lost
+	if (trans->inflight && t - trans->timer >= SV_FileTimeout(trans))
+		SV_FileTimedOut(trans);
+
+	if (trans->inflight >= trans->window)
+		return false;
 
-			transfer[i].dontsenduntil = 0;
+	// Send what is known to be lost again first,
+	// rather than waiting for the next pass
+	fragment = SV_NextUnackedFragment(trans, trans->resend);
+	resent = (fragment < trans->lostline);
+	if (resent)
+	{
+		// Remember it, so it can be found out if it's lost again. If it
+		// is and nobody remembers, it's just counted as in flight until
+		// the next timeout.
+		if (trans->numresent == FILEWINDOWMAX)
+		{
+			trans->resenthead = (trans->resenthead + 1) % FILEWINDOWMAX;
+			trans->numresent--;
+		}
+		trans->resent[(trans->resenthead + trans->numresent++) % FILEWINDOWMAX] =
+			(resentfragment_t){fragment, trans->fragment};
+		trans->resend = fragment + 1;
+	}
+	else
+	{
+		// Find the first non-acknowledged fragment
+		fragment = SV_NextUnackedFragment(trans, trans->fragment);
+		if (fragment >= trans->numfragments)
+		{
+			// The rest of this pass is either on its way or lost. Give it
+			// a chance to be acknowledged before sending it again.
+			if (trans->inflight)
+				return false;
+
+			fragment = SV_NextUnackedFragment(trans, 0);
+			if (fragment >= trans->numfragments)
+				return false;
+			trans->iteration++;
+			trans->highestacked = trans->lostline = trans->recover = trans->resend = 0;
+			trans->numresent = 0;
 		}
+		trans->fragment = fragment + 1;
+		resent = (trans->iteration > 1);
+	}
 
-		// If the client hasn't acknowledged any fragment from the previous iteration,
-		// it is most likely because their acks haven't had enough time to reach the server
-		// yet, due to latency. In that case, we wait a little to avoid useless resend.
-		if (I_GetTime() < transfer[i].dontsenduntil)
-			continue;
+	// Build a packet containing a file fragment
+	position = fragment * FILEFRAGMENTSIZE;
+	fragmentsize = min(FILEFRAGMENTSIZE, f->size - position);
+	if (trans->sendfile)
+		SV_ReadSendFile(trans->sendfile, p->data, position, fragmentsize);
+	else
+		M_Memcpy(p->data, &trans->data[position], fragmentsize);
+	p->iteration = trans->iteration;
+	p->position = LONG(position);
+	p->fileid = f->fileid;
+	p->filesize = LONG(f->size);
+	p->size = SHORT((UINT16)FILEFRAGMENTSIZE);
 
-		// Find the first non-acknowledged fragment
-		while (transfer[i].ackedfragments[transfer[i].position / FILEFRAGMENTSIZE])
+	// Send the packet
+	if (!HSendPacket(node, false, 0, FILETXHEADER + fragmentsize)) // Don't use the default acknowledgement system
+		return false; // Not sent for some odd reason, retry at next call
+
+	if (!trans->inflight)
+		trans->timer = t;
+	trans->inflight++;
+	trans->sentthistic++;
+
+	// Only time fragments sent once, an acknowledgement
+	// for a resent one could be for either copy
+	if (!trans->timing && !resent)
+	{
+		trans->timing = true;
+		trans->rttfragment = fragment;
+		trans->rttsent = I_GetPreciseTime();
+	}
+
+	trans->sentbytes += fragmentsize;
+	filesentbytes += fragmentsize;
+	if (resent)
+	{
+		trans->resentbytes += fragmentsize;
+		fileresentbytes += fragmentsize;
+	}
+
+	return true;
+}
+
+/** Handles file transmission
+  *
+  */
+void FileSendTicker(void)
+{
+	static INT32 currentnode = 0;
+	precise_t starttime;
+	INT32 sendnodes[MAXNETNODES];
+	INT32 numsendnodes = 0, i, j;
+
+	// If someone is taking too long to download, kick them with a timeout
+	// to prevent blocking the rest of the server...
+	if (luafiletransfers)
+	{
+		for (i = 1; i < MAXNETNODES; i++)
 		{
-			transfer[i].position += FILEFRAGMENTSIZE;
-			if (transfer[i].position >= f->size)
-			{
-				if (transfer[i].ackediteration < transfer[i].iteration)
-					transfer[i].dontsenduntil = I_GetTime() + TICRATE / 2;
+			luafiletransfernodestatus_t status = luafiletransfers->nodestatus[i];
 
-				transfer[i].position = 0;
-				transfer[i].iteration++;
+			if (status != LFTNS_NONE && status != LFTNS_WAITING && status != LFTNS_SENT
+				&& I_GetTime() > luafiletransfers->nodetimeouts[i])
+			{
+				Net_ConnectionTimeout(i);
 			}
 		}
+	}
 
-		// Build a packet containing a file fragment
-		p = &netbuffer->u.filetxpak;
-		fragmentsize = FILEFRAGMENTSIZE;
-		if (f->size-transfer[i].position < fragmentsize)
-			fragmentsize = f->size-transfer[i].position;
-		if (ram)
-			M_Memcpy(p->data, &f->id.ram[transfer[i].position], fragmentsize);
-		else
-		{
-			fseek(transfer[i].currentfile, transfer[i].position, SEEK_SET);
+	if (!filestosend) // No file to send
+		return;
 
-			if (fread(p->data, 1, fragmentsize, transfer[i].currentfile) != fragmentsize)
-				I_Error("FileSendTicker: can't read %s byte on %s at %d because %s", sizeu1(fragmentsize), f->id.filename, transfer[i].position, M_FileError(transfer[i].currentfile));
-		}
-		p->iteration = transfer[i].iteration;
-		p->position = LONG(transfer[i].position);
-		p->fileid = f->fileid;
-		p->filesize = LONG(f->size);
-		p->size = SHORT((UINT16)FILEFRAGMENTSIZE);
-
-		// Send the packet
-		if (HSendPacket(i, false, 0, FILETXHEADER + fragmentsize)) // Don't use the default acknowledgement system
-		{ // Success
-			transfer[i].position = (UINT32)(transfer[i].position + fragmentsize);
-			if (transfer[i].position >= f->size)
-			{
-				if (transfer[i].ackediteration < transfer[i].iteration)
-					transfer[i].dontsenduntil = I_GetTime() + TICRATE / 2;
+	starttime = I_GetPreciseTime();
+	netbuffer->packettype = PT_FILEFRAGMENT;
 
-				transfer[i].position = 0;
-				transfer[i].iteration++;
+	// Start with a different node each time, so nobody always goes last
+	for (j = 0; j < MAXNETNODES; j++)
+	{
+		i = (currentnode + j) % MAXNETNODES;
+		if (transfer[i].txlist)
+			sendnodes[numsendnodes++] = i;
+	}
+	currentnode = (currentnode+1) % MAXNETNODES;
+
+	// Take turns between the nodes until every window is full. Each window
+	// follows how fast its node acknowledges, and Net_CanSendFiles keeps
+	// downloads from eating into the bandwidth the game needs.
+	while (numsendnodes)
+	{
+		for (j = 0; j < numsendnodes;)
+		{
+			if (!Net_CanSendFiles())
+			{
+				numsendnodes = 0;
+				break;
 			}
-		}
-		else
-		{ // Not sent for some odd reason, retry at next call
-			// Exit the while (can't send this one so why should i send the next?)
-			break;
+
+			// Sending the last fragment can end the transfer
+			if (transfer[sendnodes[j]].txlist && SV_SendFileFragment(sendnodes[j]))
+				j++;
+			else
+				memmove(&sendnodes[j], &sendnodes[j+1], (--numsendnodes - j) * sizeof (*sendnodes));
 		}
 	}
+
+	filesendtime += I_GetPreciseTime() - starttime;
 }
 
 void PT_FileAck(void)
@@ -1172,7 +1743,8 @@ void PT_FileAck(void)
 	fileack_pak *packet = &netbuffer->u.fileack;
 	INT32 node = doomcom->remotenode;
 	filetran_t *trans = &transfer[node];
-	INT32 i, j;
+	UINT32 acked = 0, inflightacked = 0;
+	INT32 i, j, k;
 
 	// Wrong file id? Ignore it, it's probably a late packet
 	if (!(trans->txlist && packet->fileid == trans->txlist->fileid))
@@ -1184,40 +1756,74 @@ void PT_FileAck(void)
 		return;
 	}
 
+	// Nothing sent yet
+	if (!trans->data && !trans->sendfile)
+		return;
+
 	if (packet->iteration > trans->ackediteration)
-	{
 		trans->ackediteration = packet->iteration;
-		if (trans->ackediteration >= trans->iteration - 1)
-			trans->dontsenduntil = 0;
-	}
 
 	for (i = 0; i < packet->numsegments; i++)
 	{
 		fileacksegment_t *segment = &packet->segments[i];
+		UINT32 start = LONG(segment->start);
+		UINT32 acks = LONG(segment->acks);
 
-		for (j = 0; j < 32; j++)
-			if (LONG(segment->acks) & (1 << j))
+		// Add each run of set bits at once
+		for (j = 0; j < 32; j = k)
+		{
+			if (!(acks & (1u << j)))
 			{
-				if (LONG(segment->start) * FILEFRAGMENTSIZE >= trans->txlist->size)
-				{
-					Net_CloseConnection(node);
-					return;
-				}
+				k = j + 1;
+				continue;
+			}
 
-				if (!trans->ackedfragments[LONG(segment->start) + j])
-				{
-					trans->ackedfragments[LONG(segment->start) + j] = true;
-					trans->ackedsize += FILEFRAGMENTSIZE;
+			for (k = j + 1; k < 32 && (acks & (1u << k)); k++)
+				;
 
-					// If the last missing fragment was acked, finish!
-					if (trans->ackedsize == trans->txlist->size)
-					{
-						SV_EndFileSend(node);
-						return;
-					}
-				}
+			if (start >= trans->numfragments || (UINT32)k > trans->numfragments - start)
+			{
+				Net_CloseConnection(node);
+				return;
 			}
+
+			// Only what was sent in this pass was in flight
+			if (start + j < trans->fragment)
+			{
+				UINT32 end = min(start + k, trans->fragment);
+				UINT32 count = SV_AckFragments(trans, start + j, end);
+
+				if (count)
+					trans->highestacked = max(trans->highestacked, end);
+				inflightacked += count;
+				acked += count;
+			}
+			if (start + k > trans->fragment)
+				acked += SV_AckFragments(trans, max(start + j, trans->fragment), start + k);
+		}
+	}
+
+	if (!acked)
+		return;
+
+	trans->ackedfragments += acked;
+	trans->ackedsize = min(trans->ackedfragments * FILEFRAGMENTSIZE, trans->txlist->size);
+
+	// If the last missing fragment was acked, finish!
+	if (trans->ackedfragments == trans->numfragments)
+	{
+		SV_EndFileSend(node);
+		return;
+	}
+
+	if (trans->timing && SV_NextUnackedFragment(trans, trans->rttfragment) != trans->rttfragment)
+	{
+		SV_FileRoundTrip(trans, (INT32)((I_GetPreciseTime() - trans->rttsent) * 1000000 / I_GetPrecisePrecision()));
+		trans->timing = false;
 	}
+
+	SV_FileWindowAck(trans, inflightacked);
+	SV_FileCheckLosses(trans);
 }
 
 void PT_FileReceived(void)
@@ -1571,8 +2177,17 @@ void Command_Downloads_f(void)
 			CONS_Printf("%2d  %c%s  ", node, ratecolor, name); // Node and file name
 			CONS_Printf("\x80%uK\x84/\x80%uK ", position / 1024, size / 1024); // Progress in kB
 			CONS_Printf("\x80(%c%u%%\x80)  ", ratecolor, (UINT32)(100.0 * position / size)); // Progress in %
+			CONS_Printf("\x86window %u rtt %dms\x80  ", transfer[node].window, transfer[node].srtt / 1000); // Congestion control
 			CONS_Printf("%s\n", I_GetNodeAddress(node)); // Address and newline
 		}
+
+	if (filesentbytes)
+	{
+		double mib = (double)filesentbytes / (1024 * 1024);
+		CONS_Printf("Sent %.1f MiB, %u%% resent, %.0f us per MiB\n", mib,
+			(UINT32)(100.0 * fileresentbytes / filesentbytes),
+			(double)filesendtime * 1000000 / I_GetPrecisePrecision() / mib);
+	}
 }
 
 // Functions cut and pasted from Doomatic :)
@@ -1642,13 +2257,14 @@ filestatus_t checkfilemd5(char *filename, const UINT8 *wantedmd5sum)
 // Rewritten by Monster Iestyn to be less stupid
 // Note: if completepath is true, "filename" is modified, but only if FS_FOUND is going to be returned
 // (Don't worry about WinCE's version of filesearch, nobody cares about that OS anymore)
+// Searches go through the addon index, so folders that haven't changed aren't read again.
 filestatus_t findfile(char *filename, const UINT8 *wantedmd5sum, boolean completepath)
 {
 	filestatus_t homecheck; // store result of last file search
 	boolean badmd5 = false; // store whether md5 was bad from either of the first two searches (if nothing was found in the third)
 
 	// first, check SRB2's "home" directory
-	homecheck = filesearch(filename, srb2home, wantedmd5sum, completepath, 10);
+	homecheck = indexsearch(filename, srb2home, wantedmd5sum, completepath, 10);
 
 	if (homecheck == FS_FOUND) // we found the file, so return that we have :)
 		return FS_FOUND;
@@ -1657,7 +2273,7 @@ filestatus_t findfile(char *filename, const UINT8 *wantedmd5sum, boolean complet
 	// if not found at all, just move on without doing anything
 
 	// next, check SRB2's "path" directory
-	homecheck = filesearch(filename, srb2path, wantedmd5sum, completepath, 10);
+	homecheck = indexsearch(filename, srb2path, wantedmd5sum, completepath, 10);
 
 	if (homecheck == FS_FOUND) // we found the file, so return that we have :)
 		return FS_FOUND;
@@ -1666,7 +2282,7 @@ filestatus_t findfile(char *filename, const UINT8 *wantedmd5sum, boolean complet
 	// if not found at all, just move on without doing anything
 
 	// finally check "." directory
-	homecheck = filesearch(filename, ".", wantedmd5sum, completepath, 10);
+	homecheck = indexsearch(filename, ".", wantedmd5sum, completepath, 10);
 
 	if (homecheck != FS_NOTFOUND) // if not found this time, fall back on the below return statement
 		return homecheck; // otherwise return the result we got
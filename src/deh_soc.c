@@ -4188,9 +4188,11 @@ sfxenum_t get_sfx(const char *word)
 		word += 4; // take off the SFX_
 	else if (fastncmp("DS",word,2))
 		word += 2; // take off the DS
-	for (i = 0; i < NUMSFX; i++)
-		if (S_sfx[i].name && fasticmp(word, S_sfx[i].name))
-			return i;
+	if (fasticmp(word, S_sfx[sfx_None].name))
+		return sfx_None;
+	i = S_FindSfxByName(word);
+	if (i != sfx_None)
+		return i;
 	deh_warning("Couldn't find sfx named 'SFX_%s'",word);
 	return sfx_None;
 }
@@ -45,6 +45,8 @@
 #define NOWIPE // do not enable wipe image post processing for ARM, SH and MIPS CPUs
 #endif
 
+#define MAXFADEMASKWIDTH 640 // widest fade mask, see F_GetFadeMask
+
 typedef struct fademask_s {
 	UINT8* mask;
 	UINT16 width, height;
@@ -204,227 +206,96 @@ void F_WipeStageTitle(void)
 /**	Wipe ticker
   *
   * \param	fademask	pixels to change
+  * \param	colormap	fade colormap for WIPESTYLE_COLORMAP, or NULL
   */
-static void F_DoWipe(fademask_t *fademask)
+static void F_DoWipe(fademask_t *fademask, UINT8 *colormap)
 {
 	// Software mask wipe -- optimized; though it might not look like it!
-	// Okay, to save you wondering *how* this is more optimized than the simpler
-	// version that came before it...
 	// ---
-	// The previous code did two FixedMul calls for every single pixel on the
-	// screen, of which there are hundreds of thousands -- if not millions -- of.
-	// This worked fine for smaller screen sizes, but with excessively large
-	// (1920x1200) screens that meant 4 million+ calls out to FixedMul, and that
-	// would take /just/ long enough that fades would start to noticably lag.
+	// Every pixel of the fade mask covers a rectangle of the screen, and
+	// each of those rectangles is either copied from the start or end screen,
+	// or mapped through a single 256-entry table. We precalculate all the X
+	// and Y positions that we need to draw from and to, and then go through
+	// the screen one line at a time, so that memory is accessed in order.
+
+	// wipe screen, start, end
+	UINT8       *w_base = wipe_scr;
+	const UINT8 *s_base = wipe_scr_start;
+	const UINT8 *e_base = wipe_scr_end;
+
+	const UINT8 *mask = fademask->mask;
+	const UINT8 *transtbl[MAXFADEMASKWIDTH];
+
+	// rectangle coordinates, etc.
+	UINT16* scrxpos = (UINT16*)malloc((fademask->width + 1)  * sizeof(UINT16));
+	UINT16* scrypos = (UINT16*)malloc((fademask->height + 1) * sizeof(UINT16));
+	UINT16 maskx, masky;
+	UINT32 relativepos;
+	INT32 y;
+
+	// ---
+	// Screw it, we do the fixed point math ourselves up front.
+	scrxpos[0] = 0;
+	for (relativepos = 0, maskx = 1; maskx < fademask->width; ++maskx)
+		scrxpos[maskx] = (relativepos += fademask->xscale)>>FRACBITS;
+	scrxpos[fademask->width] = vid.width;
+
+	scrypos[0] = 0;
+	for (relativepos = 0, masky = 1; masky < fademask->height; ++masky)
+		scrypos[masky] = (relativepos += fademask->yscale)>>FRACBITS;
+	scrypos[fademask->height] = vid.height;
 	// ---
-	// This code iterates over the fade mask's pixels instead of the screen's,
-	// and deals with drawing over each rectangular area before it moves on to
-	// the next pixel in the fade mask.  As a result, it's more complex (and might
-	// look a little messy; sorry!) but it simultaneously runs at twice the speed.
-	// In addition, we precalculate all the X and Y positions that we need to draw
-	// from and to, so it uses a little extra memory, but again, helps it run faster.
+
+	for (masky = 0; masky < fademask->height; ++masky, mask += fademask->width)
 	{
-		// wipe screen, start, end
-		UINT8       *w = wipe_scr;
-		const UINT8 *s = wipe_scr_start;
-		const UINT8 *e = wipe_scr_end;
-
-		// first pixel for each screen
-		UINT8       *w_base = w;
-		const UINT8 *s_base = s;
-		const UINT8 *e_base = e;
-
-		// mask data, end
-		UINT8       *transtbl;
-		const UINT8 *mask    = fademask->mask;
-		const UINT8 *maskend = mask + fademask->size;
-
-		// rectangle draw hints
-		UINT32 draw_linestart, draw_rowstart;
-		UINT32 draw_lineend,   draw_rowend;
-		UINT32 draw_linestogo, draw_rowstogo;
-
-		// rectangle coordinates, etc.
-		UINT16* scrxpos = (UINT16*)malloc((fademask->width + 1)  * sizeof(UINT16));
-		UINT16* scrypos = (UINT16*)malloc((fademask->height + 1) * sizeof(UINT16));
-		UINT16 maskx, masky;
-		UINT32 relativepos;
-
-		// ---
-		// Screw it, we do the fixed point math ourselves up front.
-		scrxpos[0] = 0;
-		for (relativepos = 0, maskx = 1; maskx < fademask->width; ++maskx)
-			scrxpos[maskx] = (relativepos += fademask->xscale)>>FRACBITS;
-		scrxpos[fademask->width] = vid.width;
-
-		scrypos[0] = 0;
-		for (relativepos = 0, masky = 1; masky < fademask->height; ++masky)
-			scrypos[masky] = (relativepos += fademask->yscale)>>FRACBITS;
-		scrypos[fademask->height] = vid.height;
-		// ---
-
-		maskx = masky = 0;
-		do
+		// pointer to the table that each mask pixel in this row would use
+		for (maskx = 0; maskx < fademask->width; ++maskx)
 		{
-			draw_rowstart = scrxpos[maskx];
-			draw_rowend   = scrxpos[maskx + 1];
-			draw_linestart = scrypos[masky];
-			draw_lineend   = scrypos[masky + 1];
-
-			relativepos = (draw_linestart * vid.width) + draw_rowstart;
-			draw_linestogo = draw_lineend - draw_linestart;
+			int nmask = mask[maskx];
 
-			if (*mask == 0)
-			{
-				// shortcut - memcpy source to work
-				while (draw_linestogo--)
-				{
-					M_Memcpy(w_base+relativepos, s_base+relativepos, draw_rowend-draw_rowstart);
-					relativepos += vid.width;
-				}
-			}
-			else if (*mask >= 10)
-			{
-				// shortcut - memcpy target to work
-				while (draw_linestogo--)
-				{
-					M_Memcpy(w_base+relativepos, e_base+relativepos, draw_rowend-draw_rowstart);
-					relativepos += vid.width;
-				}
-			}
-			else
+			if (colormap)
 			{
-				// pointer to transtable that this mask would use
-				transtbl = R_GetTranslucencyTable((9 - *mask) + 1);
-
-				// DRAWING LOOP
-				while (draw_linestogo--)
-				{
-					w = w_base + relativepos;
-					s = s_base + relativepos;
-					e = e_base + relativepos;
-					draw_rowstogo = draw_rowend - draw_rowstart;
-
-					while (draw_rowstogo--)
-						*w++ = transtbl[ ( *e++ << 8 ) + *s++ ];
-
-					relativepos += vid.width;
-				}
-				// END DRAWING LOOP
+				if (nmask == 0 || nmask >= FADECOLORMAPROWS)
+					continue;
+				if (wipestyleflags & WSF_FADEIN)
+					nmask = (FADECOLORMAPROWS-1) - nmask;
+				transtbl[maskx] = colormap + (nmask * 256);
 			}
+			else if (nmask != 0 && nmask < 10)
+				transtbl[maskx] = R_GetTranslucencyTable((9 - nmask) + 1);
+		}
 
-			if (++maskx >= fademask->width)
-				++masky, maskx = 0;
-		} while (++mask < maskend);
-
-		free(scrxpos);
-		free(scrypos);
-	}
-}
-
-static void F_DoColormapWipe(fademask_t *fademask, UINT8 *colormap)
-{
-	// Lactozilla: F_DoWipe for WIPESTYLE_COLORMAP
-	{
-		// wipe screen, start, end
-		UINT8       *w = wipe_scr;
-		const UINT8 *s = wipe_scr_start;
-		const UINT8 *e = wipe_scr_end;
-
-		// first pixel for each screen
-		UINT8       *w_base = w;
-		const UINT8 *s_base = s;
-		const UINT8 *e_base = e;
-
-		// mask data, end
-		UINT8       *transtbl;
-		const UINT8 *mask    = fademask->mask;
-		const UINT8 *maskend = mask + fademask->size;
-
-		// rectangle draw hints
-		UINT32 draw_linestart, draw_rowstart;
-		UINT32 draw_lineend,   draw_rowend;
-		UINT32 draw_linestogo, draw_rowstogo;
-
-		// rectangle coordinates, etc.
-		UINT16* scrxpos = (UINT16*)malloc((fademask->width + 1)  * sizeof(UINT16));
-		UINT16* scrypos = (UINT16*)malloc((fademask->height + 1) * sizeof(UINT16));
-		UINT16 maskx, masky;
-		UINT32 relativepos;
-
-		// ---
-		// Screw it, we do the fixed point math ourselves up front.
-		scrxpos[0] = 0;
-		for (relativepos = 0, maskx = 1; maskx < fademask->width; ++maskx)
-			scrxpos[maskx] = (relativepos += fademask->xscale)>>FRACBITS;
-		scrxpos[fademask->width] = vid.width;
-
-		scrypos[0] = 0;
-		for (relativepos = 0, masky = 1; masky < fademask->height; ++masky)
-			scrypos[masky] = (relativepos += fademask->yscale)>>FRACBITS;
-		scrypos[fademask->height] = vid.height;
-		// ---
-
-		maskx = masky = 0;
-		do
+		// DRAWING LOOP
+		for (y = scrypos[masky]; y < scrypos[masky + 1]; ++y)
 		{
-			draw_rowstart = scrxpos[maskx];
-			draw_rowend   = scrxpos[maskx + 1];
-			draw_linestart = scrypos[masky];
-			draw_lineend   = scrypos[masky + 1];
-
-			relativepos = (draw_linestart * vid.width) + draw_rowstart;
-			draw_linestogo = draw_lineend - draw_linestart;
+			relativepos = y * vid.width;
 
-			if (*mask == 0)
+			for (maskx = 0; maskx < fademask->width; ++maskx)
 			{
-				// shortcut - memcpy source to work
-				while (draw_linestogo--)
+				const UINT32 pos = relativepos + scrxpos[maskx];
+				const size_t count = scrxpos[maskx + 1] - scrxpos[maskx];
+
+				if (mask[maskx] == 0)
 				{
-					M_Memcpy(w_base+relativepos, s_base+relativepos, draw_rowend-draw_rowstart);
-					relativepos += vid.width;
+					// shortcut - memcpy source to work
+					M_Memcpy(w_base+pos, s_base+pos, count);
 				}
-			}
-			else if (*mask >= FADECOLORMAPROWS)
-			{
-				// shortcut - memcpy target to work
-				while (draw_linestogo--)
+				else if (mask[maskx] >= (colormap ? FADECOLORMAPROWS : 10))
 				{
-					M_Memcpy(w_base+relativepos, e_base+relativepos, draw_rowend-draw_rowstart);
-					relativepos += vid.width;
+					// shortcut - memcpy target to work
+					M_Memcpy(w_base+pos, e_base+pos, count);
 				}
+				else if (colormap)
+					V_MapBytes(w_base+pos, e_base+pos, count, transtbl[maskx]);
+				else
+					V_BlendBytes(w_base+pos, s_base+pos, e_base+pos, count, transtbl[maskx]);
 			}
-			else
-			{
-				int nmask = *mask;
-				if (wipestyleflags & WSF_FADEIN)
-					nmask = (FADECOLORMAPROWS-1) - nmask;
-
-				transtbl = colormap + (nmask * 256);
-
-				// DRAWING LOOP
-				while (draw_linestogo--)
-				{
-					w = w_base + relativepos;
-					s = s_base + relativepos;
-					e = e_base + relativepos;
-					draw_rowstogo = draw_rowend - draw_rowstart;
-
-					while (draw_rowstogo--)
-						*w++ = transtbl[*e++];
-
-					relativepos += vid.width;
-				}
-				// END DRAWING LOOP
-			}
-
-			if (++maskx >= fademask->width)
-				++masky, maskx = 0;
-		} while (++mask < maskend);
-
-		free(scrxpos);
-		free(scrypos);
+		}
+		// END DRAWING LOOP
 	}
+
+	free(scrxpos);
+	free(scrypos);
 }
 #endif
 
@@ -585,7 +456,7 @@ void F_RunWipe(UINT8 wipetype, boolean drawMenu)
 				UINT8 *colormap = fadecolormap;
 				if (wipestyleflags & WSF_TOWHITE)
 					colormap += (FADECOLORMAPROWS * 256);
-				F_DoColormapWipe(fmask, colormap);
+				F_DoWipe(fmask, colormap); // Lactozilla: colormap wipe
 			}
 
 			// Draw the title card above the wipe
@@ -601,7 +472,7 @@ void F_RunWipe(UINT8 wipetype, boolean drawMenu)
 			}
 			else
 #endif
-				F_DoWipe(fmask);
+				F_DoWipe(fmask, NULL);
 		}
 
 		I_OsPolling();
@@ -24,6 +24,7 @@
 #endif
 #include <sys/stat.h>
 #include <string.h>
+#include <time.h>
 
 #include "filesrch.h"
 #include "d_netfil.h"
@@ -31,6 +32,11 @@
 #include "z_zone.h"
 #include "m_menu.h" // Addons_option_Onchange
 #include "w_wad.h"
+#include "d_main.h" // srb2home, pandf
+#include "i_system.h"
+#include "i_time.h"
+#include "md5.h"
+#include "command.h"
 
 #if defined (_WIN32) && defined (_MSC_VER)
 
@@ -479,6 +485,584 @@ filestatus_t filesearch(char *filename, const char *startpath, const UINT8 *want
 	return retval;
 }
 
+//
+// Addon index
+//
+// Remembers what is in every folder searched so far, so that finding a
+// file doesn't need a full walk of the search tree every time. A folder
+// is only read again when its modification time changes, which happens
+// whenever something is added to, removed from or renamed in it. Files
+// rewritten in place don't touch their folder, so a file's size and
+// modification time are checked again before its cached MD5 is used.
+// The index is kept in srb2home between runs.
+//
+
+#define ADDONINDEXFILE "addonindex.dat"
+#define ADDONINDEXVERSION 1
+#define ADDONINDEXHASHSIZE 4096
+
+typedef struct
+{
+	char *name;
+	boolean isdir;
+	boolean hasmd5;
+	UINT64 size;
+	INT64 mtime;
+	UINT8 md5sum[16];
+} addonentry_t;
+
+typedef struct addondir_s
+{
+	char *path; // no trailing separator
+	INT64 mtime;
+	INT64 scanned; // when it was read; 0 if never
+	tic_t checked; // when its mtime was last looked at
+	addonentry_t *entries; // sorted by name, see AddonIndex_CompareNames
+	size_t numentries;
+	struct addondir_s *hashnext;
+} addondir_t;
+
+static addondir_t *addondirs[ADDONINDEXHASHSIZE];
+static boolean addonindexloaded = false;
+static boolean addonindexdirty = false;
+static tic_t addonindexbias = 0;
+
+static UINT32 AddonIndex_Hash(const char *path)
+{
+	UINT32 hash = 2166136261u;
+	while (*path)
+		hash = (hash ^ (UINT8)*path++) * 16777619u;
+	return hash & (ADDONINDEXHASHSIZE-1);
+}
+
+// Directories are looked at no more than once per tic, so
+// searching for a whole list of files only walks the tree once.
+static tic_t AddonIndex_Stamp(void)
+{
+	return I_GetTime() + addonindexbias;
+}
+
+// Only folders named by an absolute path are kept between runs.
+static boolean AddonIndex_IsAbsolute(const char *path)
+{
+#ifdef _WIN32
+	return (path[0] == '\\' || (path[0] && path[1] == ':'));
+#else
+	return (path[0] == '/');
+#endif
+}
+
+static int AddonIndex_CompareNames(const void *a, const void *b)
+{
+	const addonentry_t *ea = a, *eb = b;
+	int cmp = strcasecmp(ea->name, eb->name);
+	return (cmp ? cmp : strcmp(ea->name, eb->name));
+}
+
+static void AddonIndex_FreeEntries(addondir_t *dir)
+{
+	size_t i;
+	for (i = 0; i < dir->numentries; i++)
+		free(dir->entries[i].name);
+	free(dir->entries);
+	dir->entries = NULL;
+	dir->numentries = 0;
+}
+
+#ifdef _DEBUG
+static void AddonIndex_Clear(void)
+{
+	size_t i;
+	addondir_t *dir, *next;
+
+	for (i = 0; i < ADDONINDEXHASHSIZE; i++)
+	{
+		for (dir = addondirs[i]; dir; dir = next)
+		{
+			next = dir->hashnext;
+			AddonIndex_FreeEntries(dir);
+			free(dir->path);
+			free(dir);
+		}
+		addondirs[i] = NULL;
+	}
+}
+#endif
+
+static addondir_t *AddonIndex_FindDir(const char *path)
+{
+	addondir_t *dir;
+	for (dir = addondirs[AddonIndex_Hash(path)]; dir; dir = dir->hashnext)
+		if (!strcmp(dir->path, path))
+			return dir;
+	return NULL;
+}
+
+static addondir_t *AddonIndex_NewDir(const char *path)
+{
+	UINT32 hash = AddonIndex_Hash(path);
+	addondir_t *dir = calloc(1, sizeof (addondir_t));
+
+	if (!dir || !(dir->path = strdup(path)))
+		I_Error("AddonIndex_NewDir: out of memory");
+
+	dir->hashnext = addondirs[hash];
+	addondirs[hash] = dir;
+	return dir;
+}
+
+// Writes "path/name" into buf, without doubling up separators.
+static boolean AddonIndex_JoinPath(char *buf, size_t size, const char *path, const char *name)
+{
+	size_t len = strlen(path);
+	int ret;
+
+	if (len && path[len-1] == PATHSEP[0])
+		ret = snprintf(buf, size, "%s%s", path, name);
+	else
+		ret = snprintf(buf, size, "%s" PATHSEP "%s", path, name);
+	return (ret >= 0 && (size_t)ret < size);
+}
+
+// Reads a folder's contents, keeping the MD5 of any file that hasn't changed.
+static void AddonIndex_ScanDir(addondir_t *dir, INT64 mtime)
+{
+	DIR *dirhandle = opendir(dir->path);
+	struct dirent *dent;
+	struct stat fsstat;
+	char path[dirpathlen];
+	addonentry_t *entries = NULL, *entry, *old;
+	size_t numentries = 0, maxentries = 0, i;
+
+	if (dirhandle)
+	{
+		while ((dent = readdir(dirhandle)) != NULL)
+		{
+			if (isuptree(dent->d_name)
+			|| strchr(dent->d_name, '\n') // couldn't be saved
+			|| !AddonIndex_JoinPath(path, sizeof path, dir->path, dent->d_name)
+			|| stat(path, &fsstat) < 0 // do we want to follow symlinks? if not: change it to lstat
+			|| !(S_ISDIR(fsstat.st_mode) || S_ISREG(fsstat.st_mode)))
+				continue;
+
+			if (numentries == maxentries)
+			{
+				maxentries = maxentries ? maxentries * 2 : 32;
+				entries = realloc(entries, maxentries * sizeof (addonentry_t));
+				if (!entries)
+					I_Error("AddonIndex_ScanDir: out of memory");
+			}
+
+			entry = &entries[numentries++];
+			memset(entry, 0, sizeof (*entry));
+			if (!(entry->name = strdup(dent->d_name)))
+				I_Error("AddonIndex_ScanDir: out of memory");
+			entry->isdir = S_ISDIR(fsstat.st_mode);
+			if (!entry->isdir)
+			{
+				entry->size = fsstat.st_size;
+				entry->mtime = fsstat.st_mtime;
+			}
+		}
+		closedir(dirhandle);
+	}
+
+	if (numentries)
+		qsort(entries, numentries, sizeof (addonentry_t), AddonIndex_CompareNames);
+
+	for (i = 0; i < numentries; i++)
+	{
+		entry = &entries[i];
+		if (entry->isdir || !dir->numentries)
+			continue;
+
+		old = bsearch(entry, dir->entries, dir->numentries, sizeof (addonentry_t), AddonIndex_CompareNames);
+		if (old && old->hasmd5 && !old->isdir && old->size == entry->size && old->mtime == entry->mtime)
+		{
+			entry->hasmd5 = true;
+			M_Memcpy(entry->md5sum, old->md5sum, 16);
+		}
+	}
+
+	AddonIndex_FreeEntries(dir);
+	dir->entries = entries;
+	dir->numentries = numentries;
+	dir->mtime = mtime;
+	dir->scanned = time(NULL);
+
+	if (AddonIndex_IsAbsolute(dir->path))
+		addonindexdirty = true;
+}
+
+static void AddonIndex_Load(void);
+
+// Returns the index's copy of a folder, reading it again if it changed.
+// Returns NULL if the folder doesn't exist.
+static addondir_t *AddonIndex_GetDir(const char *path)
+{
+	char key[dirpathlen];
+	size_t len;
+	addondir_t *dir;
+	struct stat fsstat;
+	tic_t stamp = AddonIndex_Stamp();
+
+	if (!addonindexloaded)
+		AddonIndex_Load();
+
+	strlcpy(key, path, sizeof key);
+	len = strlen(key);
+	while (len > 1 && key[len-1] == PATHSEP[0] && key[len-2] != ':')
+		key[--len] = '\0';
+
+	dir = AddonIndex_FindDir(key);
+	if (dir && dir->checked == stamp)
+		return (dir->scanned ? dir : NULL);
+
+	if (stat(key, &fsstat) < 0 || !S_ISDIR(fsstat.st_mode))
+	{
+		if (dir)
+		{
+			// Gone; forget what was in it.
+			AddonIndex_FreeEntries(dir);
+			dir->scanned = 0;
+			dir->checked = stamp;
+		}
+		return NULL;
+	}
+
+	if (!dir)
+		dir = AddonIndex_NewDir(key);
+	dir->checked = stamp;
+
+	// A change in the same second as the read could have been missed.
+	if (!dir->scanned || dir->mtime != (INT64)fsstat.st_mtime || dir->mtime >= dir->scanned)
+		AddonIndex_ScanDir(dir, fsstat.st_mtime);
+
+	return dir;
+}
+
+// The index's version of checkfilemd5.
+static filestatus_t AddonIndex_CheckMD5(addonentry_t *entry, const char *path, const UINT8 *wantedmd5sum)
+{
+#if defined (NOMD5)
+	(void)entry;
+	(void)path;
+	(void)wantedmd5sum;
+#else
+	struct stat fsstat;
+
+	if (!wantedmd5sum)
+		return FS_FOUND;
+
+	if (stat(path, &fsstat) < 0)
+		return FS_NOTFOUND;
+
+	if (entry->size != (UINT64)fsstat.st_size || entry->mtime != (INT64)fsstat.st_mtime)
+	{
+		entry->size = fsstat.st_size;
+		entry->mtime = fsstat.st_mtime;
+		entry->hasmd5 = false;
+	}
+
+	if (!entry->hasmd5)
+	{
+		FILE *fhandle = fopen(path, "rb");
+
+		if (!fhandle)
+			I_Error("Couldn't open %s for md5 check", path);
+
+		md5_stream(fhandle, entry->md5sum);
+		fclose(fhandle);
+
+		// Don't trust it later if the file could still change this second.
+		if (entry->mtime < (INT64)time(NULL))
+		{
+			entry->hasmd5 = true;
+			addonindexdirty = true;
+		}
+	}
+
+	if (memcmp(wantedmd5sum, entry->md5sum, 16))
+		return FS_MD5SUMBAD;
+#endif
+	return FS_FOUND;
+}
+
+static filestatus_t AddonIndex_Search(char *filename, const char *path, const UINT8 *wantedmd5sum,
+	boolean completepath, int depthleft)
+{
+	addondir_t *dir = AddonIndex_GetDir(path);
+	filestatus_t retval = FS_NOTFOUND;
+	char searchpath[dirpathlen];
+	addonentry_t key;
+	size_t lo, hi, i;
+
+	if (!dir)
+		return FS_NOTFOUND;
+
+	// Find the first name that matches, ignoring case.
+	key.name = (char *)filename;
+	lo = 0;
+	hi = dir->numentries;
+	while (lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if (strcasecmp(dir->entries[mid].name, key.name) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (i = lo; i < dir->numentries && !strcasecmp(dir->entries[i].name, key.name); i++)
+	{
+		addonentry_t *entry = &dir->entries[i];
+
+		if (entry->isdir || !AddonIndex_JoinPath(searchpath, sizeof searchpath, dir->path, entry->name))
+			continue;
+
+		switch (AddonIndex_CheckMD5(entry, searchpath, wantedmd5sum))
+		{
+			case FS_FOUND:
+				if (completepath)
+					strcpy(filename, searchpath);
+				else
+					strcpy(filename, entry->name);
+				return FS_FOUND;
+			case FS_MD5SUMBAD:
+				retval = FS_MD5SUMBAD;
+				break;
+			default: // prevent some compiler warnings
+				break;
+		}
+	}
+
+	if (!depthleft)
+		return retval;
+
+	for (i = 0; i < dir->numentries; i++)
+	{
+		if (!dir->entries[i].isdir
+		|| !AddonIndex_JoinPath(searchpath, sizeof searchpath, dir->path, dir->entries[i].name))
+			continue;
+
+		switch (AddonIndex_Search(filename, searchpath, wantedmd5sum, completepath, depthleft - 1))
+		{
+			case FS_FOUND:
+				return FS_FOUND;
+			case FS_MD5SUMBAD:
+				retval = FS_MD5SUMBAD;
+				break;
+			default: // prevent some compiler warnings
+				break;
+		}
+	}
+
+	return retval;
+}
+
+filestatus_t indexsearch(char *filename, const char *startpath, const UINT8 *wantedmd5sum,
+	boolean completepath, int maxsearchdepth)
+{
+	if (maxsearchdepth < 1)
+		return FS_NOTFOUND;
+	return AddonIndex_Search(filename, startpath, wantedmd5sum, completepath, maxsearchdepth - 1);
+}
+
+static void AddonIndex_Load(void)
+{
+	FILE *f;
+	char line[dirpathlen + 128];
+	addondir_t *dir = NULL;
+	addonentry_t *entry;
+	size_t maxentries = 0;
+	int version;
+
+	addonindexloaded = true;
+
+	f = fopen(va(pandf, srb2home, ADDONINDEXFILE), "r");
+	if (!f)
+		return;
+
+	if (!fgets(line, sizeof line, f) || sscanf(line, "SRB2ADDONINDEX %d", &version) != 1
+	|| version != ADDONINDEXVERSION)
+	{
+		fclose(f);
+		return;
+	}
+
+	while (fgets(line, sizeof line, f))
+	{
+		long long mtime, scanned;
+		unsigned long long size;
+		int isdir, pos = 0;
+		char md5hex[33];
+
+		line[strcspn(line, "\n")] = '\0';
+
+		if (sscanf(line, "D %lld %lld %n", &mtime, &scanned, &pos) == 2 && pos && line[pos])
+		{
+			if (AddonIndex_FindDir(line + pos))
+			{
+				dir = NULL; // just in case
+				continue;
+			}
+			dir = AddonIndex_NewDir(line + pos);
+			dir->mtime = mtime;
+			dir->scanned = scanned;
+			maxentries = 0;
+		}
+		else if (dir && sscanf(line, "E %d %llu %lld %32s %n", &isdir, &size, &mtime, md5hex, &pos) == 4
+			&& pos && line[pos])
+		{
+			if (dir->numentries == maxentries)
+			{
+				maxentries = maxentries ? maxentries * 2 : 32;
+				dir->entries = realloc(dir->entries, maxentries * sizeof (addonentry_t));
+				if (!dir->entries)
+					I_Error("AddonIndex_Load: out of memory");
+			}
+
+			entry = &dir->entries[dir->numentries++];
+			memset(entry, 0, sizeof (*entry));
+			if (!(entry->name = strdup(line + pos)))
+				I_Error("AddonIndex_Load: out of memory");
+			entry->isdir = !!isdir;
+			entry->size = size;
+			entry->mtime = mtime;
+
+			if (strlen(md5hex) == 32)
+			{
+				size_t i;
+				unsigned int byte;
+				for (i = 0; i < 16 && sscanf(md5hex + i*2, "%2x", &byte) == 1; i++)
+					entry->md5sum[i] = (UINT8)byte;
+				entry->hasmd5 = (i == 16);
+			}
+		}
+	}
+	fclose(f);
+
+	// The file is sorted already, unless someone has been editing it.
+	{
+		size_t i;
+		for (i = 0; i < ADDONINDEXHASHSIZE; i++)
+			for (dir = addondirs[i]; dir; dir = dir->hashnext)
+				if (dir->numentries)
+					qsort(dir->entries, dir->numentries, sizeof (addonentry_t), AddonIndex_CompareNames);
+	}
+}
+
+/**	\brief	Writes the addon index out to srb2home, if anything changed
+*/
+void saveaddonindex(void)
+{
+	FILE *f;
+	addondir_t *dir;
+	size_t i, j, k;
+
+	if (!addonindexdirty)
+		return;
+
+	f = fopen(va(pandf, srb2home, ADDONINDEXFILE), "w");
+	if (!f)
+		return;
+
+	fprintf(f, "SRB2ADDONINDEX %d\n", ADDONINDEXVERSION);
+
+	for (i = 0; i < ADDONINDEXHASHSIZE; i++)
+	{
+		for (dir = addondirs[i]; dir; dir = dir->hashnext)
+		{
+			if (!dir->scanned || !AddonIndex_IsAbsolute(dir->path))
+				continue;
+
+			fprintf(f, "D %lld %lld %s\n", (long long)dir->mtime, (long long)dir->scanned, dir->path);
+
+			for (j = 0; j < dir->numentries; j++)
+			{
+				addonentry_t *entry = &dir->entries[j];
+				char md5hex[33] = "-";
+
+				if (entry->hasmd5)
+					for (k = 0; k < 16; k++)
+						sprintf(md5hex + k*2, "%02x", entry->md5sum[k]);
+
+				fprintf(f, "E %d %llu %lld %s %s\n", entry->isdir, (unsigned long long)entry->size,
+					(long long)entry->mtime, md5hex, entry->name);
+			}
+		}
+	}
+
+	fclose(f);
+	addonindexdirty = false;
+}
+
+#ifdef _DEBUG
+/**	\brief	Times finding a file the old way, with a cold index and with a warm index
+*/
+void Command_AddonIndexBench_f(void)
+{
+	char filename[MAX_WADPATH];
+	const char *roots[3];
+	precise_t start;
+	UINT64 precision = I_GetPrecisePrecision() / 1000;
+	INT32 i, r, count = 10;
+	filestatus_t result[3] = {FS_NOTFOUND, FS_NOTFOUND, FS_NOTFOUND};
+	double elapsed[3] = {0.0, 0.0, 0.0};
+
+	if (COM_Argc() < 2)
+	{
+		CONS_Printf("addonindexbench <filename> [count]: time searching for a file with and without the addon index\n");
+		return;
+	}
+
+	if (COM_Argc() > 2)
+		count = max(1, atoi(COM_Argv(2)));
+
+	roots[0] = srb2home;
+	roots[1] = srb2path;
+	roots[2] = ".";
+
+	// the way findfile used to work
+	start = I_GetPreciseTime();
+	for (r = 0; r < 3 && result[0] != FS_FOUND; r++)
+	{
+		strlcpy(filename, COM_Argv(1), sizeof filename);
+		result[0] = filesearch(filename, roots[r], NULL, true, 10);
+	}
+	elapsed[0] = (double)(I_GetPreciseTime() - start) / precision;
+
+	// nothing known, as on the first run
+	AddonIndex_Clear();
+	addonindexbias++;
+	start = I_GetPreciseTime();
+	for (r = 0; r < 3 && result[1] != FS_FOUND; r++)
+	{
+		strlcpy(filename, COM_Argv(1), sizeof filename);
+		result[1] = indexsearch(filename, roots[r], NULL, true, 10);
+	}
+	elapsed[1] = (double)(I_GetPreciseTime() - start) / precision;
+
+	// every folder checked again, nothing changed
+	for (i = 0; i < count; i++)
+	{
+		addonindexbias++;
+		start = I_GetPreciseTime();
+		for (r = 0, result[2] = FS_NOTFOUND; r < 3 && result[2] != FS_FOUND; r++)
+		{
+			strlcpy(filename, COM_Argv(1), sizeof filename);
+			result[2] = indexsearch(filename, roots[r], NULL, true, 10);
+		}
+		elapsed[2] += (double)(I_GetPreciseTime() - start) / precision;
+	}
+	elapsed[2] /= count;
+
+	CONS_Printf("filesearch:  %9.2f ms (%s)\n", elapsed[0], result[0] == FS_FOUND ? "found" : "not found");
+	CONS_Printf("cold index:  %9.2f ms (%s)\n", elapsed[1], result[1] == FS_FOUND ? "found" : "not found");
+	CONS_Printf("warm index:  %9.2f ms (%s, average of %d)\n", elapsed[2], result[2] == FS_FOUND ? "found" : "not found", count);
+}
+#endif
+
 #ifndef AVOID_ERRNO
 int direrror = 0;
 #endif
@@ -1033,10 +1617,9 @@ void searchfilemenu(char *tempname)
 
 boolean preparefilemenu(boolean samedepth)
 {
-	DIR *dirhandle;
-	struct dirent *dent;
-	struct stat fsstat;
-	size_t pos = 0, folderpos = 0, numfolders = 0;
+	addondir_t *dir;
+	addonentry_t *entry;
+	size_t i, pos = 0, folderpos = 0, numfolders = 0;
 	char *tempname = NULL;
 
 	if (samedepth)
@@ -1047,8 +1630,11 @@ boolean preparefilemenu(boolean samedepth)
 	else
 		menusearch[0] = menusearch[1] = 0; // clear search
 
-	if (!(dirhandle = opendir(menupath))) // get directory
+	menupath[menupathindex[menudepthleft]] = 0;
+	if (!(dir = AddonIndex_GetDir(menupath))) // get directory
 	{
+		if (tempname)
+			Z_Free(tempname);
 		closefilemenu(true);
 		return false;
 	}
@@ -1059,43 +1645,29 @@ boolean preparefilemenu(boolean samedepth)
 		coredirmenu[sizecoredirmenu-1] = NULL;
 	}
 
-	while (true)
+	for (i = 0; i < dir->numentries; i++)
 	{
-		menupath[menupathindex[menudepthleft]] = 0;
-		dent = readdir(dirhandle);
-
-		if (!dent)
-			break;
-		else if (isuptree(dent->d_name))
-			continue; // we don't want to scan uptree
-
-		strcpy(&menupath[menupathindex[menudepthleft]],dent->d_name);
+		entry = &dir->entries[i];
 
-		if (stat(menupath,&fsstat) < 0) // do we want to follow symlinks? if not: change it to lstat
-			; // was the file (re)moved? can't stat it
-		else // is a file or directory
+		if (!entry->isdir) // file
 		{
-			if (!S_ISDIR(fsstat.st_mode)) // file
+			if (!cv_addons_showall.value)
 			{
-				if (!cv_addons_showall.value)
-				{
-					size_t len = strlen(dent->d_name)+1;
-					UINT8 ext;
-					for (ext = 0; ext < NUM_EXT_TABLE; ext++)
-						if (!strcasecmp(exttable[ext]+1, dent->d_name+len-(exttable[ext][0]))) break; // extension comparison
-					if (ext == NUM_EXT_TABLE) continue; // not an addfile-able (or exec-able) file
-				}
+				size_t len = strlen(entry->name)+1;
+				UINT8 ext;
+				for (ext = 0; ext < NUM_EXT_TABLE; ext++)
+					if (!strcasecmp(exttable[ext]+1, entry->name+len-(exttable[ext][0]))) break; // extension comparison
+				if (ext == NUM_EXT_TABLE) continue; // not an addfile-able (or exec-able) file
 			}
-			else // directory
-				numfolders++;
-
-			sizecoredirmenu++;
 		}
+		else // directory
+			numfolders++;
+
+		sizecoredirmenu++;
 	}
 
 	if (!sizecoredirmenu)
 	{
-		closedir(dirhandle);
 		closefilemenu(false);
 		if (tempname)
 			Z_Free(tempname);
@@ -1113,101 +1685,88 @@ boolean preparefilemenu(boolean samedepth)
 		dirmenu = NULL;
 
 	if (!(coredirmenu = Z_Realloc(coredirmenu, sizecoredirmenu*sizeof(char *), PU_STATIC, NULL)))
-	{
-		closedir(dirhandle); // just in case
 		I_Error("preparefilemenu(): could not reallocate coredirmenu.");
-	}
 
-	rewinddir(dirhandle);
-
-	while ((pos+folderpos) < sizecoredirmenu)
+	for (i = 0; i < dir->numentries && (pos+folderpos) < sizecoredirmenu; i++)
 	{
-		menupath[menupathindex[menudepthleft]] = 0;
-		dent = readdir(dirhandle);
+		char *temp;
+		size_t len;
+		UINT8 ext = EXT_FOLDER;
+		UINT8 folder;
 
-		if (!dent)
-			break;
-		else if (isuptree(dent->d_name))
-			continue; // we don't want to scan uptree
+		entry = &dir->entries[i];
+		len = strlen(entry->name)+1;
 
-		strcpy(&menupath[menupathindex[menudepthleft]],dent->d_name);
-
-		if (stat(menupath,&fsstat) < 0) // do we want to follow symlinks? if not: change it to lstat
-			; // was the file (re)moved? can't stat it
-		else // is a file or directory
+		if (!entry->isdir) // file
 		{
-			char *temp;
-			size_t len = strlen(dent->d_name)+1;
-			UINT8 ext = EXT_FOLDER;
-			UINT8 folder;
+			if (!((numfolders+pos) < sizecoredirmenu)) continue; // crash prevention
+			for (; ext < NUM_EXT_TABLE; ext++)
+				if (!strcasecmp(exttable[ext]+1, entry->name+len-(exttable[ext][0]))) break; // extension comparison
+			if (ext == NUM_EXT_TABLE && !cv_addons_showall.value) continue; // not an addfile-able (or exec-able) file
+			ext += EXT_START; // moving to be appropriate position
 
-			if (!S_ISDIR(fsstat.st_mode)) // file
+			if (ext >= EXT_LOADSTART)
 			{
-				if (!((numfolders+pos) < sizecoredirmenu)) continue; // crash prevention
-				for (; ext < NUM_EXT_TABLE; ext++)
-					if (!strcasecmp(exttable[ext]+1, dent->d_name+len-(exttable[ext][0]))) break; // extension comparison
-				if (ext == NUM_EXT_TABLE && !cv_addons_showall.value) continue; // not an addfile-able (or exec-able) file
-				ext += EXT_START; // moving to be appropriate position
+				size_t j;
 
-				if (ext >= EXT_LOADSTART)
-				{
-					size_t i;
+				if (filenamebuf == NULL)
+					filenamebuf = calloc(sizeof(char) * MAX_WADPATH, numwadfiles);
 
-					if (filenamebuf == NULL)
-						filenamebuf = calloc(sizeof(char) * MAX_WADPATH, numwadfiles);
+				for (j = 0; j < numwadfiles; j++)
+				{
+					if (!filenamebuf[j][0])
+					{
+						strncpy(filenamebuf[j], wadfiles[j]->filename, MAX_WADPATH);
+						filenamebuf[j][MAX_WADPATH - 1] = '\0';
+						nameonly(filenamebuf[j]);
+					}
 
-					for (i = 0; i < numwadfiles; i++)
+					if (strcmp(entry->name, filenamebuf[j]))
+						continue;
+					if (cv_addons_md5.value)
 					{
-						if (!filenamebuf[i][0])
-						{
-							strncpy(filenamebuf[i], wadfiles[i]->filename, MAX_WADPATH);
-							filenamebuf[i][MAX_WADPATH - 1] = '\0';
-							nameonly(filenamebuf[i]);
-						}
-
-						if (strcmp(dent->d_name, filenamebuf[i]))
+						strcpy(&menupath[menupathindex[menudepthleft]], entry->name);
+						if (AddonIndex_CheckMD5(entry, menupath, wadfiles[j]->md5sum) != FS_FOUND)
 							continue;
-						if (cv_addons_md5.value && !checkfilemd5(menupath, wadfiles[i]->md5sum))
-							continue;
-
-						ext |= EXT_LOADED;
 					}
-				}
-				else if (ext == EXT_CFG)
-				{
-					if (!strncmp(dent->d_name, "layout", 6))
-						ext |= EXT_LOADED;
-				}
-				else if (ext == EXT_TXT)
-				{
-					if (!strncmp(dent->d_name, "log-", 4) || !strcmp(dent->d_name, "errorlog.txt"))
-						ext |= EXT_LOADED;
-				}
 
-				if (!strcmp(dent->d_name, configfile))
 					ext |= EXT_LOADED;
-
-				folder = 0;
+				}
 			}
-			else // directory
-				len += (folder = 1);
-
-			if (len > 255)
-				len = 255;
-
-			if (!(temp = Z_Malloc((len+DIR_STRING+folder) * sizeof (char), PU_STATIC, NULL)))
-				I_Error("preparefilemenu(): could not create file entry.");
-			temp[DIR_TYPE] = ext;
-			temp[DIR_LEN] = (UINT8)(len);
-			strlcpy(temp+DIR_STRING, dent->d_name, len);
-			if (folder)
+			else if (ext == EXT_CFG)
 			{
-				strcpy(temp+len, PATHSEP);
-				coredirmenu[folderpos++] = temp;
+				if (!strncmp(entry->name, "layout", 6))
+					ext |= EXT_LOADED;
 			}
-			else
-				coredirmenu[numfolders + pos++] = temp;
+			else if (ext == EXT_TXT)
+			{
+				if (!strncmp(entry->name, "log-", 4) || !strcmp(entry->name, "errorlog.txt"))
+					ext |= EXT_LOADED;
+			}
+
+			if (!strcmp(entry->name, configfile))
+				ext |= EXT_LOADED;
+
+			folder = 0;
 		}
+		else // directory
+			len += (folder = 1);
+
+		if (len > 255)
+			len = 255;
+
+		if (!(temp = Z_Malloc((len+DIR_STRING+folder) * sizeof (char), PU_STATIC, NULL)))
+			I_Error("preparefilemenu(): could not create file entry.");
+		temp[DIR_TYPE] = ext;
+		temp[DIR_LEN] = (UINT8)(len);
+		strlcpy(temp+DIR_STRING, entry->name, len);
+		if (folder)
+		{
+			strcpy(temp+len, PATHSEP);
+			coredirmenu[folderpos++] = temp;
+		}
+		else
+			coredirmenu[numfolders + pos++] = temp;
 	}
 
 	if (filenamebuf)
@@ -1216,8 +1775,6 @@ boolean preparefilemenu(boolean samedepth)
 		filenamebuf = NULL;
 	}
 
-	closedir(dirhandle);
-
 	if ((menudepthleft != menudepth-1) // now for UP... entry
 #if defined(__ANDROID__)
 		&& !(coredirmenu[0] = writedirmenu("UP...", EXT_UP)))
@@ -29,6 +29,24 @@ extern consvar_t cv_addons_option, cv_addons_folder, cv_addons_md5, cv_addons_sh
 filestatus_t filesearch(char *filename, const char *startpath, const UINT8 *wantedmd5sum,
 	boolean completepath, int maxsearchdepth);
 
+/**	\brief	The indexsearch function
+
+	Same as filesearch, but remembers what it found in each folder and
+	only reads a folder again when it has changed, and only works out a
+	file's MD5 again when the file has changed. The index is kept in
+	srb2home between runs; see saveaddonindex.
+
+	\return	filestatus_t
+*/
+
+filestatus_t indexsearch(char *filename, const char *startpath, const UINT8 *wantedmd5sum,
+	boolean completepath, int maxsearchdepth);
+
+void saveaddonindex(void);
+#ifdef _DEBUG
+void Command_AddonIndexBench_f(void);
+#endif
+
 INT32 pathisdirectory(const char *path);
 INT32 samepaths(const char *path1, const char *path2);
 INT32 concatpaths(const char *path, const char *startpath);
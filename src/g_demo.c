@@ -40,6 +40,8 @@
 #include "lua_hook.h"
 #include "md5.h" // demo checksums
 #include "d_netfil.h" // G_CheckDemoExtraFiles
+#include "lzf.h" // demo block compression
+#include "i_threads.h"
 
 boolean timingdemo; // if true, exit with report on completion
 boolean nodrawers; // for comparative timing purposes
@@ -82,11 +84,59 @@ static struct {
 	mobj_t **hitlist;
 } ghostext;
 
+// One tic of a ghost, decoded ahead of time by G_DecodeGhostPoses.
+typedef struct
+{
+	fixed_t x, y, z;
+	UINT8 ziptic, xziptic; // GZT_ and EZT_ flags, for the fields that only apply when changed
+	UINT8 angle, frame, sprite2;
+	UINT8 numhits;
+	UINT16 color, sprite;
+	fixed_t scale, height;
+	UINT32 firsthit; // into ghostposes_t hits
+	UINT32 followdata; // into ghostposes_t follows
+} ghostpose_t;
+
+// Hit poofs worth spawning, already filtered the way G_GhostTicker used to.
+typedef struct
+{
+	mobjtype_t type;
+	fixed_t x, y, z;
+	angle_t angle;
+} ghosthit_t;
+
+typedef struct
+{
+	UINT8 followtic;
+	UINT8 skin, sprite2, frame;
+	UINT16 sprite, color;
+	fixed_t height; // unscaled
+	fixed_t scale;
+	fixed_t x, y, z; // offset from the ghost
+} ghostfollow_t;
+
+typedef struct
+{
+	// in
+	UINT8 *tics, *end;
+	UINT16 version;
+	fixed_t x, y, z; // starting position
+
+	// out
+	ghostpose_t *poses;
+	ghosthit_t *hits;
+	ghostfollow_t *follows;
+	UINT32 numposes, numhits, numfollows;
+	boolean done;
+} ghostposes_t;
+
 // Your naming conventions are stupid and useless.
 // There is no conflict here.
 typedef struct demoghost {
 	UINT8 checksum[16];
-	UINT8 *buffer, *p, fadein;
+	UINT8 fadein;
+	ghostposes_t *poses;
+	UINT32 tic;
 	UINT16 color;
 	UINT16 version;
 	mobj_t oldmo, *mo;
@@ -98,7 +148,7 @@ demoghost *ghosts = NULL;
 // DEMO RECORDING
 //
 
-#define DEMOVERSION 0x0010
+#define DEMOVERSION 0x0011
 #define DEMOHEADER  "\xF0" "SRB2Replay" "\x0F"
 
 #define DF_GHOST        0x01 // This demo contains ghost data too!
@@ -152,6 +202,296 @@ static ticcmd_t oldcmd;
 
 static mobj_t oldmetal, oldghost;
 
+//
+// DEMO STREAMS
+//
+// Since demo version 0x0011, everything after the header of a "PLAY" demo
+// is written as a stream of blocks, each one holding whole tics:
+//   UINT32 decompressed size (0 marks the end of the stream)
+//   UINT32 LZF-compressed size (0 if the block is stored as-is)
+//   block data
+// Blocks are compressed and written to disk while recording goes on,
+// so demos are no longer limited by the size of the recording buffer.
+//
+
+#define DEMOBLOCKSIZE (64*1024) // a block gets flushed once it grows past this
+#define DEMOBUFFERSIZE (2*DEMOBLOCKSIZE) // leaves room for a whole tic past DEMOBLOCKSIZE
+
+// recording
+static FILE *demofile = NULL;
+static UINT8 *demoheader = NULL; // kept around so the time and checksum can be filled in later
+static size_t demoheadersize;
+static UINT8 *demospare = NULL; // the other block buffer, swapped with demobuffer on each flush
+static boolean demowritefailed;
+
+typedef struct
+{
+	UINT8 *buffer;
+	size_t length;
+} demoblock_t;
+
+static demoblock_t demowriteblock;
+
+#ifdef HAVE_THREADS
+static I_mutex demowrite_mutex;
+static I_cond demowrite_cond;
+static boolean demowriting;
+#endif
+
+// playback
+static UINT8 *demostream_p = NULL, *demostreamend;
+static UINT8 *demoblock = NULL, *demoblockend = NULL; // decompressed tics
+static size_t demoblocksize;
+
+static void G_WriteDemoBlock(demoblock_t *block)
+{
+	UINT8 header[2*sizeof(UINT32)], *p = header;
+	UINT8 *packed;
+	size_t packedlen = 0;
+	boolean ok;
+
+	if (!demofile)
+		return;
+
+	// Only keep the compressed data if it actually saves space.
+	packed = malloc(block->length);
+	if (packed)
+		packedlen = lzf_compress(block->buffer, block->length, packed, block->length - 1);
+
+	WRITEUINT32(p, block->length);
+	WRITEUINT32(p, packedlen);
+	ok = (fwrite(header, sizeof header, 1, demofile) == 1);
+	if (ok)
+	{
+		if (packedlen)
+			ok = (fwrite(packed, packedlen, 1, demofile) == 1);
+		else
+			ok = (fwrite(block->buffer, block->length, 1, demofile) == 1);
+	}
+
+	free(packed);
+
+	if (!ok)
+		demowritefailed = true;
+}
+
+#ifdef HAVE_THREADS
+static void G_DemoWriteThread(demoblock_t *block)
+{
+	G_WriteDemoBlock(block);
+
+	I_lock_mutex(&demowrite_mutex);
+	{
+		demowriting = false;
+		I_wake_all_cond(&demowrite_cond);
+	}
+	I_unlock_mutex(demowrite_mutex);
+}
+#endif
+
+// Waits for the block being written in the background, if any.
+static void G_WaitDemoWrite(void)
+{
+#ifdef HAVE_THREADS
+	I_lock_mutex(&demowrite_mutex);
+	{
+		while (demowriting)
+			I_hold_cond(&demowrite_cond, demowrite_mutex);
+	}
+	I_unlock_mutex(demowrite_mutex);
+#endif
+}
+
+// Hands the tics recorded so far over to be written out,
+// and carries on recording into the spare buffer.
+static void G_FlushDemoBlock(void)
+{
+	UINT8 *buffer;
+
+	if (demo_p == demobuffer)
+		return;
+
+	G_WaitDemoWrite(); // the spare buffer is still being written otherwise
+
+	demowriteblock.buffer = demobuffer;
+	demowriteblock.length = demo_p - demobuffer;
+
+	buffer = demobuffer;
+	demobuffer = demospare;
+	demospare = buffer;
+	demo_p = demobuffer;
+	demoend = demobuffer + DEMOBUFFERSIZE;
+
+#ifdef HAVE_THREADS
+	if (!I_thread_is_stopped())
+	{
+		demowriting = true;
+		I_spawn_thread("demo-write", (I_thread_fn)G_DemoWriteThread, &demowriteblock);
+		return;
+	}
+#endif
+	G_WriteDemoBlock(&demowriteblock);
+}
+
+// Writes the last block and the stream terminator, then fills in the header.
+static boolean G_CloseDemoStream(void)
+{
+	UINT8 terminator[2*sizeof(UINT32)] = {0};
+	UINT8 *p = demoheader+16; // checksum position
+	boolean ok;
+
+	G_FlushDemoBlock();
+	G_WaitDemoWrite();
+
+	if (!demofile)
+		return false;
+
+	ok = (!demowritefailed && fwrite(terminator, sizeof terminator, 1, demofile) == 1);
+
+	// Rewrite the header now that the time and score are known.
+	if (ok)
+		ok = (fseek(demofile, 0, SEEK_SET) == 0 && fwrite(demoheader, demoheadersize, 1, demofile) == 1);
+
+#ifdef NOMD5
+	{
+		UINT8 i;
+		for (i = 0; i < 16; i++)
+			p[i] = P_RandomByte(); // This MD5 was chosen by fair dice roll and most likely < 50% correct.
+	}
+#else
+	// Checksum everything after the checksum, same as before demos were streamed.
+	// The blocks are read back from the file rather than kept in memory.
+	if (ok)
+		ok = (fseek(demofile, 32, SEEK_SET) == 0 && md5_stream(demofile, p) == 0);
+#endif
+
+	if (ok)
+		ok = (fseek(demofile, 16, SEEK_SET) == 0 && fwrite(p, 16, 1, demofile) == 1);
+
+	if (fclose(demofile) != 0)
+		ok = false;
+	demofile = NULL;
+
+	return ok;
+}
+
+// Returns the decompressed size of the block at p, or 0 at the end of the stream.
+// If skip is given, it is set to the size of the block in the stream.
+static UINT32 G_DemoBlockSize(UINT8 *p, UINT8 *end, size_t *skip)
+{
+	UINT32 rawsize, packedsize;
+
+	if (end - p < (ptrdiff_t)(2*sizeof(UINT32)))
+		return 0;
+
+	rawsize = READUINT32(p);
+	packedsize = READUINT32(p);
+
+	if (!packedsize)
+		packedsize = rawsize;
+	if ((size_t)(end - p) < packedsize)
+		return 0; // truncated
+
+	if (skip)
+		*skip = 2*sizeof(UINT32) + packedsize;
+	return rawsize;
+}
+
+// Decompresses the block at *stream into out, which must be G_DemoBlockSize bytes large.
+static boolean G_UnpackDemoBlock(UINT8 **stream, UINT8 *out)
+{
+	UINT8 *p = *stream;
+	UINT32 rawsize, packedsize;
+
+	rawsize = READUINT32(p);
+	packedsize = READUINT32(p);
+
+	if (packedsize)
+	{
+		if (lzf_decompress(p, packedsize, out, rawsize) != rawsize)
+			return false;
+		p += packedsize;
+	}
+	else
+	{
+		M_Memcpy(out, p, rawsize);
+		p += rawsize;
+	}
+
+	*stream = p;
+	return true;
+}
+
+// Decompresses the next block of the demo being played back.
+static boolean G_ReadDemoBlock(void)
+{
+	UINT32 size;
+
+	if (!demostream_p)
+		return false;
+
+	size = G_DemoBlockSize(demostream_p, demostreamend, NULL);
+	if (!size)
+	{
+		demostream_p = NULL;
+		return false;
+	}
+
+	if (size > demoblocksize)
+	{
+		demoblock = Z_Realloc(demoblock, size, PU_STATIC, NULL);
+		demoblocksize = size;
+	}
+
+	if (!G_UnpackDemoBlock(&demostream_p, demoblock))
+	{
+		demostream_p = NULL;
+		return false;
+	}
+
+	demo_p = demoblock;
+	demoblockend = demoblock + size;
+	return true;
+}
+
+// Looks at the next byte of the demo, decompressing another block if needed.
+static UINT8 G_PeekDemoByte(void)
+{
+	if (demo_p == demoblockend && !G_ReadDemoBlock())
+		return DEMOMARKER; // stream ended early, treat it as the end of the demo
+	return *demo_p;
+}
+
+// Decompresses a whole demo stream at once, for ghosts.
+static UINT8 *G_InflateDemoStream(UINT8 *p, UINT8 *end, INT32 tag, size_t *length)
+{
+	UINT8 *buffer, *out, *q;
+	UINT32 size;
+	size_t skip, total = 0;
+
+	for (q = p; (size = G_DemoBlockSize(q, end, &skip)) != 0; q += skip)
+		total += size;
+
+	if (!total)
+		return NULL;
+
+	// The extra byte ends the data even if the recording was cut short.
+	out = buffer = Z_Malloc(total + 1, tag, NULL);
+	while ((size = G_DemoBlockSize(p, end, NULL)) != 0)
+	{
+		if (!G_UnpackDemoBlock(&p, out))
+		{
+			Z_Free(buffer);
+			return NULL;
+		}
+		out += size;
+	}
+	*out = DEMOMARKER;
+
+	*length = total + 1;
+	return buffer;
+}
+
 void G_SaveMetal(UINT8 **buffer)
 {
 	I_Assert(buffer != NULL && *buffer != NULL);
@@ -192,7 +532,7 @@ void G_ReadDemoTiccmd(ticcmd_t *cmd, INT32 playernum)
 	G_CopyTiccmd(cmd, &oldcmd, 1);
 	players[playernum].angleturn = cmd->angleturn;
 
-	if (!(demoflags & DF_GHOST) && *demo_p == DEMOMARKER)
+	if (!(demoflags & DF_GHOST) && G_PeekDemoByte() == DEMOMARKER)
 	{
 		// end of demo data stream
 		G_CheckDemoStatus();
@@ -256,10 +596,15 @@ void G_WriteDemoTiccmd(ticcmd_t *cmd, INT32 playernum)
 
 	// attention here for the ticcmd size!
 	// latest demos with mouse aiming byte in ticcmd
-	if (!(demoflags & DF_GHOST) && ziptic_p > demoend - 9)
+	if (!(demoflags & DF_GHOST))
 	{
-		G_CheckDemoStatus(); // no more space
-		return;
+		if (ziptic_p > demoend - 9)
+		{
+			G_CheckDemoStatus(); // no more space
+			return;
+		}
+		if (demo_p - demobuffer >= DEMOBLOCKSIZE)
+			G_FlushDemoBlock();
 	}
 }
 
@@ -528,6 +873,10 @@ void G_WriteGhostTic(mobj_t *ghost)
 		G_CheckDemoStatus(); // no more space
 		return;
 	}
+
+	// The tic is complete, so this is a safe place to end a block.
+	if (demo_p - demobuffer >= DEMOBLOCKSIZE)
+		G_FlushDemoBlock();
 }
 
 // Uses ghost data to do consistency checks on your position.
@@ -667,7 +1016,7 @@ void G_ConsGhostTic(void)
 		testmo->z = oldghost.z;
 	}
 
-	if (*demo_p == DEMOMARKER)
+	if (G_PeekDemoByte() == DEMOMARKER)
 	{
 		// end of demo data stream
 		G_CheckDemoStatus();
@@ -675,75 +1024,320 @@ void G_ConsGhostTic(void)
 	}
 }
 
-void G_GhostTicker(void)
+//
+// GHOST DECODING
+//
+// Ghost replays are decoded into arrays of poses as they are added,
+// on worker threads when possible. G_GhostTicker then only has to
+// step through the poses instead of parsing each replay every tic.
+//
+
+#define GHOSTPADDING 64 // zeroes after the tics, so a cut-off tic can't read past the end
+
+#ifdef HAVE_THREADS
+static I_mutex ghostposes_mutex;
+static I_cond ghostposes_cond;
+#endif
+
+// Makes room for one more element in an array that doubles as it fills up.
+static boolean G_GrowGhostArray(void **array, UINT32 count, UINT32 *capacity, size_t size)
 {
-	demoghost *g,*p;
-	for(g = ghosts, p = NULL; g; g = g->next)
+	void *grown;
+	UINT32 newcapacity;
+
+	if (count < *capacity)
+		return true;
+
+	newcapacity = *capacity ? *capacity * 2 : 64;
+	grown = realloc(*array, newcapacity * size);
+	if (!grown)
+		return false;
+
+	*array = grown;
+	*capacity = newcapacity;
+	return true;
+}
+
+static void G_DecodeGhostPoses(ghostposes_t *gp)
+{
+	UINT8 *p = gp->tics;
+	UINT32 posecapacity = 0, hitcapacity = 0, followcapacity = 0;
+	fixed_t momx = 0, momy = 0, momz = 0;
+	boolean hasfollow = false;
+	ghostpose_t pose;
+
+	memset(&pose, 0, sizeof (pose));
+	pose.x = gp->x;
+	pose.y = gp->y;
+	pose.z = gp->z;
+
+	while (p < gp->end && *p != DEMOMARKER)
 	{
 		// Skip normal demo data.
-		UINT8 ziptic = READUINT8(g->p);
-		UINT8 xziptic = 0;
+		UINT8 ziptic = READUINT8(p);
 		if (ziptic & ZT_FWD)
-			g->p++;
+			p++;
 		if (ziptic & ZT_SIDE)
-			g->p++;
+			p++;
 		if (ziptic & ZT_ANGLE)
-			g->p += 2;
+			p += 2;
 		if (ziptic & ZT_BUTTONS)
-			g->p += 2;
+			p += 2;
 		if (ziptic & ZT_AIMING)
-			g->p += 2;
+			p += 2;
 		if (ziptic & ZT_LATENCY)
-			g->p++;
+			p++;
 
 		// Grab ghost data.
-		ziptic = READUINT8(g->p);
+		ziptic = READUINT8(p);
+		pose.ziptic = ziptic;
+		pose.xziptic = 0;
+		pose.numhits = 0;
 		if (ziptic & GZT_XYZ)
 		{
-			g->oldmo.x = READFIXED(g->p);
-			g->oldmo.y = READFIXED(g->p);
-			g->oldmo.z = READFIXED(g->p);
+			pose.x = READFIXED(p);
+			pose.y = READFIXED(p);
+			pose.z = READFIXED(p);
 		}
 		else
 		{
 			if (ziptic & GZT_MOMXY)
 			{
-				g->oldmo.momx = (g->version < 0x000e) ? READINT16(g->p)<<8 : READFIXED(g->p);
-				g->oldmo.momy = (g->version < 0x000e) ? READINT16(g->p)<<8 : READFIXED(g->p);
+				momx = (gp->version < 0x000e) ? READINT16(p)<<8 : READFIXED(p);
+				momy = (gp->version < 0x000e) ? READINT16(p)<<8 : READFIXED(p);
 			}
 			if (ziptic & GZT_MOMZ)
-				g->oldmo.momz = (g->version < 0x000e) ? READINT16(g->p)<<8 : READFIXED(g->p);
-			g->oldmo.x += g->oldmo.momx;
-			g->oldmo.y += g->oldmo.momy;
-			g->oldmo.z += g->oldmo.momz;
+				momz = (gp->version < 0x000e) ? READINT16(p)<<8 : READFIXED(p);
+			pose.x += momx;
+			pose.y += momy;
+			pose.z += momz;
 		}
 		if (ziptic & GZT_ANGLE)
-			g->mo->angle = READUINT8(g->p)<<24;
+			pose.angle = READUINT8(p);
 		if (ziptic & GZT_FRAME)
-			g->oldmo.frame = READUINT8(g->p);
+			pose.frame = READUINT8(p);
 		if (ziptic & GZT_SPR2)
-			g->oldmo.sprite2 = READUINT8(g->p);
+			pose.sprite2 = READUINT8(p);
+
+		if (ziptic & GZT_EXTRA)
+		{ // But wait, there's more!
+			UINT8 xziptic = pose.xziptic = READUINT8(p);
+			if (xziptic & EZT_COLOR)
+				pose.color = (gp->version==0x000c) ? READUINT8(p) : READUINT16(p);
+			if (xziptic & EZT_SCALE)
+				pose.scale = READFIXED(p);
+			if (xziptic & EZT_HIT)
+			{
+				UINT16 i, count = READUINT16(p), health;
+				ghosthit_t hit;
+
+				if ((size_t)(gp->end - p) < count * (sizeof(UINT32) + sizeof(UINT16) + 3*sizeof(fixed_t) + sizeof(angle_t)))
+					break;
+
+				pose.firsthit = gp->numhits;
+				for (i = 0; i < count; i++)
+				{
+					//p += 4; // reserved
+					hit.type = READUINT32(p);
+					health = READUINT16(p);
+					hit.x = READFIXED(p);
+					hit.y = READFIXED(p);
+					hit.z = READFIXED(p);
+					hit.angle = READANGLE(p);
+					if (hit.type >= NUMMOBJTYPES
+					|| !(mobjinfo[hit.type].flags & MF_SHOOTABLE)
+					|| !(mobjinfo[hit.type].flags & (MF_ENEMY|MF_MONITOR))
+					|| health != 0 || i >= 4) // only spawn for the first 4 hits per frame, to prevent ghosts from splode-spamming too bad.
+						continue;
+					if (!G_GrowGhostArray((void **)&gp->hits, gp->numhits, &hitcapacity, sizeof (ghosthit_t)))
+						continue;
+					gp->hits[gp->numhits++] = hit;
+					pose.numhits++;
+				}
+			}
+			if (xziptic & EZT_SPRITE)
+				pose.sprite = READUINT16(p);
+			if (xziptic & EZT_HEIGHT)
+				pose.height = (gp->version < 0x000e) ? READINT16(p)<<FRACBITS : READFIXED(p);
+		}
+
+		if (ziptic & GZT_FOLLOW)
+		{ // Even more...
+			ghostfollow_t follow;
+
+			memset(&follow, 0, sizeof (follow));
+			follow.followtic = READUINT8(p);
+			if (follow.followtic & FZT_SPAWNED)
+			{
+				follow.height = READINT16(p)<<FRACBITS;
+				if (follow.followtic & FZT_SKIN)
+					follow.skin = READUINT8(p);
+				hasfollow = true;
+			}
+			if (hasfollow)
+			{
+				if (follow.followtic & FZT_SCALE)
+					follow.scale = READFIXED(p);
+				follow.x = (gp->version < 0x000e) ? READINT16(p)<<8 : READFIXED(p);
+				follow.y = (gp->version < 0x000e) ? READINT16(p)<<8 : READFIXED(p);
+				follow.z = (gp->version < 0x000e) ? READINT16(p)<<8 : READFIXED(p);
+				if (follow.followtic & FZT_SKIN)
+					follow.sprite2 = READUINT8(p);
+				follow.sprite = READUINT16(p);
+				follow.frame = READUINT8(p);
+				follow.color = (gp->version==0x000c) ? READUINT8(p) : READUINT16(p);
+			}
+
+			if (!G_GrowGhostArray((void **)&gp->follows, gp->numfollows, &followcapacity, sizeof (ghostfollow_t)))
+				break;
+			pose.followdata = gp->numfollows;
+			gp->follows[gp->numfollows++] = follow;
+		}
+		else
+			hasfollow = false;
+
+		if (p > gp->end)
+			break; // the replay was cut off in the middle of this tic
+
+		if (!G_GrowGhostArray((void **)&gp->poses, gp->numposes, &posecapacity, sizeof (ghostpose_t)))
+			break;
+		gp->poses[gp->numposes++] = pose;
+	}
+
+	free(gp->tics);
+	gp->tics = gp->end = NULL;
+}
+
+#ifdef HAVE_THREADS
+static void G_GhostPosesThread(ghostposes_t *gp)
+{
+	G_DecodeGhostPoses(gp);
+
+	I_lock_mutex(&ghostposes_mutex);
+	{
+		gp->done = true;
+		I_wake_all_cond(&ghostposes_cond);
+	}
+	I_unlock_mutex(ghostposes_mutex);
+}
+#endif
+
+// Starts decoding a copy of a ghost's tics, which end at the DEMOMARKER.
+static ghostposes_t *G_StartGhostPoses(UINT8 *tics, UINT8 *end, UINT16 version, fixed_t x, fixed_t y, fixed_t z)
+{
+	ghostposes_t *gp = calloc(1, sizeof (ghostposes_t));
+	size_t length = end - tics;
+
+	if (!gp)
+		return NULL;
+
+	gp->tics = malloc(length + GHOSTPADDING);
+	if (!gp->tics)
+	{
+		free(gp);
+		return NULL;
+	}
+	M_Memcpy(gp->tics, tics, length);
+	memset(gp->tics + length, 0, GHOSTPADDING);
+	gp->end = gp->tics + length;
+
+	gp->version = version;
+	gp->x = x;
+	gp->y = y;
+	gp->z = z;
+
+#ifdef HAVE_THREADS
+	if (!I_thread_is_stopped())
+	{
+		I_spawn_thread("ghost-decode", (I_thread_fn)G_GhostPosesThread, gp);
+		return gp;
+	}
+#endif
+
+	G_DecodeGhostPoses(gp);
+	gp->done = true;
+	return gp;
+}
+
+static void G_WaitGhostPoses(ghostposes_t *gp)
+{
+#ifdef HAVE_THREADS
+	I_lock_mutex(&ghostposes_mutex);
+	{
+		while (!gp->done)
+			I_hold_cond(&ghostposes_cond, ghostposes_mutex);
+	}
+	I_unlock_mutex(ghostposes_mutex);
+#else
+	(void)gp;
+#endif
+}
+
+static void G_FreeGhostPoses(ghostposes_t *gp)
+{
+	if (!gp)
+		return;
+
+	G_WaitGhostPoses(gp);
+	free(gp->poses);
+	free(gp->hits);
+	free(gp->follows);
+	free(gp);
+}
+
+void G_GhostTicker(void)
+{
+	demoghost *g,*p;
+	for(g = ghosts, p = NULL; g; g = g->next)
+	{
+		ghostpose_t *pose;
+		UINT8 ziptic, xziptic;
+
+		if (!g->tic)
+			G_WaitGhostPoses(g->poses);
+
+		// Out of tics, or the replay couldn't be decoded at all.
+		// Nothing was shown of it, so take the ghost away too.
+		if (g->tic >= g->poses->numposes)
+		{
+			if (g->mo->tracer)
+				P_RemoveMobj(g->mo->tracer);
+			P_RemoveMobj(g->mo);
+			if (p)
+				p->next = g->next;
+			else
+				ghosts = g->next;
+			G_FreeGhostPoses(g->poses);
+			Z_Free(g);
+			continue;
+		}
+
+		pose = &g->poses->poses[g->tic++];
+		ziptic = pose->ziptic;
+		xziptic = pose->xziptic;
+
+		if (ziptic & GZT_ANGLE)
+			g->mo->angle = pose->angle<<24;
 
 		// Update ghost
 		P_UnsetThingPosition(g->mo);
-		g->mo->x = g->oldmo.x;
-		g->mo->y = g->oldmo.y;
-		g->mo->z = g->oldmo.z;
+		g->mo->x = pose->x;
+		g->mo->y = pose->y;
+		g->mo->z = pose->z;
 		P_SetThingPosition(g->mo);
-		g->mo->frame = g->oldmo.frame | tr_trans30<<FF_TRANSSHIFT;
+		g->mo->frame = pose->frame | tr_trans30<<FF_TRANSSHIFT;
 		if (g->fadein)
 		{
 			g->mo->frame += (((--g->fadein)/6)<<FF_TRANSSHIFT); // this calc never exceeds 9 unless g->fadein is bad, and it's only set once, so...
 			g->mo->flags2 &= ~MF2_DONTDRAW;
 		}
-		g->mo->sprite2 = g->oldmo.sprite2;
+		g->mo->sprite2 = pose->sprite2;
 
 		if (ziptic & GZT_EXTRA)
 		{ // But wait, there's more!
-			xziptic = READUINT8(g->p);
 			if (xziptic & EZT_COLOR)
 			{
-				g->color = (g->version==0x000c) ? READUINT8(g->p) : READUINT16(g->p);
+				g->color = pose->color;
 				switch(g->color)
 				{
 				default:
@@ -769,7 +1363,7 @@ void G_GhostTicker(void)
 				g->mo->eflags ^= MFE_VERTICALFLIP;
 			if (xziptic & EZT_SCALE)
 			{
-				g->mo->destscale = READFIXED(g->p);
+				g->mo->destscale = pose->scale;
 				if (g->mo->destscale != g->mo->scale)
 					P_SetScale(g->mo, g->mo->destscale);
 			}
@@ -828,38 +1422,22 @@ void G_GhostTicker(void)
 			}
 			if (xziptic & EZT_HIT)
 			{ // Spawn hit poofs for killing things!
-				UINT16 i, count = READUINT16(g->p), health;
-				UINT32 type;
-				fixed_t x,y,z;
-				angle_t angle;
+				ghosthit_t *hit = &g->poses->hits[pose->firsthit];
 				mobj_t *poof;
-				for (i = 0; i < count; i++)
+				UINT8 i;
+				for (i = 0; i < pose->numhits; i++, hit++)
 				{
-					//g->p += 4; // reserved
-					type = READUINT32(g->p);
-					health = READUINT16(g->p);
-					x = READFIXED(g->p);
-					y = READFIXED(g->p);
-					z = READFIXED(g->p);
-					angle = READANGLE(g->p);
-					if (!(mobjinfo[type].flags & MF_SHOOTABLE)
-					|| !(mobjinfo[type].flags & (MF_ENEMY|MF_MONITOR))
-					|| health != 0 || i >= 4) // only spawn for the first 4 hits per frame, to prevent ghosts from splode-spamming too bad.
-						continue;
-					poof = P_SpawnMobj(x, y, z, MT_GHOST);
-					poof->angle = angle;
+					poof = P_SpawnMobj(hit->x, hit->y, hit->z, MT_GHOST);
+					poof->angle = hit->angle;
 					poof->flags = MF_NOBLOCKMAP|MF_NOCLIP|MF_NOCLIPHEIGHT|MF_NOGRAVITY; // make an ATTEMPT to curb crazy SOCs fucking stuff up...
 					poof->health = 0;
 					P_SetMobjStateNF(poof, S_XPLD1);
 				}
 			}
 			if (xziptic & EZT_SPRITE)
-				g->mo->sprite = READUINT16(g->p);
+				g->mo->sprite = pose->sprite;
 			if (xziptic & EZT_HEIGHT)
-			{
-				fixed_t temp = (g->version < 0x000e) ? READINT16(g->p)<<FRACBITS : READFIXED(g->p);
-				g->mo->height = FixedMul(temp, g->mo->scale);
-			}
+				g->mo->height = FixedMul(pose->height, g->mo->scale);
 		}
 
 		// Tick ghost colors (Super and Mario Invincibility flashing)
@@ -885,54 +1463,46 @@ void G_GhostTicker(void)
 #define follow g->mo->tracer
 		if (ziptic & GZT_FOLLOW)
 		{ // Even more...
-			UINT8 followtic = READUINT8(g->p);
-			fixed_t temp;
-			if (followtic & FZT_SPAWNED)
+			ghostfollow_t *ft = &g->poses->follows[pose->followdata];
+			if (ft->followtic & FZT_SPAWNED)
 			{
 				if (follow)
 					P_RemoveMobj(follow);
 				P_SetTarget(&follow, P_SpawnMobjFromMobj(g->mo, 0, 0, 0, MT_GHOST));
 				P_SetTarget(&follow->tracer, g->mo);
 				follow->tics = -1;
-				temp = READINT16(g->p)<<FRACBITS;
-				follow->height = FixedMul(follow->scale, temp);
+				follow->height = FixedMul(follow->scale, ft->height);
 
-				if (followtic & FZT_LINKDRAW)
+				if (ft->followtic & FZT_LINKDRAW)
 					follow->flags2 |= MF2_LINKDRAW;
 
-				if (followtic & FZT_COLORIZED)
+				if (ft->followtic & FZT_COLORIZED)
 					follow->colorized = true;
 
-				if (followtic & FZT_SKIN)
-					follow->skin = &skins[READUINT8(g->p)];
+				if (ft->followtic & FZT_SKIN)
+					follow->skin = &skins[ft->skin];
 			}
 			if (follow)
 			{
-				if (followtic & FZT_SCALE)
-					follow->destscale = READFIXED(g->p);
+				if (ft->followtic & FZT_SCALE)
+					follow->destscale = ft->scale;
 				else
 					follow->destscale = g->mo->destscale;
 				if (follow->destscale != follow->scale)
 					P_SetScale(follow, follow->destscale);
 
 				P_UnsetThingPosition(follow);
-				temp = (g->version < 0x000e) ? READINT16(g->p)<<8 : READFIXED(g->p);
-				follow->x = g->mo->x + temp;
-				temp = (g->version < 0x000e) ? READINT16(g->p)<<8 : READFIXED(g->p);
-				follow->y = g->mo->y + temp;
-				temp = (g->version < 0x000e) ? READINT16(g->p)<<8 : READFIXED(g->p);
-				follow->z = g->mo->z + temp;
+				follow->x = g->mo->x + ft->x;
+				follow->y = g->mo->y + ft->y;
+				follow->z = g->mo->z + ft->z;
 				P_SetThingPosition(follow);
-				if (followtic & FZT_SKIN)
-					follow->sprite2 = READUINT8(g->p);
-				else
-					follow->sprite2 = 0;
-				follow->sprite = READUINT16(g->p);
-				follow->frame = (READUINT8(g->p)) | (g->mo->frame & FF_TRANSMASK);
+				follow->sprite2 = ft->sprite2; // 0 without FZT_SKIN
+				follow->sprite = ft->sprite;
+				follow->frame = ft->frame | (g->mo->frame & FF_TRANSMASK);
 				follow->angle = g->mo->angle;
-				follow->color = (g->version==0x000c) ? READUINT8(g->p) : READUINT16(g->p);
+				follow->color = ft->color;
 
-				if (!(followtic & FZT_SPAWNED))
+				if (!(ft->followtic & FZT_SPAWNED))
 				{
 					if (xziptic & EZT_FLIP)
 					{
@@ -948,7 +1518,7 @@ void G_GhostTicker(void)
 			P_SetTarget(&follow, NULL);
 		}
 		// Demo ends after ghost data.
-		if (*g->p == DEMOMARKER)
+		if (g->tic >= g->poses->numposes)
 		{
 			g->mo->momx = g->mo->momy = g->mo->momz = 0;
 #if 1 // freeze frame (maybe more useful for time attackers)
@@ -964,6 +1534,7 @@ void G_GhostTicker(void)
 				p->next = g->next;
 			else
 				ghosts = g->next;
+			G_FreeGhostPoses(g->poses);
 			Z_Free(g);
 			continue;
 		}
@@ -1382,18 +1953,15 @@ void G_WriteMetalTic(mobj_t *metal)
 //
 void G_RecordDemo(const char *name)
 {
-	INT32 maxsize;
-
 	strcpy(demoname, name);
 	strcat(demoname, ".lmp");
-	maxsize = 1024*1024;
-	if (M_CheckParm("-maxdemo") && M_IsNextParm())
-		maxsize = atoi(M_GetNextParm()) * 1024;
 //	if (demobuffer)
 //		free(demobuffer);
 	demo_p = NULL;
-	demobuffer = malloc(maxsize);
-	demoend = demobuffer + maxsize;
+	demobuffer = malloc(DEMOBUFFERSIZE);
+	demospare = malloc(DEMOBUFFERSIZE);
+	demoend = demobuffer + DEMOBUFFERSIZE;
+	demowritefailed = false;
 
 	demorecording = true;
 }
@@ -1424,7 +1992,14 @@ void G_BeginRecording(void)
 		return;
 	memset(name,0,sizeof(name));
 
-	demo_p = demobuffer;
+	// The header is kept in its own buffer, with room for every field,
+	// the file list and the netvars.
+	demoheadersize = 256 + MAXCOLORNAME + CV_SavedVarsSize(true);
+	for (i = mainwads; ++i < numwadfiles; )
+		if (wadfiles[i]->important)
+			demoheadersize += MAX_WADPATH + 16;
+
+	demo_p = demoheader = malloc(demoheadersize);
 	demoflags = DF_GHOST|(modeattacking<<DF_ATTACKSHIFT);
 
 	// Setup header.
@@ -1565,6 +2140,13 @@ void G_BeginRecording(void)
 	// Save netvar data
 	CV_SaveDemoVars(&demo_p);
 
+	// Write out the header now, the tics follow as a stream of blocks.
+	demoheadersize = demo_p - demoheader;
+	demofile = fopen(va(pandf, srb2home, demoname), "w+b");
+	if (!demofile || fwrite(demoheader, demoheadersize, 1, demofile) != 1)
+		demowritefailed = true;
+	demo_p = demobuffer;
+
 	memset(&oldcmd,0,sizeof(oldcmd));
 	memset(&oldghost,0,sizeof(oldghost));
 	memset(&ghostext,0,sizeof(ghostext));
@@ -1890,6 +2472,7 @@ UINT8 G_CmpDemoTime(char *oldname, char *newname)
 	switch(oldversion) // demoversion
 	{
 	case DEMOVERSION: // latest always supported
+	case 0x0010:
 	case 0x000f: // The previous demoversions also supported 
 	case 0x000e:
 	case 0x000d: // all that changed between then and now was longer color name
@@ -1974,6 +2557,7 @@ void G_DoPlayDemo(char *defdemoname)
 	UINT32 randseed, followitem;
 	fixed_t camerascale,shieldscale,actionspd,mindash,maxdash,normalspeed,runspeed,jumpfactor,height,spinheight;
 	char msg[1024];
+	size_t demolength;
 #ifdef OLD22DEMOCOMPAT
 	boolean use_old_demo_vars = false;
 #endif
@@ -1993,7 +2577,7 @@ void G_DoPlayDemo(char *defdemoname)
 	if (FIL_CheckExtension(defdemoname))
 	{
 		//FIL_DefaultExtension(defdemoname, ".lmp");
-		if (!FIL_ReadFile(defdemoname, &demobuffer))
+		if (!(demolength = FIL_ReadFile(defdemoname, &demobuffer)))
 		{
 			snprintf(msg, 1024, M_GetText("Failed to read file '%s'.\n"), defdemoname);
 			CONS_Alert(CONS_ERROR, "%s", msg);
@@ -2013,7 +2597,10 @@ void G_DoPlayDemo(char *defdemoname)
 		return;
 	}
 	else // it's an internal demo
+	{
 		demobuffer = demo_p = W_CacheLumpNum(l, PU_STATIC);
+		demolength = W_LumpLength(l);
+	}
 
 	// read demo header
 	gameaction = ga_nothing;
@@ -2037,6 +2624,7 @@ void G_DoPlayDemo(char *defdemoname)
 	demo_forwardmove_rng = (demoversion < 0x0010);
 	switch(demoversion)
 	{
+	case 0x0010:
 	case 0x000f:
 	case 0x000d:
 	case 0x000e:
@@ -2221,8 +2809,18 @@ void G_DoPlayDemo(char *defdemoname)
 #endif
 		CV_LoadDemoVars(&demo_p);
 
+	// The tics are read one block at a time from here on.
+	demostream_p = NULL;
+	demoblockend = NULL;
+	if (demoversion >= 0x0011)
+	{
+		demostream_p = demo_p;
+		demostreamend = demobuffer + demolength;
+		demo_p = NULL; // nothing decompressed yet, G_PeekDemoByte reads the first block
+	}
+
 	// Sigh ... it's an empty demo.
-	if (*demo_p == DEMOMARKER)
+	if (G_PeekDemoByte() == DEMOMARKER)
 	{
 		snprintf(msg, 1024, M_GetText("%s contains no data to be played.\n"), pdemoname);
 		CONS_Alert(CONS_ERROR, "%s", msg);
@@ -2354,6 +2952,7 @@ UINT8 G_CheckDemoForError(char *defdemoname)
 	case 0x000d:
 	case 0x000e:
 	case 0x000f:
+	case 0x0010:
 	case DEMOVERSION: // latest always supported
 		break;
 #ifdef OLD22DEMOCOMPAT
@@ -2389,6 +2988,7 @@ void G_AddGhost(char *defdemoname)
 	UINT8 *buffer,*p;
 	mapthing_t *mthing;
 	UINT16 count, ghostversion;
+	size_t length;
 
 	name[16] = '\0';
 	skin[16] = '\0';
@@ -2406,7 +3006,7 @@ void G_AddGhost(char *defdemoname)
 	if (FIL_CheckExtension(defdemoname))
 	{
 		//FIL_DefaultExtension(defdemoname, ".lmp");
-		if (!FIL_ReadFileTag(defdemoname, &buffer, PU_LEVEL))
+		if (!(length = FIL_ReadFileTag(defdemoname, &buffer, PU_LEVEL)))
 		{
 			CONS_Alert(CONS_ERROR, M_GetText("Failed to read file '%s'.\n"), defdemoname);
 			Z_Free(pdemoname);
@@ -2422,7 +3022,10 @@ void G_AddGhost(char *defdemoname)
 		return;
 	}
 	else // it's an internal demo
+	{
 		buffer = p = W_CacheLumpNum(l, PU_LEVEL);
+		length = W_LumpLength(l);
+	}
 
 	// read demo header
 	if (memcmp(p, DEMOHEADER, 12))
@@ -2437,6 +3040,7 @@ void G_AddGhost(char *defdemoname)
 	ghostversion = READUINT16(p);
 	switch(ghostversion)
 	{
+	case 0x0010:
 	case 0x000f:
 	case 0x000d:
 	case 0x000e:
@@ -2547,6 +3151,23 @@ void G_AddGhost(char *defdemoname)
 		}
 	}
 
+	// Ghosts are few and short, so their tics are decompressed all at once.
+	if (ghostversion >= 0x0011)
+	{
+		UINT8 *tics = G_InflateDemoStream(p, buffer + length, PU_LEVEL, &length);
+		if (!tics)
+		{
+			CONS_Alert(CONS_NOTICE, M_GetText("Failed to add ghost %s: Replay is empty.\n"), pdemoname);
+			Z_Free(pdemoname);
+			Z_Free(buffer);
+			return;
+		}
+		Z_Free(buffer);
+		buffer = p = tics;
+	}
+	else
+		length -= p - buffer;
+
 	if (*p == DEMOMARKER)
 	{
 		CONS_Alert(CONS_NOTICE, M_GetText("Failed to add ghost %s: Replay is empty.\n"), pdemoname);
@@ -2557,9 +3178,7 @@ void G_AddGhost(char *defdemoname)
 
 	gh = Z_Calloc(sizeof(demoghost), PU_LEVEL, NULL);
 	gh->next = ghosts;
-	gh->buffer = buffer;
 	M_Memcpy(gh->checksum, md5, 16);
-	gh->p = p;
 
 	ghosts = gh;
 
@@ -2592,6 +3211,19 @@ void G_AddGhost(char *defdemoname)
 	gh->oldmo.y = gh->mo->y;
 	gh->oldmo.z = gh->mo->z;
 
+	// Only the starting position was missing to decode the tics.
+	gh->poses = G_StartGhostPoses(p, p + length, ghostversion, gh->oldmo.x, gh->oldmo.y, gh->oldmo.z);
+	Z_Free(buffer);
+	if (!gh->poses)
+	{
+		CONS_Alert(CONS_ERROR, M_GetText("Failed to add ghost %s: Out of memory.\n"), pdemoname);
+		ghosts = gh->next;
+		P_RemoveMobj(gh->mo);
+		Z_Free(gh);
+		Z_Free(pdemoname);
+		return;
+	}
+
 	// Set skin
 	gh->mo->skin = &skins[0];
 	for (i = 0; i < numskins; i++)
@@ -2630,6 +3262,7 @@ void G_FreeGhosts(void)
 	while (ghosts)
 	{
 		demoghost *next = ghosts->next;
+		G_FreeGhostPoses(ghosts->poses);
 		Z_Free(ghosts);
 		ghosts = next;
 	}
@@ -2698,6 +3331,7 @@ void G_DoPlayMetal(void)
 	switch(metalversion)
 	{
 	case DEMOVERSION: // latest always supported
+	case 0x0010:
 	case 0x000f:
 	case 0x000e: // There are checks wheter the momentum is from older demo versions or not
 	case 0x000d: // all that changed between then and now was longer color name
@@ -2762,10 +3396,14 @@ static void G_StopDemoRecording(void)
 	if (demo_p)
 	{
 		WRITEUINT8(demo_p, DEMOMARKER); // add the demo end marker
-		WriteDemoChecksum();
-		saved = FIL_WriteFile(va(pandf, srb2home, demoname), demobuffer, demo_p - demobuffer); // finally output the file.
+		saved = G_CloseDemoStream(); // finally finish the file.
 	}
 	free(demobuffer);
+	free(demospare);
+	free(demoheader);
+	demobuffer = demospare = demoheader = NULL;
+	demotime_p = NULL;
+	demo_p = NULL;
 	demorecording = false;
 
 	if (modeattacking != ATTACKING_RECORD)
@@ -2869,6 +3507,10 @@ void G_StopDemo(void)
 {
 	Z_Free(demobuffer);
 	demobuffer = NULL;
+	Z_Free(demoblock);
+	demoblock = demoblockend = NULL;
+	demoblocksize = 0;
+	demostream_p = NULL;
 	demoplayback = false;
 	titledemo = false;
 	timingdemo = false;
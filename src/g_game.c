@@ -67,7 +67,7 @@ JoyType_t Joystick;
 JoyType_t Joystick2;
 
 // 1024 bytes is plenty for a savegame
-#define SAVEGAMESIZE (1024)
+#define SAVEGAMESIZE (1024) // initial size, the buffer grows as needed
 
 char gamedatafilename[64] = "gamedata.dat";
 char timeattackfolder[64] = "main";
@@ -5015,8 +5015,7 @@ void G_SaveGame(UINT32 slot, INT16 mapnum)
 		char name[VERSIONSIZE];
 		size_t length;
 
-		save_p = savebuffer = (UINT8 *)malloc(SAVEGAMESIZE);
-		if (!save_p)
+		if (!P_SaveBufferAlloc(SAVEGAMESIZE))
 		{
 			CONS_Alert(CONS_ERROR, M_GetText("No more free memory for saving game data\n"));
 			return;
@@ -5024,7 +5023,7 @@ void G_SaveGame(UINT32 slot, INT16 mapnum)
 
 		memset(name, 0, sizeof (name));
 		sprintf(name, (marathonmode ? "back-up %d" : "version %d"), VERSION);
-		WRITEMEM(save_p, name, VERSIONSIZE);
+		SAVEWRITEMEM(name, VERSIONSIZE);
 
 		P_SaveGame(mapnum);
 		if (marathonmode)
@@ -5032,14 +5031,14 @@ void G_SaveGame(UINT32 slot, INT16 mapnum)
 			UINT32 writetime = marathontime;
 			if (!(marathonmode & MA_INGAME))
 				writetime += TICRATE*5; // live event backup penalty because we don't know how long it takes to get to the next map
-			WRITEUINT32(save_p, writetime);
-			WRITEUINT8(save_p, (marathonmode & ~MA_INIT));
+			SAVEWRITEUINT32(writetime);
+			SAVEWRITEUINT8((marathonmode & ~MA_INIT));
 		}
 
-		length = save_p - savebuffer;
+		savebuffer = P_SaveBufferFinish(&length);
 		saved = FIL_WriteFile(backup, savebuffer, length);
 		free(savebuffer);
-		save_p = savebuffer = NULL;
+		savebuffer = NULL;
 	}
 
 	gameaction = ga_nothing;
@@ -38,6 +38,23 @@ FOutVector* unsortedVertexArray = NULL;// contains unsorted vertices and texture
 int unsortedVertexArraySize = 0;
 int unsortedVertexArrayAllocSize = 65536;
 
+// The texture last bound outside of batching mode, used by the 2D batch.
+static GLMipmap_t *bound_texture = NULL;
+
+// Quads queued by HWR_Draw2DPolygon, all sharing the same state.
+static FOutVector *batch2DVertexArray = NULL;
+static UINT32 *batch2DIndexArray = NULL;
+static int batch2DNumQuads = 0;
+static int batch2DAllocQuads = 0;
+static FSurfaceInfo batch2DSurf;
+static boolean batch2DHasSurf;
+static FBITFIELD batch2DPolyFlags;
+static GLMipmap_t *batch2DTexture;
+
+// These flags change texture parameters or need the polygon as a whole,
+// so polygons using them are never merged.
+#define PF_NO2DBATCH (PF_Corona|PF_RemoveYWrap|PF_ForceWrapX|PF_ForceWrapY|PF_WireFrame)
+
 // Enables batching mode. HWR_ProcessPolygon will collect polygons instead of passing them directly to the rendering backend.
 // Call HWR_RenderBatches to render all the collected geometry.
 void HWR_StartBatching(void)
@@ -45,6 +62,8 @@ void HWR_StartBatching(void)
     if (currently_batching)
         I_Error("Repeat call to HWR_StartBatching without HWR_RenderBatches");
 
+    HWR_Flush2DBatch();
+
     // init arrays if that has not been done yet
 	if (!finalVertexArray)
 	{
@@ -70,6 +89,7 @@ void HWR_SetCurrentTexture(GLMipmap_t *texture)
     else
     {
         GPU->SetTexture(texture);
+        bound_texture = texture;
     }
 }
 
@@ -460,4 +480,101 @@ void HWR_RenderBatches(void)
 }
 
 
+// Checks if a polygon can be appended to the current 2D batch.
+// Only the surface fields that PreparePolygon looks at for these flags are compared.
+static boolean HWR_Matches2DBatch(FSurfaceInfo *pSurf, FBITFIELD PolyFlags)
+{
+	if (PolyFlags != batch2DPolyFlags)
+		return false;
+	if (!(PolyFlags & PF_NoTexture) && bound_texture != batch2DTexture)
+		return false;
+	if ((pSurf != NULL) != batch2DHasSurf)
+		return false;
+	if (!pSurf)
+		return true;
+
+	if ((PolyFlags & (PF_Modulated|PF_ColorMapped))
+		&& pSurf->PolyColor.rgba != batch2DSurf.PolyColor.rgba)
+		return false;
+
+	if ((PolyFlags & PF_ColorMapped)
+		&& (pSurf->TintColor.rgba != batch2DSurf.TintColor.rgba
+		|| pSurf->FadeColor.rgba != batch2DSurf.FadeColor.rgba
+		|| memcmp(&pSurf->LightInfo, &batch2DSurf.LightInfo, sizeof(FLightInfo))))
+		return false;
+
+	return true;
+}
+
+// Queues a screen-space quad (4 vertices, in the order used by hw_draw.c)
+// using the texture that was last set with HWR_SetCurrentTexture.
+// The queued quads are drawn when the state changes or HWR_Flush2DBatch is called.
+void HWR_Draw2DPolygon(FSurfaceInfo *pSurf, FOutVector *pOutVerts, FBITFIELD PolyFlags)
+{
+	FOutVector *verts;
+	UINT32 *indices;
+	UINT32 base;
+
+	if (PolyFlags & PF_NO2DBATCH)
+	{
+		HWR_Flush2DBatch();
+		GPU->SetTexture(bound_texture);
+		GPU->DrawPolygon(pSurf, pOutVerts, 4, PolyFlags);
+		return;
+	}
+
+	if (batch2DNumQuads && !HWR_Matches2DBatch(pSurf, PolyFlags))
+		HWR_Flush2DBatch();
+
+	if (!batch2DNumQuads)
+	{
+		batch2DPolyFlags = PolyFlags;
+		batch2DTexture = (PolyFlags & PF_NoTexture) ? NULL : bound_texture;
+		batch2DHasSurf = (pSurf != NULL);
+		if (pSurf)
+			batch2DSurf = *pSurf;
+	}
+
+	if (batch2DNumQuads == batch2DAllocQuads)
+	{
+		// ran out of space, make the arrays double the size
+		batch2DAllocQuads = batch2DAllocQuads ? batch2DAllocQuads * 2 : 256;
+		batch2DVertexArray = realloc(batch2DVertexArray, batch2DAllocQuads * 4 * sizeof(FOutVector));
+		batch2DIndexArray = realloc(batch2DIndexArray, batch2DAllocQuads * 6 * sizeof(UINT32));
+		if (!batch2DVertexArray || !batch2DIndexArray)
+			I_Error("HWR_Draw2DPolygon: out of memory");
+	}
+
+	verts = &batch2DVertexArray[batch2DNumQuads * 4];
+	indices = &batch2DIndexArray[batch2DNumQuads * 6];
+	base = (UINT32)(batch2DNumQuads * 4);
+
+	memcpy(verts, pOutVerts, 4 * sizeof(FOutVector));
+
+	// same triangles as the fan that DrawPolygon would have drawn
+	indices[0] = base;
+	indices[1] = base + 1;
+	indices[2] = base + 2;
+	indices[3] = base;
+	indices[4] = base + 2;
+	indices[5] = base + 3;
+
+	batch2DNumQuads++;
+}
+
+// Draws all the quads queued by HWR_Draw2DPolygon.
+void HWR_Flush2DBatch(void)
+{
+	if (!batch2DNumQuads)
+		return;
+
+	if (!(batch2DPolyFlags & PF_NoTexture))
+		GPU->SetTexture(batch2DTexture);
+
+	GPU->DrawIndexedTriangles(batch2DHasSurf ? &batch2DSurf : NULL,
+		batch2DVertexArray, batch2DNumQuads * 6, batch2DPolyFlags, batch2DIndexArray);
+
+	batch2DNumQuads = 0;
+}
+
 #endif // HWRENDER
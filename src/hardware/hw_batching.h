@@ -33,4 +33,11 @@ void HWR_SetCurrentTexture(GLMipmap_t *texture);
 void HWR_ProcessPolygon(FSurfaceInfo *pSurf, FOutVector *pOutVerts, FUINT iNumPts, FBITFIELD PolyFlags, int shader, boolean horizonSpecial);
 void HWR_RenderBatches(void);
 
+// Screen-space batching for the 2D drawers in hw_draw.c.
+// Consecutive quads with the same texture, flags and surface are merged into
+// a single draw call. Anything else that touches the GPU state must call
+// HWR_Flush2DBatch first, so that the queued quads are drawn in order.
+void HWR_Draw2DPolygon(FSurfaceInfo *pSurf, FOutVector *pOutVerts, FBITFIELD PolyFlags);
+void HWR_Flush2DBatch(void);
+
 #endif
@@ -626,7 +626,10 @@ void HWR_FreeTextureData(patch_t *patch)
 	grPatch = patch->hardware;
 
 	if (vid.glstate == VID_GL_LIBRARY_LOADED)
+	{
+		HWR_Flush2DBatch();
 		GPU->DeleteTexture(grPatch->mipmap);
+	}
 	if (grPatch->mipmap->data)
 		Z_Free(grPatch->mipmap->data);
 }
@@ -694,6 +697,7 @@ void HWR_FreeTextureColormaps(patch_t *patch)
 			Z_Free(next->colormap);
 		next->data = NULL;
 		next->colormap = NULL;
+		HWR_Flush2DBatch();
 		GPU->DeleteTexture(next);
 
 		// Free the old colormap mipmap from memory.
@@ -729,6 +733,7 @@ static void FreeTextureCache(boolean freeall)
 // free all textures after each level
 void HWR_ClearAllTextures(void)
 {
+	HWR_Flush2DBatch();
 	GPU->ClearMipMapCache(); // free references to the textures
 	//FreeTextureCache(true);
 }
@@ -748,6 +753,7 @@ void HWR_InitMapTextures(void)
 
 static void FreeMapTexture(GLMapTexture_t *tex)
 {
+	HWR_Flush2DBatch();
 	GPU->DeleteTexture(&tex->mipmap);
 	if (tex->mipmap.data)
 		Z_Free(tex->mipmap.data);
@@ -793,6 +799,7 @@ void HWR_LoadMapTextures(size_t pnumtextures)
 
 void HWR_SetPalette(RGBA_t *palette)
 {
+	HWR_Flush2DBatch();
 	GPU->SetPalette(palette);
 
 	// hardware driver will flush there own cache if cache is non paletized
@@ -1015,6 +1022,8 @@ static void HWR_UpdatePatchMipmap(patch_t *patch, GLMipmap_t *grMipmap)
 
 	// If hardware does not have the texture, then call pfnSetTexture to upload it
 	// If it does have the texture, then call pfnUpdateTexture to update it
+	// Anything still queued with this mipmap must be drawn before it changes
+	HWR_Flush2DBatch();
 	if (!grMipmap->downloaded)
 		GPU->SetTexture(grMipmap);
 	else
@@ -1228,7 +1237,7 @@ patch_t *HWR_GetPic(lumpnum_t lumpnum)
 		grPatch->mipmap->flags = 0;
 		grPatch->max_s = grPatch->max_t = 1.0f;
 	}
-	GPU->SetTexture(grPatch->mipmap);
+	HWR_SetCurrentTexture(grPatch->mipmap);
 	//CONS_Debug(DBG_RENDER, "picloaded at %x as texture %d\n",grPatch->mipmap->data, grPatch->mipmap->downloaded);
 
 	return patch;
@@ -1345,7 +1354,7 @@ void HWR_GetFadeMask(lumpnum_t fademasklumpnum)
 	if (!grmip->downloaded && !grmip->data)
 		HWR_CacheFadeMask(grmip, fademasklumpnum);
 
-	GPU->SetTexture(grmip);
+	HWR_SetCurrentTexture(grmip);
 
 	// The system-memory data can be purged now.
 	Z_ChangeTag(grmip->data, PU_HWRCACHE_UNLOCKED);
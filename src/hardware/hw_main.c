@@ -6096,6 +6096,7 @@ void HWR_SetViewSize(void)
 	gl_pspritexscale = gl_viewwidth / BASEVIDWIDTH;
 	gl_pspriteyscale = ((vid.height*gl_pspritexscale*BASEVIDWIDTH)/BASEVIDHEIGHT)/vid.width;
 
+	HWR_Flush2DBatch();
 	GPU->FlushScreenTextures();
 }
 
@@ -6165,6 +6166,8 @@ void HWR_RenderSkyboxView(INT32 viewnumber, player_t *player)
 	angle_t viewrollangle = R_GetLocalViewRollAngle(player);
 	postimg_t *type;
 
+	HWR_Flush2DBatch();
+
 	if (splitscreen && player == &players[secondarydisplayplayer])
 		type = &postimgtype2;
 	else
@@ -6377,6 +6380,8 @@ void HWR_RenderPlayerView(INT32 viewnumber, player_t *player)
 
 	FRGBAFloat ClearColor;
 
+	HWR_Flush2DBatch();
+
 	if (splitscreen && player == &players[secondarydisplayplayer])
 		type = &postimgtype2;
 	else
@@ -6940,6 +6945,7 @@ void HWR_DoPostProcessor(player_t *player)
 {
 	postimg_t *type;
 
+	HWR_Flush2DBatch();
 	GPU->UnSetShader();
 
 	if (splitscreen && player == &players[secondarydisplayplayer])
@@ -7032,17 +7038,20 @@ void HWR_DoPostProcessor(player_t *player)
 void HWR_StartScreenWipe(void)
 {
 	//CONS_Debug(DBG_RENDER, "In HWR_StartScreenWipe()\n");
+	HWR_Flush2DBatch();
 	GPU->StartScreenWipe();
 }
 
 void HWR_EndScreenWipe(void)
 {
 	//CONS_Debug(DBG_RENDER, "In HWR_EndScreenWipe()\n");
+	HWR_Flush2DBatch();
 	GPU->EndScreenWipe();
 }
 
 void HWR_DrawIntermissionBG(void)
 {
+	HWR_Flush2DBatch();
 	GPU->DrawIntermissionBG();
 }
 
@@ -7087,6 +7096,7 @@ void HWR_DoWipe(UINT8 wipenum, UINT8 scrnnum)
 	if (!HWR_WipeCheck(wipenum, scrnnum))
 		return;
 
+	HWR_Flush2DBatch();
 	HWR_GetFadeMask(wipelumpnum);
 	GPU->DoScreenWipe();
 }
@@ -7097,6 +7107,7 @@ void HWR_DoTintedWipe(UINT8 wipenum, UINT8 scrnnum)
 	if (!HWR_WipeCheck(wipenum, scrnnum))
 		return;
 
+	HWR_Flush2DBatch();
 	HWR_GetFadeMask(wipelumpnum);
 	GPU->DoTintedWipe((wipestyleflags & WSF_FADEIN), (wipestyleflags & WSF_TOWHITE));
 #else
@@ -7110,7 +7121,10 @@ void HWR_RecreateContext(void)
 	HWR_ClearSkyDome();
 
 	if (vid.glstate == VID_GL_LIBRARY_LOADED)
+	{
+		HWR_Flush2DBatch();
 		GPU->RecreateContext();
+	}
 }
 
 static inline UINT16 HWR_FindShaderDefs(UINT16 wadnum)
@@ -348,6 +348,7 @@ typedef struct {
 	int SSE        : 1; ///< SSE features
 	int SSE2       : 1; ///< SSE2 features
 	int SSE3       : 1; ///< SSE3 features
+	int NEON       : 1; ///< ARM NEON features
 	int IA64       : 1; ///< Running on IA64
 	int AMD64      : 1; ///< Running on AMD64
 	int AltiVec    : 1; ///< AltiVec features
@@ -21,6 +21,7 @@ extern boolean mousegrabbedbylua;
 #define LREG_STATEACTION "STATE_ACTION"
 #define LREG_ACTIONS "MOBJ_ACTION"
 #define LREG_METATABLES "METATABLES"
+#define LREG_ARCHTYPES "ARCHIVE_TYPES"
 
 #define META_STATE "STATE_T*"
 #define META_MOBJINFO "MOBJINFO_T*"
@@ -664,10 +664,12 @@ static int mobj_set(lua_State *L)
 		}
 		else
 			mo->flags = flags;
+		P_UpdateMobjRegistries(mo);
 		break;
 	}
 	case mobj_flags2:
 		mo->flags2 = (UINT32)luaL_checkinteger(L, 3);
+		P_UpdateMobjRegistries(mo);
 		break;
 	case mobj_eflags:
 		mo->eflags = (UINT32)luaL_checkinteger(L, 3);
@@ -733,8 +735,7 @@ static int mobj_set(lua_State *L)
 		mobjtype_t newtype = luaL_checkinteger(L, 3);
 		if (newtype >= NUMMOBJTYPES)
 			return luaL_error(L, "mobj.type %d out of range (0 - %d).", newtype, NUMMOBJTYPES-1);
-		mo->type = newtype;
-		mo->info = &mobjinfo[newtype];
+		P_SetMobjRegistryType(mo, newtype);
 		P_SetScale(mo, mo->scale);
 		break;
 	}
@@ -30,6 +30,7 @@
 #ifdef LUA_ALLOW_BYTECODE
 #include "d_netfil.h" // for LUA_DumpFile
 #endif
+#include "i_system.h" // I_GetPreciseTime
 
 #include "lua_script.h"
 #include "lua_libs.h"
@@ -1022,24 +1023,47 @@ static const struct {
 	{NULL,          ARCH_NULL}
 };
 
-static UINT8 GetUserdataArchType(int index)
+// Builds registry.ARCHIVE_TYPES, which maps each archivable metatable to its
+// archive type, so userdata can be typed with a single lookup
+static void BuildArchTypes(void)
 {
 	UINT8 i;
-	lua_getmetatable(gL, index);
 
+	lua_createtable(gL, 0, sizeof(meta2arch) / sizeof(meta2arch[0]));
 	for (i = 0; meta2arch[i].meta; i++)
 	{
 		luaL_getmetatable(gL, meta2arch[i].meta);
-		if (lua_rawequal(gL, -1, -2))
+		if (lua_isnil(gL, -1))
 		{
-			lua_pop(gL, 2);
-			return meta2arch[i].arch;
+			lua_pop(gL, 1);
+			continue;
 		}
+		lua_pushinteger(gL, meta2arch[i].arch);
+		lua_rawset(gL, -3);
+	}
+	lua_setfield(gL, LUA_REGISTRYINDEX, LREG_ARCHTYPES);
+}
+
+static UINT8 GetUserdataArchType(int index)
+{
+	UINT8 type;
+
+	if (!lua_getmetatable(gL, index))
+		return ARCH_NULL;
+
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_ARCHTYPES);
+	if (lua_isnil(gL, -1))
+	{
 		lua_pop(gL, 1);
+		BuildArchTypes();
+		lua_getfield(gL, LUA_REGISTRYINDEX, LREG_ARCHTYPES);
 	}
 
-	lua_pop(gL, 1);
-	return ARCH_NULL;
+	lua_pushvalue(gL, -2);
+	lua_rawget(gL, -2);
+	type = (UINT8)lua_tointeger(gL, -1); // nil is ARCH_NULL
+	lua_pop(gL, 3);
+	return type;
 }
 
 static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
@@ -1050,34 +1074,34 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 	{
 	case LUA_TNONE:
 	case LUA_TNIL:
-		WRITEUINT8(save_p, ARCH_NULL);
+		SAVEWRITEUINT8(ARCH_NULL);
 		break;
 	// This might be a problem. D:
 	case LUA_TLIGHTUSERDATA:
 	case LUA_TTHREAD:
 	case LUA_TFUNCTION:
-		WRITEUINT8(save_p, ARCH_NULL);
+		SAVEWRITEUINT8(ARCH_NULL);
 		return 2;
 	case LUA_TBOOLEAN:
-		WRITEUINT8(save_p, lua_toboolean(gL, myindex) ? ARCH_TRUE : ARCH_FALSE);
+		SAVEWRITEUINT8(lua_toboolean(gL, myindex) ? ARCH_TRUE : ARCH_FALSE);
 		break;
 	case LUA_TNUMBER:
 	{
 		lua_Integer number = lua_tointeger(gL, myindex);
 		if (number >= INT8_MIN && number <= INT8_MAX)
 		{
-			WRITEUINT8(save_p, ARCH_INT8);
-			WRITESINT8(save_p, number);
+			SAVEWRITEUINT8(ARCH_INT8);
+			SAVEWRITESINT8(number);
 		}
 		else if (number >= INT16_MIN && number <= INT16_MAX)
 		{
-			WRITEUINT8(save_p, ARCH_INT16);
-			WRITEINT16(save_p, number);
+			SAVEWRITEUINT8(ARCH_INT16);
+			SAVEWRITEINT16(number);
 		}
 		else
 		{
-			WRITEUINT8(save_p, ARCH_INT32);
-			WRITEFIXED(save_p, number);
+			SAVEWRITEUINT8(ARCH_INT32);
+			SAVEWRITEFIXED(number);
 		}
 		break;
 	}
@@ -1085,7 +1109,6 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 	{
 		UINT32 len = (UINT32)lua_objlen(gL, myindex); // get length of string, including embedded zeros
 		const char *s = lua_tostring(gL, myindex);
-		UINT32 i = 0;
 		// if you're wondering why we're writing a string to save_p this way,
 		// it turns out that Lua can have embedded zeros ('\0') in the strings,
 		// so we can't use WRITESTRING as that cuts off when it finds a '\0'.
@@ -1095,34 +1118,34 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		// -- Monster Iestyn 05/08/18
 		if (len < 255)
 		{
-			WRITEUINT8(save_p, ARCH_SMALLSTRING);
-			WRITEUINT8(save_p, len); // save size of string
+			SAVEWRITEUINT8(ARCH_SMALLSTRING);
+			SAVEWRITEUINT8(len); // save size of string
 		}
 		else
 		{
-			WRITEUINT8(save_p, ARCH_LARGESTRING);
-			WRITEUINT32(save_p, len); // save size of string
+			SAVEWRITEUINT8(ARCH_LARGESTRING);
+			SAVEWRITEUINT32(len); // save size of string
 		}
-		while (i < len)
-			WRITECHAR(save_p, s[i++]); // write chars individually, including the embedded zeros
+		SAVEWRITEMEM(s, len); // copy the whole thing, including the embedded zeros
 		break;
 	}
 	case LUA_TTABLE:
 	{
 		boolean found = false;
-		INT32 i;
-		UINT16 t = (UINT16)lua_objlen(gL, TABLESINDEX);
+		UINT16 t;
 
-		for (i = 1; i <= t && !found; i++)
+		// the tables list also maps each table back to its ID
+		lua_pushvalue(gL, myindex);
+		lua_rawget(gL, TABLESINDEX);
+		if (lua_isnil(gL, -1))
+			t = (UINT16)lua_objlen(gL, TABLESINDEX);
+		else
 		{
-			lua_rawgeti(gL, TABLESINDEX, i);
-			if (lua_rawequal(gL, myindex, -1))
-			{
-				t = i;
-				found = true;
-			}
-			lua_pop(gL, 1);
+			t = (UINT16)lua_tointeger(gL, -1);
+			found = true;
 		}
+		lua_pop(gL, 1);
+
 		if (!found)
 		{
 			t++;
@@ -1130,18 +1153,21 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 			if (t == 0)
 			{
 				CONS_Alert(CONS_ERROR, "Too many tables to archive!\n");
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 				return 0;
 			}
 		}
 
-		WRITEUINT8(save_p, ARCH_TABLE);
-		WRITEUINT16(save_p, t);
+		SAVEWRITEUINT8(ARCH_TABLE);
+		SAVEWRITEUINT16(t);
 
 		if (!found)
 		{
 			lua_pushvalue(gL, myindex);
 			lua_rawseti(gL, TABLESINDEX, t);
+			lua_pushvalue(gL, myindex);
+			lua_pushinteger(gL, t);
+			lua_rawset(gL, TABLESINDEX);
 			return 1;
 		}
 		break;
@@ -1152,25 +1178,25 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		case ARCH_MOBJINFO:
 		{
 			mobjinfo_t *info = *((mobjinfo_t **)lua_touserdata(gL, myindex));
-			WRITEUINT8(save_p, ARCH_MOBJINFO);
-			WRITEUINT16(save_p, info - mobjinfo);
+			SAVEWRITEUINT8(ARCH_MOBJINFO);
+			SAVEWRITEUINT16(info - mobjinfo);
 			break;
 		}
 		case ARCH_STATE:
 		{
 			state_t *state = *((state_t **)lua_touserdata(gL, myindex));
-			WRITEUINT8(save_p, ARCH_STATE);
-			WRITEUINT16(save_p, state - states);
+			SAVEWRITEUINT8(ARCH_STATE);
+			SAVEWRITEUINT16(state - states);
 			break;
 		}
 		case ARCH_MOBJ:
 		{
 			mobj_t *mobj = *((mobj_t **)lua_touserdata(gL, myindex));
 			if (!mobj)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_MOBJ);
-				WRITEUINT32(save_p, mobj->mobjnum);
+				SAVEWRITEUINT8(ARCH_MOBJ);
+				SAVEWRITEUINT32(mobj->mobjnum);
 			}
 			break;
 		}
@@ -1178,10 +1204,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			player_t *player = *((player_t **)lua_touserdata(gL, myindex));
 			if (!player)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_PLAYER);
-				WRITEUINT8(save_p, player - players);
+				SAVEWRITEUINT8(ARCH_PLAYER);
+				SAVEWRITEUINT8(player - players);
 			}
 			break;
 		}
@@ -1189,10 +1215,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			mapthing_t *mapthing = *((mapthing_t **)lua_touserdata(gL, myindex));
 			if (!mapthing)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_MAPTHING);
-				WRITEUINT16(save_p, mapthing - mapthings);
+				SAVEWRITEUINT8(ARCH_MAPTHING);
+				SAVEWRITEUINT16(mapthing - mapthings);
 			}
 			break;
 		}
@@ -1200,10 +1226,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			vertex_t *vertex = *((vertex_t **)lua_touserdata(gL, myindex));
 			if (!vertex)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_VERTEX);
-				WRITEUINT16(save_p, vertex - vertexes);
+				SAVEWRITEUINT8(ARCH_VERTEX);
+				SAVEWRITEUINT16(vertex - vertexes);
 			}
 			break;
 		}
@@ -1211,10 +1237,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			line_t *line = *((line_t **)lua_touserdata(gL, myindex));
 			if (!line)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_LINE);
-				WRITEUINT16(save_p, line - lines);
+				SAVEWRITEUINT8(ARCH_LINE);
+				SAVEWRITEUINT16(line - lines);
 			}
 			break;
 		}
@@ -1222,10 +1248,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			side_t *side = *((side_t **)lua_touserdata(gL, myindex));
 			if (!side)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_SIDE);
-				WRITEUINT16(save_p, side - sides);
+				SAVEWRITEUINT8(ARCH_SIDE);
+				SAVEWRITEUINT16(side - sides);
 			}
 			break;
 		}
@@ -1233,10 +1259,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			subsector_t *subsector = *((subsector_t **)lua_touserdata(gL, myindex));
 			if (!subsector)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_SUBSECTOR);
-				WRITEUINT16(save_p, subsector - subsectors);
+				SAVEWRITEUINT8(ARCH_SUBSECTOR);
+				SAVEWRITEUINT16(subsector - subsectors);
 			}
 			break;
 		}
@@ -1244,10 +1270,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			sector_t *sector = *((sector_t **)lua_touserdata(gL, myindex));
 			if (!sector)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_SECTOR);
-				WRITEUINT16(save_p, sector - sectors);
+				SAVEWRITEUINT8(ARCH_SECTOR);
+				SAVEWRITEUINT16(sector - sectors);
 			}
 			break;
 		}
@@ -1256,10 +1282,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			seg_t *seg = *((seg_t **)lua_touserdata(gL, myindex));
 			if (!seg)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_SEG);
-				WRITEUINT16(save_p, seg - segs);
+				SAVEWRITEUINT8(ARCH_SEG);
+				SAVEWRITEUINT16(seg - segs);
 			}
 			break;
 		}
@@ -1267,10 +1293,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			node_t *node = *((node_t **)lua_touserdata(gL, myindex));
 			if (!node)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_NODE);
-				WRITEUINT16(save_p, node - nodes);
+				SAVEWRITEUINT8(ARCH_NODE);
+				SAVEWRITEUINT16(node - nodes);
 			}
 			break;
 		}
@@ -1279,16 +1305,16 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			ffloor_t *rover = *((ffloor_t **)lua_touserdata(gL, myindex));
 			if (!rover)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
 				UINT16 i = P_GetFFloorID(rover);
 				if (i == UINT16_MAX) // invalid ID
-					WRITEUINT8(save_p, ARCH_NULL);
+					SAVEWRITEUINT8(ARCH_NULL);
 				else
 				{
-					WRITEUINT8(save_p, ARCH_FFLOOR);
-					WRITEUINT16(save_p, rover->target - sectors);
-					WRITEUINT16(save_p, i);
+					SAVEWRITEUINT8(ARCH_FFLOOR);
+					SAVEWRITEUINT16(rover->target - sectors);
+					SAVEWRITEUINT16(i);
 				}
 			}
 			break;
@@ -1297,10 +1323,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			polyobj_t *polyobj = *((polyobj_t **)lua_touserdata(gL, myindex));
 			if (!polyobj)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_POLYOBJ);
-				WRITEUINT16(save_p, polyobj-PolyObjects);
+				SAVEWRITEUINT8(ARCH_POLYOBJ);
+				SAVEWRITEUINT16(polyobj-PolyObjects);
 			}
 			break;
 		}
@@ -1308,10 +1334,10 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			pslope_t *slope = *((pslope_t **)lua_touserdata(gL, myindex));
 			if (!slope)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_SLOPE);
-				WRITEUINT16(save_p, slope->id);
+				SAVEWRITEUINT8(ARCH_SLOPE);
+				SAVEWRITEUINT16(slope->id);
 			}
 			break;
 		}
@@ -1319,36 +1345,36 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		{
 			mapheader_t *header = *((mapheader_t **)lua_touserdata(gL, myindex));
 			if (!header)
-				WRITEUINT8(save_p, ARCH_NULL);
+				SAVEWRITEUINT8(ARCH_NULL);
 			else {
-				WRITEUINT8(save_p, ARCH_MAPHEADER);
-				WRITEUINT16(save_p, header - *mapheaderinfo);
+				SAVEWRITEUINT8(ARCH_MAPHEADER);
+				SAVEWRITEUINT16(header - *mapheaderinfo);
 			}
 			break;
 		}
 		case ARCH_SKINCOLOR:
 		{
 			skincolor_t *info = *((skincolor_t **)lua_touserdata(gL, myindex));
-			WRITEUINT8(save_p, ARCH_SKINCOLOR);
-			WRITEUINT16(save_p, info - skincolors);
+			SAVEWRITEUINT8(ARCH_SKINCOLOR);
+			SAVEWRITEUINT16(info - skincolors);
 			break;
 		}
 		case ARCH_MOUSE:
 		{
 			mouse_t *m = *((mouse_t **)lua_touserdata(gL, myindex));
-			WRITEUINT8(save_p, ARCH_MOUSE);
-			WRITEUINT8(save_p, m == &mouse ? 1 : 2);
+			SAVEWRITEUINT8(ARCH_MOUSE);
+			SAVEWRITEUINT8(m == &mouse ? 1 : 2);
 			break;
 		}
 		case ARCH_SKIN:
 		{
 			skin_t *skin = *((skin_t **)lua_touserdata(gL, myindex));
-			WRITEUINT8(save_p, ARCH_SKIN);
-			WRITEUINT8(save_p, skin - skins); // UINT8 because MAXSKINS is only 32
+			SAVEWRITEUINT8(ARCH_SKIN);
+			SAVEWRITEUINT8(skin - skins); // UINT8 because MAXSKINS is only 32
 			break;
 		}
 		default:
-			WRITEUINT8(save_p, ARCH_NULL);
+			SAVEWRITEUINT8(ARCH_NULL);
 			return 2;
 		}
 		break;
@@ -1356,18 +1382,25 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 	return 0;
 }
 
+// Extra variable keys are written as an index into the keys seen so far
+// in this archive. EXTVARS_NEWKEY is followed by the key itself, which gets
+// the next index if there is one left, and EXTVARS_END ends the list.
+#define EXTVARS_NEWKEY 0
+#define EXTVARS_END UINT16_MAX
+
 static void ArchiveExtVars(void *pointer, const char *ptype)
 {
-	int TABLESINDEX;
-	UINT16 i;
+	int TABLESINDEX, KEYSINDEX;
+	UINT16 numkeys;
 
 	if (!gL) {
 		if (fastcmp(ptype,"player")) // players must always be included, even if no vars
-			WRITEUINT16(save_p, 0);
+			SAVEWRITEUINT16(EXTVARS_END);
 		return;
 	}
 
-	TABLESINDEX = lua_gettop(gL);
+	KEYSINDEX = lua_gettop(gL);
+	TABLESINDEX = KEYSINDEX - 1;
 
 	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
 	I_Assert(lua_istable(gL, -1));
@@ -1379,36 +1412,59 @@ static void ArchiveExtVars(void *pointer, const char *ptype)
 	{ // no extra values table
 		lua_pop(gL, 1);
 		if (fastcmp(ptype,"player")) // players must always be included, even if no vars
-			WRITEUINT16(save_p, 0);
+			SAVEWRITEUINT16(EXTVARS_END);
 		return;
 	}
 
-	lua_pushnil(gL);
-	for (i = 0; lua_next(gL, -2); i++)
-		lua_pop(gL, 1);
-
 	// skip anything that has an empty table and isn't a player.
-	if (i == 0)
+	lua_pushnil(gL);
+	if (!lua_next(gL, -2))
 	{
 		if (fastcmp(ptype,"player")) // always include players even if they have no extra variables
-			WRITEUINT16(save_p, 0);
+			SAVEWRITEUINT16(EXTVARS_END);
 		lua_pop(gL, 1);
 		return;
 	}
+	lua_pop(gL, 2); // start over from the first key below
 
 	if (fastcmp(ptype,"mobj")) // mobjs must write their mobjnum as a header
-		WRITEUINT32(save_p, ((mobj_t *)pointer)->mobjnum);
-	WRITEUINT16(save_p, i);
+		SAVEWRITEUINT32(((mobj_t *)pointer)->mobjnum);
+
+	numkeys = (UINT16)lua_objlen(gL, KEYSINDEX);
 	lua_pushnil(gL);
 	while (lua_next(gL, -2))
 	{
 		I_Assert(lua_type(gL, -2) == LUA_TSTRING);
-		WRITESTRING(save_p, lua_tostring(gL, -2));
+
+		// keys[key] = index of an already written key
+		lua_pushvalue(gL, -2);
+		lua_rawget(gL, KEYSINDEX);
+		if (lua_isnil(gL, -1))
+		{
+			SAVEWRITEUINT16(EXTVARS_NEWKEY);
+			SAVEWRITESTRING(lua_tostring(gL, -3));
+			if (numkeys < EXTVARS_END - 1)
+			{
+				lua_pushvalue(gL, -3);
+				lua_rawseti(gL, KEYSINDEX, ++numkeys);
+				lua_pushvalue(gL, -3);
+				lua_pushinteger(gL, numkeys);
+				lua_rawset(gL, KEYSINDEX);
+			}
+		}
+		else
+		{
+			SAVEWRITEUINT16((UINT16)lua_tointeger(gL, -1));
+		}
+		lua_pop(gL, 1);
+
 		if (ArchiveValue(TABLESINDEX, -1) == 2)
 			CONS_Alert(CONS_ERROR, "Type of value for %s entry '%s' (%s) could not be archived!\n", ptype, lua_tostring(gL, -2), luaL_typename(gL, -1));
 		lua_pop(gL, 1);
 	}
 
+	SAVEWRITEUINT16(EXTVARS_END);
+
 	lua_pop(gL, 1);
 }
 
@@ -1452,7 +1508,7 @@ static void ArchiveTables(void)
 
 			lua_pop(gL, 1);
 		}
-		WRITEUINT8(save_p, ARCH_TEND);
+		SAVEWRITEUINT8(ARCH_TEND);
 
 		// Write metatable ID
 		if (lua_getmetatable(gL, -1))
@@ -1461,11 +1517,11 @@ static void ArchiveTables(void)
 			lua_getfield(gL, LUA_REGISTRYINDEX, LREG_METATABLES);
 			lua_pushvalue(gL, -2);
 			lua_gettable(gL, -2);
-			WRITEUINT16(save_p, lua_isnil(gL, -1) ? 0 : lua_tointeger(gL, -1));
+			SAVEWRITEUINT16(lua_isnil(gL, -1) ? 0 : lua_tointeger(gL, -1));
 			lua_pop(gL, 3);
 		}
 		else
-			WRITEUINT16(save_p, 0);
+			SAVEWRITEUINT16(0);
 
 		lua_pop(gL, 1);
 	}
@@ -1576,6 +1632,8 @@ static UINT8 UnArchiveValue(int TABLESINDEX)
 		ffloor_t *rover = P_GetFFloorByID(sector, id);
 		if (rover)
 			LUA_PushUserdata(gL, rover, META_FFLOOR);
+		else
+			lua_pushnil(gL);
 		break;
 	}
 	case ARCH_POLYOBJ:
@@ -1604,23 +1662,44 @@ static UINT8 UnArchiveValue(int TABLESINDEX)
 
 static void UnArchiveExtVars(void *pointer)
 {
-	int TABLESINDEX;
-	UINT16 field_count = READUINT16(save_p);
-	UINT16 i;
+	int TABLESINDEX, KEYSINDEX;
+	UINT16 key = READUINT16(save_p);
+	UINT16 numkeys;
 	char field[1024];
 
-	if (field_count == 0)
+	if (key == EXTVARS_END)
 		return;
 	I_Assert(gL != NULL);
 
-	TABLESINDEX = lua_gettop(gL);
-	lua_createtable(gL, 0, field_count); // pointer's ext vars subtable
+	KEYSINDEX = lua_gettop(gL);
+	TABLESINDEX = KEYSINDEX - 1;
+	numkeys = (UINT16)lua_objlen(gL, KEYSINDEX);
+	lua_newtable(gL); // pointer's ext vars subtable
 
-	for (i = 0; i < field_count; i++)
+	for (; key != EXTVARS_END; key = READUINT16(save_p))
 	{
-		READSTRING(save_p, field);
+		if (key == EXTVARS_NEWKEY)
+		{
+			READSTRING(save_p, field);
+			lua_pushstring(gL, field);
+			if (numkeys < EXTVARS_END - 1)
+			{
+				lua_pushvalue(gL, -1);
+				lua_rawseti(gL, KEYSINDEX, ++numkeys);
+			}
+		}
+		else if (key <= numkeys)
+			lua_rawgeti(gL, KEYSINDEX, key);
+		else
+			lua_pushnil(gL); // not a key that was read yet
 		UnArchiveValue(TABLESINDEX);
-		lua_setfield(gL, -2, field);
+		if (lua_isnil(gL, -2))
+		{
+			CONS_Alert(CONS_ERROR, "Unknown extra variable key %d was found! (Corrupted save?)\n", key);
+			lua_pop(gL, 2); // pop key and value instead of setting them in the table, to prevent Lua panic errors
+		}
+		else
+			lua_rawset(gL, -3);
 	}
 
 	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
@@ -1700,7 +1779,10 @@ void LUA_Archive(void)
 	thinker_t *th;
 
 	if (gL)
+	{
 		lua_newtable(gL); // tables to be archived.
+		lua_newtable(gL); // extra variable keys written so far
+	}
 
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
@@ -1720,7 +1802,10 @@ void LUA_Archive(void)
 		ArchiveExtVars(th, "mobj");
 	}
 
-	WRITEUINT32(save_p, UINT32_MAX); // end of mobjs marker, replaces mobjnum.
+	SAVEWRITEUINT32(UINT32_MAX); // end of mobjs marker, replaces mobjnum.
+
+	if (gL)
+		lua_pop(gL, 1); // pop keys
 
 	LUA_HookNetArchive(NetArchive); // call the NetArchive hook in archive mode
 	ArchiveTables();
@@ -1733,10 +1818,13 @@ void LUA_UnArchive(void)
 {
 	UINT32 mobjnum;
 	INT32 i;
-	thinker_t *th;
+	thinker_t *th, *start = thlist[THINK_MOBJ].next;
 
 	if (gL)
+	{
 		lua_newtable(gL); // tables to be read
+		lua_newtable(gL); // extra variable keys read so far
+	}
 
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
@@ -1747,16 +1835,29 @@ void LUA_UnArchive(void)
 
 	do {
 		mobjnum = READUINT32(save_p); // read a mobjnum
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		if (mobjnum == UINT32_MAX)
+			break;
+
+		// mobjs were archived in thinker order, so carry on
+		// from the last match, wrapping around just in case
+		th = start;
+		do
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-			if (((mobj_t *)th)->mobjnum != mobjnum) // find matching mobj
-				continue;
-			UnArchiveExtVars(th); // apply variables
-		}
+			if (th != &thlist[THINK_MOBJ]
+			&& th->function.acp1 != (actionf_p1)P_RemoveThinkerDelayed
+			&& ((mobj_t *)th)->mobjnum == mobjnum) // find matching mobj
+			{
+				UnArchiveExtVars(th); // apply variables
+				start = th->next;
+				break;
+			}
+			th = th->next;
+		} while (th != start);
 	} while(mobjnum != UINT32_MAX); // repeat until end of mobjs marker.
 
+	if (gL)
+		lua_pop(gL, 1); // pop keys
+
 	LUA_HookNetArchive(NetUnArchive); // call the NetArchive hook in unarchive mode
 	UnArchiveTables();
 
@@ -1764,6 +1865,154 @@ void LUA_UnArchive(void)
 		lua_pop(gL, 1); // pop tables
 }
 
+#ifdef _DEBUG
+/**	\brief	Archives the extra variables of made up mobjs, reads them back
+		and checks they come out the same
+*/
+void Command_ExtVarsBench_f(void)
+{
+	static const char *const keys[] = {"timer", "state", "target", "name", "active", "speed", "angle", "count"};
+	const size_t numfixed = sizeof(keys) / sizeof(keys[0]);
+	UINT64 precision = I_GetPrecisePrecision() / 1000;
+	INT32 i, count = 1000, mismatches = 0;
+	int ORIGINDEX;
+	mobj_t *mobjs;
+	UINT8 *buffer;
+	size_t length, k;
+	precise_t start;
+	double elapsed[2];
+
+	if (!gL)
+		return;
+
+	if (COM_Argc() > 1)
+		count = max(1, atoi(COM_Argv(1)));
+
+	mobjs = Z_Calloc(count * sizeof (*mobjs), PU_STATIC, NULL);
+
+	// Give every mobj the same handful of keys, and every 16th one a key
+	// of its own, with numbers, strings and booleans for values.
+	lua_newtable(gL); // the tables as they were made, by mobj number
+	ORIGINDEX = lua_gettop(gL);
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
+	for (i = 0; i < count; i++)
+	{
+		mobjs[i].mobjnum = i + 1;
+
+		lua_pushlightuserdata(gL, &mobjs[i]);
+		lua_newtable(gL);
+		for (k = 0; k < numfixed; k++)
+		{
+			if (k % 3 == 0)
+				lua_pushinteger(gL, i * 7 + (INT32)k);
+			else if (k % 3 == 1)
+				lua_pushfstring(gL, "%s %d", keys[k], i);
+			else
+				lua_pushboolean(gL, (i + k) & 1);
+			lua_setfield(gL, -2, keys[k]);
+		}
+		if (!(i & 15))
+		{
+			lua_pushfstring(gL, "unique%d", i);
+			lua_pushinteger(gL, -i);
+			lua_rawset(gL, -3);
+		}
+		lua_pushvalue(gL, -1);
+		lua_rawseti(gL, ORIGINDEX, i + 1);
+		lua_rawset(gL, -3);
+	}
+	lua_pop(gL, 1); // pop LREG_EXTVARS
+
+	start = I_GetPreciseTime();
+	P_SaveBufferAlloc(1024);
+	lua_newtable(gL); // tables
+	lua_newtable(gL); // keys
+	for (i = 0; i < count; i++)
+		ArchiveExtVars(&mobjs[i], "mobj");
+	lua_pop(gL, 2);
+	buffer = P_SaveBufferFinish(&length);
+	elapsed[0] = (double)(I_GetPreciseTime() - start) / precision;
+
+	// forget them before reading them back
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
+	for (i = 0; i < count; i++)
+	{
+		lua_pushlightuserdata(gL, &mobjs[i]);
+		lua_pushnil(gL);
+		lua_rawset(gL, -3);
+	}
+	lua_pop(gL, 1);
+
+	start = I_GetPreciseTime();
+	save_p = buffer;
+	lua_newtable(gL); // tables
+	lua_newtable(gL); // keys
+	for (i = 0; i < count; i++)
+	{
+		if (READUINT32(save_p) != mobjs[i].mobjnum)
+		{
+			mismatches++;
+			break;
+		}
+		UnArchiveExtVars(&mobjs[i]);
+	}
+	lua_pop(gL, 2);
+	elapsed[1] = (double)(I_GetPreciseTime() - start) / precision;
+
+	// compare, and clean up
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
+	for (i = 0; i < count; i++)
+	{
+		size_t origkeys = 0, newkeys = 0;
+
+		lua_rawgeti(gL, ORIGINDEX, i + 1);
+		lua_pushlightuserdata(gL, &mobjs[i]);
+		lua_rawget(gL, -3);
+		if (!lua_istable(gL, -1))
+		{
+			mismatches++;
+			lua_pop(gL, 2);
+			continue;
+		}
+
+		lua_pushnil(gL);
+		while (lua_next(gL, -3))
+		{
+			origkeys++;
+			lua_pushvalue(gL, -2);
+			lua_rawget(gL, -4);
+			if (!lua_rawequal(gL, -1, -2))
+				mismatches++;
+			lua_pop(gL, 2);
+		}
+		lua_pushnil(gL);
+		while (lua_next(gL, -2))
+		{
+			newkeys++;
+			lua_pop(gL, 1);
+		}
+		if (origkeys != newkeys)
+			mismatches++;
+		lua_pop(gL, 2);
+
+		lua_pushlightuserdata(gL, &mobjs[i]);
+		lua_pushnil(gL);
+		lua_rawset(gL, -3);
+	}
+	lua_pop(gL, 2); // pop LREG_EXTVARS and the original tables
+
+	free(buffer);
+	save_p = NULL;
+	Z_Free(mobjs);
+
+	CONS_Printf("%d mobjs, %s bytes\n", count, sizeu1(length));
+	CONS_Printf("archive:    %9.2f ms\n", elapsed[0]);
+	CONS_Printf("unarchive:  %9.2f ms\n", elapsed[1]);
+	if (mismatches)
+		CONS_Alert(CONS_WARNING, "%d extra variables didn't match!\n", mismatches);
+}
+#endif
+
 // For mobj_t, player_t, etc. to take custom variables.
 int Lua_optoption(lua_State *L, int narg, int def, int list_ref)
 {
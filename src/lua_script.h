@@ -53,6 +53,9 @@ fixed_t LUA_EvalMath(const char *word);
 void LUA_Step(void);
 void LUA_Archive(void);
 void LUA_UnArchive(void);
+#ifdef _DEBUG
+void Command_ExtVarsBench_f(void);
+#endif
 int LUA_PushGlobals(lua_State *L, const char *word);
 int LUA_CheckGlobals(lua_State *L, const char *word);
 void Got_Luacmd(UINT8 **cp, INT32 playernum); // lua_consolelib.c
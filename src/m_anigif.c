@@ -21,6 +21,7 @@
 #include "i_system.h" // I_GetPreciseTime
 #include "m_misc.h"
 #include "st_stuff.h" // st_palette
+#include "i_threads.h"
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -48,16 +49,13 @@ static UINT8 gif_dynamicdelay = (UINT8)0; // and messing something up
 // Palette handling
 static boolean gif_localcolortable = false;
 static boolean gif_colorprofile = false;
-static RGBA_t *gif_headerpalette = NULL;
+static RGBA_t gif_headerpalette[256];
 static RGBA_t *gif_framepalette = NULL;
 
-typedef struct
-{
-	void *pixels;
-	size_t size;
-	boolean owns_pixels;
-} gif_screen_t;
-static gif_screen_t gif_screens[2];
+// The screen size when the GIF was opened. The encoder
+// uses these rather than vid, which it runs alongside of.
+static INT32 gif_width = 0;
+static INT32 gif_height = 0;
 
 static FILE *gif_out = NULL;
 static INT32 gif_frames = 0;
@@ -80,13 +78,13 @@ static UINT8 gif_writeover = 0;
 static UINT8 GIF_optimizecmprow(const UINT8 *dst, const UINT8 *src, INT32 row,
 	INT32 *last, INT32 *left, INT32 *right)
 {
-	const UINT8 *dp = dst + (vid.width * row);
-	const UINT8 *sp = src + (vid.width * row);
+	const UINT8 *dp = dst + (gif_width * row);
+	const UINT8 *sp = src + (gif_width * row);
 	const UINT8 *dtmp, *stmp;
 	UINT8 doleft = 1, doright = 1;
 	INT32 i = 0;
 
-	if (!memcmp(sp, dp, vid.width))
+	if (!memcmp(sp, dp, gif_width))
 		return 0; // unchanged.
 
 	*last = row;
@@ -113,14 +111,14 @@ static UINT8 GIF_optimizecmprow(const UINT8 *dst, const UINT8 *src, INT32 row,
 	}
 
 	// right side
-	i = vid.width - 1;
-	if (*right == vid.width - 1) // edge reached
+	i = gif_width - 1;
+	if (*right == gif_width - 1) // edge reached
 		doright = 0;
 	else if (*right >= 0) // right set, non-end-of-width
 	{
 		dtmp = dp + *right + 1;
 		stmp = sp + *right + 1;
-		if (!memcmp(stmp, dtmp, vid.width - (*right + 1)))
+		if (!memcmp(stmp, dtmp, gif_width - (*right + 1)))
 			doright = 0; // right side not changed
 	}
 	while (doright)
@@ -150,7 +148,7 @@ static UINT8 GIF_optimizecmprow(const UINT8 *dst, const UINT8 *src, INT32 row,
 static void GIF_optimizeregion(const UINT8 *dst, const UINT8 *src,
 	INT32 *x, INT32 *y, INT32 *w, INT32 *h)
 {
-	INT32 st = 0, sb = vid.height - 1; // work from both directions
+	INT32 st = 0, sb = gif_height - 1; // work from both directions
 	INT32 firstchg_t = -1, firstchg_b = -1; // store first changed row.
 	INT32 lastchg_t = -1, lastchg_b = -1; // Store last row... just in case
 	INT32 lmpix = -1, rmpix = -1; // store left and rightmost change
@@ -161,7 +159,7 @@ static void GIF_optimizeregion(const UINT8 *dst, const UINT8 *src,
 		if (!stopt)
 		{
 			if (GIF_optimizecmprow(dst, src, st++, &lastchg_t, &lmpix, &rmpix)
-			 && lmpix == 0 && rmpix == vid.width - 1)
+			 && lmpix == 0 && rmpix == gif_width - 1)
 				stopt = 1;
 			if (firstchg_t < 0 && lastchg_t >= 0)
 				firstchg_t = lastchg_t;
@@ -169,7 +167,7 @@ static void GIF_optimizeregion(const UINT8 *dst, const UINT8 *src,
 		if (!stopb)
 		{
 			if (GIF_optimizecmprow(dst, src, sb--, &lastchg_b, &lmpix, &rmpix)
-			 && lmpix == 0 && rmpix == vid.width - 1)
+			 && lmpix == 0 && rmpix == gif_width - 1)
 				stopb = 1;
 			if (firstchg_b < 0 && lastchg_b >= 0)
 				firstchg_b = lastchg_b;
@@ -271,8 +269,6 @@ static void GIF_prepareLZW(void)
 	gifbwr_bits_min = 9;
 	giflzw_nextCodeToAssign = GIFLZW_DICTSTART;
 
-	if (!giflzw_hashTable)
-		giflzw_hashTable = Z_Malloc(16384*sizeof(UINT32), PU_STATIC, NULL);
 	memset(giflzw_hashTable, 0, 16384*sizeof(UINT32));
 }
 
@@ -378,8 +374,8 @@ static void GIF_lzw(void)
 		}
 		if ((scrbuf_pos += scrbuf_downscaleamt) >= scrbuf_lineend)
 		{
-			scrbuf_lineend += (vid.width * scrbuf_downscaleamt);
-			scrbuf_linebegin += (vid.width * scrbuf_downscaleamt);
+			scrbuf_lineend += (gif_width * scrbuf_downscaleamt);
+			scrbuf_linebegin += (gif_width * scrbuf_downscaleamt);
 			scrbuf_pos = scrbuf_linebegin;
 		}
 		// Just a bit of overflow prevention
@@ -506,6 +502,8 @@ static void GIF_headwrite(void)
 // ---
 const UINT8 gifframe_gchead[4] = {0x21,0xF9,0x04,0x04}; // GCE, bytes, packed byte (no trans = 0 | no input = 0 | don't remove = 4)
 
+// The encoder's buffers come from malloc, because it runs on
+// its own thread and the zone allocator is not thread safe.
 static UINT8 *gifframe_data = NULL;
 static size_t gifframe_size = 8192;
 
@@ -520,7 +518,7 @@ static void GIF_rgbconvert(UINT8 *linear, UINT8 *scr)
 {
 	UINT8 r, g, b;
 	size_t src = 0, dest = 0;
-	size_t size = (vid.width * vid.height * SCREENSHOT_BITS);
+	size_t size = (gif_width * gif_height * SCREENSHOT_BITS);
 
 	InitColorLUT(&gif_colorlookup, (gif_localcolortable) ? gif_framepalette : gif_headerpalette, true);
 
@@ -536,20 +534,93 @@ static void GIF_rgbconvert(UINT8 *linear, UINT8 *scr)
 }
 #endif
 
+
+
+// FRAME QUEUE
+// ---
+// GIF_frame only takes a copy of the screen and works out the frame's
+// delay. Everything else is done by GIF_framewrite, on a thread of its
+// own when there is one, so the game doesn't wait for the encoder.
+#define GIFQUEUE_SIZE 4
+
+typedef struct
+{
+	UINT8 *pixels; // gif_width * gif_height, palettized
+	UINT8 *linear; // OpenGL screenshot that still needs converting, or NULL
+	RGBA_t palette[256];
+	UINT16 delay;
+} gif_snapshot_t;
+
+static gif_snapshot_t gif_queue[GIFQUEUE_SIZE];
+static INT32 gif_queuehead = 0; // the frame the encoder is on, or will be next
+static INT32 gif_queued = 0; // counts the frame being encoded
+static INT32 gif_snapshots = 0;
+static INT32 gif_merged = 0;
+static INT32 gif_skipped = 0;
+static boolean gif_writefailed = false;
+
+// The last frame written. The next one is compared against it.
+static UINT8 *gif_movie = NULL;
+
+#ifdef HAVE_THREADS
+static I_mutex gif_queue_mutex;
+static I_cond gif_queue_cond;
+static boolean gif_encoding = false;
+#endif
+
+//
+// GIF_framedelay
+// works out how long the frame captured now should be shown for.
+//
+static UINT16 GIF_framedelay(void)
+{
+	UINT16 delay = 0;
+
+	if (gif_dynamicdelay ==(UINT8) 2)
+	{
+		// golden's attempt at creating a "dynamic delay"
+		UINT16 mingifdelay = 10; // minimum gif delay in milliseconds (keep at 10 because gifs can't get more precise).
+		gif_delayus += (I_GetPreciseTime() - gif_prevframetime) / (I_GetPrecisePrecision() / 1000000); // increase delay by how much time was spent between last measurement
+
+		if (gif_delayus/1000 >= mingifdelay) // delay is big enough to be able to effect gif frame delay?
+		{
+			int frames = (gif_delayus/1000) / mingifdelay; // get amount of frames to delay.
+			delay = frames; // set the delay to delay that amount of frames.
+			gif_delayus -= frames*(mingifdelay*1000); // remove frames by the amount of milliseconds they take. don't reset to 0, the microseconds help consistency.
+		}
+	}
+	else if (gif_dynamicdelay ==(UINT8) 1)
+	{
+		float delayf = ceil(100.0f/NEWTICRATE);
+
+		delay = (UINT16)((I_GetPreciseTime() - gif_prevframetime)) / (I_GetPrecisePrecision() / 1000000) /10/1000;
+
+		if (delay < (UINT16)(delayf))
+			delay = (UINT16)(delayf);
+	}
+	else
+	{
+		// the original code
+		int d1 = (int)((100.0f/NEWTICRATE)*(gif_snapshots+1));
+		int d2 = (int)((100.0f/NEWTICRATE)*(gif_snapshots));
+		delay = d1-d2;
+	}
+
+	gif_prevframetime = I_GetPreciseTime();
+	return delay;
+}
+
 //
 // GIF_framewrite
 // writes a frame into the file.
 //
-static void GIF_framewrite(void)
+static void GIF_framewrite(gif_snapshot_t *frame)
 {
 	UINT8 *p;
-	UINT8 *base_screen = gif_screens[0].pixels;
-	UINT8 *movie_screen = gif_screens[1].pixels;
+	UINT8 *screen = frame->pixels;
 	INT32 blitx, blity, blitw, blith;
 	boolean palchanged;
 
-	if (!gifframe_data)
-		gifframe_data = Z_Malloc(gifframe_size, PU_STATIC, NULL);
 	p = gifframe_data;
 
 	if (!gif_out)
@@ -558,94 +629,46 @@ static void GIF_framewrite(void)
 	// Lactozilla: Compare the header's palette with the current frame's palette and see if it changed.
 	if (gif_localcolortable)
 	{
-		gif_framepalette = GIF_getpalette(max(st_palette, 0));
+		gif_framepalette = frame->palette;
 		palchanged = memcmp(gif_headerpalette, gif_framepalette, sizeof(RGBA_t) * 256);
 	}
 	else
 		palchanged = false;
 
+#ifdef HWRENDER
+	if (frame->linear)
+	{
+		GIF_rgbconvert(frame->linear, screen);
+		free(frame->linear);
+		frame->linear = NULL;
+	}
+#endif
+
 	// Compare image data (for optimizing GIF)
 	// If the palette has changed, the entire frame is considered to be different.
 	if (gif_optimize && gif_frames > 0 && (!palchanged))
 	{
-		// before blit movie_screen points to last frame, cur_screen points to this frame
-		UINT8 *cur_screen = base_screen;
-		GIF_optimizeregion(cur_screen, movie_screen, &blitx, &blity, &blitw, &blith);
-
-		// blit to temp screen
-		if (rendermode == render_soft)
-			I_ReadScreen(movie_screen);
-#ifdef HWRENDER
-		else if (rendermode == render_opengl)
-		{
-			UINT8 *linear = HWR_GetScreenshot();
-			GIF_rgbconvert(linear, movie_screen);
-			free(linear);
-		}
-#endif
+		GIF_optimizeregion(screen, gif_movie, &blitx, &blity, &blitw, &blith);
+		memcpy(gif_movie, screen, gif_width * gif_height);
 	}
 	else
 	{
 		blitx = blity = 0;
-		blitw = vid.width;
-		blith = vid.height;
-
-#ifdef HWRENDER
-		// Copy the current OpenGL frame into the base screen
-		if (rendermode == render_opengl)
-		{
-			UINT8 *linear = HWR_GetScreenshot();
-			GIF_rgbconvert(linear, base_screen);
-			free(linear);
-		}
-#endif
-
-		// Copy the first frame into the movie screen
-		// OpenGL already does the same above.
-		if (gif_frames == 0 && rendermode == render_soft)
-			I_ReadScreen(movie_screen);
+		blitw = gif_width;
+		blith = gif_height;
 
-		movie_screen = base_screen;
+		// Keep the first frame to compare the next one against.
+		if (gif_frames == 0)
+			memcpy(gif_movie, screen, gif_width * gif_height);
 	}
 
 	// screen regions are handled in GIF_lzw
 	{
-		UINT16 delay = 0;
 		INT32 startline;
 
-		if (gif_dynamicdelay ==(UINT8) 2)
-		{
-			// golden's attempt at creating a "dynamic delay"
-			UINT16 mingifdelay = 10; // minimum gif delay in milliseconds (keep at 10 because gifs can't get more precise).
-			gif_delayus += (I_GetPreciseTime() - gif_prevframetime) / (I_GetPrecisePrecision() / 1000000); // increase delay by how much time was spent between last measurement
-
-			if (gif_delayus/1000 >= mingifdelay) // delay is big enough to be able to effect gif frame delay?
-			{
-				int frames = (gif_delayus/1000) / mingifdelay; // get amount of frames to delay.
-				delay = frames; // set the delay to delay that amount of frames.
-				gif_delayus -= frames*(mingifdelay*1000); // remove frames by the amount of milliseconds they take. don't reset to 0, the microseconds help consistency.
-			}
-		}
-		else if (gif_dynamicdelay ==(UINT8) 1)
-		{
-			float delayf = ceil(100.0f/NEWTICRATE);
-
-			delay = (UINT16)((I_GetPreciseTime() - gif_prevframetime)) / (I_GetPrecisePrecision() / 1000000) /10/1000;
-
-			if (delay < (UINT16)(delayf))
-				delay = (UINT16)(delayf);
-		}
-		else
-		{
-			// the original code
-			int d1 = (int)((100.0f/NEWTICRATE)*(gif_frames+1));
-			int d2 = (int)((100.0f/NEWTICRATE)*(gif_frames));
-			delay = d1-d2;
-		}
-
 		WRITEMEM(p, gifframe_gchead, 4);
 
-		WRITEUINT16(p, delay);
+		WRITEUINT16(p, frame->delay);
 		WRITEUINT8(p, 0);
 		WRITEUINT8(p, 0); // end of GCE
 
@@ -678,19 +701,17 @@ static void GIF_framewrite(void)
 				WRITEUINT8(p, 0); // They are equal, no Local Color Table needed.
 		}
 
-		scrbuf_pos = movie_screen + blitx + (blity * vid.width);
-		scrbuf_writeend = scrbuf_pos + (blitw - 1) + ((blith - 1) * vid.width);
+		scrbuf_pos = screen + blitx + (blity * gif_width);
+		scrbuf_writeend = scrbuf_pos + (blitw - 1) + ((blith - 1) * gif_width);
 
-		if (!gifbwr_buf)
-			gifbwr_buf = Z_Malloc(256, PU_STATIC, NULL);
 		gifbwr_cur = gifbwr_buf;
 
 		GIF_prepareLZW();
 		giflzw_workingCode = UINT16_MAX;
 		WRITEUINT8(p, gifbwr_bits_min - 1);
 
-		startline = (scrbuf_pos - movie_screen) / vid.width;
-		scrbuf_linebegin = movie_screen + (startline * vid.width) + blitx;
+		startline = (scrbuf_pos - screen) / gif_width;
+		scrbuf_linebegin = screen + (startline * gif_width) + blitx;
 		scrbuf_lineend = scrbuf_linebegin + blitw;
 
 		//prewrite a table clear
@@ -704,7 +725,14 @@ static void GIF_framewrite(void)
 			if ((size_t)(p - gifframe_data) + gifbwr_bufsize + 1 >= gifframe_size)
 			{
 				INT32 temppos = p - gifframe_data;
-				gifframe_data = Z_Realloc(gifframe_data, (gifframe_size *= 2), PU_STATIC, NULL);
+				UINT8 *data = realloc(gifframe_data, gifframe_size * 2);
+				if (!data)
+				{
+					gif_writefailed = true; // the frame is lost, but the file is still good
+					return;
+				}
+				gifframe_data = data;
+				gifframe_size *= 2;
 				p = gifframe_data + temppos; // realloc moves gifframe_data, so p is now invalid
 			}
 
@@ -720,7 +748,126 @@ static void GIF_framewrite(void)
 	}
 	fwrite(gifframe_data, 1, (p - gifframe_data), gif_out);
 	++gif_frames;
-	gif_prevframetime = I_GetPreciseTime();
+}
+
+//
+// GIF_snapshot
+// copies the screen and palette for the encoder.
+//
+static void GIF_snapshot(gif_snapshot_t *frame, UINT16 delay)
+{
+	frame->delay = delay;
+
+	if (gif_localcolortable)
+		M_Memcpy(frame->palette, GIF_getpalette(max(st_palette, 0)), sizeof(frame->palette));
+
+#ifdef HWRENDER
+	if (rendermode == render_opengl)
+	{
+		// Converting it to the palette is left to the encoder.
+		frame->linear = HWR_GetScreenshot();
+		return;
+	}
+#endif
+	frame->linear = NULL;
+	I_ReadScreen(frame->pixels);
+}
+
+#ifdef HAVE_THREADS
+//
+// GIF_encodethread
+// writes queued frames until there are none left.
+//
+static void GIF_encodethread(void *userdata)
+{
+	(void)userdata;
+
+	for (;;)
+	{
+		gif_snapshot_t *frame;
+
+		I_lock_mutex(&gif_queue_mutex);
+		{
+			if (!gif_queued)
+			{
+				gif_encoding = false;
+				I_wake_all_cond(&gif_queue_cond);
+				I_unlock_mutex(gif_queue_mutex);
+				return;
+			}
+			frame = &gif_queue[gif_queuehead];
+		}
+		I_unlock_mutex(gif_queue_mutex);
+
+		// GIF_frame leaves this one alone until it's off the queue.
+		GIF_framewrite(frame);
+
+		I_lock_mutex(&gif_queue_mutex);
+		{
+			gif_queuehead = (gif_queuehead + 1) % GIFQUEUE_SIZE;
+			gif_queued--;
+		}
+		I_unlock_mutex(gif_queue_mutex);
+	}
+}
+
+// Waits for the encoder to write out everything queued.
+static void GIF_waitqueue(void)
+{
+	I_lock_mutex(&gif_queue_mutex);
+	{
+		while (gif_encoding)
+			I_hold_cond(&gif_queue_cond, gif_queue_mutex);
+	}
+	I_unlock_mutex(gif_queue_mutex);
+}
+#endif
+
+static boolean GIF_allocqueue(void)
+{
+	size_t size = gif_width * gif_height;
+	INT32 i;
+
+	// The encoder may never write some of the pixels of an OpenGL
+	// frame when downscaling, so they must not start out as garbage.
+	for (i = 0; i < GIFQUEUE_SIZE; i++)
+	{
+		gif_queue[i].pixels = Z_Calloc(size, PU_STATIC, NULL);
+		gif_queue[i].linear = NULL;
+	}
+	gif_movie = Z_Calloc(size, PU_STATIC, NULL);
+	gif_queuehead = gif_queued = 0;
+
+	gifframe_size = 8192;
+	gifframe_data = malloc(gifframe_size);
+	gifbwr_buf = malloc(256);
+	giflzw_hashTable = malloc(16384*sizeof(UINT32));
+
+	return (gifframe_data && gifbwr_buf && giflzw_hashTable);
+}
+
+static void GIF_freequeue(void)
+{
+	INT32 i;
+
+	for (i = 0; i < GIFQUEUE_SIZE; i++)
+	{
+		Z_Free(gif_queue[i].pixels);
+		gif_queue[i].pixels = NULL;
+		free(gif_queue[i].linear);
+		gif_queue[i].linear = NULL;
+	}
+	Z_Free(gif_movie);
+	gif_movie = NULL;
+
+	free(gifbwr_buf);
+	gifbwr_buf = gifbwr_cur = NULL;
+
+	free(gifframe_data);
+	gifframe_data = NULL;
+
+	free(giflzw_hashTable);
+	giflzw_hashTable = NULL;
 }
 
 
@@ -744,77 +891,92 @@ INT32 GIF_open(const char *filename)
 	gif_dynamicdelay = (UINT8)cv_gif_dynamicdelay.value;
 	gif_localcolortable = (!!cv_gif_localcolortable.value);
 	gif_colorprofile = (!!cv_screenshot_colorprofile.value);
-	gif_headerpalette = GIF_getpalette(0);
+	M_Memcpy(gif_headerpalette, GIF_getpalette(0), sizeof(gif_headerpalette));
+
+	gif_width = vid.width;
+	gif_height = vid.height;
+
+	if (!GIF_allocqueue())
+	{
+		GIF_freequeue();
+		fclose(gif_out);
+		gif_out = NULL;
+		return 0;
+	}
 
 	GIF_headwrite();
-	gif_frames = 0;
+	gif_frames = gif_snapshots = 0;
+	gif_merged = gif_skipped = 0;
+	gif_writefailed = false;
 	gif_prevframetime = I_GetPreciseTime();
 	gif_delayus = 0;
 
 	return 1;
 }
 
-static void GIF_checkscreens(void)
+//
+// GIF_frame
+// writes a frame into the output gif
+//
+void GIF_frame(void)
 {
-	for (size_t i = 0; i < sizeof(gif_screens) / sizeof(gif_screens[0]); i++)
+	gif_snapshot_t *frame;
+	UINT16 delay;
+
+	if (!gif_out)
+		return;
+
+	// The header can't be changed now, so there is
+	// nothing sensible to do with a frame of another size.
+	if (vid.width != gif_width || vid.height != gif_height)
 	{
-		if (rendermode == render_soft)
-		{
-			if (gif_screens[i].owns_pixels)
-			{
-				Z_Free(gif_screens[i].pixels);
-				gif_screens[i].owns_pixels = false;
-			}
+		gif_skipped++;
+		return;
+	}
 
-			gif_screens[i].size = 0;
+	delay = GIF_framedelay();
+	gif_snapshots++;
 
-			if (i == 1)
-				gif_screens[i].pixels = screens[2];
-			else
-				gif_screens[i].pixels = screens[0];
-		}
-		else
+#ifdef HAVE_THREADS
+	if (!I_thread_is_stopped())
+	{
+		I_lock_mutex(&gif_queue_mutex);
 		{
-			size_t sz = vid.width * vid.height * vid.bpp;
-
-			if (!gif_screens[i].owns_pixels)
-			{
-				gif_screens[i].size = sz;
-				gif_screens[i].pixels = Z_Malloc(gif_screens[i].size, PU_STATIC, NULL);
-				gif_screens[i].owns_pixels = true;
-			}
-			else if (gif_screens[i].size != sz)
+			if (gif_queued == GIFQUEUE_SIZE)
 			{
-				gif_screens[i].size = sz;
-				gif_screens[i].pixels = Z_Realloc(gif_screens[i].pixels, gif_screens[i].size, PU_STATIC, NULL);
+				// The encoder can't keep up. Instead of waiting for it,
+				// show the newest frame in the queue for longer, as
+				// though this one had never been drawn.
+				frame = &gif_queue[(gif_queuehead + gif_queued - 1) % GIFQUEUE_SIZE];
+				frame->delay = (UINT16)min(frame->delay + delay, UINT16_MAX);
+				gif_merged++;
+				I_unlock_mutex(gif_queue_mutex);
+				return;
 			}
+			frame = &gif_queue[(gif_queuehead + gif_queued) % GIFQUEUE_SIZE];
 		}
-	}
-}
+		I_unlock_mutex(gif_queue_mutex);
 
-static void GIF_freescreens(void)
-{
-	for (size_t i = 0; i < sizeof(gif_screens) / sizeof(gif_screens[0]); i++)
-	{
-		if (gif_screens[i].owns_pixels)
+		// The encoder doesn't look at this slot until it is queued.
+		GIF_snapshot(frame, delay);
+
+		I_lock_mutex(&gif_queue_mutex);
 		{
-			Z_Free(gif_screens[i].pixels);
-			gif_screens[i].owns_pixels = false;
+			gif_queued++;
+			if (!gif_encoding)
+			{
+				gif_encoding = true;
+				I_spawn_thread("gif-encode", GIF_encodethread, NULL);
+			}
 		}
-
-		gif_screens[i].size = 0;
-		gif_screens[i].pixels = NULL;
+		I_unlock_mutex(gif_queue_mutex);
+		return;
 	}
-}
+#endif
 
-//
-// GIF_frame
-// writes a frame into the output gif
-//
-void GIF_frame(void)
-{
-	GIF_checkscreens();
-	GIF_framewrite();
+	frame = &gif_queue[gif_queuehead];
+	GIF_snapshot(frame, delay);
+	GIF_framewrite(frame);
 }
 
 //
@@ -826,26 +988,24 @@ INT32 GIF_close(void)
 	if (!gif_out)
 		return 0;
 
+#ifdef HAVE_THREADS
+	GIF_waitqueue();
+#endif
+
 	// final terminator.
 	fwrite(";", 1, 1, gif_out);
 	fclose(gif_out);
 	gif_out = NULL;
 
-	if (gifbwr_buf)
-		Z_Free(gifbwr_buf);
-	gifbwr_buf = gifbwr_cur = NULL;
-
-	if (gifframe_data)
-		Z_Free(gifframe_data);
-	gifframe_data = NULL;
-
-	if (giflzw_hashTable)
-		Z_Free(giflzw_hashTable);
-	giflzw_hashTable = NULL;
-
-	GIF_freescreens();
+	GIF_freequeue();
 
 	CONS_Printf(M_GetText("Animated gif closed; wrote %d frames\n"), gif_frames);
+	if (gif_merged)
+		CONS_Printf(M_GetText("%d frames were merged into the previous one to keep up\n"), gif_merged);
+	if (gif_writefailed)
+		CONS_Alert(CONS_WARNING, M_GetText("Ran out of memory for some frames of the animated gif\n"));
+	if (gif_skipped)
+		CONS_Printf(M_GetText("%d frames were skipped because the resolution changed\n"), gif_skipped);
 	return 1;
 }
 #endif //ifdef HAVE_ANIGIF
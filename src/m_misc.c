@@ -44,6 +44,7 @@
 #include "command.h" // cv_execversion
 
 #include "m_anigif.h"
+#include "i_threads.h"
 
 // So that the screenshot menu auto-updates...
 #include "m_menu.h"
@@ -798,6 +799,14 @@ static void PNG_warn(png_structp PNG, png_const_charp pngtext)
 	CONS_Debug(DBG_RENDER, "libpng warning at %p: %s", PNG, pngtext);
 }
 
+// For images written away from the main thread, where I_Error can't be
+// used: jumps back to the writer, which gives up on the image instead.
+FUNCNORETURN static void PNG_threaderror(png_structp PNG, png_const_charp pngtext)
+{
+	(void)pngtext;
+	longjmp(png_jmpbuf(PNG), 1);
+}
+
 static void M_PNGhdr(png_structp png_ptr, png_infop png_info_ptr, PNG_CONST png_uint_32 width, PNG_CONST png_uint_32 height, PNG_CONST png_byte *palette)
 {
 	const png_byte png_interlace = PNG_INTERLACE_NONE; //PNG_INTERLACE_ADAM7
@@ -834,69 +843,81 @@ static void M_PNGhdr(png_structp png_ptr, png_infop png_info_ptr, PNG_CONST png_
 	}
 }
 
-static void M_PNGText(png_structp png_ptr, png_infop png_info_ptr, PNG_CONST png_byte movie)
+/** The parts of a PNG's text that come from the game, taken
+  * when the picture is, since it may be written out much later.
+  */
+typedef struct
 {
-#ifdef PNG_TEXT_SUPPORTED
-#define SRB2PNGTXT 11 //PNG_KEYWORD_MAX_LENGTH(79) is the max
-	png_text png_infotext[SRB2PNGTXT];
-	char keytxt[SRB2PNGTXT][12] = {
-	"Title", "Description", "Playername", "Mapnum", "Mapname",
-	"Location", "Interface", "Render Mode", "Revision", "Build Date", "Build Time"};
-	char titletxt[] = "Sonic Robo Blast 2 " VERSIONSTRING;
-	png_charp playertxt =  cv_playername.zstring;
-	char desctxt[] = "SRB2 Screenshot";
-	char Movietxt[] = "SRB2 Movie";
-	size_t i;
-	char interfacetxt[] =
-#ifdef HAVE_SDL
-	 "SDL";
-#elif defined (_WINDOWS)
-	 "DirectX";
-#else
-	 "Unknown";
-#endif
-	char rendermodetxt[9];
-	char maptext[8];
-	char lvlttltext[48];
-	char locationtxt[40];
-	char ctrevision[40];
-	char ctdate[40];
-	char cttime[40];
+	char player[MAXPLAYERNAME+1];
+	char rendermode[9];
+	char map[8];
+	char lvlttl[48];
+	char location[40];
+} pngtextinfo_t;
+
+static void M_PNGTextInfo(pngtextinfo_t *info)
+{
+	strlcpy(info->player, cv_playername.zstring, sizeof info->player);
 
 	switch (rendermode)
 	{
 		case render_soft:
-			strcpy(rendermodetxt, "Software");
+			strcpy(info->rendermode, "Software");
 			break;
 		case render_opengl:
-			strcpy(rendermodetxt, "OpenGL");
+			strcpy(info->rendermode, "OpenGL");
 			break;
 		default: // Just in case
-			strcpy(rendermodetxt, "None");
+			strcpy(info->rendermode, "None");
 			break;
 	}
 
 	if (gamestate == GS_LEVEL)
-		snprintf(maptext, 8, "%s", G_BuildMapName(gamemap));
+		snprintf(info->map, 8, "%s", G_BuildMapName(gamemap));
 	else
-		snprintf(maptext, 8, "Unknown");
+		snprintf(info->map, 8, "Unknown");
 
 	if (gamestate == GS_LEVEL && mapheaderinfo[gamemap-1]->lvlttl[0] != '\0')
-		snprintf(lvlttltext, 48, "%s%s%s",
+		snprintf(info->lvlttl, 48, "%s%s%s",
 			mapheaderinfo[gamemap-1]->lvlttl,
 			(mapheaderinfo[gamemap-1]->levelflags & LF_NOZONE) ? "" : " Zone",
 			(mapheaderinfo[gamemap-1]->actnum > 0) ? va(" %d",mapheaderinfo[gamemap-1]->actnum) : "");
 	else
-		snprintf(lvlttltext, 48, "Unknown");
+		snprintf(info->lvlttl, 48, "Unknown");
 
 	if (gamestate == GS_LEVEL && players[displayplayer].mo)
-		snprintf(locationtxt, 40, "X:%d Y:%d Z:%d A:%d",
+		snprintf(info->location, 40, "X:%d Y:%d Z:%d A:%d",
 			players[displayplayer].mo->x>>FRACBITS,
 			players[displayplayer].mo->y>>FRACBITS,
 			players[displayplayer].mo->z>>FRACBITS,
 			FixedInt(AngleFixed(players[displayplayer].mo->angle)));
 	else
-		snprintf(locationtxt, 40, "Unknown");
+		snprintf(info->location, 40, "Unknown");
+}
+
+static void M_PNGText(png_structp png_ptr, png_infop png_info_ptr, pngtextinfo_t *info, PNG_CONST png_byte movie)
+{
+#ifdef PNG_TEXT_SUPPORTED
+#define SRB2PNGTXT 11 //PNG_KEYWORD_MAX_LENGTH(79) is the max
+	png_text png_infotext[SRB2PNGTXT];
+	char keytxt[SRB2PNGTXT][12] = {
+	"Title", "Description", "Playername", "Mapnum", "Mapname",
+	"Location", "Interface", "Render Mode", "Revision", "Build Date", "Build Time"};
+	char titletxt[] = "Sonic Robo Blast 2 " VERSIONSTRING;
+	char desctxt[] = "SRB2 Screenshot";
+	char Movietxt[] = "SRB2 Movie";
+	size_t i;
+	char interfacetxt[] =
+#ifdef HAVE_SDL
+	 "SDL";
+#elif defined (_WINDOWS)
+	 "DirectX";
+#else
+	 "Unknown";
+#endif
+	char ctrevision[40];
+	char ctdate[40];
+	char cttime[40];
 
 	memset(png_infotext,0x00,sizeof (png_infotext));
 
@@ -908,12 +929,12 @@ static void M_PNGText(png_structp png_ptr, png_infop png_info_ptr, PNG_CONST png
 		png_infotext[1].text = Movietxt;
 	else
 		png_infotext[1].text = desctxt;
-	png_infotext[2].text = playertxt;
-	png_infotext[3].text = maptext;
-	png_infotext[4].text = lvlttltext;
-	png_infotext[5].text = locationtxt;
+	png_infotext[2].text = info->player;
+	png_infotext[3].text = info->map;
+	png_infotext[4].text = info->lvlttl;
+	png_infotext[5].text = info->location;
 	png_infotext[6].text = interfacetxt;
-	png_infotext[7].text = rendermodetxt;
+	png_infotext[7].text = info->rendermode;
 	png_infotext[8].text = strncpy(ctrevision, comprevision, sizeof(ctrevision)-1);
 	png_infotext[9].text = strncpy(ctdate, compdate, sizeof(ctdate)-1);
 	png_infotext[10].text = strncpy(cttime, comptime, sizeof(cttime)-1);
@@ -1038,34 +1059,63 @@ static inline boolean M_PNGLib(void)
 #endif
 }
 
-static void M_PNGFrame(png_structp png_ptr, png_infop png_info_ptr, png_bytep png_buf)
+// APNG frames are copied by M_SaveFrame and written by M_PNGFrame,
+// in order, on a thread of its own when there is one.
+#define APNG_QUEUESIZE 4
+
+typedef struct
 {
-	png_uint_16 downscale = apng_downscale ? vid.dupx : 1;
+	png_bytep data; // the whole screen, from malloc
+	png_uint_16 delay;
+} apngframe_t;
+
+static apngframe_t apng_queue[APNG_QUEUESIZE];
+static INT32 apng_queuehead = 0; // the frame being written, or to be written next
+static INT32 apng_queued = 0; // counts the frame being written
+static png_uint_32 apng_captured = 0;
+static png_uint_32 apng_merged = 0;
+static boolean apng_failed = false;
 
+// The screen size and downscale when the aPNG was opened.
+static INT32 apng_width = 0;
+static INT32 apng_height = 0;
+static png_uint_16 apng_scale = 1;
+
+#ifdef HAVE_THREADS
+static I_mutex apng_mutex;
+static I_cond apng_cond;
+static boolean apng_writing = false;
+#endif
+
+static void M_PNGFrame(png_structp png_ptr, png_infop png_info_ptr, apngframe_t *frame)
+{
 	png_uint_32 pitch = png_get_rowbytes(png_ptr, png_info_ptr);
-	PNG_CONST png_uint_32 width = vid.width / downscale;
-	PNG_CONST png_uint_32 height = vid.height / downscale;
-	png_bytepp row_pointers = png_malloc(png_ptr, height * sizeof (png_bytep));
-	png_uint_32 x, y;
-	png_uint_16 framedelay = (png_uint_16)cv_apng_delay.value;
+	PNG_CONST png_uint_32 width = apng_width / apng_scale;
+	PNG_CONST png_uint_32 height = apng_height / apng_scale;
+	PNG_CONST png_uint_32 bpp = pitch / width;
+	png_bytep png_buf = frame->data;
+	png_bytep rows = malloc(pitch * height);
+	png_bytepp row_pointers = malloc(height * sizeof (png_bytep));
+	png_uint_32 x, y, c;
 
-	apng_frames++;
+	if (!rows || !row_pointers || apng_failed)
+		goto done;
+
+	if (setjmp(png_jmpbuf(png_ptr)))
+	{
+		// Nothing after a broken frame can be trusted.
+		apng_failed = true;
+		goto done;
+	}
 
 	for (y = 0; y < height; y++)
 	{
-		row_pointers[y] = malloc(pitch * sizeof(png_byte));
+		row_pointers[y] = rows + (y * pitch);
 		for (x = 0; x < width; x++)
-			row_pointers[y][x] = png_buf[x * downscale];
-		png_buf += pitch * (downscale * downscale);
-	}
-		//for (x = 0; x < width; x++)
-		//{
-		//	printf("%d", x);
-		//	row_pointers[y][x] = 0;
-		//}
-	/*	row_pointers[y] = calloc(1, sizeof(png_bytep));
-		png_buf += pitch * 2;
-	}*/
+			for (c = 0; c < bpp; c++)
+				row_pointers[y][x*bpp + c] = png_buf[(x * apng_scale)*bpp + c];
+		png_buf += (apng_width * bpp) * apng_scale;
+	}
 
 #ifndef PNG_STATIC
 	if (aPNG_write_frame_head)
@@ -1075,7 +1125,7 @@ static void M_PNGFrame(png_structp png_ptr, png_infop png_info_ptr, png_bytep pn
 			height,    /* height */
 			0,         /* x offset */
 			0,         /* y offset */
-			framedelay, TICRATE,/* delay numerator and denominator */
+			frame->delay, TICRATE,/* delay numerator and denominator */
 			PNG_DISPOSE_OP_BACKGROUND, /* dispose */
 			PNG_BLEND_OP_SOURCE        /* blend */
 		                     );
@@ -1087,7 +1137,131 @@ static void M_PNGFrame(png_structp png_ptr, png_infop png_info_ptr, png_bytep pn
 #endif
 		aPNG_write_frame_tail(apng_ptr, apng_info_ptr);
 
-	png_free(png_ptr, (png_voidp)row_pointers);
+	apng_frames++;
+
+done:
+	free(rows);
+	free(row_pointers);
+	free(frame->data);
+	frame->data = NULL;
+}
+
+#ifdef HAVE_THREADS
+static void M_APNGThread(void *userdata)
+{
+	(void)userdata;
+
+	for (;;)
+	{
+		apngframe_t *frame;
+
+		I_lock_mutex(&apng_mutex);
+		{
+			if (!apng_queued)
+			{
+				apng_writing = false;
+				I_wake_all_cond(&apng_cond);
+				I_unlock_mutex(apng_mutex);
+				return;
+			}
+			frame = &apng_queue[apng_queuehead];
+		}
+		I_unlock_mutex(apng_mutex);
+
+		M_PNGFrame(apng_ptr, apng_info_ptr, frame);
+
+		I_lock_mutex(&apng_mutex);
+		{
+			apng_queuehead = (apng_queuehead + 1) % APNG_QUEUESIZE;
+			apng_queued--;
+		}
+		I_unlock_mutex(apng_mutex);
+	}
+}
+#endif
+
+// Waits for every queued frame to be written.
+static void M_WaitAPNG(void)
+{
+#ifdef HAVE_THREADS
+	I_lock_mutex(&apng_mutex);
+	{
+		while (apng_writing)
+			I_hold_cond(&apng_cond, apng_mutex);
+	}
+	I_unlock_mutex(apng_mutex);
+#endif
+}
+
+// Copies the screen for M_PNGFrame. The game only waits
+// for the copy; the frame is compressed afterwards.
+static void M_QueueAPNGFrame(void)
+{
+	apngframe_t *frame;
+	png_uint_16 delay = (png_uint_16)cv_apng_delay.value;
+
+	// The header has the old size, so this frame can't go in.
+	if (vid.width != apng_width || vid.height != apng_height)
+		return;
+
+	apng_captured++;
+
+#ifdef HAVE_THREADS
+	if (!I_thread_is_stopped())
+	{
+		I_lock_mutex(&apng_mutex);
+		{
+			if (apng_queued == APNG_QUEUESIZE)
+			{
+				// Compression can't keep up. Show the newest
+				// queued frame for longer instead of waiting.
+				frame = &apng_queue[(apng_queuehead + apng_queued - 1) % APNG_QUEUESIZE];
+				frame->delay = (png_uint_16)min(frame->delay + delay, UINT16_MAX);
+				apng_merged++;
+				I_unlock_mutex(apng_mutex);
+				return;
+			}
+			frame = &apng_queue[(apng_queuehead + apng_queued) % APNG_QUEUESIZE];
+		}
+		I_unlock_mutex(apng_mutex);
+	}
+	else
+#endif
+		frame = &apng_queue[apng_queuehead];
+
+	frame->delay = delay;
+	frame->data = NULL;
+	if (rendermode == render_soft)
+	{
+		frame->data = malloc(vid.width * vid.height);
+		if (frame->data)
+			I_ReadScreen(frame->data);
+	}
+#ifdef HWRENDER
+	else
+		frame->data = HWR_GetScreenshot();
+#endif
+
+	if (!frame->data)
+		return;
+
+#ifdef HAVE_THREADS
+	if (!I_thread_is_stopped())
+	{
+		I_lock_mutex(&apng_mutex);
+		{
+			apng_queued++;
+			if (!apng_writing)
+			{
+				apng_writing = true;
+				I_spawn_thread("apng-write", M_APNGThread, NULL);
+			}
+		}
+		I_unlock_mutex(apng_mutex);
+		return;
+	}
+#endif
+	M_PNGFrame(apng_ptr, apng_info_ptr, frame);
 }
 
 static void M_PNGfix_acTL(png_structp png_ptr, png_infop png_info_ptr,
@@ -1103,6 +1277,7 @@ static void M_PNGfix_acTL(png_structp png_ptr, png_infop png_info_ptr,
 static boolean M_SetupaPNG(png_const_charp filename, png_bytep pal)
 {
 	png_uint_16 downscale;
+	pngtextinfo_t textinfo;
 
 	apng_downscale = (!!cv_apng_downscale.value);
 
@@ -1160,7 +1335,8 @@ static boolean M_SetupaPNG(png_const_charp filename, png_bytep pal)
 
 	M_PNGhdr(apng_ptr, apng_info_ptr, vid.width / downscale, vid.height / downscale, pal);
 
-	M_PNGText(apng_ptr, apng_info_ptr, true);
+	M_PNGTextInfo(&textinfo);
+	M_PNGText(apng_ptr, apng_info_ptr, &textinfo, true);
 
 	apng_set_set_acTL_fn(apng_ptr, apng_ainfo_ptr, aPNG_set_acTL);
 
@@ -1168,7 +1344,15 @@ static boolean M_SetupaPNG(png_const_charp filename, png_bytep pal)
 
 	apng_write_info(apng_ptr, apng_info_ptr, apng_ainfo_ptr);
 
-	apng_frames = 0;
+	// From here on the frames may be written on another thread.
+	png_set_error_fn(apng_ptr, NULL, PNG_threaderror, NULL);
+
+	apng_frames = apng_captured = apng_merged = 0;
+	apng_failed = false;
+	apng_width = vid.width;
+	apng_height = vid.height;
+	apng_scale = downscale;
+	apng_queuehead = apng_queued = 0;
 
 	return true;
 }
@@ -1320,30 +1504,15 @@ void M_SaveFrame(void)
 		case MM_APNG:
 #ifdef USE_APNG
 			{
-				UINT8 *linear = NULL;
 				if (!apng_FILE) // should not happen!!
 				{
 					moviemode = MM_OFF;
 					return;
 				}
 
-				if (rendermode == render_soft)
-				{
-					// munge planar buffer to linear
-					linear = screens[2];
-					I_ReadScreen(linear);
-				}
-#ifdef HWRENDER
-				else
-					linear = HWR_GetScreenshot();
-#endif
-				M_PNGFrame(apng_ptr, apng_info_ptr, (png_bytep)linear);
-#ifdef HWRENDER
-				if (rendermode != render_soft && linear)
-					free(linear);
-#endif
+				M_QueueAPNGFrame();
 
-				if (apng_frames == PNG_UINT_31_MAX)
+				if (apng_captured == PNG_UINT_31_MAX)
 				{
 					CONS_Alert(CONS_NOTICE, M_GetText("Max movie size reached\n"));
 					M_StopMovie();
@@ -1373,17 +1542,28 @@ void M_StopMovie(void)
 			if (!apng_FILE)
 				return;
 
-			if (apng_frames)
+			M_WaitAPNG();
+
+			if (apng_frames && !apng_failed)
 			{
-				M_PNGfix_acTL(apng_ptr, apng_info_ptr, apng_ainfo_ptr);
-				apng_write_end(apng_ptr, apng_info_ptr, apng_ainfo_ptr);
+				if (!setjmp(png_jmpbuf(apng_ptr)))
+				{
+					M_PNGfix_acTL(apng_ptr, apng_info_ptr, apng_ainfo_ptr);
+					apng_write_end(apng_ptr, apng_info_ptr, apng_ainfo_ptr);
+				}
+				else
+					apng_failed = true;
 			}
 
 			png_destroy_write_struct(&apng_ptr, &apng_info_ptr);
 
 			fclose(apng_FILE);
 			apng_FILE = NULL;
+			if (apng_failed)
+				CONS_Alert(CONS_ERROR, "aPNG write error; the file is incomplete\n");
 			CONS_Printf("aPNG closed; wrote %u frames\n", (UINT32)apng_frames);
+			if (apng_merged)
+				CONS_Printf("%u frames were merged into the previous one to keep up\n", (UINT32)apng_merged);
 			apng_frames = 0;
 			break;
 #else
@@ -1402,51 +1582,72 @@ void M_StopMovie(void)
 // ==========================================================================
 //                            SCREEN SHOTS
 // ==========================================================================
+#if NUMSCREENS > 2
+static void M_ScreenShotResult(boolean ok, const char *freename, const char *pathname);
+#endif
+
 #ifdef USE_PNG
-/** Writes a PNG file to disk.
-  *
-  * \param filename Filename to write to.
-  * \param data     The image data.
-  * \param width    Width of the picture.
-  * \param height   Height of the picture.
-  * \param palette  Palette of image data.
-  *  \note if palette is NULL, BGR888 format
+/** Everything needed to write out a PNG, taken
+  * when the picture is so it can be written later.
   */
-boolean M_SavePNG(const char *filename, void *data, int width, int height, const UINT8 *palette)
+typedef struct
+{
+	png_FILE_p file;
+	char filename[MAX_WADPATH];
+	png_bytep data;
+	int width, height;
+	UINT8 palette[768];
+	boolean paletted;
+	INT32 level, memory, strategy, windowbits;
+	pngtextinfo_t textinfo;
+} pngjob_t;
+
+static void M_SetupPNGJob(pngjob_t *job, const char *filename, void *data, int width, int height, const UINT8 *palette)
+{
+	strlcpy(job->filename, filename, sizeof job->filename);
+	job->data = data;
+	job->width = width;
+	job->height = height;
+	job->paletted = (palette != NULL);
+	if (palette)
+		M_Memcpy(job->palette, palette, sizeof job->palette);
+
+	job->level = cv_zlib_level.value;
+	job->memory = cv_zlib_memory.value;
+	job->strategy = cv_zlib_strategy.value;
+	job->windowbits = cv_zlib_window_bits.value;
+
+	M_PNGTextInfo(&job->textinfo);
+}
+
+/** Writes out a PNG to the job's open file, closing it.
+  * The file is removed if anything goes wrong.
+  */
+static boolean M_WritePNG(pngjob_t *job, png_error_ptr error_fn, png_error_ptr warn_fn)
 {
 	png_structp png_ptr;
 	png_infop png_info_ptr;
-	PNG_CONST png_byte *PLTE = (const png_byte *)palette;
+	PNG_CONST png_byte *PLTE = job->paletted ? (const png_byte *)job->palette : NULL;
 #ifdef PNG_SETJMP_SUPPORTED
 #ifdef USE_FAR_KEYWORD
 	jmp_buf jmpbuf;
 #endif
 #endif
-	png_FILE_p png_FILE;
 
-	png_FILE = fopen(filename,"wb");
-	if (!png_FILE)
-	{
-		CONS_Debug(DBG_RENDER, "M_SavePNG: Error on opening %s for write\n", filename);
-		return false;
-	}
-
-	png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, PNG_error, PNG_warn);
+	png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, error_fn, warn_fn);
 	if (!png_ptr)
 	{
-		CONS_Debug(DBG_RENDER, "M_SavePNG: Error on initialize libpng\n");
-		fclose(png_FILE);
-		remove(filename);
+		fclose(job->file);
+		remove(job->filename);
 		return false;
 	}
 
 	png_info_ptr = png_create_info_struct(png_ptr);
 	if (!png_info_ptr)
 	{
-		CONS_Debug(DBG_RENDER, "M_SavePNG: Error on allocate for libpng\n");
 		png_destroy_write_struct(&png_ptr,  NULL);
-		fclose(png_FILE);
-		remove(filename);
+		fclose(job->file);
+		remove(job->filename);
 		return false;
 	}
 
@@ -1456,16 +1657,15 @@ boolean M_SavePNG(const char *filename, void *data, int width, int height, const
 	if (setjmp(png_jmpbuf(png_ptr)))
 #endif
 	{
-		//CONS_Debug(DBG_RENDER, "libpng write error on %s\n", filename);
 		png_destroy_write_struct(&png_ptr, &png_info_ptr);
-		fclose(png_FILE);
-		remove(filename);
+		fclose(job->file);
+		remove(job->filename);
 		return false;
 	}
 #ifdef USE_FAR_KEYWORD
 	png_memcpy(png_jmpbuf(png_ptr),jmpbuf, sizeof (jmp_buf));
 #endif
-	png_init_io(png_ptr, png_FILE);
+	png_init_io(png_ptr, job->file);
 
 #ifdef PNG_SET_USER_LIMITS_SUPPORTED
 	png_set_user_limits(png_ptr, MAXVIDWIDTH, MAXVIDHEIGHT);
@@ -1473,25 +1673,186 @@ boolean M_SavePNG(const char *filename, void *data, int width, int height, const
 
 	//png_set_filter(png_ptr, 0, PNG_ALL_FILTERS);
 
-	png_set_compression_level(png_ptr, cv_zlib_level.value);
-	png_set_compression_mem_level(png_ptr, cv_zlib_memory.value);
-	png_set_compression_strategy(png_ptr, cv_zlib_strategy.value);
-	png_set_compression_window_bits(png_ptr, cv_zlib_window_bits.value);
+	png_set_compression_level(png_ptr, job->level);
+	png_set_compression_mem_level(png_ptr, job->memory);
+	png_set_compression_strategy(png_ptr, job->strategy);
+	png_set_compression_window_bits(png_ptr, job->windowbits);
 
-	M_PNGhdr(png_ptr, png_info_ptr, width, height, PLTE);
+	M_PNGhdr(png_ptr, png_info_ptr, job->width, job->height, PLTE);
 
-	M_PNGText(png_ptr, png_info_ptr, false);
+	M_PNGText(png_ptr, png_info_ptr, &job->textinfo, false);
 
 	png_write_info(png_ptr, png_info_ptr);
 
-	M_PNGImage(png_ptr, png_info_ptr, height, data);
+	M_PNGImage(png_ptr, png_info_ptr, job->height, job->data);
 
 	png_write_end(png_ptr, png_info_ptr);
 	png_destroy_write_struct(&png_ptr, &png_info_ptr);
 
-	fclose(png_FILE);
+	fclose(job->file);
 	return true;
 }
+
+/** Writes a PNG file to disk.
+  *
+  * \param filename Filename to write to.
+  * \param data     The image data.
+  * \param width    Width of the picture.
+  * \param height   Height of the picture.
+  * \param palette  Palette of image data.
+  *  \note if palette is NULL, BGR888 format
+  */
+boolean M_SavePNG(const char *filename, void *data, int width, int height, const UINT8 *palette)
+{
+	pngjob_t job;
+
+	job.file = fopen(filename,"wb");
+	if (!job.file)
+	{
+		CONS_Debug(DBG_RENDER, "M_SavePNG: Error on opening %s for write\n", filename);
+		return false;
+	}
+
+	M_SetupPNGJob(&job, filename, data, width, height, palette);
+
+	if (!M_WritePNG(&job, PNG_error, PNG_warn))
+	{
+		CONS_Debug(DBG_RENDER, "M_SavePNG: Error on writing %s\n", filename);
+		return false;
+	}
+	return true;
+}
+
+#if NUMSCREENS > 2
+// Screenshots are copied by M_DoScreenShot and compressed in the
+// background, up to SCREENSHOT_JOBS at a time. M_UpdateScreenShots
+// reports them once they're done.
+#define SCREENSHOT_JOBS 4
+
+typedef enum
+{
+	SSJ_FREE,
+	SSJ_WRITING,
+	SSJ_DONE
+} screenshotstate_t;
+
+typedef struct
+{
+	pngjob_t png;
+	char freename[13];
+	char pathname[MAX_WADPATH];
+	screenshotstate_t state;
+	boolean ok;
+} screenshotjob_t;
+
+static screenshotjob_t screenshotjobs[SCREENSHOT_JOBS];
+
+#ifdef HAVE_THREADS
+static I_mutex screenshot_mutex;
+static I_cond screenshot_cond;
+#endif
+
+static void M_ScreenShotThread(screenshotjob_t *job)
+{
+	boolean ok = M_WritePNG(&job->png, PNG_threaderror, NULL);
+
+	free(job->png.data);
+	job->png.data = NULL;
+
+#ifdef HAVE_THREADS
+	I_lock_mutex(&screenshot_mutex);
+#endif
+	{
+		job->ok = ok;
+		job->state = SSJ_DONE;
+#ifdef HAVE_THREADS
+		I_wake_all_cond(&screenshot_cond);
+#endif
+	}
+#ifdef HAVE_THREADS
+	I_unlock_mutex(screenshot_mutex);
+#endif
+}
+
+// Finds a free job, waiting for one to finish if there are none.
+static screenshotjob_t *M_GetScreenShotJob(void)
+{
+	INT32 i;
+
+	for (;;)
+	{
+		M_UpdateScreenShots();
+
+		for (i = 0; i < SCREENSHOT_JOBS; i++)
+			if (screenshotjobs[i].state == SSJ_FREE)
+				return &screenshotjobs[i];
+
+#ifdef HAVE_THREADS
+		I_lock_mutex(&screenshot_mutex);
+		{
+			for (i = 0; i < SCREENSHOT_JOBS; i++)
+				if (screenshotjobs[i].state == SSJ_DONE)
+					break;
+			if (i == SCREENSHOT_JOBS)
+				I_hold_cond(&screenshot_cond, screenshot_mutex);
+		}
+		I_unlock_mutex(screenshot_mutex);
+#endif
+	}
+}
+
+/** Copies the screen and starts writing it out as a PNG.
+  * Returns false if the screenshot couldn't be started.
+  */
+static boolean M_QueueScreenShot(const char *pathname, const char *freename)
+{
+	screenshotjob_t *job = M_GetScreenShotJob();
+	const char *filename = va(pandf,pathname,freename);
+	png_bytep linear = NULL;
+	UINT8 *palette = NULL;
+
+	// Opening the file now keeps the next screenshot from taking its name.
+	job->png.file = fopen(filename, "wb");
+	if (!job->png.file)
+		return false;
+
+	if (rendermode == render_soft)
+	{
+		linear = malloc(vid.width * vid.height);
+		if (linear)
+			I_ReadScreen(linear);
+		M_CreateScreenShotPalette();
+		palette = screenshot_palette;
+	}
+#ifdef HWRENDER
+	else if (rendermode == render_opengl)
+		linear = HWR_GetScreenshot();
+#endif
+
+	if (!linear)
+	{
+		fclose(job->png.file);
+		remove(filename);
+		return false;
+	}
+
+	M_SetupPNGJob(&job->png, filename, linear, vid.width, vid.height, palette);
+	strlcpy(job->freename, freename, sizeof job->freename);
+	strlcpy(job->pathname, pathname, sizeof job->pathname);
+	job->state = SSJ_WRITING;
+
+#ifdef HAVE_THREADS
+	if (!I_thread_is_stopped())
+	{
+		I_spawn_thread("png-write", (I_thread_fn)M_ScreenShotThread, job);
+		return true;
+	}
+#endif
+	M_ScreenShotThread(job);
+	M_UpdateScreenShots();
+	return true;
+}
+#endif
 #else
 /** PCX file structure.
   */
@@ -1604,7 +1965,9 @@ void M_DoScreenShot(void)
 	const char *freename = NULL;
 	char pathname[MAX_WADPATH];
 	boolean ret = false;
+#ifndef USE_PNG
 	UINT8 *linear = NULL;
+#endif
 
 	// Don't take multiple screenshots, obviously
 	takescreenshot = false;
@@ -1630,12 +1993,15 @@ void M_DoScreenShot(void)
 
 #ifdef USE_PNG
 	freename = Newsnapshotfile(pathname,"png");
+
+	// written in the background, and reported by M_UpdateScreenShots
+	if (freename && M_QueueScreenShot(pathname, freename))
+		return;
 #else
 	if (rendermode == render_soft)
 		freename = Newsnapshotfile(pathname,"pcx");
 	else if (rendermode == render_opengl)
 		freename = Newsnapshotfile(pathname,"tga");
-#endif
 
 	if (rendermode == render_soft)
 	{
@@ -1655,15 +2021,19 @@ void M_DoScreenShot(void)
 #endif
 	{
 		M_CreateScreenShotPalette();
-#ifdef USE_PNG
-		ret = M_SavePNG(va(pandf,pathname,freename), linear, vid.width, vid.height, screenshot_palette);
-#else
 		ret = WritePCXfile(va(pandf,pathname,freename), linear, vid.width, vid.height, screenshot_palette);
-#endif
 	}
 
 failure:
-	if (ret)
+#endif
+	M_ScreenShotResult(ret, freename, pathname);
+#endif
+}
+
+#if NUMSCREENS > 2
+static void M_ScreenShotResult(boolean ok, const char *freename, const char *pathname)
+{
+	if (ok)
 	{
 		if (moviemode != MM_SCREENSHOT)
 			CONS_Printf(M_GetText("Screen shot %s saved in %s\n"), freename, pathname);
@@ -1678,7 +2048,68 @@ failure:
 		if (moviemode == MM_SCREENSHOT)
 			M_StopMovie();
 	}
+}
+#endif
+
+/** Reports the screenshots that have finished being written.
+  */
+void M_UpdateScreenShots(void)
+{
+#if NUMSCREENS > 2 && defined (USE_PNG)
+	INT32 i;
+
+	for (i = 0; i < SCREENSHOT_JOBS; i++)
+	{
+		screenshotjob_t *job = &screenshotjobs[i];
+		boolean done;
+
+#ifdef HAVE_THREADS
+		I_lock_mutex(&screenshot_mutex);
+#endif
+		done = (job->state == SSJ_DONE);
+#ifdef HAVE_THREADS
+		I_unlock_mutex(screenshot_mutex);
+#endif
+
+		if (done)
+		{
+			// Free first, M_StopMovie might be called.
+			job->state = SSJ_FREE;
+			M_ScreenShotResult(job->ok, job->freename, job->pathname);
+		}
+	}
+#endif
+}
+
+/** Counts the screenshots and movie frames still waiting to be
+  * compressed and written, for perfstats.
+  */
+INT32 M_PendingCaptures(void)
+{
+	INT32 pending = 0;
+#if NUMSCREENS > 2 && defined (USE_PNG)
+	INT32 i;
+
+#ifdef HAVE_THREADS
+	I_lock_mutex(&screenshot_mutex);
+#endif
+	for (i = 0; i < SCREENSHOT_JOBS; i++)
+		if (screenshotjobs[i].state == SSJ_WRITING)
+			pending++;
+#ifdef HAVE_THREADS
+	I_unlock_mutex(screenshot_mutex);
+#endif
+#endif
+#ifdef USE_APNG
+#ifdef HAVE_THREADS
+	I_lock_mutex(&apng_mutex);
+#endif
+	pending += apng_queued;
+#ifdef HAVE_THREADS
+	I_unlock_mutex(apng_mutex);
+#endif
 #endif
+	return pending;
 }
 
 boolean M_ScreenshotResponder(event_t *ev)
@@ -75,6 +75,8 @@ boolean M_SavePNG(const char *filename, void *data, int width, int height, const
 extern boolean takescreenshot;
 void M_ScreenShot(void);
 void M_DoScreenShot(void);
+void M_UpdateScreenShots(void);
+INT32 M_PendingCaptures(void);
 boolean M_ScreenshotResponder(event_t *ev);
 
 void Command_SaveConfig_f(void);
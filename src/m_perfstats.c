@@ -18,6 +18,7 @@
 #include "z_zone.h"
 #include "p_local.h"
 #include "r_fps.h"
+#include "m_misc.h" // M_PendingCaptures
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -70,6 +71,8 @@ ps_metric_t ps_lua_mobjhooks = {0};
 
 ps_metric_t ps_otherlogictime = {0};
 
+static ps_metric_t ps_capturequeue = {0};
+
 // Columns for perfstats pages.
 
 // Position on screen is determined separately in the drawing functions.
@@ -101,6 +104,8 @@ perfstatrow_t rendertime_rows[] = {
 	{" bsptime", " RenderBSPNode: ", &ps_bsptime, PS_TIME|PS_LEVEL|PS_SW},
 	{" sprclip", " R_ClipSprites: ", &ps_sw_spritecliptime, PS_TIME|PS_LEVEL|PS_SW},
 	{" portals", " Portals+Skybox:", &ps_sw_portaltime, PS_TIME|PS_LEVEL|PS_SW},
+	{"  skybox ", "  Skybox:        ", &ps_sw_skyboxtime, PS_TIME|PS_LEVEL|PS_SW},
+	{"  slowest", "  Slowest portal:", &ps_sw_maxportaltime, PS_TIME|PS_LEVEL|PS_SW},
 	{" planes ", " R_DrawPlanes:  ", &ps_sw_planetime, PS_TIME|PS_LEVEL|PS_SW},
 	{" masked ", " R_DrawMasked:  ", &ps_sw_maskedtime, PS_TIME|PS_LEVEL|PS_SW},
 	{" other  ", " Other:         ", &ps_otherrendertime, PS_TIME|PS_LEVEL|PS_SW},
@@ -115,11 +120,18 @@ perfstatrow_t gamelogicbrief_row[] = {
 	{0}
 };
 
+perfstatrow_t capture_rows[] = {
+	{"capture", "Capture queue: ", &ps_capturequeue, PS_HIDE_ZERO},
+	{0}
+};
+
 perfstatrow_t commoncounter_rows[] = {
 	{"bspcall", "BSP calls:   ", &ps_numbspcalls, 0},
 	{"sprites", "Sprites:     ", &ps_numsprites, 0},
 	{"drwnode", "Drawnodes:   ", &ps_numdrawnodes, 0},
 	{"plyobjs", "Polyobjects: ", &ps_numpolyobjects, 0},
+	{"portals", "Portals:     ", &ps_sw_numportals, PS_SW},
+	{"prtcull", "Culled prtls:", &ps_sw_numportalsculled, PS_SW},
 	{0}
 };
 
@@ -440,6 +452,9 @@ static void PS_UpdateFrameStats(void)
 	ps_frametime.value.p = currenttime - ps_prevframetime;
 	ps_prevframetime = currenttime;
 
+	// screenshots and movie frames still being compressed
+	ps_capturequeue.value.i = M_PendingCaptures();
+
 	// update 3d rendering stats
 	if (PS_IsLevelActive())
 	{
@@ -477,6 +492,7 @@ static void PS_UpdateFrameStats(void)
 	if (cv_ps_samplesize.value > 1)
 	{
 		PS_UpdateRowHistories(rendertime_rows, true);
+		PS_UpdateRowHistories(capture_rows, true);
 		if (PS_IsLevelActive())
 			PS_UpdateRowHistories(commoncounter_rows, true);
 
@@ -650,7 +666,9 @@ static void PS_DrawRenderStats(void)
 
 	y = PS_DrawPerfRows(20, 10, V_YELLOWMAP, rendertime_rows);
 
-	PS_DrawPerfRows(20, y + half_row, V_GRAYMAP, gamelogicbrief_row);
+	y = PS_DrawPerfRows(20, y + half_row, V_GRAYMAP, gamelogicbrief_row);
+
+	PS_DrawPerfRows(20, y, V_GRAYMAP, capture_rows);
 
 	if (PS_IsLevelActive())
 	{
@@ -3919,18 +3919,12 @@ static mobj_t *P_FindBossFlyPoint(mobj_t *mo, INT32 tag)
 
 static void P_DoBossVictory(mobj_t *mo)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	INT32 i;
 
-	// scan the remaining thinkers to see if all bosses are dead
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	// scan the remaining targets to see if all bosses are dead
+	for (mo2 = mobjtargetregistry.head; mo2; mo2 = mo2->targetnext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
 		if (mo2 == mo)
 			continue;
 
@@ -8829,7 +8823,6 @@ void A_FindTarget(mobj_t *actor)
 	INT32 locvar1 = var1;
 	INT32 locvar2 = var2;
 	mobj_t *targetedmobj = NULL;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist1 = 0, dist2 = 0;
 
@@ -8839,33 +8832,25 @@ void A_FindTarget(mobj_t *actor)
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTarget called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
 	// scan the thinkers
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(locvar1); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)locvar1)
+		if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
+			continue; // Ignore spectators
+		if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
+			continue; // Ignore dead things
+		if (targetedmobj == NULL)
 		{
-			if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
-				continue; // Ignore spectators
-			if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
-				continue; // Ignore dead things
-			if (targetedmobj == NULL)
+			targetedmobj = mo2;
+			dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+		}
+		else
+		{
+			dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+			if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
 			{
 				targetedmobj = mo2;
-				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-			}
-			else
-			{
-				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-				if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
-				{
-					targetedmobj = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -8893,7 +8878,6 @@ void A_FindTracer(mobj_t *actor)
 	INT32 locvar1 = var1;
 	INT32 locvar2 = var2;
 	mobj_t *targetedmobj = NULL;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist1 = 0, dist2 = 0;
 
@@ -8903,33 +8887,25 @@ void A_FindTracer(mobj_t *actor)
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTracer called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
 	// scan the thinkers
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(locvar1); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == (mobjtype_t)locvar1)
+		if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
+			continue; // Ignore spectators
+		if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
+			continue; // Ignore dead things
+		if (targetedmobj == NULL)
 		{
-			if (mo2->player && (mo2->player->spectator || mo2->player->pflags & PF_INVIS))
-				continue; // Ignore spectators
-			if ((mo2->player || mo2->flags & MF_ENEMY) && mo2->health <= 0)
-				continue; // Ignore dead things
-			if (targetedmobj == NULL)
+			targetedmobj = mo2;
+			dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+		}
+		else
+		{
+			dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+			if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
 			{
 				targetedmobj = mo2;
-				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-			}
-			else
-			{
-				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-				if ((!locvar2 && dist1 < dist2) || (locvar2 && dist1 > dist2))
-				{
-					targetedmobj = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -9241,6 +9217,7 @@ void A_SetObjectFlags(mobj_t *actor)
 	}
 
 	actor->flags = locvar1;
+	P_UpdateMobjRegistries(actor);
 
 	if (unlinkthings)
 		P_SetThingPosition(actor);
@@ -9270,6 +9247,8 @@ void A_SetObjectFlags2(mobj_t *actor)
 		actor->flags2 &= ~locvar1;
 	else
 		actor->flags2 = locvar1;
+
+	P_UpdateMobjRegistries(actor);
 }
 
 // Function: A_BossJetFume
@@ -9543,34 +9522,25 @@ void A_RemoteAction(mobj_t *actor)
 	{
 		///* DO A_FINDTARGET STUFF *///
 		mobj_t *targetedmobj = NULL;
-		thinker_t *th;
 		mobj_t *mo2;
 		fixed_t dist1 = 0, dist2 = 0;
 
 		// scan the thinkers
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = P_FirstMobjOfType(locvar1); mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type == (mobjtype_t)locvar1)
+			if (targetedmobj == NULL)
+			{
+				targetedmobj = mo2;
+				dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+			}
+			else
 			{
-				if (targetedmobj == NULL)
+				dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
+
+				if ((locvar2 && dist1 < dist2) || (!locvar2 && dist1 > dist2))
 				{
 					targetedmobj = mo2;
-					dist2 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-				}
-				else
-				{
-					dist1 = R_PointToDist2(actor->x, actor->y, mo2->x, mo2->y);
-
-					if ((locvar2 && dist1 < dist2) || (!locvar2 && dist1 > dist2))
-					{
-						targetedmobj = mo2;
-						dist2 = dist1;
-					}
+					dist2 = dist1;
 				}
 			}
 		}
@@ -9800,33 +9770,24 @@ void A_SetObjectTypeState(mobj_t *actor)
 	const UINT16 loc2lw = (UINT16)(locvar2 & 65535);
 	const UINT16 loc2up = (UINT16)(locvar2 >> 16);
 
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist = 0;
 
 	if (LUA_CallAction(A_SETOBJECTTYPESTATE, actor))
 		return;
 
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(loc2lw); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
+		dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
 
-		if (mo2->type == (mobjtype_t)loc2lw)
+		if (mo2->health > 0)
 		{
-			dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
-
-			if (mo2->health > 0)
+			if (loc2up == 0)
+				P_SetMobjState(mo2, locvar1);
+			else
 			{
-				if (loc2up == 0)
+				if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
 					P_SetMobjState(mo2, locvar1);
-				else
-				{
-					if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
-						P_SetMobjState(mo2, locvar1);
-				}
 			}
 		}
 	}
@@ -10430,31 +10391,22 @@ void A_CheckThingCount(mobj_t *actor)
 	const UINT16 loc2up = (UINT16)(locvar2 >> 16);
 
 	INT32 count = 0;
-	thinker_t *th;
 	mobj_t *mo2;
 	fixed_t dist = 0;
 
 	if (LUA_CallAction(A_CHECKTHINGCOUNT, actor))
 		return;
 
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = P_FirstMobjOfType(loc1up); mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
+		dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
 
-		if (mo2->type == (mobjtype_t)loc1up)
+		if (loc2up == 0)
+			count++;
+		else
 		{
-			dist = P_AproxDistance(mo2->x - actor->x, mo2->y - actor->y);
-
-			if (loc2up == 0)
+			if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
 				count++;
-			else
-			{
-				if (dist <= FixedMul(loc2up*FRACUNIT, actor->scale))
-					count++;
-			}
 		}
 	}
 
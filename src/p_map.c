@@ -4355,6 +4355,10 @@ static boolean P_CheckSectorPolyObjects(sector_t *sector, boolean realcrush, boo
 {
 	size_t i;
 
+	// No polyobjects, nothing to look for among the sector's lines.
+	if (!numPolyObjects)
+		return true;
+
 	// Sal: This stupid function chain is required to fix polyobjects not being able to crush.
 	// Monster Iestyn: don't use P_CheckSector actually just look for objects in the blockmap instead
 	validcount++;
@@ -4403,38 +4407,70 @@ static boolean P_CheckSectorPolyObjects(sector_t *sector, boolean realcrush, boo
 	return true;
 }
 
+// Bumped whenever a node joins or leaves a sector's touching_thinglist, and
+// whenever P_CheckTouchingThinglist resets the visited marks.
+static UINT32 thinglistchanges = 0;
+
 static boolean P_CheckTouchingThinglist(sector_t *sector, boolean realcrush, boolean crunch)
 {
 	msecnode_t *n;
+	UINT32 changes;
+
+	thinglistchanges++;
 
 	for (n = sector->touching_thinglist; n; n = n->m_thinglist_next)
 		n->visited = false;
 
-	do
+	n = sector->touching_thinglist;
+	while (n) // go through list
 	{
-		for (n = sector->touching_thinglist; n; n = n->m_thinglist_next) // go through list
+		if (n->visited)
 		{
-			if (n->visited)
-				continue;
+			n = n->m_thinglist_next;
+			continue;
+		}
 
-			n->visited = true; // mark thing as processed
+		n->visited = true; // mark thing as processed
 
-			if (n->m_thing->flags & MF_NOBLOCKMAP) //jff 4/7/98 don't do these
-				continue;
+		if (n->m_thing->flags & MF_NOBLOCKMAP) //jff 4/7/98 don't do these
+		{
+			n = n->m_thinglist_next;
+			continue;
+		}
 
-			if (!PIT_ChangeSector(n->m_thing, realcrush, crunch) && !realcrush) // process it
-				return false;
+		changes = thinglistchanges;
 
-			break; // exit and start over
-		}
-	} while (n); // repeat from scratch until all things left are marked valid
+		if (!PIT_ChangeSector(n->m_thing, realcrush, crunch) && !realcrush) // process it
+			return false;
+
+		// Start over if any list (or the marks on it) changed while processing;
+		// if not, everything up to here is already marked and the next
+		// unvisited node can only come after this one.
+		if (thinglistchanges == changes)
+			n = n->m_thinglist_next;
+		else
+			n = sector->touching_thinglist;
+	}
 
 	return true;
 }
 
+// Marks the sectors this sector's FOFs appear in as moved, and updates
+// their precipitation. That only depends on the plane heights, so once
+// for both passes of P_CheckSector is enough.
+static void P_RecalcAttachedSectors(sector_t *sector)
+{
+	size_t i;
+
+	for (i = 0; i < sector->numattached; i++)
+	{
+		sectors[sector->attached[i]].moved = true;
+		P_RecalcPrecipInSector(&sectors[sector->attached[i]]);
+	}
+}
+
 static boolean P_CheckSectorFFloors(sector_t *sector, boolean realcrush, boolean crunch)
 {
-	sector_t *sec;
 	size_t i;
 
 	if (!sector->numattached)
@@ -4442,16 +4478,10 @@ static boolean P_CheckSectorFFloors(sector_t *sector, boolean realcrush, boolean
 
 	for (i = 0; i < sector->numattached; i++)
 	{
-		sec = &sectors[sector->attached[i]];
-
-		sec->moved = true;
-
-		P_RecalcPrecipInSector(sec);
-
 		if (!sector->attachedsolid[i])
 			continue;
 
-		if (!P_CheckTouchingThinglist(sec, realcrush, crunch))
+		if (!P_CheckTouchingThinglist(&sectors[sector->attached[i]], realcrush, crunch))
 			return false;
 	}
 
@@ -4485,6 +4515,8 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 	//
 	// killough 4/7/98: simplified to avoid using complicated counter
 
+	P_RecalcAttachedSectors(sector);
+
 	// First, let's see if anything will keep it from crushing.
 	if (!P_CheckSectorHelper(sector, false, crunch))
 		return true;
@@ -4597,6 +4629,7 @@ static msecnode_t *P_AddSecnode(sector_t *s, mobj_t *thing, msecnode_t *nextnode
 	if (s->touching_thinglist)
 		node->m_thinglist_next->m_thinglist_prev = node;
 	s->touching_thinglist = node;
+	thinglistchanges++;
 	return node;
 }
 
@@ -4676,6 +4709,7 @@ static msecnode_t *P_DelSecnode(msecnode_t *node)
 		node->m_sector->touching_thinglist = sn;
 	if (sn)
 		sn->m_thinglist_prev = sp;
+	thinglistchanges++;
 
 	// Return this node to the freelist
 
@@ -4811,10 +4845,150 @@ static inline boolean PIT_GetPrecipSectors(line_t *ld)
 	return true;
 }
 
-// P_CreateSecNodeList alters/creates the sector_list that shows what sectors
-// the object resides in.
+// Most things spend most of their time well inside a single sector, where
+// the full rebuild below always ends with the same one-node list. So when
+// a rebuild finds a thing touching nothing but the sector it is in, it also
+// works out how far the bounding box could move before it might reach a
+// line bordering another sector, and stores that in the mobj. Until the
+// thing has moved that far, its list is known to be unchanged.
 
-void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
+#define SECNODEMARGIN (64*FRACUNIT) // how far beyond the bounding box to look for lines
+
+static sector_t *clearsector; // sector the thing is in
+static INT64 clearance; // how far tmbbox can move
+
+// PIT_GetSecNodeClearance
+// Limits clearance to how far tmbbox can move without crossing the line,
+// if the line borders any sector other than clearsector.
+static boolean PIT_GetSecNodeClearance(line_t *ld)
+{
+	INT64 gap, cross, mincross = -1;
+	INT32 ldx = 0, ldy = 0;
+	boolean side = false;
+	INT32 i;
+
+	if (ld->polyobj) // PIT_GetSectors ignores these as well
+		return true;
+
+	if (ld->frontsector == clearsector && (!ld->backsector || ld->backsector == clearsector))
+		return true;
+
+	// Bounding boxes that are apart have to close the gap along both axes.
+	gap = max((INT64)ld->bbox[BOXLEFT] - tmbbox[BOXRIGHT], (INT64)tmbbox[BOXLEFT] - ld->bbox[BOXRIGHT]);
+	gap = max(gap, (INT64)ld->bbox[BOXBOTTOM] - tmbbox[BOXTOP]);
+	gap = max(gap, (INT64)tmbbox[BOXBOTTOM] - ld->bbox[BOXTOP]);
+
+	// The line as P_BoxOnLineSide sees it: diagonal lines have their
+	// direction cut down to whole units by P_PointOnLineSide.
+	if (ld->slopetype != ST_HORIZONTAL && ld->slopetype != ST_VERTICAL)
+	{
+		ldx = ld->dx>>FRACBITS;
+		ldy = ld->dy>>FRACBITS;
+
+		if (!ldx && !ldy) // every point is on the same side
+			return true;
+	}
+
+	// With all corners on one side of the line, the nearest one has to get
+	// to it. Axis-aligned lines are compared against exactly, so that is
+	// just the distance to the line along the other axis.
+	for (i = 0; i < 4; i++)
+	{
+		fixed_t px = tmbbox[(i & 1) ? BOXRIGHT : BOXLEFT];
+		fixed_t py = tmbbox[(i & 2) ? BOXTOP : BOXBOTTOM];
+
+		if (ld->slopetype == ST_HORIZONTAL)
+			cross = (INT64)py - ld->v1->y;
+		else if (ld->slopetype == ST_VERTICAL)
+			cross = (INT64)px - ld->v1->x;
+		else
+			cross = ((INT64)px - ld->v1->x) * ldy - ((INT64)py - ld->v1->y) * ldx;
+
+		if (i && (cross > 0) != side)
+		{
+			mincross = 0;
+			break;
+		}
+
+		side = (cross > 0);
+		if (cross < 0)
+			cross = -cross;
+		if (mincross < 0 || cross < mincross)
+			mincross = cross;
+	}
+
+	// For diagonals, moving at most d along each axis brings a point at
+	// most d * (|ldx| + |ldy|) closer, in these units. P_PointOnLineSide
+	// rounds to within two units either way, so allow for that too.
+	if (ldx || ldy)
+		mincross = (mincross - 2*FRACUNIT) / (abs(ldx) + abs(ldy));
+
+	gap = max(gap, mincross);
+
+	if (gap < clearance)
+		clearance = gap;
+
+	return true;
+}
+
+// Works out and stores the distance thing's bounding box, in tmbbox, can
+// move before its sector list could change, assuming the list is just the
+// sector the thing is in.
+static void P_GetSecNodeClearance(mobj_t *thing, fixed_t x, fixed_t y)
+{
+	INT32 xl, xh, yl, yh, bx, by;
+
+	clearsector = thing->subsector->sector;
+
+	xl = (unsigned)(tmbbox[BOXLEFT] - SECNODEMARGIN - bmaporgx)>>MAPBLOCKSHIFT;
+	xh = (unsigned)(tmbbox[BOXRIGHT] + SECNODEMARGIN - bmaporgx)>>MAPBLOCKSHIFT;
+	yl = (unsigned)(tmbbox[BOXBOTTOM] - SECNODEMARGIN - bmaporgy)>>MAPBLOCKSHIFT;
+	yh = (unsigned)(tmbbox[BOXTOP] + SECNODEMARGIN - bmaporgy)>>MAPBLOCKSHIFT;
+
+	BMBOUNDFIX(xl, xh, yl, yh);
+
+	// Lines outside the blocks looked at are only found once the bounding
+	// box reaches those blocks.
+	clearance = (INT64)tmbbox[BOXLEFT] - ((INT64)bmaporgx + (INT64)xl * MAPBLOCKSIZE);
+	clearance = min(clearance, (INT64)bmaporgx + (INT64)(xh + 1) * MAPBLOCKSIZE - tmbbox[BOXRIGHT]);
+	clearance = min(clearance, (INT64)tmbbox[BOXBOTTOM] - ((INT64)bmaporgy + (INT64)yl * MAPBLOCKSIZE));
+	clearance = min(clearance, (INT64)bmaporgy + (INT64)(yh + 1) * MAPBLOCKSIZE - tmbbox[BOXTOP]);
+
+	validcount++;
+
+	for (bx = xl; bx <= xh; bx++)
+		for (by = yl; by <= yh; by++)
+			P_BlockLinesIterator(bx, by, PIT_GetSecNodeClearance);
+
+	thing->secnodex = x;
+	thing->secnodey = y;
+	thing->secnoderadius = thing->radius;
+	thing->secnodeclear = (clearance > FRACUNIT) ? (fixed_t)min(clearance - FRACUNIT, INT32_MAX) : 0;
+}
+
+// Returns true if thing, about to be placed at (x, y), is known to touch
+// exactly the sectors in its current one-node sector_list.
+static boolean P_SecNodeListUnchanged(mobj_t *thing, fixed_t x, fixed_t y)
+{
+	INT64 dx = (INT64)x - thing->secnodex;
+	INT64 dy = (INT64)y - thing->secnodey;
+
+	if (!sector_list || sector_list->m_sectorlist_next)
+		return false;
+
+	if (sector_list->m_thing != thing || sector_list->m_sector != thing->subsector->sector)
+		return false;
+
+	if (thing->radius != thing->secnoderadius)
+		return false;
+
+	return (dx < 0 ? -dx : dx) < thing->secnodeclear
+		&& (dy < 0 ? -dy : dy) < thing->secnodeclear;
+}
+
+// P_RebuildSecNodeList
+// Works out the sector_list from scratch, from the lines around the thing.
+static void P_RebuildSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
 {
 	INT32 xl, xh, yl, yh, bx, by;
 	msecnode_t *node = sector_list;
@@ -4874,6 +5048,13 @@ void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
 			node = node->m_sectorlist_next;
 	}
 
+	// Touching only the sector it is in? Then see how far it can go
+	// before that might change.
+	if (!sector_list->m_sectorlist_next)
+		P_GetSecNodeClearance(thing, x, y);
+	else
+		thing->secnodeclear = 0;
+
 	/* cph -
 	* This is the strife we get into for using global variables. tmthing
 	*  is being used by several different functions calling
@@ -4897,6 +5078,65 @@ void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
 	}
 }
 
+#ifdef PARANOIA
+// Rebuilds the sector_list the slow way, and checks that it comes out the
+// same as the one-node list being kept. The clearance the list was kept
+// with is left as it was, so that it plays out as in other builds.
+static void P_CheckSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
+{
+	msecnode_t *cached = sector_list;
+	fixed_t secnodex = thing->secnodex, secnodey = thing->secnodey;
+	fixed_t secnoderadius = thing->secnoderadius, secnodeclear = thing->secnodeclear;
+
+	P_RebuildSecNodeList(thing, x, y);
+
+	if (sector_list != cached || sector_list->m_sectorlist_next)
+		I_Error("P_CreateSecNodeList: stale sector list kept for mobj type %d at (%d, %d)\n",
+			thing->type, x>>FRACBITS, y>>FRACBITS);
+
+	thing->secnodex = secnodex;
+	thing->secnodey = secnodey;
+	thing->secnoderadius = secnoderadius;
+	thing->secnodeclear = secnodeclear;
+}
+#endif
+
+// P_CreateSecNodeList alters/creates the sector_list that shows what sectors
+// the object resides in.
+
+void P_CreateSecNodeList(mobj_t *thing, fixed_t x, fixed_t y)
+{
+	if (!P_SecNodeListUnchanged(thing, x, y))
+	{
+		P_RebuildSecNodeList(thing, x, y);
+		return;
+	}
+
+	// Nothing that borders another sector can be in reach yet, so the list
+	// stays as it is. Leave the globals as the rebuild would.
+#ifdef PARANOIA
+	P_CheckSecNodeList(thing, x, y);
+#endif
+
+	tmflags = thing->flags;
+	validcount++;
+
+	if (tmthing)
+	{
+		tmbbox[BOXTOP]  = tmy + tmthing->radius;
+		tmbbox[BOXBOTTOM] = tmy - tmthing->radius;
+		tmbbox[BOXRIGHT]  = tmx + tmthing->radius;
+		tmbbox[BOXLEFT]   = tmx - tmthing->radius;
+	}
+	else
+	{
+		tmbbox[BOXTOP] = y + thing->radius;
+		tmbbox[BOXBOTTOM] = y - thing->radius;
+		tmbbox[BOXRIGHT] = x + thing->radius;
+		tmbbox[BOXLEFT] = x - thing->radius;
+	}
+}
+
 // More crazy crap Tails 08-25-2002
 void P_CreatePrecipSecNodeList(precipmobj_t *thing,fixed_t x,fixed_t y)
 {
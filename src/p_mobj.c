@@ -77,6 +77,151 @@ void P_AddCachedAction(mobj_t *mobj, INT32 statenum)
 	actioncachehead.prev = newaction;
 }
 
+mobjregistry_t mobjtyperegistry[NUMMOBJTYPES];
+mobjregistry_t mobjtargetregistry;
+
+static UINT32 mobjregorder;
+
+void P_InitMobjRegistries(void)
+{
+	memset(mobjtyperegistry, 0, sizeof (mobjtyperegistry));
+	mobjtargetregistry.head = mobjtargetregistry.tail = NULL;
+	mobjregorder = 0;
+}
+
+//
+// P_MobjIsTargetCandidate
+// Anything P_LookForEnemies or P_LookForFocusTarget could ever accept.
+//
+static boolean P_MobjIsTargetCandidate(mobj_t *mobj)
+{
+	if ((mobj->flags|mobj->info->flags) & (MF_ENEMY|MF_BOSS|MF_MONITOR|MF_SPRING|MF_PUSHABLE))
+		return true;
+
+	if (mobj->flags2 & MF2_INVERTAIMABLE)
+		return true;
+
+	switch (mobj->type)
+	{
+		case MT_FAKEMOBILE:
+		case MT_EGGSHIELD:
+		case MT_EGGSTATUE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Objects may join a registry long after they were spawned,
+// so walk back from the tail to keep the list in thinker order.
+#define REGISTRY_INSERT(reg, mobj, next, prev) \
+{ \
+	mobj_t *after = (reg)->tail; \
+	while (after && after->regorder > (mobj)->regorder) \
+		after = after->prev; \
+	(mobj)->prev = after; \
+	(mobj)->next = after ? after->next : (reg)->head; \
+	if (after) \
+		after->next = (mobj); \
+	else \
+		(reg)->head = (mobj); \
+	if ((mobj)->next) \
+		(mobj)->next->prev = (mobj); \
+	else \
+		(reg)->tail = (mobj); \
+}
+
+// The unlinked mobj's own next pointer is left alone, so a loop that
+// removes the object it is currently visiting can still move on.
+#define REGISTRY_REMOVE(reg, mobj, next, prev) \
+{ \
+	if ((mobj)->prev) \
+		(mobj)->prev->next = (mobj)->next; \
+	else \
+		(reg)->head = (mobj)->next; \
+	if ((mobj)->next) \
+		(mobj)->next->prev = (mobj)->prev; \
+	else \
+		(reg)->tail = (mobj)->prev; \
+}
+
+//
+// P_LinkMobjRegistries
+// Called whenever a mobj is added to thlist[THINK_MOBJ].
+//
+void P_LinkMobjRegistries(mobj_t *mobj)
+{
+	mobj->regorder = ++mobjregorder;
+	mobj->registered = MOBJREG_TYPE;
+	REGISTRY_INSERT(&mobjtyperegistry[mobj->type], mobj, typenext, typeprev)
+
+	if (P_MobjIsTargetCandidate(mobj))
+	{
+		mobj->registered |= MOBJREG_TARGET;
+		REGISTRY_INSERT(&mobjtargetregistry, mobj, targetnext, targetprev)
+	}
+}
+
+void P_UnlinkMobjRegistries(mobj_t *mobj)
+{
+	if (mobj->registered & MOBJREG_TYPE)
+		REGISTRY_REMOVE(&mobjtyperegistry[mobj->type], mobj, typenext, typeprev)
+
+	if (mobj->registered & MOBJREG_TARGET)
+		REGISTRY_REMOVE(&mobjtargetregistry, mobj, targetnext, targetprev)
+
+	mobj->registered = 0;
+}
+
+//
+// P_UpdateMobjRegistries
+// Call after changing flags or flags2 of a mobj that may already be thinking.
+//
+void P_UpdateMobjRegistries(mobj_t *mobj)
+{
+	if ((mobj->registered & (MOBJREG_TYPE|MOBJREG_TARGET)) != MOBJREG_TYPE)
+		return; // not thinking, or already a target
+
+	if (!P_MobjIsTargetCandidate(mobj))
+		return;
+
+	mobj->registered |= MOBJREG_TARGET;
+	REGISTRY_INSERT(&mobjtargetregistry, mobj, targetnext, targetprev)
+}
+
+//
+// P_SetMobjRegistryType
+// Changes a mobj's type, moving it to the right registry.
+//
+void P_SetMobjRegistryType(mobj_t *mobj, mobjtype_t type)
+{
+	if (mobj->registered & MOBJREG_TYPE)
+		REGISTRY_REMOVE(&mobjtyperegistry[mobj->type], mobj, typenext, typeprev)
+
+	mobj->type = type;
+	mobj->info = &mobjinfo[type];
+
+	if (mobj->registered & MOBJREG_TYPE)
+	{
+		REGISTRY_INSERT(&mobjtyperegistry[mobj->type], mobj, typenext, typeprev)
+		P_UpdateMobjRegistries(mobj);
+	}
+}
+
+#undef REGISTRY_INSERT
+#undef REGISTRY_REMOVE
+
+//
+// P_FirstMobjOfType
+// Range-checked access to mobjtyperegistry, for types coming from SOC or Lua.
+//
+mobj_t *P_FirstMobjOfType(INT32 type)
+{
+	if (type < 0 || type >= NUMMOBJTYPES)
+		return NULL;
+	return mobjtyperegistry[type].head;
+}
+
 //
 // P_SetupStateAnimation
 //
@@ -4413,7 +4558,6 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 		if (!mobj->reactiontime && mobj->health <= mobj->info->damage)
 		{ // Spawn pinch dummies from the center when we're leaving it.
-			thinker_t *th;
 			mobj_t *mo2;
 			mobj_t *dummy;
 			SINT8 way0 = mobj->threshold; // 0 through 4.
@@ -4423,14 +4567,8 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 			// scan the thinkers to make sure all the old pinch dummies are gone before making new ones
 			// this can happen if the boss was hurt earlier than expected
-			for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+			for (mo2 = P_FirstMobjOfType(mobj->info->mass); mo2; mo2 = mo2->typenext)
 			{
-				if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-					continue;
-
-				mo2 = (mobj_t *)th;
-				if (mo2->type != (mobjtype_t)mobj->info->mass)
-					continue;
 				if (mo2->tracer != mobj)
 					continue;
 
@@ -5477,7 +5615,6 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 	if (!mobj->tracer)
 	{
-		thinker_t *th;
 		mobj_t *mo2;
 		mobj_t *last=NULL;
 
@@ -5490,21 +5627,14 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 		// Run through the thinkers ONCE and find all of the MT_BOSS9GATHERPOINT in the map.
 		// Build a hoop linked list of 'em!
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = mobjtyperegistry[MT_BOSS9GATHERPOINT].head; mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-			if (mo2->type == MT_BOSS9GATHERPOINT)
-			{
-				if (last)
-					P_SetTarget(&last->hnext, mo2);
-				else
-					P_SetTarget(&mobj->hnext, mo2);
-				P_SetTarget(&mo2->hprev, last);
-				last = mo2;
-			}
+			if (last)
+				P_SetTarget(&last->hnext, mo2);
+			else
+				P_SetTarget(&mobj->hnext, mo2);
+			P_SetTarget(&mo2->hprev, last);
+			last = mo2;
 		}
 	}
 
@@ -6155,35 +6285,26 @@ nodanger:
 // Finds the CLOSEST axis to the source mobj
 mobj_t *P_GetClosestAxis(mobj_t *source)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis = NULL;
 	fixed_t dist1, dist2 = 0;
 
 	// scan the thinkers to find the closest axis point
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = mobjtyperegistry[MT_AXIS].head; mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type == MT_AXIS)
+		if (closestaxis == NULL)
+		{
+			closestaxis = mo2;
+			dist2 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
+		}
+		else
 		{
-			if (closestaxis == NULL)
+			dist1 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
+
+			if (dist1 < dist2)
 			{
 				closestaxis = mo2;
-				dist2 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
-			}
-			else
-			{
-				dist1 = R_PointToDist2(source->x, source->y, mo2->x, mo2->y)-mo2->radius;
-
-				if (dist1 < dist2)
-				{
-					closestaxis = mo2;
-					dist2 = dist1;
-				}
+				dist2 = dist1;
 			}
 		}
 	}
@@ -10516,6 +10637,7 @@ void P_PushableThinker(mobj_t *mobj)
 				P_SetThingPosition(spawnmo);
 				spawnmo->flags2 = mobj->flags2;
 				spawnmo->flags |= MF_PUSHABLE;
+				P_UpdateMobjRegistries(spawnmo);
 				P_RemoveMobj(mobj);
 				break;
 			default:
@@ -11057,7 +11179,10 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	}
 
 	if (!(mobj->flags & MF_NOTHINK))
+	{
 		P_AddThinker(THINK_MOBJ, &mobj->thinker);
+		P_LinkMobjRegistries(mobj);
+	}
 
 	if (mobj->skin) // correct inadequecies above.
 	{
@@ -11239,6 +11364,8 @@ void P_RemoveMobj(mobj_t *mobj)
 	mobj->state = NULL;
 	mobj->player = NULL;
 
+	P_UnlinkMobjRegistries(mobj);
+
 	P_RemoveFloorSpriteSlope(mobj);
 
 	// stop any playing sound
@@ -11283,7 +11410,13 @@ void P_RemoveMobj(mobj_t *mobj)
 	// DBG: set everything in mobj_t to 0xFF instead of leaving it. debug memory error.
 #ifdef SCRAMBLE_REMOVED
 	// Invalidate mobj_t data to cause crashes if accessed!
-	memset((UINT8 *)mobj + sizeof(thinker_t), 0xff, sizeof(mobj_t) - sizeof(thinker_t));
+	{
+		// Except for the registry links, which a running loop may still follow
+		mobj_t *typenext = mobj->typenext, *targetnext = mobj->targetnext;
+		memset((UINT8 *)mobj + sizeof(thinker_t), 0xff, sizeof(mobj_t) - sizeof(thinker_t));
+		mobj->typenext = typenext;
+		mobj->targetnext = targetnext;
+	}
 #endif
 }
 
@@ -398,11 +398,22 @@ typedef struct mobj_s
 	struct pslope_s *standingslope; // The slope that the object is standing on (shouldn't need synced in savegames, right?)
 
 	boolean resetinterp; // if true, some fields should not be interpolated (see R_InterpolateMobjState implementation)
+	UINT32 interpframe, interpindex; // slot in the per-frame interpolated state cache (see R_InterpolateMobjState), not saved
 	boolean colorized; // Whether the mobj uses the rainbow colormap
 	boolean mirrored; // The object's rotations will be mirrored left to right, e.g., see frame AL from the right and AR from the left
 	fixed_t shadowscale; // If this object casts a shadow, and the size relative to radius
 	INT32 dispoffset; // copy of info->dispoffset, so mobjs can be sorted independently of their type
 
+	// Links in the mobj registries (see P_LinkMobjRegistries), not saved.
+	struct mobj_s *typenext, *typeprev;
+	struct mobj_s *targetnext, *targetprev;
+	UINT32 regorder; // spawn order in thlist[THINK_MOBJ], keeps the registries sorted
+	UINT8 registered; // MOBJREG_ flags
+
+	// Where touching_sectorlist was last rebuilt, and how far the bounding box
+	// can move from there before the list could change (see P_CreateSecNodeList), not saved.
+	fixed_t secnodex, secnodey, secnoderadius, secnodeclear;
+
 	// WARNING: New fields must be added separately to savegame and Lua.
 } mobj_t;
 
@@ -482,6 +493,38 @@ void P_InitCachedActions(void);
 void P_RunCachedActions(void);
 void P_AddCachedAction(mobj_t *mobj, INT32 statenum);
 
+//
+// Mobj registries
+// Intrusive lists of thinking mobjs, in the same order as thlist[THINK_MOBJ],
+// so commonly queried objects can be found without walking every thinker.
+//
+typedef enum
+{
+	MOBJREG_TYPE   = 1, // mobjtyperegistry[mobj->type]
+	MOBJREG_TARGET = 1<<1  // mobjtargetregistry
+} mobjregflag_t;
+
+typedef struct
+{
+	struct mobj_s *head;
+	struct mobj_s *tail;
+} mobjregistry_t;
+
+// Every mobj of a given type.
+extern mobjregistry_t mobjtyperegistry[NUMMOBJTYPES];
+
+// Enemies, bosses, monitors, springs, pushables and anything else the player
+// can home in on or lock onto. This is a superset: flags can be lost after
+// an object is linked, so callers still need to check them.
+extern mobjregistry_t mobjtargetregistry;
+
+void P_InitMobjRegistries(void);
+void P_LinkMobjRegistries(mobj_t *mobj);
+void P_UnlinkMobjRegistries(mobj_t *mobj);
+void P_UpdateMobjRegistries(mobj_t *mobj);
+void P_SetMobjRegistryType(mobj_t *mobj, mobjtype_t type);
+mobj_t *P_FirstMobjOfType(INT32 type);
+
 // check mobj against water content, before movement code
 void P_MobjCheckWater(mobj_t *mobj);
 
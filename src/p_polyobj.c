@@ -102,6 +102,11 @@ polymaplink_t **polyblocklinks;
 // Polyobject Blockmap
 static polymaplink_t *bmap_freelist; // free list of blockmap links
 
+// Candidate mobjs gathered by Polyobj_clipThings. Used as a stack, since
+// pushing a thing can run Lua that moves another polyobject.
+static mobj_t **clipmobjs = NULL;
+static size_t numclipmobjs = 0, maxclipmobjs = 0;
+
 
 //
 // Static Functions
@@ -599,18 +604,14 @@ static void Polyobj_moveToSpawnSpot(mapthing_t *anchor)
 	Polyobj_attachToSubsec(po);
 }
 
-// Attaches a polyobject to its appropriate subsector.
-static void Polyobj_attachToSubsec(polyobj_t *po)
+// Calculates the center point of a polyobject from its vertices and returns
+// the subsector that point lies in.
+static subsector_t *Polyobj_findSubsec(polyobj_t *po)
 {
-	subsector_t  *ss;
 	fixed_t center_x = 0, center_y = 0;
 	fixed_t numVertices;
 	size_t i;
 
-	// never attach a bad polyobject
-	if (po->isBad)
-		return;
-
 	numVertices = (fixed_t)(po->numVertices*FRACUNIT);
 
 	for (i = 0; i < po->numVertices; ++i)
@@ -622,8 +623,12 @@ static void Polyobj_attachToSubsec(polyobj_t *po)
 	po->centerPt.x = center_x;
 	po->centerPt.y = center_y;
 
-	ss = R_PointInSubsector(po->centerPt.x, po->centerPt.y);
+	return R_PointInSubsector(po->centerPt.x, po->centerPt.y);
+}
 
+// Links a polyobject into the given subsector's polyobject list.
+static void Polyobj_insertIntoSubsec(polyobj_t *po, subsector_t *ss)
+{
 	M_DLListInsert(&po->link, (mdllistitem_t **)(void *)(&ss->polyList));
 
 #ifdef R_LINKEDPORTALS
@@ -634,14 +639,14 @@ static void Polyobj_attachToSubsec(polyobj_t *po)
 	po->attached = true;
 }
 
-// Removes a polyobject from the subsector to which it is attached.
-static void Polyobj_removeFromSubsec(polyobj_t *po)
+// Attaches a polyobject to its appropriate subsector.
+static void Polyobj_attachToSubsec(polyobj_t *po)
 {
-	if (po->attached)
-	{
-		M_DLListRemove(&po->link);
-		po->attached = false;
-	}
+	// never attach a bad polyobject
+	if (po->isBad)
+		return;
+
+	Polyobj_insertIntoSubsec(po, Polyobj_findSubsec(po));
 }
 
 // Blockmap Functions
@@ -673,19 +678,10 @@ static void Polyobj_putLink(polymaplink_t *l)
 	bmap_freelist = l;
 }
 
-// Inserts a polyobject into the polyobject blockmap. Unlike, mobj_t's,
-// polyobjects need to be linked into every blockmap cell which their
-// bounding box intersects. This ensures the accurate level of clipping
-// which is present with linedefs but absent from most mobj interactions.
-static void Polyobj_linkToBlockmap(polyobj_t *po)
+// Calculates the range of blockmap cells covered by a polyobject's vertices.
+static void Polyobj_getBlockbox(polyobj_t *po, fixed_t *blockbox)
 {
-	fixed_t *blockbox = po->blockbox;
 	size_t i;
-	fixed_t x, y;
-
-	// never link a bad polyobject or a polyobject already linked
-	if (po->isBad || po->linked)
-		return;
 
 	// 2/26/06: start line box with values of first vertex, not INT32_MIN/INT32_MAX
 	blockbox[BOXLEFT]   = blockbox[BOXRIGHT] = po->vertices[0]->x;
@@ -700,63 +696,155 @@ static void Polyobj_linkToBlockmap(polyobj_t *po)
 	blockbox[BOXLEFT]   = (unsigned)(blockbox[BOXLEFT]   - bmaporgx) >> MAPBLOCKSHIFT;
 	blockbox[BOXTOP]    = (unsigned)(blockbox[BOXTOP]    - bmaporgy) >> MAPBLOCKSHIFT;
 	blockbox[BOXBOTTOM] = (unsigned)(blockbox[BOXBOTTOM] - bmaporgy) >> MAPBLOCKSHIFT;
+}
+
+// Returns true if the blockmap cell (x, y) lies within blockbox.
+FUNCINLINE static ATTRINLINE boolean Polyobj_cellInBox(const fixed_t *blockbox, INT32 x, INT32 y)
+{
+	return x >= blockbox[BOXLEFT] && x <= blockbox[BOXRIGHT]
+		&& y >= blockbox[BOXBOTTOM] && y <= blockbox[BOXTOP];
+}
+
+// Links a polyobject into a single blockmap cell, at the front, and returns
+// the link, or NULL if the cell is outside the blockmap.
+static polymaplink_t *Polyobj_linkToCell(polyobj_t *po, INT32 x, INT32 y)
+{
+	polymaplink_t *l;
+
+	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+		return NULL;
+
+	l = Polyobj_getLink();
+	l->po = po;
+
+	M_DLListInsert(&l->link,
+				(mdllistitem_t **)(&polyblocklinks[y*bmapwidth + x]));
+
+	return l;
+}
+
+// Returns how many cells a blockbox covers.
+static size_t Polyobj_boxCells(const fixed_t *blockbox)
+{
+	if (blockbox[BOXRIGHT] < blockbox[BOXLEFT] || blockbox[BOXTOP] < blockbox[BOXBOTTOM])
+		return 0;
+
+	return (size_t)(blockbox[BOXRIGHT] - blockbox[BOXLEFT] + 1)
+		* (size_t)(blockbox[BOXTOP] - blockbox[BOXBOTTOM] + 1);
+}
+
+// Inserts a polyobject into the polyobject blockmap. Unlike, mobj_t's,
+// polyobjects need to be linked into every blockmap cell which their
+// bounding box intersects. This ensures the accurate level of clipping
+// which is present with linedefs but absent from most mobj interactions.
+static void Polyobj_linkToBlockmap(polyobj_t *po)
+{
+	fixed_t *blockbox = po->blockbox;
+	fixed_t x, y;
+	size_t i = 0;
+
+	// never link a bad polyobject or a polyobject already linked
+	if (po->isBad || po->linked)
+		return;
+
+	Polyobj_getBlockbox(po, blockbox);
+	po->blocklinks = Z_Malloc(Polyobj_boxCells(blockbox) * sizeof (*po->blocklinks), PU_LEVEL, NULL);
 
 	// link polyobject to every block its bounding box intersects
 	for (y = blockbox[BOXBOTTOM]; y <= blockbox[BOXTOP]; ++y)
-	{
 		for (x = blockbox[BOXLEFT]; x <= blockbox[BOXRIGHT]; ++x)
-		{
-			if (!(x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight))
-			{
-				polymaplink_t  *l = Polyobj_getLink();
-
-				l->po = po;
-
-				M_DLListInsert(&l->link,
-							(mdllistitem_t **)(&polyblocklinks[y*bmapwidth + x]));
-			}
-		}
-	}
+			po->blocklinks[i++] = Polyobj_linkToCell(po, x, y);
 
 	po->linked = true;
 }
 
-// Unlinks a polyobject from all blockmap cells it intersects and returns
-// its polymaplink objects to the free list.
-static void Polyobj_removeFromBlockmap(polyobj_t *po)
+// Brings a linked polyobject's blockmap links up to date after it has moved.
+// Cells it has left or entered get their links removed or added. In the
+// cells it stays in, its link is moved to the front, without a search, so
+// every cell ends up just as if it had been unlinked and linked again.
+static void Polyobj_relinkToBlockmap(polyobj_t *po)
 {
-	polymaplink_t *rover;
-	fixed_t *blockbox = po->blockbox;
+	fixed_t *oldbox = po->blockbox;
+	fixed_t newbox[4];
+	polymaplink_t **oldlinks = po->blocklinks;
+	polymaplink_t **newlinks, *l;
+	mdllistitem_t **head;
+	boolean samebox;
 	INT32 x, y;
+	size_t i;
+
+	if (po->isBad)
+		return;
 
-	// don't bother trying to unlink one that's not linked
 	if (!po->linked)
+	{
+		Polyobj_linkToBlockmap(po);
 		return;
+	}
 
-	// search all cells the polyobject touches
-	for (y = blockbox[BOXBOTTOM]; y <= blockbox[BOXTOP]; ++y)
+	Polyobj_getBlockbox(po, newbox);
+
+	samebox = !memcmp(newbox, oldbox, sizeof(newbox));
+	newlinks = samebox ? oldlinks
+		: Z_Malloc(Polyobj_boxCells(newbox) * sizeof (*newlinks), PU_LEVEL, NULL);
+
+	// leave the cells that are no longer covered
+	if (!samebox)
 	{
-		for (x = blockbox[BOXLEFT]; x <= blockbox[BOXRIGHT]; ++x)
+		for (i = 0, y = oldbox[BOXBOTTOM]; y <= oldbox[BOXTOP]; ++y)
+			for (x = oldbox[BOXLEFT]; x <= oldbox[BOXRIGHT]; ++x, ++i)
+				if (oldlinks[i] && !Polyobj_cellInBox(newbox, x, y))
+				{
+					M_DLListRemove(&oldlinks[i]->link);
+					Polyobj_putLink(oldlinks[i]);
+				}
+	}
+
+	// then go to the front of every covered cell, entering the new ones
+	for (i = 0, y = newbox[BOXBOTTOM]; y <= newbox[BOXTOP]; ++y)
+		for (x = newbox[BOXLEFT]; x <= newbox[BOXRIGHT]; ++x, ++i)
 		{
-			if (!(x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight))
+			if (!Polyobj_cellInBox(oldbox, x, y))
 			{
-				rover = polyblocklinks[y * bmapwidth + x];
-
-				while (rover && rover->po != po)
-					rover = (polymaplink_t *)(rover->link.next);
+				newlinks[i] = Polyobj_linkToCell(po, x, y);
+				continue;
+			}
 
-				// polyobject not in this cell? go on to next.
-				if (!rover)
-					continue;
+			l = oldlinks[(y - oldbox[BOXBOTTOM]) * (oldbox[BOXRIGHT] - oldbox[BOXLEFT] + 1) + (x - oldbox[BOXLEFT])];
+			newlinks[i] = l;
+			if (!l)
+				continue;
 
-				// remove this link from the blockmap and put it on the freelist
-				M_DLListRemove(&rover->link);
-				Polyobj_putLink(rover);
+			head = (mdllistitem_t **)(&polyblocklinks[y*bmapwidth + x]);
+			if (*head != &l->link)
+			{
+				M_DLListRemove(&l->link);
+				M_DLListInsert(&l->link, head);
 			}
 		}
+
+	if (!samebox)
+	{
+		Z_Free(oldlinks);
+		po->blocklinks = newlinks;
+		memcpy(oldbox, newbox, sizeof(newbox));
 	}
+}
+
+// Updates a polyobject's subsector and blockmap links after it has moved.
+// It goes back to the front of its subsector's list, as it would if it
+// had been removed and attached again.
+static void Polyobj_relink(polyobj_t *po)
+{
+	// never relink a bad polyobject
+	if (po->isBad)
+		return;
+
+	if (po->attached)
+		M_DLListRemove(&po->link);
+	Polyobj_attachToSubsec(po);
 
-	po->linked = false;
+	Polyobj_relinkToBlockmap(po);
 }
 
 // Movement functions
@@ -913,65 +1001,130 @@ static void Polyobj_carryThings(polyobj_t *po, fixed_t dx, fixed_t dy)
 	}
 }
 
-// Checks for things that are in the way of a polyobject line move.
+// Calculates the blockmap cells within MAXRADIUS of a linedef.
+static void Polyobj_getLineBlockbox(line_t *line, fixed_t *linebox)
+{
+	linebox[BOXLEFT]   = (unsigned)(line->bbox[BOXLEFT]   - bmaporgx - MAXRADIUS) >> MAPBLOCKSHIFT;
+	linebox[BOXRIGHT]  = (unsigned)(line->bbox[BOXRIGHT]  - bmaporgx + MAXRADIUS) >> MAPBLOCKSHIFT;
+	linebox[BOXBOTTOM] = (unsigned)(line->bbox[BOXBOTTOM] - bmaporgy - MAXRADIUS) >> MAPBLOCKSHIFT;
+	linebox[BOXTOP]    = (unsigned)(line->bbox[BOXTOP]    - bmaporgy + MAXRADIUS) >> MAPBLOCKSHIFT;
+}
+
+// Checks for things that are in the way of a polyobject's lines after a move.
 // Returns true if something was hit.
-static INT32 Polyobj_clipThings(polyobj_t *po, line_t *line)
+//
+// The mobjs in the blockmap cells around the polyobject are gathered once and
+// then tested against every line, rather than walking the cells around each
+// line in turn, which visits the same cells once per line.
+static INT32 Polyobj_clipThings(polyobj_t *po)
 {
 	INT32 hitflags = 0;
-	fixed_t linebox[4];
+	fixed_t clipbox[4], linebox[4];
+	size_t first = numclipmobjs, last;
+	size_t i, j;
 	INT32 x, y;
 
 	if (!(po->flags & POF_SOLID))
 		return hitflags;
 
-	// adjust linedef bounding box to blockmap, extend by MAXRADIUS
-	linebox[BOXLEFT]   = (unsigned)(line->bbox[BOXLEFT]   - bmaporgx - MAXRADIUS) >> MAPBLOCKSHIFT;
-	linebox[BOXRIGHT]  = (unsigned)(line->bbox[BOXRIGHT]  - bmaporgx + MAXRADIUS) >> MAPBLOCKSHIFT;
-	linebox[BOXBOTTOM] = (unsigned)(line->bbox[BOXBOTTOM] - bmaporgy - MAXRADIUS) >> MAPBLOCKSHIFT;
-	linebox[BOXTOP]    = (unsigned)(line->bbox[BOXTOP]    - bmaporgy + MAXRADIUS) >> MAPBLOCKSHIFT;
+	// find all the cells any line can contact
+	clipbox[BOXLEFT] = clipbox[BOXBOTTOM] = INT32_MAX;
+	clipbox[BOXRIGHT] = clipbox[BOXTOP] = INT32_MIN;
 
-	// check all mobj blockmap cells the line contacts
-	for (y = linebox[BOXBOTTOM]; y <= linebox[BOXTOP]; ++y)
+	for (i = 0; i < po->numLines; ++i)
 	{
-		for (x = linebox[BOXLEFT]; x <= linebox[BOXRIGHT]; ++x)
+		Polyobj_getLineBlockbox(po->lines[i], linebox);
+
+		if (linebox[BOXLEFT] > linebox[BOXRIGHT] || linebox[BOXBOTTOM] > linebox[BOXTOP])
+			continue;
+
+		clipbox[BOXLEFT]   = min(clipbox[BOXLEFT],   linebox[BOXLEFT]);
+		clipbox[BOXRIGHT]  = max(clipbox[BOXRIGHT],  linebox[BOXRIGHT]);
+		clipbox[BOXBOTTOM] = min(clipbox[BOXBOTTOM], linebox[BOXBOTTOM]);
+		clipbox[BOXTOP]    = max(clipbox[BOXTOP],    linebox[BOXTOP]);
+	}
+
+	clipbox[BOXLEFT]   = max(clipbox[BOXLEFT], 0);
+	clipbox[BOXRIGHT]  = min(clipbox[BOXRIGHT], bmapwidth - 1);
+	clipbox[BOXBOTTOM] = max(clipbox[BOXBOTTOM], 0);
+	clipbox[BOXTOP]    = min(clipbox[BOXTOP], bmapheight - 1);
+
+	// gather the things in those cells
+	for (y = clipbox[BOXBOTTOM]; y <= clipbox[BOXTOP]; ++y)
+	{
+		for (x = clipbox[BOXLEFT]; x <= clipbox[BOXRIGHT]; ++x)
 		{
-			if (!(x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight))
+			mobj_t *mo = blocklinks[y * bmapwidth + x];
+
+			for (; mo; mo = mo->bnext)
 			{
-				mobj_t *mo = blocklinks[y * bmapwidth + x];
+				// Don't scroll objects that aren't affected by gravity
+				if (mo->flags & MF_NOGRAVITY)
+					continue;
+				// (The above check used to only move MF_SOLID objects, but that's inconsistent with conveyor behavior. -Red)
+
+				if (mo->flags & MF_NOCLIP)
+					continue;
 
-				for (; mo; mo = mo->bnext)
+				if (numclipmobjs >= maxclipmobjs)
 				{
+					maxclipmobjs = maxclipmobjs ? maxclipmobjs * 2 : 64;
+					clipmobjs = Z_Realloc(clipmobjs, sizeof (*clipmobjs) * maxclipmobjs, PU_STATIC, NULL);
+				}
 
-					// Don't scroll objects that aren't affected by gravity
-					if (mo->flags & MF_NOGRAVITY)
-						continue;
-					// (The above check used to only move MF_SOLID objects, but that's inconsistent with conveyor behavior. -Red)
+				clipmobjs[numclipmobjs++] = mo;
+			}
+		}
+	}
 
-					if (mo->flags & MF_NOCLIP)
-						continue;
+	last = numclipmobjs;
 
-					if (mo->z + mo->height <= line->backsector->floorheight)
-						continue;
+	// check them against each line
+	for (i = 0; i < po->numLines; ++i)
+	{
+		line_t *line = po->lines[i];
 
-					if (mo->z >= line->backsector->ceilingheight)
-						continue;
+		Polyobj_getLineBlockbox(line, linebox);
 
-					if (Polyobj_untouched(line, mo))
-						continue;
+		for (j = first; j < last; ++j)
+		{
+			mobj_t *mo = clipmobjs[j];
 
-					if (mo->flags & MF_PUSHABLE && (po->flags & POF_PUSHABLESTOP))
-						hitflags |= 2;
-					else
-						Polyobj_pushThing(po, line, mo);
+			if (P_MobjWasRemoved(mo))
+				continue;
 
-					if (mo->player && (po->lines[0]->backsector->flags & MSF_TRIGGERSPECIAL_TOUCH) && !(po->flags & POF_NOSPECIALS))
-						P_ProcessSpecialSector(mo->player, mo->subsector->sector, po->lines[0]->backsector);
+			// only things in the cells the line contacts
+			x = (unsigned)(mo->x - bmaporgx) >> MAPBLOCKSHIFT;
+			y = (unsigned)(mo->y - bmaporgy) >> MAPBLOCKSHIFT;
 
-					hitflags |= 1;
-				}
-			} // end if
-		} // end for (y)
-	} // end for (x)
+			if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+				continue;
+
+			if (!Polyobj_cellInBox(linebox, x, y))
+				continue;
+
+			if (mo->z + mo->height <= line->backsector->floorheight)
+				continue;
+
+			if (mo->z >= line->backsector->ceilingheight)
+				continue;
+
+			if (Polyobj_untouched(line, mo))
+				continue;
+
+			if (mo->flags & MF_PUSHABLE && (po->flags & POF_PUSHABLESTOP))
+				hitflags |= 2;
+			else
+				Polyobj_pushThing(po, line, mo);
+
+			if (mo->player && (po->lines[0]->backsector->flags & MSF_TRIGGERSPECIAL_TOUCH) && !(po->flags & POF_NOSPECIALS))
+				P_ProcessSpecialSector(mo->player, mo->subsector->sector, po->lines[0]->backsector);
+
+			hitflags |= 1;
+		}
+	}
+
+	numclipmobjs = first;
 
 	return hitflags;
 }
@@ -1002,8 +1155,7 @@ boolean Polyobj_moveXY(polyobj_t *po, fixed_t x, fixed_t y, boolean checkmobjs)
 	if (checkmobjs)
 	{
 		// check for blocking things (yes, it needs to be done separately)
-		for (i = 0; i < po->numLines; ++i)
-			hitflags |= Polyobj_clipThings(po, po->lines[i]);
+		hitflags = Polyobj_clipThings(po);
 	}
 
 	if (hitflags & 2)
@@ -1024,10 +1176,7 @@ boolean Polyobj_moveXY(polyobj_t *po, fixed_t x, fixed_t y, boolean checkmobjs)
 
 		if (checkmobjs)
 			Polyobj_carryThings(po, x, y);
-		Polyobj_removeFromBlockmap(po); // unlink it from the blockmap
-		Polyobj_removeFromSubsec(po);   // unlink it from its subsector
-		Polyobj_linkToBlockmap(po);     // relink to blockmap
-		Polyobj_attachToSubsec(po);     // relink to subsector
+		Polyobj_relink(po); // relink to blockmap and subsector
 	}
 
 	return !(hitflags & 2);
@@ -1201,8 +1350,7 @@ boolean Polyobj_rotate(polyobj_t *po, angle_t delta, boolean turnplayers, boolea
 	if (checkmobjs)
 	{
 		// check for blocking things
-		for (i = 0; i < po->numLines; ++i)
-			hitflags |= Polyobj_clipThings(po, po->lines[i]);
+		hitflags = Polyobj_clipThings(po);
 
 		Polyobj_rotateThings(po, origin, delta, turnplayers, turnothers);
 	}
@@ -1226,10 +1374,7 @@ boolean Polyobj_rotate(polyobj_t *po, angle_t delta, boolean turnplayers, boolea
 		// update polyobject's angle
 		po->angle += delta;
 
-		Polyobj_removeFromBlockmap(po); // unlink it from the blockmap
-		Polyobj_removeFromSubsec(po);   // remove from subsector
-		Polyobj_linkToBlockmap(po);     // relink to blockmap
-		Polyobj_attachToSubsec(po);     // relink to subsector
+		Polyobj_relink(po); // relink to blockmap and subsector
 	}
 
 	return !(hitflags & 2);
@@ -2479,10 +2624,7 @@ void T_PolyObjFlag(polymove_t *th)
 	for (i = 0; i < po->numLines; i++)
 		Polyobj_rotateLine(po->lines[i]);
 
-	Polyobj_removeFromBlockmap(po); // unlink it from the blockmap
-	Polyobj_removeFromSubsec(po);   // unlink it from its subsector
-	Polyobj_linkToBlockmap(po);     // relink to blockmap
-	Polyobj_attachToSubsec(po);     // relink to subsector
+	Polyobj_relink(po); // relink to blockmap and subsector
 }
 
 boolean EV_DoPolyObjFlag(polyflagdata_t *pfdata)
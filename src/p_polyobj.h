@@ -98,6 +98,7 @@ typedef struct polyobj_s
 
 	fixed_t blockbox[4]; // bounding box for clipping
 	UINT8 linked;         // is linked to blockmap
+	struct polymaplink_s **blocklinks; // link in each cell of blockbox, row by row
 	size_t validcount;   // for clipping: prevents multiple checks
 	INT32 damage;        // damage to inflict on stuck things
 	fixed_t thrust;      // amount of thrust to put on blocking objects
@@ -35,10 +35,74 @@
 #include "p_polyobj.h"
 #include "lua_script.h"
 #include "p_slopes.h"
+#include "i_system.h"
 
 savedata_t savedata;
 UINT8 *save_p;
 
+savestats_t netsavestats;
+
+static UINT8 *savebuffer_start = NULL;
+UINT8 *save_end = NULL;
+
+UINT8 *P_SaveBufferAlloc(size_t size)
+{
+	savebuffer_start = malloc(size);
+	save_end = savebuffer_start ? savebuffer_start + size : NULL;
+	save_p = savebuffer_start;
+	return savebuffer_start;
+}
+
+//
+// P_SaveBufferReserve
+// Makes sure at least size bytes can be written at save_p.
+// Does nothing when no buffer was allocated with P_SaveBufferAlloc.
+//
+void P_SaveBufferReserve(size_t size)
+{
+	size_t used, newsize;
+	UINT8 *newbuffer;
+
+	if (!savebuffer_start)
+		return;
+
+	used = save_p - savebuffer_start;
+	newsize = save_end - savebuffer_start;
+	if (used > newsize)
+		I_Error("Savegame buffer overrun"); // someone wrote without making room first
+
+	if (newsize - used >= size)
+		return;
+
+	while (newsize - used < size)
+		newsize *= 2;
+
+	newbuffer = realloc(savebuffer_start, newsize);
+	if (!newbuffer)
+		I_Error("No more free memory for savegame");
+
+	savebuffer_start = newbuffer;
+	save_end = newbuffer + newsize;
+	save_p = newbuffer + used;
+}
+
+//
+// P_SaveBufferFinish
+// Hands the buffer over to the caller, who must free() it.
+//
+UINT8 *P_SaveBufferFinish(size_t *length)
+{
+	UINT8 *buffer = savebuffer_start;
+
+	P_SaveBufferReserve(0); // final overrun check
+	*length = save_p - savebuffer_start;
+
+	savebuffer_start = NULL;
+	save_end = NULL;
+	save_p = NULL;
+	return buffer;
+}
+
 // Block UINT32s to attempt to ensure that the correct data is
 // being sent and received
 #define ARCHIVEBLOCK_MISC     0x7FEEDEED
@@ -73,26 +137,26 @@ static inline void P_ArchivePlayer(void)
 #ifdef NEWSKINSAVES
 	// Write a specific value into the old skininfo location.
 	// If we read something other than this, it's an older save file that used skin numbers.
-	WRITEUINT16(save_p, NEWSKINSAVES);
+	SAVEWRITEUINT16(NEWSKINSAVES);
 #endif
 
 	// Write skin names, so that loading skins in different orders
 	// doesn't change who the save file is for!
-	WRITESTRINGN(save_p, skins[player->skin].name, SKINNAMESIZE);
+	SAVEWRITESTRINGN(skins[player->skin].name, SKINNAMESIZE);
 
 	if (botskin != 0)
 	{
-		WRITESTRINGN(save_p, skins[botskin-1].name, SKINNAMESIZE);
+		SAVEWRITESTRINGN(skins[botskin-1].name, SKINNAMESIZE);
 	}
 	else
 	{
-		WRITESTRINGN(save_p, "\0", SKINNAMESIZE);
+		SAVEWRITESTRINGN("\0", SKINNAMESIZE);
 	}
 
-	WRITEUINT8(save_p, numgameovers);
-	WRITESINT8(save_p, pllives);
-	WRITEUINT32(save_p, player->score);
-	WRITEINT32(save_p, player->continues);
+	SAVEWRITEUINT8(numgameovers);
+	SAVEWRITESINT8(pllives);
+	SAVEWRITEUINT32(player->score);
+	SAVEWRITEINT32(player->continues);
 }
 
 static inline void P_UnArchivePlayer(void)
@@ -131,11 +195,11 @@ static void P_NetArchivePlayers(void)
 	UINT16 flags;
 //	size_t q;
 
-	WRITEUINT32(save_p, ARCHIVEBLOCK_PLAYERS);
+	SAVEWRITEUINT32(ARCHIVEBLOCK_PLAYERS);
 
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
-		WRITESINT8(save_p, (SINT8)adminplayers[i]);
+		SAVEWRITESINT8((SINT8)adminplayers[i]);
 
 		if (!playeringame[i])
 			continue;
@@ -144,140 +208,140 @@ static void P_NetArchivePlayers(void)
 
 		// no longer send ticcmds
 
-		WRITESTRINGN(save_p, player_names[i], MAXPLAYERNAME);
-		WRITEINT16(save_p, players[i].angleturn);
-		WRITEINT16(save_p, players[i].oldrelangleturn);
-		WRITEANGLE(save_p, players[i].aiming);
-		WRITEANGLE(save_p, players[i].drawangle);
-		WRITEANGLE(save_p, players[i].viewrollangle);
-		WRITEANGLE(save_p, players[i].awayviewaiming);
-		WRITEINT32(save_p, players[i].awayviewtics);
-		WRITEINT16(save_p, players[i].rings);
-		WRITEINT16(save_p, players[i].spheres);
-
-		WRITESINT8(save_p, players[i].pity);
-		WRITEINT32(save_p, players[i].currentweapon);
-		WRITEINT32(save_p, players[i].ringweapons);
-
-		WRITEUINT16(save_p, players[i].ammoremoval);
-		WRITEUINT32(save_p, players[i].ammoremovaltimer);
-		WRITEINT32(save_p, players[i].ammoremovaltimer);
+		SAVEWRITESTRINGN(player_names[i], MAXPLAYERNAME);
+		SAVEWRITEINT16(players[i].angleturn);
+		SAVEWRITEINT16(players[i].oldrelangleturn);
+		SAVEWRITEANGLE(players[i].aiming);
+		SAVEWRITEANGLE(players[i].drawangle);
+		SAVEWRITEANGLE(players[i].viewrollangle);
+		SAVEWRITEANGLE(players[i].awayviewaiming);
+		SAVEWRITEINT32(players[i].awayviewtics);
+		SAVEWRITEINT16(players[i].rings);
+		SAVEWRITEINT16(players[i].spheres);
+
+		SAVEWRITESINT8(players[i].pity);
+		SAVEWRITEINT32(players[i].currentweapon);
+		SAVEWRITEINT32(players[i].ringweapons);
+
+		SAVEWRITEUINT16(players[i].ammoremoval);
+		SAVEWRITEUINT32(players[i].ammoremovaltimer);
+		SAVEWRITEINT32(players[i].ammoremovaltimer);
 
 		for (j = 0; j < NUMPOWERS; j++)
-			WRITEUINT16(save_p, players[i].powers[j]);
-
-		WRITEUINT8(save_p, players[i].playerstate);
-		WRITEUINT32(save_p, players[i].pflags);
-		WRITEUINT8(save_p, players[i].panim);
-		WRITEUINT8(save_p, players[i].stronganim);
-		WRITEUINT8(save_p, players[i].spectator);
-
-		WRITEUINT16(save_p, players[i].flashpal);
-		WRITEUINT16(save_p, players[i].flashcount);
-
-		WRITEUINT8(save_p, players[i].skincolor);
-		WRITEINT32(save_p, players[i].skin);
-		WRITEUINT32(save_p, players[i].availabilities);
-		WRITEUINT32(save_p, players[i].score);
-		WRITEUINT32(save_p, players[i].recordscore);
-		WRITEFIXED(save_p, players[i].dashspeed);
-		WRITESINT8(save_p, players[i].lives);
-		WRITESINT8(save_p, players[i].continues);
-		WRITESINT8(save_p, players[i].xtralife);
-		WRITEUINT8(save_p, players[i].gotcontinue);
-		WRITEFIXED(save_p, players[i].speed);
-		WRITEUINT8(save_p, players[i].secondjump);
-		WRITEUINT8(save_p, players[i].fly1);
-		WRITEUINT8(save_p, players[i].scoreadd);
-		WRITEUINT32(save_p, players[i].glidetime);
-		WRITEUINT8(save_p, players[i].climbing);
-		WRITEINT32(save_p, players[i].deadtimer);
-		WRITEUINT32(save_p, players[i].exiting);
-		WRITEUINT8(save_p, players[i].homing);
-		WRITEUINT32(save_p, players[i].dashmode);
-		WRITEUINT32(save_p, players[i].skidtime);
+			SAVEWRITEUINT16(players[i].powers[j]);
+
+		SAVEWRITEUINT8(players[i].playerstate);
+		SAVEWRITEUINT32(players[i].pflags);
+		SAVEWRITEUINT8(players[i].panim);
+		SAVEWRITEUINT8(players[i].stronganim);
+		SAVEWRITEUINT8(players[i].spectator);
+
+		SAVEWRITEUINT16(players[i].flashpal);
+		SAVEWRITEUINT16(players[i].flashcount);
+
+		SAVEWRITEUINT8(players[i].skincolor);
+		SAVEWRITEINT32(players[i].skin);
+		SAVEWRITEUINT32(players[i].availabilities);
+		SAVEWRITEUINT32(players[i].score);
+		SAVEWRITEUINT32(players[i].recordscore);
+		SAVEWRITEFIXED(players[i].dashspeed);
+		SAVEWRITESINT8(players[i].lives);
+		SAVEWRITESINT8(players[i].continues);
+		SAVEWRITESINT8(players[i].xtralife);
+		SAVEWRITEUINT8(players[i].gotcontinue);
+		SAVEWRITEFIXED(players[i].speed);
+		SAVEWRITEUINT8(players[i].secondjump);
+		SAVEWRITEUINT8(players[i].fly1);
+		SAVEWRITEUINT8(players[i].scoreadd);
+		SAVEWRITEUINT32(players[i].glidetime);
+		SAVEWRITEUINT8(players[i].climbing);
+		SAVEWRITEINT32(players[i].deadtimer);
+		SAVEWRITEUINT32(players[i].exiting);
+		SAVEWRITEUINT8(players[i].homing);
+		SAVEWRITEUINT32(players[i].dashmode);
+		SAVEWRITEUINT32(players[i].skidtime);
 
 		//////////
 		// Bots //
 		//////////
-		WRITEUINT8(save_p, players[i].bot);
-		WRITEUINT8(save_p, players[i].botmem.lastForward);
-		WRITEUINT8(save_p, players[i].botmem.lastBlocked);
-		WRITEUINT8(save_p, players[i].botmem.catchup_tics);
-		WRITEUINT8(save_p, players[i].botmem.thinkstate);
-		WRITEUINT8(save_p, players[i].removing);
+		SAVEWRITEUINT8(players[i].bot);
+		SAVEWRITEUINT8(players[i].botmem.lastForward);
+		SAVEWRITEUINT8(players[i].botmem.lastBlocked);
+		SAVEWRITEUINT8(players[i].botmem.catchup_tics);
+		SAVEWRITEUINT8(players[i].botmem.thinkstate);
+		SAVEWRITEUINT8(players[i].removing);
 
-		WRITEUINT8(save_p, players[i].blocked);
-		WRITEUINT16(save_p, players[i].lastbuttons);
+		SAVEWRITEUINT8(players[i].blocked);
+		SAVEWRITEUINT16(players[i].lastbuttons);
 
 		////////////////////////////
 		// Conveyor Belt Movement //
 		////////////////////////////
-		WRITEFIXED(save_p, players[i].cmomx); // Conveyor momx
-		WRITEFIXED(save_p, players[i].cmomy); // Conveyor momy
-		WRITEFIXED(save_p, players[i].rmomx); // "Real" momx (momx - cmomx)
-		WRITEFIXED(save_p, players[i].rmomy); // "Real" momy (momy - cmomy)
+		SAVEWRITEFIXED(players[i].cmomx); // Conveyor momx
+		SAVEWRITEFIXED(players[i].cmomy); // Conveyor momy
+		SAVEWRITEFIXED(players[i].rmomx); // "Real" momx (momx - cmomx)
+		SAVEWRITEFIXED(players[i].rmomy); // "Real" momy (momy - cmomy)
 
 		/////////////////////
 		// Race Mode Stuff //
 		/////////////////////
-		WRITEINT16(save_p, players[i].numboxes);
-		WRITEINT16(save_p, players[i].totalring);
-		WRITEUINT32(save_p, players[i].realtime);
-		WRITEUINT8(save_p, players[i].laps);
+		SAVEWRITEINT16(players[i].numboxes);
+		SAVEWRITEINT16(players[i].totalring);
+		SAVEWRITEUINT32(players[i].realtime);
+		SAVEWRITEUINT8(players[i].laps);
 
 		////////////////////
 		// CTF Mode Stuff //
 		////////////////////
-		WRITEINT32(save_p, players[i].ctfteam);
-		WRITEUINT16(save_p, players[i].gotflag);
-
-		WRITEINT32(save_p, players[i].weapondelay);
-		WRITEINT32(save_p, players[i].tossdelay);
-
-		WRITEUINT32(save_p, players[i].starposttime);
-		WRITEINT16(save_p, players[i].starpostx);
-		WRITEINT16(save_p, players[i].starposty);
-		WRITEINT16(save_p, players[i].starpostz);
-		WRITEINT32(save_p, players[i].starpostnum);
-		WRITEANGLE(save_p, players[i].starpostangle);
-		WRITEFIXED(save_p, players[i].starpostscale);
-
-		WRITEANGLE(save_p, players[i].angle_pos);
-		WRITEANGLE(save_p, players[i].old_angle_pos);
-
-		WRITEINT32(save_p, players[i].flyangle);
-		WRITEUINT32(save_p, players[i].drilltimer);
-		WRITEINT32(save_p, players[i].linkcount);
-		WRITEUINT32(save_p, players[i].linktimer);
-		WRITEINT32(save_p, players[i].anotherflyangle);
-		WRITEUINT32(save_p, players[i].nightstime);
-		WRITEUINT32(save_p, players[i].bumpertime);
-		WRITEINT32(save_p, players[i].drillmeter);
-		WRITEUINT8(save_p, players[i].drilldelay);
-		WRITEUINT8(save_p, players[i].bonustime);
-		WRITEFIXED(save_p, players[i].oldscale);
-		WRITEUINT8(save_p, players[i].mare);
-		WRITEUINT8(save_p, players[i].marelap);
-		WRITEUINT8(save_p, players[i].marebonuslap);
-		WRITEUINT32(save_p, players[i].marebegunat);
-		WRITEUINT32(save_p, players[i].startedtime);
-		WRITEUINT32(save_p, players[i].finishedtime);
-		WRITEUINT32(save_p, players[i].lapbegunat);
-		WRITEUINT32(save_p, players[i].lapstartedtime);
-		WRITEINT16(save_p, players[i].finishedspheres);
-		WRITEINT16(save_p, players[i].finishedrings);
-		WRITEUINT32(save_p, players[i].marescore);
-		WRITEUINT32(save_p, players[i].lastmarescore);
-		WRITEUINT32(save_p, players[i].totalmarescore);
-		WRITEUINT8(save_p, players[i].lastmare);
-		WRITEUINT8(save_p, players[i].lastmarelap);
-		WRITEUINT8(save_p, players[i].lastmarebonuslap);
-		WRITEUINT8(save_p, players[i].totalmarelap);
-		WRITEUINT8(save_p, players[i].totalmarebonuslap);
-		WRITEINT32(save_p, players[i].maxlink);
-		WRITEUINT8(save_p, players[i].texttimer);
-		WRITEUINT8(save_p, players[i].textvar);
+		SAVEWRITEINT32(players[i].ctfteam);
+		SAVEWRITEUINT16(players[i].gotflag);
+
+		SAVEWRITEINT32(players[i].weapondelay);
+		SAVEWRITEINT32(players[i].tossdelay);
+
+		SAVEWRITEUINT32(players[i].starposttime);
+		SAVEWRITEINT16(players[i].starpostx);
+		SAVEWRITEINT16(players[i].starposty);
+		SAVEWRITEINT16(players[i].starpostz);
+		SAVEWRITEINT32(players[i].starpostnum);
+		SAVEWRITEANGLE(players[i].starpostangle);
+		SAVEWRITEFIXED(players[i].starpostscale);
+
+		SAVEWRITEANGLE(players[i].angle_pos);
+		SAVEWRITEANGLE(players[i].old_angle_pos);
+
+		SAVEWRITEINT32(players[i].flyangle);
+		SAVEWRITEUINT32(players[i].drilltimer);
+		SAVEWRITEINT32(players[i].linkcount);
+		SAVEWRITEUINT32(players[i].linktimer);
+		SAVEWRITEINT32(players[i].anotherflyangle);
+		SAVEWRITEUINT32(players[i].nightstime);
+		SAVEWRITEUINT32(players[i].bumpertime);
+		SAVEWRITEINT32(players[i].drillmeter);
+		SAVEWRITEUINT8(players[i].drilldelay);
+		SAVEWRITEUINT8(players[i].bonustime);
+		SAVEWRITEFIXED(players[i].oldscale);
+		SAVEWRITEUINT8(players[i].mare);
+		SAVEWRITEUINT8(players[i].marelap);
+		SAVEWRITEUINT8(players[i].marebonuslap);
+		SAVEWRITEUINT32(players[i].marebegunat);
+		SAVEWRITEUINT32(players[i].startedtime);
+		SAVEWRITEUINT32(players[i].finishedtime);
+		SAVEWRITEUINT32(players[i].lapbegunat);
+		SAVEWRITEUINT32(players[i].lapstartedtime);
+		SAVEWRITEINT16(players[i].finishedspheres);
+		SAVEWRITEINT16(players[i].finishedrings);
+		SAVEWRITEUINT32(players[i].marescore);
+		SAVEWRITEUINT32(players[i].lastmarescore);
+		SAVEWRITEUINT32(players[i].totalmarescore);
+		SAVEWRITEUINT8(players[i].lastmare);
+		SAVEWRITEUINT8(players[i].lastmarelap);
+		SAVEWRITEUINT8(players[i].lastmarebonuslap);
+		SAVEWRITEUINT8(players[i].totalmarelap);
+		SAVEWRITEUINT8(players[i].totalmarebonuslap);
+		SAVEWRITEINT32(players[i].maxlink);
+		SAVEWRITEUINT8(players[i].texttimer);
+		SAVEWRITEUINT8(players[i].textvar);
 
 		if (players[i].capsule)
 			flags |= CAPSULE;
@@ -297,59 +361,59 @@ static void P_NetArchivePlayers(void)
 		if (players[i].drone)
 			flags |= DRONE;
 
-		WRITEINT16(save_p, players[i].lastsidehit);
-		WRITEINT16(save_p, players[i].lastlinehit);
+		SAVEWRITEINT16(players[i].lastsidehit);
+		SAVEWRITEINT16(players[i].lastlinehit);
 
-		WRITEUINT32(save_p, players[i].losstime);
+		SAVEWRITEUINT32(players[i].losstime);
 
-		WRITEUINT8(save_p, players[i].timeshit);
+		SAVEWRITEUINT8(players[i].timeshit);
 
-		WRITEINT32(save_p, players[i].onconveyor);
+		SAVEWRITEINT32(players[i].onconveyor);
 
-		WRITEUINT32(save_p, players[i].jointime);
-		WRITEUINT32(save_p, players[i].quittime);
+		SAVEWRITEUINT32(players[i].jointime);
+		SAVEWRITEUINT32(players[i].quittime);
 
-		WRITEUINT16(save_p, flags);
+		SAVEWRITEUINT16(flags);
 
 		if (flags & CAPSULE)
-			WRITEUINT32(save_p, players[i].capsule->mobjnum);
+			SAVEWRITEUINT32(players[i].capsule->mobjnum);
 
 		if (flags & FIRSTAXIS)
-			WRITEUINT32(save_p, players[i].axis1->mobjnum);
+			SAVEWRITEUINT32(players[i].axis1->mobjnum);
 
 		if (flags & SECONDAXIS)
-			WRITEUINT32(save_p, players[i].axis2->mobjnum);
+			SAVEWRITEUINT32(players[i].axis2->mobjnum);
 
 		if (flags & AWAYVIEW)
-			WRITEUINT32(save_p, players[i].awayviewmobj->mobjnum);
+			SAVEWRITEUINT32(players[i].awayviewmobj->mobjnum);
 
 		if (flags & FOLLOW)
-			WRITEUINT32(save_p, players[i].followmobj->mobjnum);
+			SAVEWRITEUINT32(players[i].followmobj->mobjnum);
 
 		if (flags & DRONE)
-			WRITEUINT32(save_p, players[i].drone->mobjnum);
-
-		WRITEFIXED(save_p, players[i].camerascale);
-		WRITEFIXED(save_p, players[i].shieldscale);
-
-		WRITEUINT8(save_p, players[i].charability);
-		WRITEUINT8(save_p, players[i].charability2);
-		WRITEUINT32(save_p, players[i].charflags);
-		WRITEUINT32(save_p, (UINT32)players[i].thokitem);
-		WRITEUINT32(save_p, (UINT32)players[i].spinitem);
-		WRITEUINT32(save_p, (UINT32)players[i].revitem);
-		WRITEUINT32(save_p, (UINT32)players[i].followitem);
-		WRITEFIXED(save_p, players[i].actionspd);
-		WRITEFIXED(save_p, players[i].mindash);
-		WRITEFIXED(save_p, players[i].maxdash);
-		WRITEFIXED(save_p, players[i].normalspeed);
-		WRITEFIXED(save_p, players[i].runspeed);
-		WRITEUINT8(save_p, players[i].thrustfactor);
-		WRITEUINT8(save_p, players[i].accelstart);
-		WRITEUINT8(save_p, players[i].acceleration);
-		WRITEFIXED(save_p, players[i].jumpfactor);
-		WRITEFIXED(save_p, players[i].height);
-		WRITEFIXED(save_p, players[i].spinheight);
+			SAVEWRITEUINT32(players[i].drone->mobjnum);
+
+		SAVEWRITEFIXED(players[i].camerascale);
+		SAVEWRITEFIXED(players[i].shieldscale);
+
+		SAVEWRITEUINT8(players[i].charability);
+		SAVEWRITEUINT8(players[i].charability2);
+		SAVEWRITEUINT32(players[i].charflags);
+		SAVEWRITEUINT32((UINT32)players[i].thokitem);
+		SAVEWRITEUINT32((UINT32)players[i].spinitem);
+		SAVEWRITEUINT32((UINT32)players[i].revitem);
+		SAVEWRITEUINT32((UINT32)players[i].followitem);
+		SAVEWRITEFIXED(players[i].actionspd);
+		SAVEWRITEFIXED(players[i].mindash);
+		SAVEWRITEFIXED(players[i].maxdash);
+		SAVEWRITEFIXED(players[i].normalspeed);
+		SAVEWRITEFIXED(players[i].runspeed);
+		SAVEWRITEUINT8(players[i].thrustfactor);
+		SAVEWRITEUINT8(players[i].accelstart);
+		SAVEWRITEUINT8(players[i].acceleration);
+		SAVEWRITEFIXED(players[i].jumpfactor);
+		SAVEWRITEFIXED(players[i].height);
+		SAVEWRITEFIXED(players[i].spinheight);
 	}
 }
 
@@ -670,7 +734,7 @@ static void P_NetArchiveColormaps(void)
 	// We save and then we clean up our colormap mess
 	extracolormap_t *exc, *exc_next;
 	UINT32 i = 0;
-	WRITEUINT32(save_p, num_net_colormaps); // save for safety
+	SAVEWRITEUINT32(num_net_colormaps); // save for safety
 
 	for (exc = net_colormaps; i < num_net_colormaps; i++, exc = exc_next)
 	{
@@ -679,15 +743,15 @@ static void P_NetArchiveColormaps(void)
 		if (!exc)
 			exc = R_CreateDefaultColormap(false);
 
-		WRITEUINT8(save_p, exc->fadestart);
-		WRITEUINT8(save_p, exc->fadeend);
-		WRITEUINT8(save_p, exc->flags);
+		SAVEWRITEUINT8(exc->fadestart);
+		SAVEWRITEUINT8(exc->fadeend);
+		SAVEWRITEUINT8(exc->flags);
 
-		WRITEINT32(save_p, exc->rgba);
-		WRITEINT32(save_p, exc->fadergba);
+		SAVEWRITEINT32(exc->rgba);
+		SAVEWRITEINT32(exc->fadergba);
 
 #ifdef EXTRACOLORMAPLUMPS
-		WRITESTRINGN(save_p, exc->lumpname, 9);
+		SAVEWRITESTRINGN(exc->lumpname, 9);
 #endif
 
 		exc_next = exc->next;
@@ -807,9 +871,9 @@ static void P_NetArchiveWaypoints(void)
 
 	for (i = 0; i < NUMWAYPOINTSEQUENCES; i++)
 	{
-		WRITEUINT16(save_p, numwaypoints[i]);
+		SAVEWRITEUINT16(numwaypoints[i]);
 		for (j = 0; j < numwaypoints[i]; j++)
-			WRITEUINT32(save_p, waypoints[i][j] ? waypoints[i][j]->mobjnum : 0);
+			SAVEWRITEUINT32(waypoints[i][j] ? waypoints[i][j]->mobjnum : 0);
 	}
 }
 
@@ -948,16 +1012,16 @@ static void ArchiveFFloors(const sector_t *ss)
 
 		if (fflr_diff)
 		{
-			WRITEUINT16(save_p, j); // save ffloor "number"
-			WRITEUINT8(save_p, fflr_diff);
+			SAVEWRITEUINT16(j); // save ffloor "number"
+			SAVEWRITEUINT8(fflr_diff);
 			if (fflr_diff & FD_FLAGS)
-				WRITEUINT32(save_p, rover->fofflags);
+				SAVEWRITEUINT32(rover->fofflags);
 			if (fflr_diff & FD_ALPHA)
-				WRITEINT16(save_p, rover->alpha);
+				SAVEWRITEINT16(rover->alpha);
 		}
 		j++;
 	}
-	WRITEUINT16(save_p, 0xffff);
+	SAVEWRITEUINT16(0xffff);
 }
 
 static void UnArchiveFFloors(const sector_t *ss)
@@ -1079,78 +1143,78 @@ static void ArchiveSectors(void)
 
 		if (diff)
 		{
-			WRITEUINT16(save_p, i);
-			WRITEUINT8(save_p, diff);
+			SAVEWRITEUINT16(i);
+			SAVEWRITEUINT8(diff);
 			if (diff & SD_DIFF2)
-				WRITEUINT8(save_p, diff2);
+				SAVEWRITEUINT8(diff2);
 			if (diff2 & SD_DIFF3)
-				WRITEUINT8(save_p, diff3);
+				SAVEWRITEUINT8(diff3);
 			if (diff3 & SD_DIFF4)
-				WRITEUINT8(save_p, diff4);
+				SAVEWRITEUINT8(diff4);
 			if (diff & SD_FLOORHT)
-				WRITEFIXED(save_p, ss->floorheight);
+				SAVEWRITEFIXED(ss->floorheight);
 			if (diff & SD_CEILHT)
-				WRITEFIXED(save_p, ss->ceilingheight);
+				SAVEWRITEFIXED(ss->ceilingheight);
 			if (diff & SD_FLOORPIC)
-				WRITEMEM(save_p, levelflats[ss->floorpic].name, 8);
+				SAVEWRITEMEM(levelflats[ss->floorpic].name, 8);
 			if (diff & SD_CEILPIC)
-				WRITEMEM(save_p, levelflats[ss->ceilingpic].name, 8);
+				SAVEWRITEMEM(levelflats[ss->ceilingpic].name, 8);
 			if (diff & SD_LIGHT)
-				WRITEINT16(save_p, ss->lightlevel);
+				SAVEWRITEINT16(ss->lightlevel);
 			if (diff & SD_SPECIAL)
-				WRITEINT16(save_p, ss->special);
+				SAVEWRITEINT16(ss->special);
 			if (diff2 & SD_FXOFFS)
-				WRITEFIXED(save_p, ss->floorxoffset);
+				SAVEWRITEFIXED(ss->floorxoffset);
 			if (diff2 & SD_FYOFFS)
-				WRITEFIXED(save_p, ss->flooryoffset);
+				SAVEWRITEFIXED(ss->flooryoffset);
 			if (diff2 & SD_CXOFFS)
-				WRITEFIXED(save_p, ss->ceilingxoffset);
+				SAVEWRITEFIXED(ss->ceilingxoffset);
 			if (diff2 & SD_CYOFFS)
-				WRITEFIXED(save_p, ss->ceilingyoffset);
+				SAVEWRITEFIXED(ss->ceilingyoffset);
 			if (diff2 & SD_FLOORANG)
-				WRITEANGLE(save_p, ss->floorangle);
+				SAVEWRITEANGLE(ss->floorangle);
 			if (diff2 & SD_CEILANG)
-				WRITEANGLE(save_p, ss->ceilingangle);
+				SAVEWRITEANGLE(ss->ceilingangle);
 			if (diff2 & SD_TAG)
 			{
-				WRITEUINT32(save_p, ss->tags.count);
+				SAVEWRITEUINT32(ss->tags.count);
 				for (j = 0; j < ss->tags.count; j++)
-					WRITEINT16(save_p, ss->tags.tags[j]);
+					SAVEWRITEINT16(ss->tags.tags[j]);
 			}
 
 			if (diff3 & SD_COLORMAP)
-				WRITEUINT32(save_p, CheckAddNetColormapToList(ss->extra_colormap));
+				SAVEWRITEUINT32(CheckAddNetColormapToList(ss->extra_colormap));
 					// returns existing index if already added, or appends to net_colormaps and returns new index
 			if (diff3 & SD_CRUMBLESTATE)
-				WRITEINT32(save_p, ss->crumblestate);
+				SAVEWRITEINT32(ss->crumblestate);
 			if (diff3 & SD_FLOORLIGHT)
 			{
-				WRITEINT16(save_p, ss->floorlightlevel);
-				WRITEUINT8(save_p, ss->floorlightabsolute);
+				SAVEWRITEINT16(ss->floorlightlevel);
+				SAVEWRITEUINT8(ss->floorlightabsolute);
 			}
 			if (diff3 & SD_CEILLIGHT)
 			{
-				WRITEINT16(save_p, ss->ceilinglightlevel);
-				WRITEUINT8(save_p, ss->ceilinglightabsolute);
+				SAVEWRITEINT16(ss->ceilinglightlevel);
+				SAVEWRITEUINT8(ss->ceilinglightabsolute);
 			}
 			if (diff3 & SD_FLAG)
-				WRITEUINT32(save_p, ss->flags);
+				SAVEWRITEUINT32(ss->flags);
 			if (diff3 & SD_SPECIALFLAG)
-				WRITEUINT32(save_p, ss->specialflags);
+				SAVEWRITEUINT32(ss->specialflags);
 			if (diff4 & SD_DAMAGETYPE)
-				WRITEUINT8(save_p, ss->damagetype);
+				SAVEWRITEUINT8(ss->damagetype);
 			if (diff4 & SD_TRIGGERTAG)
-				WRITEINT16(save_p, ss->triggertag);
+				SAVEWRITEINT16(ss->triggertag);
 			if (diff4 & SD_TRIGGERER)
-				WRITEUINT8(save_p, ss->triggerer);
+				SAVEWRITEUINT8(ss->triggerer);
 			if (diff4 & SD_GRAVITY)
-				WRITEFIXED(save_p, ss->gravity);
+				SAVEWRITEFIXED(ss->gravity);
 			if (diff & SD_FFLOORS)
 				ArchiveFFloors(ss);
 		}
 	}
 
-	WRITEUINT16(save_p, 0xffff);
+	SAVEWRITEUINT16(0xffff);
 }
 
 static void UnArchiveSectors(void)
@@ -1332,66 +1396,65 @@ static void ArchiveLines(void)
 
 		if (diff)
 		{
-			WRITEINT16(save_p, i);
-			WRITEUINT8(save_p, diff);
+			SAVEWRITEINT16(i);
+			SAVEWRITEUINT8(diff);
 			if (diff & LD_DIFF2)
-				WRITEUINT8(save_p, diff2);
+				SAVEWRITEUINT8(diff2);
 			if (diff & LD_FLAG)
-				WRITEINT16(save_p, li->flags);
+				SAVEWRITEINT16(li->flags);
 			if (diff & LD_SPECIAL)
-				WRITEINT16(save_p, li->special);
+				SAVEWRITEINT16(li->special);
 			if (diff & LD_CLLCOUNT)
-				WRITEINT16(save_p, li->callcount);
+				SAVEWRITEINT16(li->callcount);
 
 			si = &sides[li->sidenum[0]];
 			if (diff & LD_S1TEXOFF)
-				WRITEFIXED(save_p, si->textureoffset);
+				SAVEWRITEFIXED(si->textureoffset);
 			if (diff & LD_S1TOPTEX)
-				WRITEINT32(save_p, si->toptexture);
+				SAVEWRITEINT32(si->toptexture);
 			if (diff & LD_S1BOTTEX)
-				WRITEINT32(save_p, si->bottomtexture);
+				SAVEWRITEINT32(si->bottomtexture);
 			if (diff & LD_S1MIDTEX)
-				WRITEINT32(save_p, si->midtexture);
+				SAVEWRITEINT32(si->midtexture);
 
 			si = &sides[li->sidenum[1]];
 			if (diff2 & LD_S2TEXOFF)
-				WRITEFIXED(save_p, si->textureoffset);
+				SAVEWRITEFIXED(si->textureoffset);
 			if (diff2 & LD_S2TOPTEX)
-				WRITEINT32(save_p, si->toptexture);
+				SAVEWRITEINT32(si->toptexture);
 			if (diff2 & LD_S2BOTTEX)
-				WRITEINT32(save_p, si->bottomtexture);
+				SAVEWRITEINT32(si->bottomtexture);
 			if (diff2 & LD_S2MIDTEX)
-				WRITEINT32(save_p, si->midtexture);
+				SAVEWRITEINT32(si->midtexture);
 			if (diff2 & LD_ARGS)
 			{
 				UINT8 j;
 				for (j = 0; j < NUMLINEARGS; j++)
-					WRITEINT32(save_p, li->args[j]);
+					SAVEWRITEINT32(li->args[j]);
 			}
 			if (diff2 & LD_STRINGARGS)
 			{
 				UINT8 j;
 				for (j = 0; j < NUMLINESTRINGARGS; j++)
 				{
-					size_t len, k;
+					size_t len;
 
 					if (!li->stringargs[j])
 					{
-						WRITEINT32(save_p, 0);
+						SAVEWRITEINT32(0);
 						continue;
 					}
 
 					len = strlen(li->stringargs[j]);
-					WRITEINT32(save_p, len);
-					for (k = 0; k < len; k++)
-						WRITECHAR(save_p, li->stringargs[j][k]);
+					SAVEWRITEINT32(len);
+					SAVEWRITEMEM(li->stringargs[j], len);
 				}
 			}
 			if (diff2 & LD_EXECUTORDELAY)
-				WRITEINT32(save_p, li->executordelay);
+				SAVEWRITEINT32(li->executordelay);
 		}
 	}
-	WRITEUINT16(save_p, 0xffff);
+	SAVEWRITEUINT16(0xffff);
 }
 
 static void UnArchiveLines(void)
@@ -1475,6 +1538,8 @@ static void UnArchiveLines(void)
 			li->executordelay = READINT32(save_p);
 
 	}
+
+	Taglist_InitLineSpecials();
 }
 
 static void P_NetArchiveWorld(void)
@@ -1482,7 +1547,7 @@ static void P_NetArchiveWorld(void)
 	// initialize colormap vars because paranoia
 	ClearNetColormaps();
 
-	WRITEUINT32(save_p, ARCHIVEBLOCK_WORLD);
+	SAVEWRITEUINT32(ARCHIVEBLOCK_WORLD);
 
 	ArchiveSectors();
 	ArchiveLines();
@@ -1827,28 +1892,28 @@ static void SaveMobjThinker(const thinker_t *th, const UINT8 type)
 	if (mobj->type == MT_HOOPCENTER)
 		diff = MD_SPAWNPOINT;
 
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, diff);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(diff);
 	if (diff & MD_MORE)
-		WRITEUINT32(save_p, diff2);
+		SAVEWRITEUINT32(diff2);
 
 	// save pointer, at load time we will search this pointer to reinitilize pointers
-	WRITEUINT32(save_p, (size_t)mobj);
+	SAVEWRITEUINT32((size_t)mobj);
 
-	WRITEFIXED(save_p, mobj->z); // Force this so 3dfloor problems don't arise.
-	WRITEFIXED(save_p, mobj->floorz);
-	WRITEFIXED(save_p, mobj->ceilingz);
+	SAVEWRITEFIXED(mobj->z); // Force this so 3dfloor problems don't arise.
+	SAVEWRITEFIXED(mobj->floorz);
+	SAVEWRITEFIXED(mobj->ceilingz);
 
 	if (diff2 & MD2_FLOORROVER)
 	{
-		WRITEUINT32(save_p, SaveSector(mobj->floorrover->target));
-		WRITEUINT16(save_p, P_GetFFloorID(mobj->floorrover));
+		SAVEWRITEUINT32(SaveSector(mobj->floorrover->target));
+		SAVEWRITEUINT16(P_GetFFloorID(mobj->floorrover));
 	}
 
 	if (diff2 & MD2_CEILINGROVER)
 	{
-		WRITEUINT32(save_p, SaveSector(mobj->ceilingrover->target));
-		WRITEUINT16(save_p, P_GetFFloorID(mobj->ceilingrover));
+		SAVEWRITEUINT32(SaveSector(mobj->ceilingrover->target));
+		SAVEWRITEUINT16(P_GetFFloorID(mobj->ceilingrover));
 	}
 
 	if (diff & MD_SPAWNPOINT)
@@ -1857,517 +1922,517 @@ static void SaveMobjThinker(const thinker_t *th, const UINT8 type)
 
 		for (z = 0; z < nummapthings; z++)
 			if (&mapthings[z] == mobj->spawnpoint)
-				WRITEUINT16(save_p, z);
+				SAVEWRITEUINT16(z);
 		if (mobj->type == MT_HOOPCENTER)
 			return;
 	}
 
 	if (diff & MD_TYPE)
-		WRITEUINT32(save_p, mobj->type);
+		SAVEWRITEUINT32(mobj->type);
 	if (diff & MD_POS)
 	{
-		WRITEFIXED(save_p, mobj->x);
-		WRITEFIXED(save_p, mobj->y);
-		WRITEANGLE(save_p, mobj->angle);
-		WRITEANGLE(save_p, mobj->pitch);
-		WRITEANGLE(save_p, mobj->roll);
+		SAVEWRITEFIXED(mobj->x);
+		SAVEWRITEFIXED(mobj->y);
+		SAVEWRITEANGLE(mobj->angle);
+		SAVEWRITEANGLE(mobj->pitch);
+		SAVEWRITEANGLE(mobj->roll);
 	}
 	if (diff & MD_MOM)
 	{
-		WRITEFIXED(save_p, mobj->momx);
-		WRITEFIXED(save_p, mobj->momy);
-		WRITEFIXED(save_p, mobj->momz);
-		WRITEFIXED(save_p, mobj->pmomz);
+		SAVEWRITEFIXED(mobj->momx);
+		SAVEWRITEFIXED(mobj->momy);
+		SAVEWRITEFIXED(mobj->momz);
+		SAVEWRITEFIXED(mobj->pmomz);
 	}
 	if (diff & MD_RADIUS)
-		WRITEFIXED(save_p, mobj->radius);
+		SAVEWRITEFIXED(mobj->radius);
 	if (diff & MD_HEIGHT)
-		WRITEFIXED(save_p, mobj->height);
+		SAVEWRITEFIXED(mobj->height);
 	if (diff & MD_FLAGS)
-		WRITEUINT32(save_p, mobj->flags);
+		SAVEWRITEUINT32(mobj->flags);
 	if (diff & MD_FLAGS2)
-		WRITEUINT32(save_p, mobj->flags2);
+		SAVEWRITEUINT32(mobj->flags2);
 	if (diff & MD_HEALTH)
-		WRITEINT32(save_p, mobj->health);
+		SAVEWRITEINT32(mobj->health);
 	if (diff & MD_RTIME)
-		WRITEINT32(save_p, mobj->reactiontime);
+		SAVEWRITEINT32(mobj->reactiontime);
 	if (diff & MD_STATE)
-		WRITEUINT16(save_p, mobj->state-states);
+		SAVEWRITEUINT16(mobj->state-states);
 	if (diff & MD_TICS)
-		WRITEINT32(save_p, mobj->tics);
+		SAVEWRITEINT32(mobj->tics);
 	if (diff & MD_SPRITE) {
-		WRITEUINT16(save_p, mobj->sprite);
+		SAVEWRITEUINT16(mobj->sprite);
 		if (mobj->sprite == SPR_PLAY)
-			WRITEUINT8(save_p, mobj->sprite2);
+			SAVEWRITEUINT8(mobj->sprite2);
 	}
 	if (diff & MD_FRAME)
 	{
-		WRITEUINT32(save_p, mobj->frame);
-		WRITEUINT16(save_p, mobj->anim_duration);
+		SAVEWRITEUINT32(mobj->frame);
+		SAVEWRITEUINT16(mobj->anim_duration);
 	}
 	if (diff & MD_EFLAGS)
-		WRITEUINT16(save_p, mobj->eflags);
+		SAVEWRITEUINT16(mobj->eflags);
 	if (diff & MD_PLAYER)
-		WRITEUINT8(save_p, mobj->player-players);
+		SAVEWRITEUINT8(mobj->player-players);
 	if (diff & MD_MOVEDIR)
-		WRITEANGLE(save_p, mobj->movedir);
+		SAVEWRITEANGLE(mobj->movedir);
 	if (diff & MD_MOVECOUNT)
-		WRITEINT32(save_p, mobj->movecount);
+		SAVEWRITEINT32(mobj->movecount);
 	if (diff & MD_THRESHOLD)
-		WRITEINT32(save_p, mobj->threshold);
+		SAVEWRITEINT32(mobj->threshold);
 	if (diff & MD_LASTLOOK)
-		WRITEINT32(save_p, mobj->lastlook);
+		SAVEWRITEINT32(mobj->lastlook);
 	if (diff & MD_TARGET)
-		WRITEUINT32(save_p, mobj->target->mobjnum);
+		SAVEWRITEUINT32(mobj->target->mobjnum);
 	if (diff & MD_TRACER)
-		WRITEUINT32(save_p, mobj->tracer->mobjnum);
+		SAVEWRITEUINT32(mobj->tracer->mobjnum);
 	if (diff & MD_FRICTION)
-		WRITEFIXED(save_p, mobj->friction);
+		SAVEWRITEFIXED(mobj->friction);
 	if (diff & MD_MOVEFACTOR)
-		WRITEFIXED(save_p, mobj->movefactor);
+		SAVEWRITEFIXED(mobj->movefactor);
 	if (diff & MD_FUSE)
-		WRITEINT32(save_p, mobj->fuse);
+		SAVEWRITEINT32(mobj->fuse);
 	if (diff & MD_WATERTOP)
-		WRITEFIXED(save_p, mobj->watertop);
+		SAVEWRITEFIXED(mobj->watertop);
 	if (diff & MD_WATERBOTTOM)
-		WRITEFIXED(save_p, mobj->waterbottom);
+		SAVEWRITEFIXED(mobj->waterbottom);
 	if (diff & MD_SCALE)
-		WRITEFIXED(save_p, mobj->scale);
+		SAVEWRITEFIXED(mobj->scale);
 	if (diff & MD_DSCALE)
-		WRITEFIXED(save_p, mobj->destscale);
+		SAVEWRITEFIXED(mobj->destscale);
 	if (diff2 & MD2_SCALESPEED)
-		WRITEFIXED(save_p, mobj->scalespeed);
+		SAVEWRITEFIXED(mobj->scalespeed);
 	if (diff2 & MD2_CUSVAL)
-		WRITEINT32(save_p, mobj->cusval);
+		SAVEWRITEINT32(mobj->cusval);
 	if (diff2 & MD2_CVMEM)
-		WRITEINT32(save_p, mobj->cvmem);
+		SAVEWRITEINT32(mobj->cvmem);
 	if (diff2 & MD2_SKIN)
-		WRITEUINT8(save_p, (UINT8)((skin_t *)mobj->skin - skins));
+		SAVEWRITEUINT8((UINT8)((skin_t *)mobj->skin - skins));
 	if (diff2 & MD2_COLOR)
-		WRITEUINT16(save_p, mobj->color);
+		SAVEWRITEUINT16(mobj->color);
 	if (diff2 & MD2_EXTVAL1)
-		WRITEINT32(save_p, mobj->extravalue1);
+		SAVEWRITEINT32(mobj->extravalue1);
 	if (diff2 & MD2_EXTVAL2)
-		WRITEINT32(save_p, mobj->extravalue2);
+		SAVEWRITEINT32(mobj->extravalue2);
 	if (diff2 & MD2_HNEXT)
-		WRITEUINT32(save_p, mobj->hnext->mobjnum);
+		SAVEWRITEUINT32(mobj->hnext->mobjnum);
 	if (diff2 & MD2_HPREV)
-		WRITEUINT32(save_p, mobj->hprev->mobjnum);
+		SAVEWRITEUINT32(mobj->hprev->mobjnum);
 	if (diff2 & MD2_SLOPE)
-		WRITEUINT16(save_p, mobj->standingslope->id);
+		SAVEWRITEUINT16(mobj->standingslope->id);
 	if (diff2 & MD2_COLORIZED)
-		WRITEUINT8(save_p, mobj->colorized);
+		SAVEWRITEUINT8(mobj->colorized);
 	if (diff2 & MD2_MIRRORED)
-		WRITEUINT8(save_p, mobj->mirrored);
+		SAVEWRITEUINT8(mobj->mirrored);
 	if (diff2 & MD2_SPRITEROLL)
-		WRITEANGLE(save_p, mobj->spriteroll);
+		SAVEWRITEANGLE(mobj->spriteroll);
 	if (diff2 & MD2_SHADOWSCALE)
-		WRITEFIXED(save_p, mobj->shadowscale);
+		SAVEWRITEFIXED(mobj->shadowscale);
 	if (diff2 & MD2_RENDERFLAGS)
-		WRITEUINT32(save_p, mobj->renderflags);
+		SAVEWRITEUINT32(mobj->renderflags);
 	if (diff2 & MD2_BLENDMODE)
-		WRITEINT32(save_p, mobj->blendmode);
+		SAVEWRITEINT32(mobj->blendmode);
 	if (diff2 & MD2_SPRITEXSCALE)
-		WRITEFIXED(save_p, mobj->spritexscale);
+		SAVEWRITEFIXED(mobj->spritexscale);
 	if (diff2 & MD2_SPRITEYSCALE)
-		WRITEFIXED(save_p, mobj->spriteyscale);
+		SAVEWRITEFIXED(mobj->spriteyscale);
 	if (diff2 & MD2_SPRITEXOFFSET)
-		WRITEFIXED(save_p, mobj->spritexoffset);
+		SAVEWRITEFIXED(mobj->spritexoffset);
 	if (diff2 & MD2_SPRITEYOFFSET)
-		WRITEFIXED(save_p, mobj->spriteyoffset);
+		SAVEWRITEFIXED(mobj->spriteyoffset);
 	if (diff2 & MD2_FLOORSPRITESLOPE)
 	{
 		pslope_t *slope = mobj->floorspriteslope;
 
-		WRITEFIXED(save_p, slope->zdelta);
-		WRITEANGLE(save_p, slope->zangle);
-		WRITEANGLE(save_p, slope->xydirection);
+		SAVEWRITEFIXED(slope->zdelta);
+		SAVEWRITEANGLE(slope->zangle);
+		SAVEWRITEANGLE(slope->xydirection);
 
-		WRITEFIXED(save_p, slope->o.x);
-		WRITEFIXED(save_p, slope->o.y);
-		WRITEFIXED(save_p, slope->o.z);
+		SAVEWRITEFIXED(slope->o.x);
+		SAVEWRITEFIXED(slope->o.y);
+		SAVEWRITEFIXED(slope->o.z);
 
-		WRITEFIXED(save_p, slope->d.x);
-		WRITEFIXED(save_p, slope->d.y);
+		SAVEWRITEFIXED(slope->d.x);
+		SAVEWRITEFIXED(slope->d.y);
 
-		WRITEFIXED(save_p, slope->normal.x);
-		WRITEFIXED(save_p, slope->normal.y);
-		WRITEFIXED(save_p, slope->normal.z);
+		SAVEWRITEFIXED(slope->normal.x);
+		SAVEWRITEFIXED(slope->normal.y);
+		SAVEWRITEFIXED(slope->normal.z);
 	}
 	if (diff2 & MD2_DRAWONLYFORPLAYER)
-		WRITEUINT8(save_p, mobj->drawonlyforplayer-players);
+		SAVEWRITEUINT8(mobj->drawonlyforplayer-players);
 	if (diff2 & MD2_DONTDRAWFORVIEWMOBJ)
-		WRITEUINT32(save_p, mobj->dontdrawforviewmobj->mobjnum);
+		SAVEWRITEUINT32(mobj->dontdrawforviewmobj->mobjnum);
 	if (diff2 & MD2_DISPOFFSET)
-		WRITEINT32(save_p, mobj->dispoffset);
+		SAVEWRITEINT32(mobj->dispoffset);
 
-	WRITEUINT32(save_p, mobj->mobjnum);
+	SAVEWRITEUINT32(mobj->mobjnum);
 }
 
 static void SaveNoEnemiesThinker(const thinker_t *th, const UINT8 type)
 {
 	const noenemies_t *ht  = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
 }
 
 static void SaveBounceCheeseThinker(const thinker_t *th, const UINT8 type)
 {
 	const bouncecheese_t *ht  = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEFIXED(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->distance);
-	WRITEFIXED(save_p, ht->floorwasheight);
-	WRITEFIXED(save_p, ht->ceilingwasheight);
-	WRITECHAR(save_p, ht->low);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEFIXED(ht->speed);
+	SAVEWRITEFIXED(ht->distance);
+	SAVEWRITEFIXED(ht->floorwasheight);
+	SAVEWRITEFIXED(ht->ceilingwasheight);
+	SAVEWRITECHAR(ht->low);
 }
 
 static void SaveContinuousFallThinker(const thinker_t *th, const UINT8 type)
 {
 	const continuousfall_t *ht  = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEFIXED(save_p, ht->speed);
-	WRITEINT32(save_p, ht->direction);
-	WRITEFIXED(save_p, ht->floorstartheight);
-	WRITEFIXED(save_p, ht->ceilingstartheight);
-	WRITEFIXED(save_p, ht->destheight);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEFIXED(ht->speed);
+	SAVEWRITEINT32(ht->direction);
+	SAVEWRITEFIXED(ht->floorstartheight);
+	SAVEWRITEFIXED(ht->ceilingstartheight);
+	SAVEWRITEFIXED(ht->destheight);
 }
 
 static void SaveMarioBlockThinker(const thinker_t *th, const UINT8 type)
 {
 	const mariothink_t *ht  = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEFIXED(save_p, ht->speed);
-	WRITEINT32(save_p, ht->direction);
-	WRITEFIXED(save_p, ht->floorstartheight);
-	WRITEFIXED(save_p, ht->ceilingstartheight);
-	WRITEINT16(save_p, ht->tag);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEFIXED(ht->speed);
+	SAVEWRITEINT32(ht->direction);
+	SAVEWRITEFIXED(ht->floorstartheight);
+	SAVEWRITEFIXED(ht->ceilingstartheight);
+	SAVEWRITEINT16(ht->tag);
 }
 
 static void SaveMarioCheckThinker(const thinker_t *th, const UINT8 type)
 {
 	const mariocheck_t *ht  = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-	WRITEUINT32(save_p, SaveSector(ht->sector));
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
+	SAVEWRITEUINT32(SaveSector(ht->sector));
 }
 
 static void SaveThwompThinker(const thinker_t *th, const UINT8 type)
 {
 	const thwomp_t *ht  = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEFIXED(save_p, ht->crushspeed);
-	WRITEFIXED(save_p, ht->retractspeed);
-	WRITEINT32(save_p, ht->direction);
-	WRITEFIXED(save_p, ht->floorstartheight);
-	WRITEFIXED(save_p, ht->ceilingstartheight);
-	WRITEINT32(save_p, ht->delay);
-	WRITEINT16(save_p, ht->tag);
-	WRITEUINT16(save_p, ht->sound);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEFIXED(ht->crushspeed);
+	SAVEWRITEFIXED(ht->retractspeed);
+	SAVEWRITEINT32(ht->direction);
+	SAVEWRITEFIXED(ht->floorstartheight);
+	SAVEWRITEFIXED(ht->ceilingstartheight);
+	SAVEWRITEINT32(ht->delay);
+	SAVEWRITEINT16(ht->tag);
+	SAVEWRITEUINT16(ht->sound);
 }
 
 static void SaveFloatThinker(const thinker_t *th, const UINT8 type)
 {
 	const floatthink_t *ht  = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT16(save_p, ht->tag);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEINT16(ht->tag);
 }
 
 static void SaveEachTimeThinker(const thinker_t *th, const UINT8 type)
 {
 	const eachtime_t *ht  = (const void *)th;
 	size_t i;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
-		WRITECHAR(save_p, ht->playersInArea[i]);
+		SAVEWRITECHAR(ht->playersInArea[i]);
 	}
-	WRITECHAR(save_p, ht->triggerOnExit);
+	SAVEWRITECHAR(ht->triggerOnExit);
 }
 
 static void SaveRaiseThinker(const thinker_t *th, const UINT8 type)
 {
 	const raise_t *ht  = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT16(save_p, ht->tag);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEFIXED(save_p, ht->ceilingbottom);
-	WRITEFIXED(save_p, ht->ceilingtop);
-	WRITEFIXED(save_p, ht->basespeed);
-	WRITEFIXED(save_p, ht->extraspeed);
-	WRITEUINT8(save_p, ht->shaketimer);
-	WRITEUINT8(save_p, ht->flags);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT16(ht->tag);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEFIXED(ht->ceilingbottom);
+	SAVEWRITEFIXED(ht->ceilingtop);
+	SAVEWRITEFIXED(ht->basespeed);
+	SAVEWRITEFIXED(ht->extraspeed);
+	SAVEWRITEUINT8(ht->shaketimer);
+	SAVEWRITEUINT8(ht->flags);
 }
 
 static void SaveCeilingThinker(const thinker_t *th, const UINT8 type)
 {
 	const ceiling_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEFIXED(save_p, ht->bottomheight);
-	WRITEFIXED(save_p, ht->topheight);
-	WRITEFIXED(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->delay);
-	WRITEFIXED(save_p, ht->delaytimer);
-	WRITEUINT8(save_p, ht->crush);
-	WRITEINT32(save_p, ht->texture);
-	WRITEINT32(save_p, ht->direction);
-	WRITEINT16(save_p, ht->tag);
-	WRITEFIXED(save_p, ht->origspeed);
-	WRITEFIXED(save_p, ht->sourceline);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT8(ht->type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEFIXED(ht->bottomheight);
+	SAVEWRITEFIXED(ht->topheight);
+	SAVEWRITEFIXED(ht->speed);
+	SAVEWRITEFIXED(ht->delay);
+	SAVEWRITEFIXED(ht->delaytimer);
+	SAVEWRITEUINT8(ht->crush);
+	SAVEWRITEINT32(ht->texture);
+	SAVEWRITEINT32(ht->direction);
+	SAVEWRITEINT16(ht->tag);
+	SAVEWRITEFIXED(ht->origspeed);
+	SAVEWRITEFIXED(ht->sourceline);
 }
 
 static void SaveFloormoveThinker(const thinker_t *th, const UINT8 type)
 {
 	const floormove_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEUINT8(save_p, ht->crush);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->direction);
-	WRITEINT32(save_p, ht->texture);
-	WRITEFIXED(save_p, ht->floordestheight);
-	WRITEFIXED(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->origspeed);
-	WRITEFIXED(save_p, ht->delay);
-	WRITEFIXED(save_p, ht->delaytimer);
-	WRITEINT16(save_p, ht->tag);
-	WRITEFIXED(save_p, ht->sourceline);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT8(ht->type);
+	SAVEWRITEUINT8(ht->crush);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEINT32(ht->direction);
+	SAVEWRITEINT32(ht->texture);
+	SAVEWRITEFIXED(ht->floordestheight);
+	SAVEWRITEFIXED(ht->speed);
+	SAVEWRITEFIXED(ht->origspeed);
+	SAVEWRITEFIXED(ht->delay);
+	SAVEWRITEFIXED(ht->delaytimer);
+	SAVEWRITEINT16(ht->tag);
+	SAVEWRITEFIXED(ht->sourceline);
 }
 
 static void SaveLightflashThinker(const thinker_t *th, const UINT8 type)
 {
 	const lightflash_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->maxlight);
-	WRITEINT32(save_p, ht->minlight);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEINT32(ht->maxlight);
+	SAVEWRITEINT32(ht->minlight);
 }
 
 static void SaveStrobeThinker(const thinker_t *th, const UINT8 type)
 {
 	const strobe_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->count);
-	WRITEINT16(save_p, ht->minlight);
-	WRITEINT16(save_p, ht->maxlight);
-	WRITEINT32(save_p, ht->darktime);
-	WRITEINT32(save_p, ht->brighttime);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEINT32(ht->count);
+	SAVEWRITEINT16(ht->minlight);
+	SAVEWRITEINT16(ht->maxlight);
+	SAVEWRITEINT32(ht->darktime);
+	SAVEWRITEINT32(ht->brighttime);
 }
 
 static void SaveGlowThinker(const thinker_t *th, const UINT8 type)
 {
 	const glow_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT16(save_p, ht->minlight);
-	WRITEINT16(save_p, ht->maxlight);
-	WRITEINT16(save_p, ht->direction);
-	WRITEINT16(save_p, ht->speed);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEINT16(ht->minlight);
+	SAVEWRITEINT16(ht->maxlight);
+	SAVEWRITEINT16(ht->direction);
+	SAVEWRITEINT16(ht->speed);
 }
 
 static inline void SaveFireflickerThinker(const thinker_t *th, const UINT8 type)
 {
 	const fireflicker_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->count);
-	WRITEINT32(save_p, ht->resetcount);
-	WRITEINT16(save_p, ht->maxlight);
-	WRITEINT16(save_p, ht->minlight);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEINT32(ht->count);
+	SAVEWRITEINT32(ht->resetcount);
+	SAVEWRITEINT16(ht->maxlight);
+	SAVEWRITEINT16(ht->minlight);
 }
 
 static void SaveElevatorThinker(const thinker_t *th, const UINT8 type)
 {
 	const elevator_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEUINT32(save_p, SaveSector(ht->actionsector));
-	WRITEINT32(save_p, ht->direction);
-	WRITEFIXED(save_p, ht->floordestheight);
-	WRITEFIXED(save_p, ht->ceilingdestheight);
-	WRITEFIXED(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->origspeed);
-	WRITEFIXED(save_p, ht->low);
-	WRITEFIXED(save_p, ht->high);
-	WRITEFIXED(save_p, ht->distance);
-	WRITEFIXED(save_p, ht->delay);
-	WRITEFIXED(save_p, ht->delaytimer);
-	WRITEFIXED(save_p, ht->floorwasheight);
-	WRITEFIXED(save_p, ht->ceilingwasheight);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT8(ht->type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEUINT32(SaveSector(ht->actionsector));
+	SAVEWRITEINT32(ht->direction);
+	SAVEWRITEFIXED(ht->floordestheight);
+	SAVEWRITEFIXED(ht->ceilingdestheight);
+	SAVEWRITEFIXED(ht->speed);
+	SAVEWRITEFIXED(ht->origspeed);
+	SAVEWRITEFIXED(ht->low);
+	SAVEWRITEFIXED(ht->high);
+	SAVEWRITEFIXED(ht->distance);
+	SAVEWRITEFIXED(ht->delay);
+	SAVEWRITEFIXED(ht->delaytimer);
+	SAVEWRITEFIXED(ht->floorwasheight);
+	SAVEWRITEFIXED(ht->ceilingwasheight);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
 }
 
 static void SaveCrumbleThinker(const thinker_t *th, const UINT8 type)
 {
 	const crumble_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEUINT32(save_p, SaveSector(ht->actionsector));
-	WRITEUINT32(save_p, SavePlayer(ht->player)); // was dummy
-	WRITEINT32(save_p, ht->direction);
-	WRITEINT32(save_p, ht->origalpha);
-	WRITEINT32(save_p, ht->timer);
-	WRITEFIXED(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->floorwasheight);
-	WRITEFIXED(save_p, ht->ceilingwasheight);
-	WRITEUINT8(save_p, ht->flags);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEUINT32(SaveSector(ht->actionsector));
+	SAVEWRITEUINT32(SavePlayer(ht->player)); // was dummy
+	SAVEWRITEINT32(ht->direction);
+	SAVEWRITEINT32(ht->origalpha);
+	SAVEWRITEINT32(ht->timer);
+	SAVEWRITEFIXED(ht->speed);
+	SAVEWRITEFIXED(ht->floorwasheight);
+	SAVEWRITEFIXED(ht->ceilingwasheight);
+	SAVEWRITEUINT8(ht->flags);
 }
 
 static inline void SaveScrollThinker(const thinker_t *th, const UINT8 type)
 {
 	const scroll_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEFIXED(save_p, ht->dx);
-	WRITEFIXED(save_p, ht->dy);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEINT32(save_p, ht->control);
-	WRITEFIXED(save_p, ht->last_height);
-	WRITEFIXED(save_p, ht->vdx);
-	WRITEFIXED(save_p, ht->vdy);
-	WRITEINT32(save_p, ht->accel);
-	WRITEINT32(save_p, ht->exclusive);
-	WRITEUINT8(save_p, ht->type);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEFIXED(ht->dx);
+	SAVEWRITEFIXED(ht->dy);
+	SAVEWRITEINT32(ht->affectee);
+	SAVEWRITEINT32(ht->control);
+	SAVEWRITEFIXED(ht->last_height);
+	SAVEWRITEFIXED(ht->vdx);
+	SAVEWRITEFIXED(ht->vdy);
+	SAVEWRITEINT32(ht->accel);
+	SAVEWRITEINT32(ht->exclusive);
+	SAVEWRITEUINT8(ht->type);
 }
 
 static inline void SaveFrictionThinker(const thinker_t *th, const UINT8 type)
 {
 	const friction_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->friction);
-	WRITEINT32(save_p, ht->movefactor);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEINT32(save_p, ht->referrer);
-	WRITEUINT8(save_p, ht->roverfriction);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->friction);
+	SAVEWRITEINT32(ht->movefactor);
+	SAVEWRITEINT32(ht->affectee);
+	SAVEWRITEINT32(ht->referrer);
+	SAVEWRITEUINT8(ht->roverfriction);
 }
 
 static inline void SavePusherThinker(const thinker_t *th, const UINT8 type)
 {
 	const pusher_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEFIXED(save_p, ht->x_mag);
-	WRITEFIXED(save_p, ht->y_mag);
-	WRITEFIXED(save_p, ht->z_mag);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEUINT8(save_p, ht->roverpusher);
-	WRITEINT32(save_p, ht->referrer);
-	WRITEINT32(save_p, ht->exclusive);
-	WRITEINT32(save_p, ht->slider);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT8(ht->type);
+	SAVEWRITEFIXED(ht->x_mag);
+	SAVEWRITEFIXED(ht->y_mag);
+	SAVEWRITEFIXED(ht->z_mag);
+	SAVEWRITEINT32(ht->affectee);
+	SAVEWRITEUINT8(ht->roverpusher);
+	SAVEWRITEINT32(ht->referrer);
+	SAVEWRITEINT32(ht->exclusive);
+	SAVEWRITEINT32(ht->slider);
 }
 
 static void SaveLaserThinker(const thinker_t *th, const UINT8 type)
 {
 	const laserthink_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT16(save_p, ht->tag);
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-	WRITEUINT8(save_p, ht->nobosses);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT16(ht->tag);
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
+	SAVEWRITEUINT8(ht->nobosses);
 }
 
 static void SaveLightlevelThinker(const thinker_t *th, const UINT8 type)
 {
 	const lightlevel_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT16(save_p, ht->sourcelevel);
-	WRITEINT16(save_p, ht->destlevel);
-	WRITEFIXED(save_p, ht->fixedcurlevel);
-	WRITEFIXED(save_p, ht->fixedpertic);
-	WRITEINT32(save_p, ht->timer);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEINT16(ht->sourcelevel);
+	SAVEWRITEINT16(ht->destlevel);
+	SAVEWRITEFIXED(ht->fixedcurlevel);
+	SAVEWRITEFIXED(ht->fixedpertic);
+	SAVEWRITEINT32(ht->timer);
 }
 
 static void SaveExecutorThinker(const thinker_t *th, const UINT8 type)
 {
 	const executor_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveLine(ht->line));
-	WRITEUINT32(save_p, SaveMobjnum(ht->caller));
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEINT32(save_p, ht->timer);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveLine(ht->line));
+	SAVEWRITEUINT32(SaveMobjnum(ht->caller));
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEINT32(ht->timer);
 }
 
 static void SaveDisappearThinker(const thinker_t *th, const UINT8 type)
 {
 	const disappear_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, ht->appeartime);
-	WRITEUINT32(save_p, ht->disappeartime);
-	WRITEUINT32(save_p, ht->offset);
-	WRITEUINT32(save_p, ht->timer);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEINT32(save_p, ht->sourceline);
-	WRITEINT32(save_p, ht->exists);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(ht->appeartime);
+	SAVEWRITEUINT32(ht->disappeartime);
+	SAVEWRITEUINT32(ht->offset);
+	SAVEWRITEUINT32(ht->timer);
+	SAVEWRITEINT32(ht->affectee);
+	SAVEWRITEINT32(ht->sourceline);
+	SAVEWRITEINT32(ht->exists);
 }
 
 static void SaveFadeThinker(const thinker_t *th, const UINT8 type)
 {
 	const fade_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, CheckAddNetColormapToList(ht->dest_exc));
-	WRITEUINT32(save_p, ht->sectornum);
-	WRITEUINT32(save_p, ht->ffloornum);
-	WRITEINT32(save_p, ht->alpha);
-	WRITEINT16(save_p, ht->sourcevalue);
-	WRITEINT16(save_p, ht->destvalue);
-	WRITEINT16(save_p, ht->destlightlevel);
-	WRITEINT16(save_p, ht->speed);
-	WRITEUINT8(save_p, (UINT8)ht->ticbased);
-	WRITEINT32(save_p, ht->timer);
-	WRITEUINT8(save_p, ht->doexists);
-	WRITEUINT8(save_p, ht->dotranslucent);
-	WRITEUINT8(save_p, ht->dolighting);
-	WRITEUINT8(save_p, ht->docolormap);
-	WRITEUINT8(save_p, ht->docollision);
-	WRITEUINT8(save_p, ht->doghostfade);
-	WRITEUINT8(save_p, ht->exactalpha);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(CheckAddNetColormapToList(ht->dest_exc));
+	SAVEWRITEUINT32(ht->sectornum);
+	SAVEWRITEUINT32(ht->ffloornum);
+	SAVEWRITEINT32(ht->alpha);
+	SAVEWRITEINT16(ht->sourcevalue);
+	SAVEWRITEINT16(ht->destvalue);
+	SAVEWRITEINT16(ht->destlightlevel);
+	SAVEWRITEINT16(ht->speed);
+	SAVEWRITEUINT8((UINT8)ht->ticbased);
+	SAVEWRITEINT32(ht->timer);
+	SAVEWRITEUINT8(ht->doexists);
+	SAVEWRITEUINT8(ht->dotranslucent);
+	SAVEWRITEUINT8(ht->dolighting);
+	SAVEWRITEUINT8(ht->docolormap);
+	SAVEWRITEUINT8(ht->docollision);
+	SAVEWRITEUINT8(ht->doghostfade);
+	SAVEWRITEUINT8(ht->exactalpha);
 }
 
 static void SaveFadeColormapThinker(const thinker_t *th, const UINT8 type)
 {
 	const fadecolormap_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSector(ht->sector));
-	WRITEUINT32(save_p, CheckAddNetColormapToList(ht->source_exc));
-	WRITEUINT32(save_p, CheckAddNetColormapToList(ht->dest_exc));
-	WRITEUINT8(save_p, (UINT8)ht->ticbased);
-	WRITEINT32(save_p, ht->duration);
-	WRITEINT32(save_p, ht->timer);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSector(ht->sector));
+	SAVEWRITEUINT32(CheckAddNetColormapToList(ht->source_exc));
+	SAVEWRITEUINT32(CheckAddNetColormapToList(ht->dest_exc));
+	SAVEWRITEUINT8((UINT8)ht->ticbased);
+	SAVEWRITEINT32(ht->duration);
+	SAVEWRITEINT32(ht->timer);
 }
 
 static void SavePlaneDisplaceThinker(const thinker_t *th, const UINT8 type)
 {
 	const planedisplace_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->affectee);
-	WRITEINT32(save_p, ht->control);
-	WRITEFIXED(save_p, ht->last_height);
-	WRITEFIXED(save_p, ht->speed);
-	WRITEUINT8(save_p, ht->type);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->affectee);
+	SAVEWRITEINT32(ht->control);
+	SAVEWRITEFIXED(ht->last_height);
+	SAVEWRITEFIXED(ht->speed);
+	SAVEWRITEUINT8(ht->type);
 }
 
 static inline void SaveDynamicLineSlopeThinker(const thinker_t *th, const UINT8 type)
 {
 	const dynlineplanethink_t* ht = (const void*)th;
 
-	WRITEUINT8(save_p, type);
-	WRITEUINT8(save_p, ht->type);
-	WRITEUINT32(save_p, SaveSlope(ht->slope));
-	WRITEUINT32(save_p, SaveLine(ht->sourceline));
-	WRITEFIXED(save_p, ht->extent);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT8(ht->type);
+	SAVEWRITEUINT32(SaveSlope(ht->slope));
+	SAVEWRITEUINT32(SaveLine(ht->sourceline));
+	SAVEWRITEFIXED(ht->extent);
 }
 
 static inline void SaveDynamicVertexSlopeThinker(const thinker_t *th, const UINT8 type)
@@ -2375,119 +2440,119 @@ static inline void SaveDynamicVertexSlopeThinker(const thinker_t *th, const UINT
 	size_t i;
 	const dynvertexplanethink_t* ht = (const void*)th;
 
-	WRITEUINT8(save_p, type);
-	WRITEUINT32(save_p, SaveSlope(ht->slope));
+	SAVEWRITEUINT8(type);
+	SAVEWRITEUINT32(SaveSlope(ht->slope));
 	for (i = 0; i < 3; i++)
-		WRITEUINT32(save_p, SaveSector(ht->secs[i]));
-	WRITEMEM(save_p, ht->vex, sizeof(ht->vex));
-	WRITEMEM(save_p, ht->origsecheights, sizeof(ht->origsecheights));
-	WRITEMEM(save_p, ht->origvecheights, sizeof(ht->origvecheights));
-	WRITEUINT8(save_p, ht->relative);
+		SAVEWRITEUINT32(SaveSector(ht->secs[i]));
+	SAVEWRITEMEM(ht->vex, sizeof(ht->vex));
+	SAVEWRITEMEM(ht->origsecheights, sizeof(ht->origsecheights));
+	SAVEWRITEMEM(ht->origvecheights, sizeof(ht->origvecheights));
+	SAVEWRITEUINT8(ht->relative);
 }
 
 static inline void SavePolyrotatetThinker(const thinker_t *th, const UINT8 type)
 {
 	const polyrotate_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->speed);
-	WRITEINT32(save_p, ht->distance);
-	WRITEUINT8(save_p, ht->turnobjs);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->polyObjNum);
+	SAVEWRITEINT32(ht->speed);
+	SAVEWRITEINT32(ht->distance);
+	SAVEWRITEUINT8(ht->turnobjs);
 }
 
 static void SavePolymoveThinker(const thinker_t *th, const UINT8 type)
 {
 	const polymove_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->speed);
-	WRITEFIXED(save_p, ht->momx);
-	WRITEFIXED(save_p, ht->momy);
-	WRITEINT32(save_p, ht->distance);
-	WRITEANGLE(save_p, ht->angle);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->polyObjNum);
+	SAVEWRITEINT32(ht->speed);
+	SAVEWRITEFIXED(ht->momx);
+	SAVEWRITEFIXED(ht->momy);
+	SAVEWRITEINT32(ht->distance);
+	SAVEWRITEANGLE(ht->angle);
 }
 
 static void SavePolywaypointThinker(const thinker_t *th, UINT8 type)
 {
 	const polywaypoint_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->speed);
-	WRITEINT32(save_p, ht->sequence);
-	WRITEINT32(save_p, ht->pointnum);
-	WRITEINT32(save_p, ht->direction);
-	WRITEUINT8(save_p, ht->returnbehavior);
-	WRITEUINT8(save_p, ht->continuous);
-	WRITEUINT8(save_p, ht->stophere);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->polyObjNum);
+	SAVEWRITEINT32(ht->speed);
+	SAVEWRITEINT32(ht->sequence);
+	SAVEWRITEINT32(ht->pointnum);
+	SAVEWRITEINT32(ht->direction);
+	SAVEWRITEUINT8(ht->returnbehavior);
+	SAVEWRITEUINT8(ht->continuous);
+	SAVEWRITEUINT8(ht->stophere);
 }
 
 static void SavePolyslidedoorThinker(const thinker_t *th, const UINT8 type)
 {
 	const polyslidedoor_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->delay);
-	WRITEINT32(save_p, ht->delayCount);
-	WRITEINT32(save_p, ht->initSpeed);
-	WRITEINT32(save_p, ht->speed);
-	WRITEINT32(save_p, ht->initDistance);
-	WRITEINT32(save_p, ht->distance);
-	WRITEUINT32(save_p, ht->initAngle);
-	WRITEUINT32(save_p, ht->angle);
-	WRITEUINT32(save_p, ht->revAngle);
-	WRITEFIXED(save_p, ht->momx);
-	WRITEFIXED(save_p, ht->momy);
-	WRITEUINT8(save_p, ht->closing);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->polyObjNum);
+	SAVEWRITEINT32(ht->delay);
+	SAVEWRITEINT32(ht->delayCount);
+	SAVEWRITEINT32(ht->initSpeed);
+	SAVEWRITEINT32(ht->speed);
+	SAVEWRITEINT32(ht->initDistance);
+	SAVEWRITEINT32(ht->distance);
+	SAVEWRITEUINT32(ht->initAngle);
+	SAVEWRITEUINT32(ht->angle);
+	SAVEWRITEUINT32(ht->revAngle);
+	SAVEWRITEFIXED(ht->momx);
+	SAVEWRITEFIXED(ht->momy);
+	SAVEWRITEUINT8(ht->closing);
 }
 
 static void SavePolyswingdoorThinker(const thinker_t *th, const UINT8 type)
 {
 	const polyswingdoor_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->delay);
-	WRITEINT32(save_p, ht->delayCount);
-	WRITEINT32(save_p, ht->initSpeed);
-	WRITEINT32(save_p, ht->speed);
-	WRITEINT32(save_p, ht->initDistance);
-	WRITEINT32(save_p, ht->distance);
-	WRITEUINT8(save_p, ht->closing);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->polyObjNum);
+	SAVEWRITEINT32(ht->delay);
+	SAVEWRITEINT32(ht->delayCount);
+	SAVEWRITEINT32(ht->initSpeed);
+	SAVEWRITEINT32(ht->speed);
+	SAVEWRITEINT32(ht->initDistance);
+	SAVEWRITEINT32(ht->distance);
+	SAVEWRITEUINT8(ht->closing);
 }
 
 static void SavePolydisplaceThinker(const thinker_t *th, const UINT8 type)
 {
 	const polydisplace_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEUINT32(save_p, SaveSector(ht->controlSector));
-	WRITEFIXED(save_p, ht->dx);
-	WRITEFIXED(save_p, ht->dy);
-	WRITEFIXED(save_p, ht->oldHeights);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->polyObjNum);
+	SAVEWRITEUINT32(SaveSector(ht->controlSector));
+	SAVEWRITEFIXED(ht->dx);
+	SAVEWRITEFIXED(ht->dy);
+	SAVEWRITEFIXED(ht->oldHeights);
 }
 
 static void SavePolyrotdisplaceThinker(const thinker_t *th, const UINT8 type)
 {
 	const polyrotdisplace_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEUINT32(save_p, SaveSector(ht->controlSector));
-	WRITEFIXED(save_p, ht->rotscale);
-	WRITEUINT8(save_p, ht->turnobjs);
-	WRITEFIXED(save_p, ht->oldHeights);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->polyObjNum);
+	SAVEWRITEUINT32(SaveSector(ht->controlSector));
+	SAVEWRITEFIXED(ht->rotscale);
+	SAVEWRITEUINT8(ht->turnobjs);
+	SAVEWRITEFIXED(ht->oldHeights);
 }
 
 static void SavePolyfadeThinker(const thinker_t *th, const UINT8 type)
 {
 	const polyfade_t *ht = (const void *)th;
-	WRITEUINT8(save_p, type);
-	WRITEINT32(save_p, ht->polyObjNum);
-	WRITEINT32(save_p, ht->sourcevalue);
-	WRITEINT32(save_p, ht->destvalue);
-	WRITEUINT8(save_p, (UINT8)ht->docollision);
-	WRITEUINT8(save_p, (UINT8)ht->doghostfade);
-	WRITEUINT8(save_p, (UINT8)ht->ticbased);
-	WRITEINT32(save_p, ht->duration);
-	WRITEINT32(save_p, ht->timer);
+	SAVEWRITEUINT8(type);
+	SAVEWRITEINT32(ht->polyObjNum);
+	SAVEWRITEINT32(ht->sourcevalue);
+	SAVEWRITEINT32(ht->destvalue);
+	SAVEWRITEUINT8((UINT8)ht->docollision);
+	SAVEWRITEUINT8((UINT8)ht->doghostfade);
+	SAVEWRITEUINT8((UINT8)ht->ticbased);
+	SAVEWRITEINT32(ht->duration);
+	SAVEWRITEINT32(ht->timer);
 }
 
 static void P_NetArchiveThinkers(void)
@@ -2495,7 +2560,7 @@ static void P_NetArchiveThinkers(void)
 	const thinker_t *th;
 	UINT32 i;
 
-	WRITEUINT32(save_p, ARCHIVEBLOCK_THINKERS);
+	SAVEWRITEUINT32(ARCHIVEBLOCK_THINKERS);
 
 	for (i = 0; i < NUM_THINKERLISTS; i++)
 	{
@@ -2507,6 +2572,7 @@ static void P_NetArchiveThinkers(void)
 			 || th->function.acp1 == (actionf_p1)P_NullPrecipThinker))
 				numsaved++;
 
+
 			if (th->function.acp1 == (actionf_p1)P_MobjThinker)
 			{
 				SaveMobjThinker(th, tc_mobj);
@@ -2723,7 +2789,7 @@ static void P_NetArchiveThinkers(void)
 
 		CONS_Debug(DBG_NETPLAY, "%u thinkers saved in list %d\n", numsaved, i);
 
-		WRITEUINT8(save_p, tc_end);
+		SAVEWRITEUINT8(tc_end);
 	}
 }
 
@@ -3923,7 +3989,11 @@ static void P_NetUnArchiveThinkers(void)
 					I_Error("P_UnarchiveSpecials: Unknown tclass %d in savegame", tclass);
 			}
 			if (th)
+			{
 				P_AddThinker(i, th);
+				if (tclass == tc_mobj)
+					P_LinkMobjRegistries((mobj_t *)th);
+			}
 		}
 
 		CONS_Debug(DBG_NETPLAY, "%u thinkers loaded in list %d\n", numloaded, i);
@@ -3959,23 +4029,23 @@ static void P_NetUnArchiveThinkers(void)
 static inline void P_ArchivePolyObj(polyobj_t *po)
 {
 	UINT8 diff = 0;
-	WRITEINT32(save_p, po->id);
-	WRITEANGLE(save_p, po->angle);
+	SAVEWRITEINT32(po->id);
+	SAVEWRITEANGLE(po->angle);
 
-	WRITEFIXED(save_p, po->spawnSpot.x);
-	WRITEFIXED(save_p, po->spawnSpot.y);
+	SAVEWRITEFIXED(po->spawnSpot.x);
+	SAVEWRITEFIXED(po->spawnSpot.y);
 
 	if (po->flags != po->spawnflags)
 		diff |= PD_FLAGS;
 	if (po->translucency != po->spawntrans)
 		diff |= PD_TRANS;
 
-	WRITEUINT8(save_p, diff);
+	SAVEWRITEUINT8(diff);
 
 	if (diff & PD_FLAGS)
-		WRITEINT32(save_p, po->flags);
+		SAVEWRITEINT32(po->flags);
 	if (diff & PD_TRANS)
-		WRITEINT32(save_p, po->translucency);
+		SAVEWRITEINT32(po->translucency);
 }
 
 static inline void P_UnArchivePolyObj(polyobj_t *po)
@@ -4017,10 +4087,10 @@ static inline void P_ArchivePolyObjects(void)
 {
 	INT32 i;
 
-	WRITEUINT32(save_p, ARCHIVEBLOCK_POBJS);
+	SAVEWRITEUINT32(ARCHIVEBLOCK_POBJS);
 
 	// save number of polyobjects
-	WRITEINT32(save_p, numPolyObjects);
+	SAVEWRITEINT32(numPolyObjects);
 
 	for (i = 0; i < numPolyObjects; ++i)
 		P_ArchivePolyObj(&PolyObjects[i]);
@@ -4161,7 +4231,7 @@ static inline void P_NetArchiveSpecials(void)
 {
 	size_t i, z;
 
-	WRITEUINT32(save_p, ARCHIVEBLOCK_SPECIALS);
+	SAVEWRITEUINT32(ARCHIVEBLOCK_SPECIALS);
 
 	// itemrespawn queue for deathmatch
 	i = iquetail;
@@ -4171,30 +4241,31 @@ static inline void P_NetArchiveSpecials(void)
 		{
 			if (&mapthings[z] == itemrespawnque[i])
 			{
-				WRITEUINT32(save_p, z);
+				SAVEWRITEUINT32(z);
 				break;
 			}
 		}
-		WRITEUINT32(save_p, itemrespawntime[i]);
+		SAVEWRITEUINT32(itemrespawntime[i]);
 		i = (i + 1) & (ITEMQUESIZE-1);
 	}
 
 	// end delimiter
-	WRITEUINT32(save_p, 0xffffffff);
+	SAVEWRITEUINT32(0xffffffff);
 
 	// Sky number
-	WRITEINT32(save_p, globallevelskynum);
+	SAVEWRITEINT32(globallevelskynum);
 
 	// Current global weather type
-	WRITEUINT8(save_p, globalweather);
+	SAVEWRITEUINT8(globalweather);
 
 	if (metalplayback) // Is metal sonic running?
 	{
-		WRITEUINT8(save_p, 0x01);
+		SAVEWRITEUINT8(0x01);
+		P_SaveBufferReserve(sizeof (UINT32)); // G_SaveMetal writes through its own pointer
 		G_SaveMetal(&save_p);
 	}
 	else
-		WRITEUINT8(save_p, 0x00);
+		SAVEWRITEUINT8(0x00);
 }
 
 static void P_NetUnArchiveSpecials(void)
@@ -4247,9 +4318,9 @@ static inline void P_ArchiveMisc(INT16 mapnum)
 	if (gamecomplete)
 		mapnum |= 8192;
 
-	WRITEINT16(save_p, mapnum);
-	WRITEUINT16(save_p, emeralds+357);
-	WRITESTRINGN(save_p, timeattackfolder, sizeof(timeattackfolder));
+	SAVEWRITEINT16(mapnum);
+	SAVEWRITEUINT16(emeralds+357);
+	SAVEWRITESTRINGN(timeattackfolder, sizeof(timeattackfolder));
 }
 
 static inline void P_UnArchiveSPGame(INT16 mapoverride)
@@ -4297,83 +4368,83 @@ static void P_NetArchiveMisc(boolean resending)
 {
 	INT32 i;
 
-	WRITEUINT32(save_p, ARCHIVEBLOCK_MISC);
+	SAVEWRITEUINT32(ARCHIVEBLOCK_MISC);
 
 	if (resending)
-		WRITEUINT32(save_p, gametic);
-	WRITEINT16(save_p, gamemap);
+		SAVEWRITEUINT32(gametic);
+	SAVEWRITEINT16(gamemap);
 
 	if (gamestate != GS_LEVEL)
-		WRITEINT16(save_p, GS_WAITINGPLAYERS); // nice hack to put people back into waitingplayers
+		SAVEWRITEINT16(GS_WAITINGPLAYERS); // nice hack to put people back into waitingplayers
 	else
-		WRITEINT16(save_p, gamestate);
-	WRITEINT16(save_p, gametype);
+		SAVEWRITEINT16(gamestate);
+	SAVEWRITEINT16(gametype);
 
 	{
 		UINT32 pig = 0;
 		for (i = 0; i < MAXPLAYERS; i++)
 			pig |= (playeringame[i] != 0)<<i;
-		WRITEUINT32(save_p, pig);
+		SAVEWRITEUINT32(pig);
 	}
 
-	WRITEUINT32(save_p, P_GetRandSeed());
+	SAVEWRITEUINT32(P_GetRandSeed());
 
-	WRITEUINT32(save_p, tokenlist);
+	SAVEWRITEUINT32(tokenlist);
 
-	WRITEUINT32(save_p, leveltime);
-	WRITEUINT32(save_p, ssspheres);
-	WRITEINT16(save_p, lastmap);
-	WRITEUINT16(save_p, bossdisabled);
+	SAVEWRITEUINT32(leveltime);
+	SAVEWRITEUINT32(ssspheres);
+	SAVEWRITEINT16(lastmap);
+	SAVEWRITEUINT16(bossdisabled);
 
-	WRITEUINT16(save_p, emeralds);
+	SAVEWRITEUINT16(emeralds);
 	{
 		UINT8 globools = 0;
 		if (stagefailed)
 			globools |= 1;
 		if (stoppedclock)
 			globools |= (1<<1);
-		WRITEUINT8(save_p, globools);
+		SAVEWRITEUINT8(globools);
 	}
 
-	WRITEUINT32(save_p, token);
-	WRITEINT32(save_p, sstimer);
-	WRITEUINT32(save_p, bluescore);
-	WRITEUINT32(save_p, redscore);
+	SAVEWRITEUINT32(token);
+	SAVEWRITEINT32(sstimer);
+	SAVEWRITEUINT32(bluescore);
+	SAVEWRITEUINT32(redscore);
 
-	WRITEUINT16(save_p, skincolor_redteam);
-	WRITEUINT16(save_p, skincolor_blueteam);
-	WRITEUINT16(save_p, skincolor_redring);
-	WRITEUINT16(save_p, skincolor_bluering);
+	SAVEWRITEUINT16(skincolor_redteam);
+	SAVEWRITEUINT16(skincolor_blueteam);
+	SAVEWRITEUINT16(skincolor_redring);
+	SAVEWRITEUINT16(skincolor_bluering);
 
-	WRITEINT32(save_p, modulothing);
+	SAVEWRITEINT32(modulothing);
 
-	WRITEINT16(save_p, autobalance);
-	WRITEINT16(save_p, teamscramble);
+	SAVEWRITEINT16(autobalance);
+	SAVEWRITEINT16(teamscramble);
 
 	for (i = 0; i < MAXPLAYERS; i++)
-		WRITEINT16(save_p, scrambleplayers[i]);
+		SAVEWRITEINT16(scrambleplayers[i]);
 
 	for (i = 0; i < MAXPLAYERS; i++)
-		WRITEINT16(save_p, scrambleteams[i]);
+		SAVEWRITEINT16(scrambleteams[i]);
 
-	WRITEINT16(save_p, scrambletotal);
-	WRITEINT16(save_p, scramblecount);
+	SAVEWRITEINT16(scrambletotal);
+	SAVEWRITEINT16(scramblecount);
 
-	WRITEUINT32(save_p, countdown);
-	WRITEUINT32(save_p, countdown2);
+	SAVEWRITEUINT32(countdown);
+	SAVEWRITEUINT32(countdown2);
 
-	WRITEFIXED(save_p, gravity);
+	SAVEWRITEFIXED(gravity);
 
-	WRITEUINT32(save_p, countdowntimer);
-	WRITEUINT8(save_p, countdowntimeup);
+	SAVEWRITEUINT32(countdowntimer);
+	SAVEWRITEUINT8(countdowntimeup);
 
-	WRITEUINT32(save_p, hidetime);
+	SAVEWRITEUINT32(hidetime);
 
 	// Is it paused?
 	if (paused)
-		WRITEUINT8(save_p, 0x2f);
+		SAVEWRITEUINT8(0x2f);
 	else
-		WRITEUINT8(save_p, 0x2e);
+		SAVEWRITEUINT8(0x2e);
 }
 
 static inline boolean P_NetUnArchiveMisc(boolean reloading)
@@ -4481,23 +4552,24 @@ static inline void P_NetArchiveEmblems(void)
 	UINT8 btemp;
 	INT32 curmare;
 
-	WRITEUINT32(save_p, ARCHIVEBLOCK_EMBLEMS);
+	// everything up to the NiGHTS records
+	SAVEWRITEUINT32(ARCHIVEBLOCK_EMBLEMS);
 
 	// These should be synchronized before savegame loading by the wad files being the same anyway,
 	// but just in case, for now, we'll leave them here for testing. It would be very bad if they mismatch.
-	WRITEUINT8(save_p, (UINT8)savemoddata);
-	WRITEINT32(save_p, numemblems);
-	WRITEINT32(save_p, numextraemblems);
+	SAVEWRITEUINT8((UINT8)savemoddata);
+	SAVEWRITEINT32(numemblems);
+	SAVEWRITEINT32(numextraemblems);
 
 	// The rest of this is lifted straight from G_SaveGameData in g_game.c
 	// TODO: Optimize this to only send information about emblems, unlocks, etc. which actually exist
 	//       There is no need to go all the way up to MAXEMBLEMS when wads are guaranteed to be the same.
 
-	WRITEUINT32(save_p, data->totalplaytime);
+	SAVEWRITEUINT32(data->totalplaytime);
 
 	// TODO put another cipher on these things? meh, I don't care...
 	for (i = 0; i < NUMMAPS; i++)
-		WRITEUINT8(save_p, (data->mapvisited[i] & MV_MAX));
+		SAVEWRITEUINT8((data->mapvisited[i] & MV_MAX));
 
 	// To save space, use one bit per collected/achieved/unlocked flag
 	for (i = 0; i < MAXEMBLEMS;)
@@ -4505,7 +4577,7 @@ static inline void P_NetArchiveEmblems(void)
 		btemp = 0;
 		for (j = 0; j < 8 && j+i < MAXEMBLEMS; ++j)
 			btemp |= (data->collected[j+i] << j);
-		WRITEUINT8(save_p, btemp);
+		SAVEWRITEUINT8(btemp);
 		i += j;
 	}
 	for (i = 0; i < MAXEXTRAEMBLEMS;)
@@ -4513,7 +4585,7 @@ static inline void P_NetArchiveEmblems(void)
 		btemp = 0;
 		for (j = 0; j < 8 && j+i < MAXEXTRAEMBLEMS; ++j)
 			btemp |= (data->extraCollected[j+i] << j);
-		WRITEUINT8(save_p, btemp);
+		SAVEWRITEUINT8(btemp);
 		i += j;
 	}
 	for (i = 0; i < MAXUNLOCKABLES;)
@@ -4521,7 +4593,7 @@ static inline void P_NetArchiveEmblems(void)
 		btemp = 0;
 		for (j = 0; j < 8 && j+i < MAXUNLOCKABLES; ++j)
 			btemp |= (data->unlocked[j+i] << j);
-		WRITEUINT8(save_p, btemp);
+		SAVEWRITEUINT8(btemp);
 		i += j;
 	}
 	for (i = 0; i < MAXCONDITIONSETS;)
@@ -4529,28 +4601,28 @@ static inline void P_NetArchiveEmblems(void)
 		btemp = 0;
 		for (j = 0; j < 8 && j+i < MAXCONDITIONSETS; ++j)
 			btemp |= (data->achieved[j+i] << j);
-		WRITEUINT8(save_p, btemp);
+		SAVEWRITEUINT8(btemp);
 		i += j;
 	}
 
-	WRITEUINT32(save_p, data->timesBeaten);
-	WRITEUINT32(save_p, data->timesBeatenWithEmeralds);
-	WRITEUINT32(save_p, data->timesBeatenUltimate);
+	SAVEWRITEUINT32(data->timesBeaten);
+	SAVEWRITEUINT32(data->timesBeatenWithEmeralds);
+	SAVEWRITEUINT32(data->timesBeatenUltimate);
 
 	// Main records
 	for (i = 0; i < NUMMAPS; i++)
 	{
 		if (data->mainrecords[i])
 		{
-			WRITEUINT32(save_p, data->mainrecords[i]->score);
-			WRITEUINT32(save_p, data->mainrecords[i]->time);
-			WRITEUINT16(save_p, data->mainrecords[i]->rings);
+			SAVEWRITEUINT32(data->mainrecords[i]->score);
+			SAVEWRITEUINT32(data->mainrecords[i]->time);
+			SAVEWRITEUINT16(data->mainrecords[i]->rings);
 		}
 		else
 		{
-			WRITEUINT32(save_p, 0);
-			WRITEUINT32(save_p, 0);
-			WRITEUINT16(save_p, 0);
+			SAVEWRITEUINT32(0);
+			SAVEWRITEUINT32(0);
+			SAVEWRITEUINT16(0);
 		}
 	}
 
@@ -4559,38 +4631,38 @@ static inline void P_NetArchiveEmblems(void)
 	{
 		if (!data->nightsrecords[i] || !data->nightsrecords[i]->nummares)
 		{
-			WRITEUINT8(save_p, 0);
+			SAVEWRITEUINT8(0);
 			continue;
 		}
 
-		WRITEUINT8(save_p, data->nightsrecords[i]->nummares);
+		SAVEWRITEUINT8(data->nightsrecords[i]->nummares);
 
 		for (curmare = 0; curmare < (data->nightsrecords[i]->nummares + 1); ++curmare)
 		{
-			WRITEUINT32(save_p, data->nightsrecords[i]->score[curmare]);
-			WRITEUINT8(save_p, data->nightsrecords[i]->grade[curmare]);
-			WRITEUINT32(save_p, data->nightsrecords[i]->time[curmare]);
+			SAVEWRITEUINT32(data->nightsrecords[i]->score[curmare]);
+			SAVEWRITEUINT8(data->nightsrecords[i]->grade[curmare]);
+			SAVEWRITEUINT32(data->nightsrecords[i]->time[curmare]);
 		}
 	}
 
 	// Mid-map stuff
-	WRITEUINT32(save_p, unlocktriggers);
+	SAVEWRITEUINT32(unlocktriggers);
 
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
 		if (!ntemprecords[i].nummares)
 		{
-			WRITEUINT8(save_p, 0);
+			SAVEWRITEUINT8(0);
 			continue;
 		}
 
-		WRITEUINT8(save_p, ntemprecords[i].nummares);
+		SAVEWRITEUINT8(ntemprecords[i].nummares);
 
 		for (curmare = 0; curmare < (ntemprecords[i].nummares + 1); ++curmare)
 		{
-			WRITEUINT32(save_p, ntemprecords[i].score[curmare]);
-			WRITEUINT8(save_p, ntemprecords[i].grade[curmare]);
-			WRITEUINT32(save_p, ntemprecords[i].time[curmare]);
+			SAVEWRITEUINT32(ntemprecords[i].score[curmare]);
+			SAVEWRITEUINT8(ntemprecords[i].grade[curmare]);
+			SAVEWRITEUINT32(ntemprecords[i].time[curmare]);
 		}
 	}
 }
@@ -4744,13 +4816,13 @@ static inline void P_ArchiveLuabanksAndConsistency(void)
 
 	if (banksinuse)
 	{
-		WRITEUINT8(save_p, 0xb7); // luabanks marker
-		WRITEUINT8(save_p, banksinuse);
+		SAVEWRITEUINT8(0xb7); // luabanks marker
+		SAVEWRITEUINT8(banksinuse);
 		for (i = 0; i < banksinuse; i++)
-			WRITEINT32(save_p, luabanks[i]);
+			SAVEWRITEINT32(luabanks[i]);
 	}
 
-	WRITEUINT8(save_p, 0x1d); // consistency marker
+	SAVEWRITEUINT8(0x1d); // consistency marker
 }
 
 static inline boolean P_UnArchiveLuabanksAndConsistency(void)
@@ -4790,12 +4862,37 @@ void P_SaveGame(INT16 mapnum)
 	P_ArchiveLuabanksAndConsistency();
 }
 
+// Sizes are taken as offsets into the buffer, since
+// the buffer may move while a section is written.
+static size_t savesection_offset;
+static precise_t savesection_time;
+
+static void P_StartSaveSection(void)
+{
+	savesection_offset = savebuffer_start ? (size_t)(save_p - savebuffer_start) : 0;
+	savesection_time = I_GetPreciseTime();
+}
+
+static void P_EndSaveSection(savesection_t section)
+{
+	size_t offset = savebuffer_start ? (size_t)(save_p - savebuffer_start) : 0;
+
+	netsavestats.time[section] += I_GetPreciseTime() - savesection_time;
+	netsavestats.size[section] += offset - savesection_offset;
+}
+
 void P_SaveNetGame(boolean resending)
 {
 	thinker_t *th;
 	mobj_t *mobj;
 	INT32 i = 1; // don't start from 0, it'd be confused with a blank pointer otherwise
+	precise_t precision = I_GetPrecisePrecision() / 1000000;
+
+	memset(&netsavestats, 0, sizeof (netsavestats));
 
+	// CV_SaveNetVars writes through its own pointer, so make room for all of it
+	P_StartSaveSection();
+	P_SaveBufferReserve(CV_SavedVarsSize(false));
 	CV_SaveNetVars(&save_p);
 	P_NetArchiveMisc(resending);
 	P_NetArchiveEmblems();
@@ -4813,18 +4910,39 @@ void P_SaveNetGame(boolean resending)
 	}
 
 	P_NetArchivePlayers();
+	P_EndSaveSection(SAVESECTION_MISC);
+
 	if (gamestate == GS_LEVEL)
 	{
+		P_StartSaveSection();
 		P_NetArchiveWorld();
 		P_ArchivePolyObjects();
+		P_EndSaveSection(SAVESECTION_WORLD);
+
+		P_StartSaveSection();
 		P_NetArchiveThinkers();
+		P_EndSaveSection(SAVESECTION_THINKERS);
+
+		P_StartSaveSection();
 		P_NetArchiveSpecials();
 		P_NetArchiveColormaps();
 		P_NetArchiveWaypoints();
+		P_EndSaveSection(SAVESECTION_WORLD);
 	}
+
+	P_StartSaveSection();
 	LUA_Archive();
+	P_EndSaveSection(SAVESECTION_LUA);
 
+	P_StartSaveSection();
 	P_ArchiveLuabanksAndConsistency();
+	P_EndSaveSection(SAVESECTION_MISC);
+
+	CONS_Debug(DBG_NETPLAY, "Gamestate: misc %s bytes (%d us), world %s bytes (%d us), thinkers %s bytes (%d us), Lua %s bytes (%d us)\n",
+		sizeu1(netsavestats.size[SAVESECTION_MISC]), (int)(netsavestats.time[SAVESECTION_MISC] / precision),
+		sizeu2(netsavestats.size[SAVESECTION_WORLD]), (int)(netsavestats.time[SAVESECTION_WORLD] / precision),
+		sizeu3(netsavestats.size[SAVESECTION_THINKERS]), (int)(netsavestats.time[SAVESECTION_THINKERS] / precision),
+		sizeu4(netsavestats.size[SAVESECTION_LUA]), (int)(netsavestats.time[SAVESECTION_LUA] / precision));
 }
 
 boolean P_LoadGame(INT16 mapoverride)
@@ -44,4 +44,48 @@ typedef struct
 extern savedata_t savedata;
 extern UINT8 *save_p;
 
+// Growable buffer for savegames and netgame archives.
+// P_SaveBufferAlloc points save_p at a new buffer. The SAVEWRITE
+// macros below make room for each value before writing it, which
+// may move the buffer (and save_p) when it grows. Code that writes
+// through its own pointer must call P_SaveBufferReserve first with
+// the exact size it is about to write.
+extern UINT8 *save_end;
+UINT8 *P_SaveBufferAlloc(size_t size);
+void P_SaveBufferReserve(size_t size);
+UINT8 *P_SaveBufferFinish(size_t *length);
+
+#define SAVEROOM(n) do { if (save_p + (n) > save_end) P_SaveBufferReserve(n); } while (0)
+
+#define SAVEWRITEUINT8(b)   do { SAVEROOM(sizeof (  UINT8)); WRITEUINT8(save_p, b);  } while (0)
+#define SAVEWRITESINT8(b)   do { SAVEROOM(sizeof (  SINT8)); WRITESINT8(save_p, b);  } while (0)
+#define SAVEWRITEINT16(b)   do { SAVEROOM(sizeof (  INT16)); WRITEINT16(save_p, b);  } while (0)
+#define SAVEWRITEUINT16(b)  do { SAVEROOM(sizeof ( UINT16)); WRITEUINT16(save_p, b); } while (0)
+#define SAVEWRITEINT32(b)   do { SAVEROOM(sizeof (  INT32)); WRITEINT32(save_p, b);  } while (0)
+#define SAVEWRITEUINT32(b)  do { SAVEROOM(sizeof ( UINT32)); WRITEUINT32(save_p, b); } while (0)
+#define SAVEWRITECHAR(b)    do { SAVEROOM(sizeof (   char)); WRITECHAR(save_p, b);   } while (0)
+#define SAVEWRITEFIXED(b)   do { SAVEROOM(sizeof (fixed_t)); WRITEFIXED(save_p, b);  } while (0)
+#define SAVEWRITEANGLE(b)   do { SAVEROOM(sizeof (angle_t)); WRITEANGLE(save_p, b);  } while (0)
+#define SAVEWRITEMEM(s, n)  do { size_t n_tmp = (n); SAVEROOM(n_tmp); WRITEMEM(save_p, s, n_tmp); } while (0)
+#define SAVEWRITESTRING(s)  do { const char *s_tmp = (s); SAVEROOM(strlen(s_tmp) + 1); WRITESTRING(save_p, s_tmp); } while (0)
+#define SAVEWRITESTRINGN(s, n) do { const char *s_tmp = (s); SAVEROOM(n); WRITESTRINGN(save_p, s_tmp, n); } while (0)
+
+typedef enum
+{
+	SAVESECTION_MISC, // netvars, misc, emblems, players, luabanks
+	SAVESECTION_WORLD, // sectors, lines, polyobjects, specials, colormaps, waypoints
+	SAVESECTION_THINKERS,
+	SAVESECTION_LUA,
+	NUMSAVESECTIONS
+} savesection_t;
+
+typedef struct
+{
+	size_t size[NUMSAVESECTIONS];
+	precise_t time[NUMSAVESECTIONS];
+} savestats_t;
+
+// Stats for the last P_SaveNetGame call
+extern savestats_t netsavestats;
+
 #endif
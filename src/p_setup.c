@@ -6866,6 +6866,7 @@ static void P_ConvertBinaryMap(void)
 {
 	contextdrift = false;
 	P_ConvertBinaryLinedefTypes();
+	Taglist_InitLineSpecials(); // The specials changed, and the thing conversion looks lines up by them
 	P_ConvertBinarySectorTypes();
 	P_ConvertBinaryThingTypes();
 	P_ConvertBinaryLinedefFlags();
@@ -7803,6 +7804,7 @@ boolean P_LoadLevel(boolean fromnetsave, boolean reloadinggamestate)
 
 	// Clear pointers that would be left dangling by the purge
 	R_FlushTranslationColormapCache();
+	G_FreeGhosts(); // also frees their decoded tics, which aren't PU_LEVEL
 
 #ifdef HWRENDER
 	// Free GPU textures before freeing patches.
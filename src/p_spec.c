@@ -3880,7 +3880,6 @@ void P_SetupSignExit(player_t *player)
 {
 	mobj_t *thing;
 	msecnode_t *node = player->mo->subsector->sector->touching_thinglist; // things touching this sector
-	thinker_t *think;
 	INT32 numfound = 0;
 
 	for (; node; node = node->m_thinglist_next)
@@ -3911,15 +3910,8 @@ void P_SetupSignExit(player_t *player)
 
 	// didn't find any signposts in the exit sector.
 	// spin all signposts in the level then.
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
+	for (thing = mobjtyperegistry[MT_SIGN].head; thing; thing = thing->typenext)
 	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		thing = (mobj_t *)think;
-		if (thing->type != MT_SIGN)
-			continue;
-
 		if (!numfound
 			&& !(player->mo->target && player->mo->target->type == MT_SIGN)
 			&& !((gametyperules & GTR_FRIENDLY) && (netgame || multiplayer) && cv_exitmove.value))
@@ -4442,7 +4434,6 @@ static boolean P_DoAllPlayersTrigger(mtag_t triggertag)
 
 static void P_ProcessEggCapsule(player_t *player, sector_t *sector)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	INT32 i;
 
@@ -4451,13 +4442,8 @@ static void P_ProcessEggCapsule(player_t *player, sector_t *sector)
 
 	// Find the center of the Eggtrap and release all the pretty animals!
 	// The chimps are my friends.. heeheeheheehehee..... - LouisJM
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = mobjtyperegistry[MT_EGGTRAP].head; mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-		mo2 = (mobj_t *)th;
-		if (mo2->type != MT_EGGTRAP)
-			continue;
 		P_KillMobj(mo2, NULL, player->mo, 0);
 	}
 
@@ -8205,7 +8191,6 @@ void T_FadeColormap(fadecolormap_t *d)
 	}
 	else
 	{
-		extracolormap_t *exc;
 		INT32 duration = d->ticbased ? d->duration : 256;
 		fixed_t factor = min(FixedDiv(duration - d->timer, duration), 1*FRACUNIT);
 		INT16 cr, cg, cb, ca, fadestart, fadeend, flags;
@@ -8265,18 +8250,7 @@ void T_FadeColormap(fadecolormap_t *d)
 		// setup new colormap
 		//////////////////
 
-		if (!(d->sector->extra_colormap = R_GetColormapFromListByValues(rgba, fadergba, fadestart, fadeend, flags)))
-		{
-			exc = R_CreateDefaultColormap(false);
-			exc->fadestart = fadestart;
-			exc->fadeend = fadeend;
-			exc->flags = flags;
-			exc->rgba = rgba;
-			exc->fadergba = fadergba;
-			exc->colormap = R_CreateLightTable(exc);
-			R_AddColormapToList(exc);
-			d->sector->extra_colormap = exc;
-		}
+		d->sector->extra_colormap = R_GetFadeColormap(rgba, fadergba, fadestart, fadeend, flags);
 	}
 }
 
@@ -200,6 +200,7 @@ void P_InitThinkers(void)
 	UINT8 i;
 	for (i = 0; i < NUM_THINKERLISTS; i++)
 		thlist[i].prev = thlist[i].next = &thlist[i];
+	P_InitMobjRegistries();
 }
 
 // Adds a new thinker at the end of the list.
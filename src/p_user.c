@@ -422,7 +422,6 @@ void P_ResetScore(player_t *player)
 //
 UINT8 P_FindLowestMare(void)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	UINT8 mare = UINT8_MAX;
 
@@ -431,15 +430,8 @@ UINT8 P_FindLowestMare(void)
 
 	// scan the thinkers
 	// to find the egg capsule with the lowest mare
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = mobjtyperegistry[MT_EGGCAPSULE].head; mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type != MT_EGGCAPSULE)
-			continue;
 		if (mo2->health <= 0)
 			continue;
 
@@ -466,7 +458,6 @@ UINT8 P_FindLowestMare(void)
 //
 boolean P_TransferToNextMare(player_t *player)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis = NULL;
 	INT32 lowestaxisnum = -1;
@@ -484,16 +475,8 @@ boolean P_TransferToNextMare(player_t *player)
 
 	// scan the thinkers
 	// to find the closest axis point
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = mobjtyperegistry[MT_AXIS].head; mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type != MT_AXIS)
-			continue;
-
 		if (mo2->threshold != mare)
 			continue;
 
@@ -599,7 +582,6 @@ static mobj_t *P_FindAxisTransfer(INT32 mare, INT32 axisnum, mobjtype_t type)
 // Finds the CLOSEST axis with the number specified.
 void P_TransferToAxis(player_t *player, INT32 axisnum)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis;
 	INT32 mare = player->mare;
@@ -611,15 +593,8 @@ void P_TransferToAxis(player_t *player, INT32 axisnum)
 
 	// scan the thinkers
 	// to find the closest axis point
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = mobjtyperegistry[MT_AXIS].head; mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-
-		if (mo2->type != MT_AXIS)
-			continue;
 		if (mo2->health != axisnum)
 			continue;
 		if (mo2->threshold != mare)
@@ -661,7 +636,6 @@ void P_TransferToAxis(player_t *player, INT32 axisnum)
 //
 static void P_DeNightserizePlayer(player_t *player)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
 	player->powers[pw_carry] = CR_NIGHTSFALL;
@@ -712,15 +686,8 @@ static void P_DeNightserizePlayer(player_t *player)
 	}
 
 	// Check to see if the player should be killed.
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+	for (mo2 = mobjtyperegistry[MT_NIGHTSDRONE].head; mo2; mo2 = mo2->typenext)
 	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-		if (mo2->type != MT_NIGHTSDRONE)
-			continue;
-
 		if (mo2->flags2 & MF2_AMBUSH)
 		{
 			player->marescore = player->spheres = player->rings = 0;
@@ -7105,7 +7072,6 @@ static void P_NiGHTSMovement(player_t *player)
 	boolean still = false, moved = false, backwardaxis = false, firstdrill;
 	INT16 newangle = 0;
 	fixed_t xspeed, yspeed;
-	thinker_t *th;
 	mobj_t *mo2;
 	mobj_t *closestaxis = NULL;
 	fixed_t newx, newy, radius;
@@ -7193,15 +7159,8 @@ static void P_NiGHTSMovement(player_t *player)
 
 		// scan the thinkers
 		// to find the closest axis point
-		for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
+		for (mo2 = mobjtyperegistry[MT_AXIS].head; mo2; mo2 = mo2->typenext)
 		{
-			if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-				continue;
-
-			mo2 = (mobj_t *)th;
-
-			if (mo2->type != MT_AXIS)
-				continue;
 			if (mo2->threshold != player->mare)
 				continue;
 
@@ -9137,20 +9096,14 @@ void P_Earthquake(mobj_t *inflictor, mobj_t *source, fixed_t radius)
 mobj_t *P_LookForFocusTarget(player_t *player, mobj_t *exclude, SINT8 direction, UINT8 lockonflags)
 {
 	mobj_t *mo;
-	thinker_t *think;
 	mobj_t *closestmo = NULL;
 	const fixed_t maxdist = 2560*player->mo->scale;
 	const angle_t span = ANGLE_45;
 	fixed_t dist, closestdist = 0;
 	angle_t dangle, closestdangle = 0;
 
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
+	for (mo = mobjtargetregistry.head; mo; mo = mo->targetnext)
 	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo = (mobj_t *)think;
-
 		if (mo->flags & MF_NOCLIPTHING)
 			continue;
 
@@ -9256,20 +9209,14 @@ mobj_t *P_LookForFocusTarget(player_t *player, mobj_t *exclude, SINT8 direction,
 mobj_t *P_LookForEnemies(player_t *player, boolean nonenemies, boolean bullet)
 {
 	mobj_t *mo;
-	thinker_t *think;
 	mobj_t *closestmo = NULL;
 	const fixed_t maxdist = FixedMul((bullet ? RING_DIST*2 : RING_DIST), player->mo->scale);
 	const angle_t span = (bullet ? ANG30 : ANGLE_90);
 	fixed_t dist, closestdist = 0;
 	const mobjflag_t nonenemiesdisregard = (bullet ? 0 : MF_MONITOR)|MF_SPRING;
 
-	for (think = thlist[THINK_MOBJ].next; think != &thlist[THINK_MOBJ]; think = think->next)
+	for (mo = mobjtargetregistry.head; mo; mo = mo->targetnext)
 	{
-		if (think->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo = (mobj_t *)think;
-
 		if (mo->flags & MF_NOCLIPTHING)
 			continue;
 
@@ -9402,28 +9349,20 @@ boolean P_HomingAttack(mobj_t *source, mobj_t *enemy) // Home in on your target
 // Search for emeralds
 void P_FindEmerald(void)
 {
-	thinker_t *th;
 	mobj_t *mo2;
 
 	hunt1 = hunt2 = hunt3 = NULL;
 
 	// scan the remaining thinkers
 	// to find all emeralds
-	for (th = thlist[THINK_MOBJ].next; th != &thlist[THINK_MOBJ]; th = th->next)
-	{
-		if (th->function.acp1 == (actionf_p1)P_RemoveThinkerDelayed)
-			continue;
-
-		mo2 = (mobj_t *)th;
-		if (mo2->type == MT_EMERHUNT)
-		{
-			if (!hunt1)
-				hunt1 = mo2;
-			else if (!hunt2)
-				hunt2 = mo2;
-			else if (!hunt3)
-				hunt3 = mo2;
-		}
+	for (mo2 = mobjtyperegistry[MT_EMERHUNT].head; mo2; mo2 = mo2->typenext)
+	{
+		if (!hunt1)
+			hunt1 = mo2;
+		else if (!hunt2)
+			hunt2 = mo2;
+		else if (!hunt3)
+			hunt3 = mo2;
 	}
 	return;
 }
@@ -416,6 +416,48 @@ void R_ReInitColormaps(UINT16 num)
 	R_ClearColormaps();
 }
 
+// Colormap registry
+// Everything in extra_colormaps is also kept in a hash table keyed on its
+// values, so looking a colormap up doesn't walk the whole list. The
+// chains keep the list's order, so the same entry is found as before.
+#define COLORMAPHASHSIZE 256
+
+static extracolormap_t *colormaphash[COLORMAPHASHSIZE];
+static extracolormap_t *colormaptail; // Last entry of extra_colormaps
+
+// Colormap fades make a colormap for every step they take. Those are kept
+// apart, most recently used first, so the ones nothing uses anymore can be
+// handed to the next step instead of piling up until the level ends. The
+// most recent unused steps are kept as they are, for fades that go back
+// over the same colors.
+#define FADESTEPMEMO 64
+
+static extracolormap_t *fadesteps, *fadestepslast;
+static extracolormap_t *freefadesteps; // Taken out of the registry, only the light table is kept
+static UINT32 fadestepsused; // As of the last count
+
+colormapstats_t colormapstats;
+
+static UINT32 ColormapHash(INT32 rgba, INT32 fadergba, UINT8 fadestart, UINT8 fadeend, UINT8 flags)
+{
+	UINT32 hash = (UINT32)rgba;
+	hash = hash * 31 + (UINT32)fadergba;
+	hash = hash * 31 + (fadestart | (fadeend << 8) | (flags << 16));
+	return (hash ^ (hash >> 16)) & (COLORMAPHASHSIZE - 1);
+}
+
+static void R_ResetColormapRegistry(extracolormap_t *defaultexc)
+{
+	memset(colormaphash, 0, sizeof(colormaphash));
+	fadesteps = fadestepslast = freefadesteps = NULL;
+	fadestepsused = 0;
+	memset(&colormapstats, 0, sizeof(colormapstats));
+
+	extra_colormaps = colormaptail = NULL;
+	R_AddColormapToList(defaultexc);
+	colormapstats.tables = 1;
+}
+
 //
 // R_ClearColormaps
 //
@@ -423,8 +465,8 @@ void R_ReInitColormaps(UINT16 num)
 //
 void R_ClearColormaps(void)
 {
-	// Purged by PU_LEVEL, just overwrite the pointer
-	extra_colormaps = R_CreateDefaultColormap(true);
+	// Purged by PU_LEVEL, just overwrite the pointers
+	R_ResetColormapRegistry(R_CreateDefaultColormap(true));
 }
 
 //
@@ -458,7 +500,10 @@ extracolormap_t *R_GetDefaultColormap(void)
 #endif
 
 	if (!extra_colormaps)
-		return (extra_colormaps = R_CreateDefaultColormap(true));
+	{
+		R_ResetColormapRegistry(R_CreateDefaultColormap(true));
+		return extra_colormaps;
+	}
 
 #ifdef COLORMAPREVERSELIST
 	for (exc = extra_colormaps; exc->next; exc = exc->next);
@@ -481,6 +526,9 @@ extracolormap_t *R_CopyColormap(extracolormap_t *extra_colormap, boolean lightta
 
 	*exc = *extra_colormap;
 	exc->next = exc->prev = NULL;
+	exc->hashnext = exc->fadenext = exc->fadeprev = NULL;
+	exc->refcount = 0;
+	exc->fadestep = false;
 
 #ifdef EXTRACOLORMAPLUMPS
 	strncpy(exc->lumpname, extra_colormap->lumpname, 9);
@@ -509,13 +557,28 @@ extracolormap_t *R_CopyColormap(extracolormap_t *extra_colormap, boolean lightta
 //
 void R_AddColormapToList(extracolormap_t *extra_colormap)
 {
-#ifndef COLORMAPREVERSELIST
-	extracolormap_t *exc;
+	extracolormap_t **link = &colormaphash[ColormapHash(extra_colormap->rgba, extra_colormap->fadergba,
+		extra_colormap->fadestart, extra_colormap->fadeend, extra_colormap->flags)];
+
+	// Might be a copy of a registered colormap, start over
+	extra_colormap->fadenext = extra_colormap->fadeprev = NULL;
+	extra_colormap->refcount = 0;
+	extra_colormap->fadestep = false;
+
+#ifdef COLORMAPREVERSELIST
+	extra_colormap->hashnext = *link;
+	*link = extra_colormap;
+#else
+	while (*link)
+		link = &(*link)->hashnext;
+	extra_colormap->hashnext = NULL;
+	*link = extra_colormap;
 #endif
+	colormapstats.colormaps++;
 
 	if (!extra_colormaps)
 	{
-		extra_colormaps = extra_colormap;
+		extra_colormaps = colormaptail = extra_colormap;
 		extra_colormap->next = 0;
 		extra_colormap->prev = 0;
 		return;
@@ -527,14 +590,67 @@ void R_AddColormapToList(extracolormap_t *extra_colormap)
 	extra_colormaps = extra_colormap;
 	extra_colormap->prev = 0;
 #else
-	for (exc = extra_colormaps; exc->next; exc = exc->next);
-
-	exc->next = extra_colormap;
-	extra_colormap->prev = exc;
+	colormaptail->next = extra_colormap;
+	extra_colormap->prev = colormaptail;
 	extra_colormap->next = 0;
+	colormaptail = extra_colormap;
 #endif
 }
 
+static void R_RemoveColormapFromList(extracolormap_t *extra_colormap)
+{
+	extracolormap_t **link = &colormaphash[ColormapHash(extra_colormap->rgba, extra_colormap->fadergba,
+		extra_colormap->fadestart, extra_colormap->fadeend, extra_colormap->flags)];
+
+	while (*link != extra_colormap)
+		link = &(*link)->hashnext;
+	*link = extra_colormap->hashnext;
+
+	if (extra_colormap->prev)
+		extra_colormap->prev->next = extra_colormap->next;
+	else
+		extra_colormaps = extra_colormap->next;
+
+	if (extra_colormap->next)
+		extra_colormap->next->prev = extra_colormap->prev;
+	else
+		colormaptail = extra_colormap->prev;
+
+	extra_colormap->next = extra_colormap->prev = extra_colormap->hashnext = NULL;
+	colormapstats.colormaps--;
+}
+
+static void R_UnlinkFadeStep(extracolormap_t *exc)
+{
+	if (exc->fadeprev)
+		exc->fadeprev->fadenext = exc->fadenext;
+	else
+		fadesteps = exc->fadenext;
+
+	if (exc->fadenext)
+		exc->fadenext->fadeprev = exc->fadeprev;
+	else
+		fadestepslast = exc->fadeprev;
+
+	exc->fadenext = exc->fadeprev = NULL;
+}
+
+static void R_TouchFadeStep(extracolormap_t *exc)
+{
+	if (fadesteps == exc)
+		return;
+
+	if (exc->fadeprev || exc->fadenext || fadestepslast == exc)
+		R_UnlinkFadeStep(exc);
+
+	exc->fadenext = fadesteps;
+	if (fadesteps)
+		fadesteps->fadeprev = exc;
+	else
+		fadestepslast = exc;
+	fadesteps = exc;
+}
+
 //
 // R_CheckDefaultColormapByValues()
 //
@@ -613,7 +729,7 @@ extracolormap_t *R_GetColormapFromListByValues(INT32 rgba, INT32 fadergba, UINT8
 	extracolormap_t *exc;
 	UINT32 dbg_i = 0;
 
-	for (exc = extra_colormaps; exc; exc = exc->next)
+	for (exc = colormaphash[ColormapHash(rgba, fadergba, fadestart, fadeend, flags)]; exc; exc = exc->hashnext)
 	{
 		if (rgba == exc->rgba
 			&& fadergba == exc->fadergba
@@ -628,6 +744,15 @@ extracolormap_t *R_GetColormapFromListByValues(INT32 rgba, INT32 fadergba, UINT8
 			CONS_Debug(DBG_RENDER, "Found Colormap %d: rgba(%d,%d,%d,%d) fadergba(%d,%d,%d,%d)\n",
 				dbg_i, R_GetRgbaR(rgba), R_GetRgbaG(rgba), R_GetRgbaB(rgba), R_GetRgbaA(rgba),
 				R_GetRgbaR(fadergba), R_GetRgbaG(fadergba), R_GetRgbaB(fadergba), R_GetRgbaA(fadergba));
+
+			// Whoever asked can hold on to it for as long as they want,
+			// so it can't be recycled anymore
+			if (exc->fadestep)
+			{
+				R_UnlinkFadeStep(exc);
+				exc->fadestep = false;
+				colormapstats.fadesteps--;
+			}
 			return exc;
 		}
 		dbg_i++;
@@ -694,7 +819,16 @@ static double deltas[256][3], map[256][3];
 
 static int RoundUp(double number);
 
+static lighttable_t *R_MakeLightTable(extracolormap_t *extra_colormap, lighttable_t *lighttable);
+
 lighttable_t *R_CreateLightTable(extracolormap_t *extra_colormap)
+{
+	colormapstats.tables++;
+	return R_MakeLightTable(extra_colormap, NULL);
+}
+
+// Fills in lighttable, or a new one if it's NULL
+static lighttable_t *R_MakeLightTable(extracolormap_t *extra_colormap, lighttable_t *lighttable)
 {
 	double cmaskr, cmaskg, cmaskb, cdestr, cdestg, cdestb;
 	double maskamt = 0, othermask = 0;
@@ -711,7 +845,6 @@ lighttable_t *R_CreateLightTable(extracolormap_t *extra_colormap)
 	UINT8 fadestart = extra_colormap->fadestart,
 		fadedist = extra_colormap->fadeend - extra_colormap->fadestart;
 
-	lighttable_t *lighttable = NULL;
 	size_t i;
 
 	/////////////////////
@@ -783,8 +916,9 @@ lighttable_t *R_CreateLightTable(extracolormap_t *extra_colormap)
 
 		// Now allocate memory for the actual colormap array itself!
 		// aligned on 8 bit for asm code
-		colormap_p = Z_MallocAlign((256 * 34) + 10, PU_LEVEL, NULL, 8);
-		lighttable = (UINT8 *)colormap_p;
+		if (!lighttable)
+			lighttable = Z_MallocAlign(LIGHTTABLESIZE, PU_LEVEL, NULL, 8);
+		colormap_p = (char *)lighttable;
 
 		// Calculate the palette index for each palette index, for each light level
 		// (as well as the two unused colormap lines we inherited from Doom)
@@ -997,6 +1131,124 @@ extracolormap_t *R_CreateColormap(INT32 rgba, INT32 fadergba, UINT8 fadestart, U
 	return extra_colormap;
 }
 
+static void R_CountFadeStepRef(extracolormap_t *exc)
+{
+	if (exc && exc->fadestep)
+		exc->refcount++;
+}
+
+//
+// R_RecycleFadeColormaps()
+//
+// Counts what still uses each fade step, and takes the ones nothing uses
+// out of the registry, except for the FADESTEPMEMO most recently used.
+// Colormap pointers get copied around freely by linedef executors, so
+// rather than counting at every assignment, this goes over everything
+// that can hold one between tics: sectors and their colormap faders.
+//
+static void R_RecycleFadeColormaps(void)
+{
+	extracolormap_t *exc, *prev;
+	UINT32 unused = 0;
+	size_t i;
+
+	for (exc = fadesteps; exc; exc = exc->fadenext)
+		exc->refcount = 0;
+
+	for (i = 0; i < numsectors; i++)
+	{
+		fadecolormap_t *fader = sectors[i].fadecolormapdata;
+
+		R_CountFadeStepRef(sectors[i].extra_colormap);
+		R_CountFadeStepRef(sectors[i].spawn_extra_colormap);
+		if (fader)
+		{
+			R_CountFadeStepRef(fader->source_exc);
+			R_CountFadeStepRef(fader->dest_exc);
+		}
+	}
+
+	fadestepsused = 0;
+	for (exc = fadesteps; exc; exc = prev)
+	{
+		prev = exc->fadenext;
+
+		if (exc->refcount)
+			fadestepsused++;
+		else if (++unused > FADESTEPMEMO)
+		{
+			R_UnlinkFadeStep(exc);
+			R_RemoveColormapFromList(exc);
+			exc->fadestep = false;
+			colormapstats.fadesteps--;
+
+			exc->next = freefadesteps;
+			freefadesteps = exc;
+			colormapstats.recycled++;
+		}
+	}
+}
+
+//
+// R_GetFadeColormap()
+//
+// Finds or makes the colormap for a step of a colormap fade.
+// Unlike the others, it can be recycled once nothing uses it anymore.
+//
+extracolormap_t *R_GetFadeColormap(INT32 rgba, INT32 fadergba, UINT8 fadestart, UINT8 fadeend, UINT8 flags)
+{
+	extracolormap_t *exc;
+
+	for (exc = colormaphash[ColormapHash(rgba, fadergba, fadestart, fadeend, flags)]; exc; exc = exc->hashnext)
+	{
+		if (rgba == exc->rgba
+			&& fadergba == exc->fadergba
+			&& fadestart == exc->fadestart
+			&& fadeend == exc->fadeend
+			&& flags == exc->flags
+#ifdef EXTRACOLORMAPLUMPS
+			&& exc->lump == LUMPERROR
+#endif
+		)
+		{
+			if (exc->fadestep)
+				R_TouchFadeStep(exc);
+			colormapstats.fadehits++;
+			return exc;
+		}
+	}
+
+	colormapstats.fademisses++;
+
+	if (!freefadesteps && colormapstats.fadesteps >= fadestepsused + FADESTEPMEMO*2)
+		R_RecycleFadeColormaps();
+
+	if (freefadesteps)
+	{
+		exc = freefadesteps;
+		freefadesteps = exc->next;
+	}
+	else
+	{
+		exc = R_CreateDefaultColormap(false);
+		colormapstats.tables++;
+	}
+
+	exc->fadestart = fadestart;
+	exc->fadeend = fadeend;
+	exc->flags = flags;
+	exc->rgba = rgba;
+	exc->fadergba = fadergba;
+	exc->colormap = R_MakeLightTable(exc, exc->colormap);
+
+	R_AddColormapToList(exc);
+	exc->fadestep = true;
+	R_TouchFadeStep(exc);
+	colormapstats.fadesteps++;
+
+	return exc;
+}
+
 //
 // R_AddColormaps()
 // NOTE: The result colormap is not added to the extra_colormaps chain. You must do that yourself!
@@ -1103,6 +1355,114 @@ extracolormap_t *R_AddColormaps(extracolormap_t *exc_augend, extracolormap_t *ex
 	return exc_augend;
 }
 
+// Inverse lookup for the master palette
+// The RGB cube is split into 32x32x32 cells. Each cell keeps the palette
+// entries that can be the nearest for some color inside it, in palette
+// order, so looking a color up only has to search those and still picks
+// the same entry as searching the whole palette would. A cell is filled
+// in the first time a color inside it is looked up.
+#define INVPALBITS 3
+#define INVPALCELLS (256 >> INVPALBITS)
+#define INVPALCELL(r, g, b) (((((r) >> INVPALBITS) * INVPALCELLS) + ((g) >> INVPALBITS)) * INVPALCELLS + ((b) >> INVPALBITS))
+
+static UINT32 invpalcell[INVPALCELLS*INVPALCELLS*INVPALCELLS]; // 1 + offset of the cell in invpalentries, 0 if not filled in yet
+static UINT8 *invpalentries; // For each filled cell, the number of entries minus one, then the entries
+static size_t invpalused, invpalsize;
+static boolean invpalrepeat[256]; // The same color is earlier in the palette, so this entry is never the nearest
+static boolean invpalready;
+
+/** \brief Forgets the inverse lookup, call whenever pMasterPalette changes
+*/
+void R_ClearNearestColorCache(void)
+{
+	memset(invpalcell, 0, sizeof(invpalcell));
+	invpalused = 0;
+	invpalready = false;
+}
+
+static void FindRepeatedPaletteColors(void)
+{
+	INT32 i, j;
+
+	for (i = 0; i < 256; i++)
+	{
+		invpalrepeat[i] = false;
+		for (j = 0; j < i; j++)
+			if (pMasterPalette[j].s.red == pMasterPalette[i].s.red
+				&& pMasterPalette[j].s.green == pMasterPalette[i].s.green
+				&& pMasterPalette[j].s.blue == pMasterPalette[i].s.blue)
+			{
+				invpalrepeat[i] = true;
+				break;
+			}
+	}
+
+	invpalready = true;
+}
+
+static inline INT32 CellAxisDistance(INT32 v, INT32 lo, INT32 *farthest)
+{
+	const INT32 hi = lo + (1 << INVPALBITS) - 1;
+	*farthest = max(v - lo, hi - v);
+	if (v < lo)
+		return lo - v;
+	if (v > hi)
+		return v - hi;
+	return 0;
+}
+
+/** \brief Fills in the cell that holds a color
+
+	An entry can only be the nearest somewhere in the cell if its distance
+	to the closest corner of the cell is no more than the distance of some
+	other entry to its farthest corner.
+*/
+static const UINT8 *MakeInversePaletteCell(UINT8 r, UINT8 g, UINT8 b)
+{
+	const INT32 lor = r & ~((1 << INVPALBITS) - 1);
+	const INT32 log = g & ~((1 << INVPALBITS) - 1);
+	const INT32 lob = b & ~((1 << INVPALBITS) - 1);
+	INT32 nearest[256], farthest, bestfarthest = INT32_MAX;
+	INT32 fr, fg, fb, dr, dg, db;
+	UINT8 *cell;
+	INT32 i, count = 0;
+
+	if (!invpalready)
+		FindRepeatedPaletteColors();
+
+	for (i = 0; i < 256; i++)
+	{
+		dr = CellAxisDistance(pMasterPalette[i].s.red, lor, &fr);
+		dg = CellAxisDistance(pMasterPalette[i].s.green, log, &fg);
+		db = CellAxisDistance(pMasterPalette[i].s.blue, lob, &fb);
+		nearest[i] = dr*dr + dg*dg + db*db;
+		farthest = fr*fr + fg*fg + fb*fb;
+		if (farthest < bestfarthest)
+			bestfarthest = farthest;
+	}
+
+	for (i = 0; i < 256; i++)
+		if (nearest[i] <= bestfarthest && !invpalrepeat[i])
+			count++;
+
+	if (invpalused + count + 1 > invpalsize)
+	{
+		invpalsize = max(invpalsize * 2, invpalused + 256 + 1);
+		invpalentries = Z_Realloc(invpalentries, invpalsize, PU_STATIC, NULL);
+	}
+
+	cell = &invpalentries[invpalused];
+	invpalcell[INVPALCELL(r, g, b)] = (UINT32)invpalused + 1;
+	invpalused += count + 1;
+
+	*cell++ = (UINT8)(count - 1);
+	for (i = 0; i < 256; i++)
+		if (nearest[i] <= bestfarthest && !invpalrepeat[i])
+			*cell++ = (UINT8)i;
+
+	return &invpalentries[invpalcell[INVPALCELL(r, g, b)] - 1];
+}
+
 // Thanks to quake2 source!
 // utils3/qdata/images.c
 UINT8 NearestPaletteColor(UINT8 r, UINT8 g, UINT8 b, RGBA_t *palette)
@@ -1114,6 +1474,31 @@ UINT8 NearestPaletteColor(UINT8 r, UINT8 g, UINT8 b, RGBA_t *palette)
 	if (palette == NULL)
 		palette = pMasterPalette;
 
+	if (palette == pMasterPalette)
+	{
+		const UINT32 ofs = invpalcell[INVPALCELL(r, g, b)];
+		const UINT8 *cell = ofs ? &invpalentries[ofs - 1] : MakeInversePaletteCell(r, g, b);
+		const int count = *cell++ + 1;
+
+		for (i = 0; i < count; i++)
+		{
+			dr = r - palette[cell[i]].s.red;
+			dg = g - palette[cell[i]].s.green;
+			db = b - palette[cell[i]].s.blue;
+			distortion = dr*dr + dg*dg + db*db;
+			if (distortion < bestdistortion)
+			{
+				if (!distortion)
+					return cell[i];
+
+				bestdistortion = distortion;
+				bestcolor = cell[i];
+			}
+		}
+
+		return (UINT8)bestcolor;
+	}
+
 	for (i = 0; i < 256; i++)
 	{
 		dr = r - palette[i].s.red;
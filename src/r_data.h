@@ -73,6 +73,20 @@ extracolormap_t *R_GetColormapFromListByValues(INT32 rgba, INT32 fadergba, UINT8
 boolean R_CheckDefaultColormap(extracolormap_t *extra_colormap, boolean checkrgba, boolean checkfadergba, boolean checkparams);
 boolean R_CheckEqualColormaps(extracolormap_t *exc_a, extracolormap_t *exc_b, boolean checkrgba, boolean checkfadergba, boolean checkparams);
 extracolormap_t *R_GetColormapFromList(extracolormap_t *extra_colormap);
+extracolormap_t *R_GetFadeColormap(INT32 rgba, INT32 fadergba, UINT8 fadestart, UINT8 fadeend, UINT8 flags);
+
+#define LIGHTTABLESIZE ((256 * 34) + 10)
+
+typedef struct
+{
+	UINT32 colormaps; // In extra_colormaps
+	UINT32 fadesteps; // Of those, made for colormap fades
+	UINT32 tables; // Light tables made this level
+	UINT32 fadehits, fademisses; // Fade steps found and made
+	UINT32 recycled; // Fade steps taken out of the registry for reuse
+} colormapstats_t;
+
+extern colormapstats_t colormapstats;
 
 typedef enum
 {
@@ -117,6 +131,7 @@ const char *R_NameForColormap(extracolormap_t *extra_colormap);
 #define R_PutRgbaRGB(r, g, b) (R_PutRgbaR(r) + R_PutRgbaG(g) + R_PutRgbaB(b))
 #define R_PutRgbaRGBA(r, g, b, a) (R_PutRgbaRGB(r, g, b) + R_PutRgbaA(a))
 
+void R_ClearNearestColorCache(void);
 UINT8 NearestPaletteColor(UINT8 r, UINT8 g, UINT8 b, RGBA_t *palette);
 #define NearestColor(r, g, b) NearestPaletteColor(r, g, b, NULL)
 
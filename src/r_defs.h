@@ -76,6 +76,13 @@ typedef struct extracolormap_s
 
 	struct extracolormap_s *next;
 	struct extracolormap_s *prev;
+
+	// Registry bookkeeping, see R_AddColormapToList and R_GetFadeColormap
+	struct extracolormap_s *hashnext;
+	struct extracolormap_s *fadenext; // Fade steps only, most recently used first
+	struct extracolormap_s *fadeprev;
+	UINT32 refcount; // Sectors and faders using a fade step, as of the last count
+	boolean fadestep; // Made for a step of a colormap fade, can be recycled
 } extracolormap_t;
 
 //
@@ -27,6 +27,12 @@
 #include "console.h" // Until buffering gets finished
 #include "libdivide.h" // used by NPO2 tilted span functions
 
+#if defined (COLUMNS_SSE2)
+#include <emmintrin.h>
+#elif defined (COLUMNS_NEON)
+#include <arm_neon.h>
+#endif
+
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
 #endif
@@ -94,6 +100,20 @@ UINT8 *dc_translation;
 struct r_lightlist_s *dc_lightlist = NULL;
 INT32 dc_numlights = 0, dc_maxlights, dc_texheight;
 
+// =========================================================================
+//                      MULTI-COLUMN DRAWING CODE STUFF
+// =========================================================================
+
+/**	\brief draws the rows a group of adjacent columns share, NULL to draw every column on its own
+*/
+void (*colfunc_multi)(UINT8 *dest, INT32 count, const columnlanes_t *lanes);
+INT32 colfunc_multi_lanes;
+
+/**	\brief check every batch of columns against R_DrawColumn_8, set with -validatedrawers
+*/
+boolean r_validatedrawers = false;
+static UINT32 columnmismatches = 0;
+
 // =========================================================================
 //                      SPAN DRAWING CODE STUFF
 // =========================================================================
@@ -923,6 +943,200 @@ static void R_CalcTiltedLighting(fixed_t start, fixed_t end)
 
 #include "r_draw8.c"
 #include "r_draw8_npo2.c"
+#include "r_draw8_simd.c"
+
+// ==========================================================================
+//                          COLUMN BATCHING
+// ==========================================================================
+
+// Texture position of a column after the given number of rows,
+// wrapping around exactly like the drawers' own frac += fracstep.
+#define ADVANCEFRAC(frac, fracstep, rows) ((fixed_t)((UINT32)(frac) + (UINT32)(fracstep)*(UINT32)(rows)))
+
+static fixed_t R_ColumnJobFrac(const columnjob_t *job)
+{
+	return (job->texturemid + FixedMul((job->yl << FRACBITS) - centeryfrac, job->iscale))*(!job->hires);
+}
+
+/**	\brief Draws rows y1 to y2 of a queued column, starting at texture position frac
+*/
+static void R_DrawColumnJobRows(const columnjob_t *job, fixed_t frac, INT32 y1, INT32 y2)
+{
+	UINT8 *dest = &topleft[y1*vid.width + job->x];
+	const UINT8 *source = job->source;
+	const lighttable_t *colormap = job->colormap;
+	const INT32 heightmask = job->texheight - 1;
+	const fixed_t fracstep = job->iscale;
+
+	for (; y1 <= y2; y1++)
+	{
+		*dest = colormap[source[(frac>>FRACBITS) & heightmask]];
+		dest += vid.width;
+		frac += fracstep;
+	}
+}
+
+/**	\brief Redraws a batch of columns with R_DrawColumn_8, and reports
+	any pixel that came out different the first time
+*/
+static void R_ValidateColumnBatch(const columnjob_t *jobs, INT32 count)
+{
+	static UINT8 drawn[MAXVIDHEIGHT];
+	lighttable_t *colormap = dc_colormap;
+	INT32 x = dc_x, yl = dc_yl, yh = dc_yh;
+	fixed_t iscale = dc_iscale, texturemid = dc_texturemid;
+	INT32 texheight = dc_texheight;
+	UINT8 hires = dc_hires;
+	UINT8 *source = dc_source;
+	INT32 i, y, wrong;
+
+	for (i = 0; i < count; i++)
+	{
+		const columnjob_t *job = &jobs[i];
+		UINT8 *dest = &topleft[job->yl*vid.width + job->x];
+
+		for (y = job->yl; y <= job->yh; y++, dest += vid.width)
+			drawn[y] = *dest;
+
+		dc_x = job->x;
+		dc_yl = job->yl;
+		dc_yh = job->yh;
+		dc_iscale = job->iscale;
+		dc_texturemid = job->texturemid;
+		dc_texheight = job->texheight;
+		dc_hires = job->hires;
+		dc_source = job->source;
+		dc_colormap = job->colormap;
+		R_DrawColumn_8();
+
+		wrong = 0;
+		dest = &topleft[job->yl*vid.width + job->x];
+		for (y = job->yl; y <= job->yh; y++, dest += vid.width)
+			wrong += (drawn[y] != *dest);
+
+		if (wrong && columnmismatches++ < 16)
+			CONS_Alert(CONS_WARNING, "Column %d (rows %d to %d) differs from R_DrawColumn_8 in %d pixels\n", job->x, job->yl, job->yh, wrong);
+	}
+
+	dc_x = x;
+	dc_yl = yl;
+	dc_yh = yh;
+	dc_iscale = iscale;
+	dc_texturemid = texturemid;
+	dc_texheight = texheight;
+	dc_hires = hires;
+	dc_source = source;
+	dc_colormap = colormap;
+}
+
+/**	\brief Draws every column waiting in a batch
+
+	If the batch is a full group of adjacent columns, the rows they all share
+	go through colfunc_multi and the rest are drawn one column at a time.
+*/
+void R_FlushColumnBatch(columnbatch_t *batch)
+{
+	const columnjob_t *jobs = batch->jobs;
+	const INT32 count = batch->count;
+	INT32 top = 0, bottom = -1;
+	INT32 i;
+
+	if (!count)
+		return;
+	batch->count = 0;
+
+	if (count == colfunc_multi_lanes)
+	{
+		top = jobs[0].yl;
+		bottom = jobs[0].yh;
+		for (i = 1; i < count; i++)
+		{
+			top = max(top, jobs[i].yl);
+			bottom = min(bottom, jobs[i].yh);
+		}
+	}
+
+	if (bottom - top + 1 < MINCOLUMNLANEROWS)
+	{
+		for (i = 0; i < count; i++)
+			R_DrawColumnJobRows(&jobs[i], R_ColumnJobFrac(&jobs[i]), jobs[i].yl, jobs[i].yh);
+	}
+	else
+	{
+		columnlanes_t lanes;
+		fixed_t frac;
+
+		lanes.heightmask = jobs[0].texheight - 1;
+		for (i = 0; i < count; i++)
+		{
+			const columnjob_t *job = &jobs[i];
+
+			frac = R_ColumnJobFrac(job);
+			R_DrawColumnJobRows(job, frac, job->yl, top - 1);
+			frac = ADVANCEFRAC(frac, job->iscale, top - job->yl);
+
+			lanes.source[i] = job->source;
+			lanes.colormap[i] = job->colormap;
+			lanes.frac[i] = frac;
+			lanes.fracstep[i] = job->iscale;
+
+			R_DrawColumnJobRows(job, ADVANCEFRAC(frac, job->iscale, bottom + 1 - top), bottom + 1, job->yh);
+		}
+
+		colfunc_multi(&topleft[top*vid.width + jobs[0].x], bottom - top + 1, &lanes);
+	}
+
+	if (r_validatedrawers)
+		R_ValidateColumnBatch(jobs, count);
+}
+
+#undef ADVANCEFRAC
+
+/**	\brief Queues the column described by dc_* to be drawn together with its neighbours
+
+	Only plain opaque columns of power of two textures are queued, anything
+	else is drawn by colfunc right away. Queued columns are drawn once the
+	batch is full, when a column that doesn't continue it comes in, or when
+	R_FlushColumnBatch is called, which the caller must do before anything
+	else draws over the same part of the screen.
+*/
+void R_BatchColumn(columnbatch_t *batch)
+{
+	columnjob_t *job;
+
+	if (!colfunc_multi || colfunc != colfuncs[BASEDRAWFUNC]
+	|| (dc_texheight & (dc_texheight - 1)) || dc_yl > dc_yh)
+	{
+		colfunc();
+		return;
+	}
+
+#ifdef RANGECHECK
+	if ((unsigned)dc_x >= (unsigned)vid.width || dc_yl < 0 || dc_yh >= vid.height)
+		return;
+#endif
+
+	if (batch->count)
+	{
+		job = &batch->jobs[batch->count - 1];
+		if (dc_x != job->x + 1 || dc_texheight != job->texheight)
+			R_FlushColumnBatch(batch);
+	}
+
+	job = &batch->jobs[batch->count++];
+	job->x = dc_x;
+	job->yl = dc_yl;
+	job->yh = dc_yh;
+	job->iscale = dc_iscale;
+	job->texturemid = dc_texturemid;
+	job->texheight = dc_texheight;
+	job->hires = dc_hires;
+	job->source = dc_source;
+	job->colormap = dc_colormap;
+
+	if (batch->count >= colfunc_multi_lanes)
+		R_FlushColumnBatch(batch);
+}
 
 // ==========================================================================
 //                   INCLUDE 16bpp DRAWING CODE HERE
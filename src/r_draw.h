@@ -16,6 +16,18 @@
 
 #include "r_defs.h"
 
+// Multi-column drawers for opaque columns with vector texture stepping
+// that this compiler can build. Which one is used is decided at runtime,
+// in SCR_SetDrawFuncs.
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__)) \
+	&& (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined (__clang__))
+#define COLUMNS_SSE2
+#elif defined (_MSC_VER) && (defined (_M_IX86) || defined (_M_X64))
+#define COLUMNS_SSE2
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+#define COLUMNS_NEON
+#endif
+
 // -------------------------------
 // COMMON STUFF FOR 8bpp AND 16bpp
 // -------------------------------
@@ -49,6 +61,54 @@ extern INT32 dc_numlights, dc_maxlights;
 //Fix TUTIFRUTI
 extern INT32 dc_texheight;
 
+// -------------------------------
+// MULTI-COLUMN DRAWING CODE STUFF
+// -------------------------------
+
+// Widest group of columns a multi-column drawer takes at once
+#define MAXCOLUMNLANES 4
+
+// Groups shorter than this are drawn one column at a time
+#define MINCOLUMNLANEROWS 4
+
+/**	\brief Per-column state for a multi-column drawer, in the rows all columns share
+*/
+typedef struct
+{
+	const UINT8 *source[MAXCOLUMNLANES];
+	const lighttable_t *colormap[MAXCOLUMNLANES];
+	fixed_t frac[MAXCOLUMNLANES];
+	fixed_t fracstep[MAXCOLUMNLANES];
+	INT32 heightmask;
+} columnlanes_t;
+
+/**	\brief An opaque column waiting to be drawn together with its neighbours
+*/
+typedef struct
+{
+	INT32 x, yl, yh;
+	fixed_t iscale, texturemid;
+	INT32 texheight;
+	UINT8 hires;
+	UINT8 *source;
+	lighttable_t *colormap;
+} columnjob_t;
+
+typedef struct
+{
+	columnjob_t jobs[MAXCOLUMNLANES];
+	INT32 count;
+} columnbatch_t;
+
+// Draws count rows of colfunc_multi_lanes adjacent columns, starting at dest
+extern void (*colfunc_multi)(UINT8 *dest, INT32 count, const columnlanes_t *lanes);
+extern INT32 colfunc_multi_lanes;
+
+extern boolean r_validatedrawers;
+
+void R_BatchColumn(columnbatch_t *batch);
+void R_FlushColumnBatch(columnbatch_t *batch);
+
 // -----------------------
 // SPAN DRAWING CODE STUFF
 // -----------------------
@@ -178,6 +238,14 @@ void R_Draw2sMultiPatchTranslucentColumn_8(void);
 void R_DrawFogColumn_8(void);
 void R_DrawColumnShadowed_8(void);
 
+void R_DrawColumns_8(UINT8 *dest, INT32 count, const columnlanes_t *lanes);
+#ifdef COLUMNS_SSE2
+void R_DrawColumns_8_SSE2(UINT8 *dest, INT32 count, const columnlanes_t *lanes);
+#endif
+#ifdef COLUMNS_NEON
+void R_DrawColumns_8_NEON(UINT8 *dest, INT32 count, const columnlanes_t *lanes);
+#endif
+
 #define PLANELIGHTFLOAT (BASEVIDWIDTH * BASEVIDWIDTH / vid.width / zeroheight / 21.0f * FIXED_TO_FLOAT(fovtan))
 
 void R_DrawSpan_8(void);
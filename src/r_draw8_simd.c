@@ -0,0 +1,128 @@
+// SONIC ROBO BLAST 2
+//-----------------------------------------------------------------------------
+// Copyright (C) 1998-2000 by DooM Legacy Team.
+// Copyright (C) 1999-2023 by Sonic Team Junior.
+//
+// This program is free software distributed under the
+// terms of the GNU General Public License, version 2.
+// See the 'LICENSE' file for more details.
+//-----------------------------------------------------------------------------
+/// \file  r_draw8_simd.c
+/// \brief 8bpp multi-column drawer functions for opaque columns
+/// \note  no includes because this is included as part of r_draw.c
+
+// ==========================================================================
+// MULTI-COLUMN DRAWERS
+// ==========================================================================
+
+// These only stand in for R_DrawColumn_8, for the rows shared by a group
+// of adjacent wall or sky columns, see R_FlushColumnBatch. Every column
+// keeps its own source, colormap and texture step, and gives the same
+// result as R_DrawColumn_8 would for a power of two texture. Drawing a
+// row of neighbouring pixels at a time touches each line of the screen
+// once instead of once per column, which is where the time goes.
+//
+// The SSE2 and NEON versions only step and wrap the texture positions
+// in vector registers. The texture and colormap lookups are still done
+// one byte at a time, as in the plain C version. The translucent,
+// translated and shade drawers have no multi-column versions.
+
+#ifdef COLUMNS_SSE2
+#ifdef _MSC_VER
+#define TARGET_SSE2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+#endif
+
+/**	\brief The R_DrawColumns_8 function
+	Draws four columns at once, without using any vector instructions.
+*/
+void R_DrawColumns_8(UINT8 *dest, INT32 count, const columnlanes_t *lanes)
+{
+	const UINT8 *source0 = lanes->source[0], *source1 = lanes->source[1];
+	const UINT8 *source2 = lanes->source[2], *source3 = lanes->source[3];
+	const lighttable_t *colormap0 = lanes->colormap[0], *colormap1 = lanes->colormap[1];
+	const lighttable_t *colormap2 = lanes->colormap[2], *colormap3 = lanes->colormap[3];
+	fixed_t frac0 = lanes->frac[0], frac1 = lanes->frac[1];
+	fixed_t frac2 = lanes->frac[2], frac3 = lanes->frac[3];
+	const INT32 heightmask = lanes->heightmask;
+
+	do
+	{
+		dest[0] = colormap0[source0[(frac0>>FRACBITS) & heightmask]];
+		dest[1] = colormap1[source1[(frac1>>FRACBITS) & heightmask]];
+		dest[2] = colormap2[source2[(frac2>>FRACBITS) & heightmask]];
+		dest[3] = colormap3[source3[(frac3>>FRACBITS) & heightmask]];
+		dest += vid.width;
+
+		frac0 += lanes->fracstep[0];
+		frac1 += lanes->fracstep[1];
+		frac2 += lanes->fracstep[2];
+		frac3 += lanes->fracstep[3];
+	} while (--count);
+}
+
+#ifdef COLUMNS_SSE2
+/**	\brief The R_DrawColumns_8_SSE2 function
+	Draws four columns at once, stepping their texture positions with SSE2.
+*/
+TARGET_SSE2 void R_DrawColumns_8_SSE2(UINT8 *dest, INT32 count, const columnlanes_t *lanes)
+{
+	const UINT8 *source0 = lanes->source[0], *source1 = lanes->source[1];
+	const UINT8 *source2 = lanes->source[2], *source3 = lanes->source[3];
+	const lighttable_t *colormap0 = lanes->colormap[0], *colormap1 = lanes->colormap[1];
+	const lighttable_t *colormap2 = lanes->colormap[2], *colormap3 = lanes->colormap[3];
+	__m128i frac = _mm_loadu_si128((const __m128i *)lanes->frac);
+	const __m128i fracstep = _mm_loadu_si128((const __m128i *)lanes->fracstep);
+	const __m128i heightmask = _mm_set1_epi32(lanes->heightmask);
+	INT16 ofs[4];
+	UINT32 pixels;
+
+	do
+	{
+		// (frac>>FRACBITS) always fits in 16 bits, even without a mask
+		__m128i index = _mm_and_si128(_mm_srai_epi32(frac, FRACBITS), heightmask);
+		_mm_storel_epi64((__m128i *)ofs, _mm_packs_epi32(index, index));
+
+		pixels = colormap0[source0[ofs[0]]]
+			| (colormap1[source1[ofs[1]]] << 8)
+			| (colormap2[source2[ofs[2]]] << 16)
+			| ((UINT32)colormap3[source3[ofs[3]]] << 24);
+		memcpy(dest, &pixels, sizeof(pixels));
+		dest += vid.width;
+
+		frac = _mm_add_epi32(frac, fracstep);
+	} while (--count);
+}
+#endif
+
+#ifdef COLUMNS_NEON
+/**	\brief The R_DrawColumns_8_NEON function
+	Draws four columns at once, stepping their texture positions with NEON.
+*/
+void R_DrawColumns_8_NEON(UINT8 *dest, INT32 count, const columnlanes_t *lanes)
+{
+	const UINT8 *source0 = lanes->source[0], *source1 = lanes->source[1];
+	const UINT8 *source2 = lanes->source[2], *source3 = lanes->source[3];
+	const lighttable_t *colormap0 = lanes->colormap[0], *colormap1 = lanes->colormap[1];
+	const lighttable_t *colormap2 = lanes->colormap[2], *colormap3 = lanes->colormap[3];
+	int32x4_t frac = vld1q_s32(lanes->frac);
+	const int32x4_t fracstep = vld1q_s32(lanes->fracstep);
+	const int32x4_t heightmask = vdupq_n_s32(lanes->heightmask);
+	INT16 ofs[4];
+
+	do
+	{
+		vst1_s16(ofs, vmovn_s32(vandq_s32(vshrq_n_s32(frac, FRACBITS), heightmask)));
+
+		dest[0] = colormap0[source0[ofs[0]]];
+		dest[1] = colormap1[source1[ofs[1]]];
+		dest[2] = colormap2[source2[ofs[2]]];
+		dest[3] = colormap3[source3[ofs[3]]];
+		dest += vid.width;
+
+		frac = vaddq_s32(frac, fracstep);
+	} while (--count);
+}
+#endif
@@ -284,6 +284,48 @@ angle_t R_InterpolateAngle(angle_t from, angle_t to)
 	return (R_LerpAngle(from, to, rendertimefrac));
 }
 
+// Interpolated mobj states computed for the current frame, indexed by
+// mobj->interpindex. A mobj's slot is valid while its interpframe matches.
+static interpmobjstate_t *interpstates = NULL;
+static size_t interpstates_len = 0;
+static size_t interpstates_capacity = 0;
+static UINT32 interpstates_frame = 1;
+static fixed_t interpstates_frac = FRACUNIT;
+
+void R_ClearMobjInterpolationCache(void)
+{
+	interpstates_len = 0;
+	if (++interpstates_frame == 0) // 0 is what new mobjs start with
+		interpstates_frame = 1;
+}
+
+static void R_CacheMobjState(mobj_t *mobj, const interpmobjstate_t *state)
+{
+	if (interpstates_len >= interpstates_capacity)
+	{
+		if (interpstates_capacity == 0)
+		{
+			interpstates_capacity = 256;
+		}
+		else
+		{
+			interpstates_capacity *= 2;
+		}
+
+		interpstates = Z_Realloc(
+			interpstates,
+			sizeof(interpmobjstate_t) * interpstates_capacity,
+			PU_STATIC,
+			NULL
+		);
+	}
+
+	interpstates[interpstates_len] = *state;
+	mobj->interpframe = interpstates_frame;
+	mobj->interpindex = (UINT32)interpstates_len;
+	interpstates_len += 1;
+}
+
 void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
 {
 	if (frac == FRACUNIT)
@@ -306,6 +348,19 @@ void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
 		return;
 	}
 
+	// Every sprite, shadow and model of a mobj asks for the same state,
+	// possibly several times per view, so only work it out once per frame.
+	if (frac != interpstates_frac)
+	{
+		R_ClearMobjInterpolationCache();
+		interpstates_frac = frac;
+	}
+	else if (mobj->interpframe == interpstates_frame)
+	{
+		*out = interpstates[mobj->interpindex];
+		return;
+	}
+
 	out->x = R_LerpFixed(mobj->old_x, mobj->x, frac);
 	out->y = R_LerpFixed(mobj->old_y, mobj->y, frac);
 	out->z = R_LerpFixed(mobj->old_z, mobj->z, frac);
@@ -344,6 +399,8 @@ void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
 	out->pitch = mobj->resetinterp ? mobj->pitch : R_LerpAngle(mobj->old_pitch, mobj->pitch, frac);
 	out->roll = mobj->resetinterp ? mobj->roll : R_LerpAngle(mobj->old_roll, mobj->roll, frac);
 	out->spriteroll = mobj->resetinterp ? mobj->spriteroll : R_LerpAngle(mobj->old_spriteroll, mobj->spriteroll, frac);
+
+	R_CacheMobjState(mobj, out);
 }
 
 void R_InterpolatePrecipMobjState(precipmobj_t *mobj, fixed_t frac, interpmobjstate_t *out)
@@ -819,6 +876,7 @@ void R_ResetMobjInterpolationState(mobj_t *mobj)
 	}
 
 	mobj->resetinterp = false;
+	mobj->interpframe = 0;
 }
 
 //
@@ -131,7 +131,10 @@ fixed_t R_InterpolateFixed(fixed_t from, fixed_t to);
 angle_t R_InterpolateAngle(angle_t from, angle_t to);
 
 // Evaluate the interpolated mobj state for the given mobj
+// The result is cached until R_ClearMobjInterpolationCache is called or a different frac is used
 void R_InterpolateMobjState(mobj_t *mobj, fixed_t frac, interpmobjstate_t *out);
+// Forget the interpolated mobj states cached for the last frame. Call before rendering a frame.
+void R_ClearMobjInterpolationCache(void);
 // Evaluate the interpolated mobj state for the given precipmobj
 void R_InterpolatePrecipMobjState(precipmobj_t *mobj, fixed_t frac, interpmobjstate_t *out);
 
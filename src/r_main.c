@@ -105,12 +105,16 @@ ps_metric_t ps_bsptime = {0};
 
 ps_metric_t ps_sw_spritecliptime = {0};
 ps_metric_t ps_sw_portaltime = {0};
+ps_metric_t ps_sw_skyboxtime = {0};
+ps_metric_t ps_sw_maxportaltime = {0};
 ps_metric_t ps_sw_planetime = {0};
 ps_metric_t ps_sw_maskedtime = {0};
 
 ps_metric_t ps_numbspcalls = {0};
 ps_metric_t ps_numsprites = {0};
 ps_metric_t ps_numdrawnodes = {0};
+ps_metric_t ps_sw_numportals = {0};
+ps_metric_t ps_sw_numportalsculled = {0};
 ps_metric_t ps_numpolyobjects = {0};
 
 static CV_PossibleValue_t drawdist_cons_t[] = {
@@ -1508,6 +1512,8 @@ void R_RenderPlayerView(player_t *player)
 	Mask_Pre(&masks[nummasks - 1]);
 	curdrawsegs = ds_p;
 	ps_numbspcalls.value.i = ps_numpolyobjects.value.i = ps_numdrawnodes.value.i = 0;
+	ps_sw_numportals.value.i = ps_sw_numportalsculled.value.i = 0;
+	ps_sw_skyboxtime.value.p = ps_sw_maxportaltime.value.p = 0;
 	PS_START_TIMING(ps_bsptime);
 	R_RenderBSPNode((INT32)numnodes - 1);
 	PS_STOP_TIMING(ps_bsptime);
@@ -1532,6 +1538,9 @@ void R_RenderPlayerView(player_t *player)
 
 		for(portal = portal_base; portal; portal = portal_base)
 		{
+			precise_t portaltime = I_GetPreciseTime();
+			boolean skybox = (portal->clipline == -1);
+
 			portalrender = portal->pass; // Recursiveness depth.
 
 			R_ClearFFloorClips();
@@ -1563,6 +1572,13 @@ void R_RenderPlayerView(player_t *player)
 			R_ClipSprites(ds_p - (masks[nummasks - 1].drawsegs[1] - masks[nummasks - 1].drawsegs[0]), portal);
 
 			Portal_Remove(portal);
+
+			portaltime = I_GetPreciseTime() - portaltime;
+			if (skybox)
+				ps_sw_skyboxtime.value.p += portaltime;
+			if (portaltime > ps_sw_maxportaltime.value.p)
+				ps_sw_maxportaltime.value.p = portaltime;
+			ps_sw_numportals.value.i++;
 		}
 	}
 	PS_STOP_TIMING(ps_sw_portaltime);
@@ -1584,6 +1600,197 @@ void R_RenderPlayerView(player_t *player)
 //                    ENGINE COMMANDS & VARS
 // =========================================================================
 
+#ifdef _DEBUG
+// Renders the current view several times with every column drawn on its
+// own, and then again with column batching, and prints how long it took.
+// Only opaque wall and sky columns are batched, so sprites and translucent
+// midtextures take the same time in both passes.
+static void Command_DrawerBench_f(void)
+{
+	void (*multi)(UINT8 *, INT32, const columnlanes_t *) = colfunc_multi;
+	const INT32 lanes = colfunc_multi_lanes;
+	const boolean validate = r_validatedrawers;
+	INT32 frames = 30;
+	precise_t time[2];
+	INT32 i, pass;
+
+	if (rendermode != render_soft || gamestate != GS_LEVEL || splitscreen || !players[displayplayer].mo)
+	{
+		CONS_Printf(M_GetText("You must be in a level, without splitscreen, in the Software renderer to use this.\n"));
+		return;
+	}
+
+	if (!multi)
+	{
+		CONS_Printf(M_GetText("Column batching is turned off.\n"));
+		return;
+	}
+
+	if (COM_Argc() > 1)
+		frames = max(atoi(COM_Argv(1)), 1);
+
+	r_validatedrawers = false;
+	topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
+
+	// once to make sure every texture in view is cached
+	R_RenderPlayerView(&players[displayplayer]);
+
+	for (pass = 0; pass < 2; pass++)
+	{
+		colfunc_multi = pass ? multi : NULL;
+		colfunc_multi_lanes = pass ? lanes : 0;
+
+		time[pass] = I_GetPreciseTime();
+		for (i = 0; i < frames; i++)
+			R_RenderPlayerView(&players[displayplayer]);
+		time[pass] = I_GetPreciseTime() - time[pass];
+	}
+
+	colfunc_multi = multi;
+	colfunc_multi_lanes = lanes;
+	r_validatedrawers = validate;
+
+	CONS_Printf("%d frames: %.3f ms per frame one column at a time, %.3f ms %d columns at a time\n", frames,
+		(double)time[0] * 1000.0 / I_GetPrecisePrecision() / frames,
+		(double)time[1] * 1000.0 / I_GetPrecisePrecision() / frames, lanes);
+}
+#endif
+
+#ifdef _DEBUG
+static void Command_ColorBench_f(void)
+{
+	RGBA_t palette[256];
+	INT32 count = 1<<20, mismatches = 0;
+	UINT32 seed, color;
+	UINT8 *results;
+	precise_t time[3];
+	INT32 i, pass;
+
+	if (COM_Argc() > 1)
+		count = max(atoi(COM_Argv(1)), 1);
+
+	// a copy of the master palette isn't recognised as it, so this is
+	// searched the slow way
+	M_Memcpy(palette, pMasterPalette, sizeof(palette));
+	results = Z_Malloc(count, PU_STATIC, NULL);
+
+	// first with an empty lookup, then once it is filled in, then without it
+	R_ClearNearestColorCache();
+	for (pass = 0; pass < 3; pass++)
+	{
+		seed = 0x12345678;
+		time[pass] = I_GetPreciseTime();
+		for (i = 0; i < count; i++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			color = seed >> 8;
+
+			if (pass < 2)
+				results[i] = NearestColor(color & 0xFF, (color >> 8) & 0xFF, color >> 16);
+			else if (NearestPaletteColor(color & 0xFF, (color >> 8) & 0xFF, color >> 16, palette) != results[i])
+				mismatches++;
+		}
+		time[pass] = I_GetPreciseTime() - time[pass];
+	}
+
+	Z_Free(results);
+
+	CONS_Printf("%d colors: %.3f ms searching the palette, %.3f ms with the lookup (%.3f ms while it was still empty)\n", count,
+		(double)time[2] * 1000.0 / I_GetPrecisePrecision(),
+		(double)time[1] * 1000.0 / I_GetPrecisePrecision(),
+		(double)time[0] * 1000.0 / I_GetPrecisePrecision());
+	if (mismatches)
+		CONS_Alert(CONS_WARNING, "%d colors didn't match!\n", mismatches);
+}
+#endif
+
+#ifdef _DEBUG
+// Times the full screen fade and wipe kernels against plain byte loops
+// at some common resolutions, and checks that they give the same result.
+static void Command_FadeBench_f(void)
+{
+	static const INT32 sizes[][2] = {{320, 200}, {1280, 720}, {1920, 1080}, {3840, 2160}};
+	const UINT8 *lut = colormaps + 16*256;
+	const UINT8 *transtable = R_GetTranslucencyTable(tr_trans50);
+	INT32 runs = 20, mismatches = 0;
+	UINT8 *bg, *fg, *out[2];
+	precise_t time[4];
+	size_t count, j;
+	INT32 i, s, pass;
+
+	if (COM_Argc() > 1)
+		runs = max(atoi(COM_Argv(1)), 1);
+
+	for (s = 0; s < (INT32)(sizeof(sizes) / sizeof(sizes[0])); s++)
+	{
+		count = (size_t)sizes[s][0] * sizes[s][1];
+		bg = Z_Malloc(count, PU_STATIC, NULL);
+		fg = Z_Malloc(count, PU_STATIC, NULL);
+		out[0] = Z_Malloc(count, PU_STATIC, NULL);
+		out[1] = Z_Malloc(count, PU_STATIC, NULL);
+
+		for (j = 0; j < count; j++)
+		{
+			bg[j] = (UINT8)(j * 7 + (j >> 9));
+			fg[j] = (UINT8)(j * 13 + (j >> 7));
+		}
+
+		// fades one byte at a time, then with V_MapBytes,
+		// and the same for translucent wipes with V_BlendBytes
+		for (pass = 0; pass < 4; pass++)
+		{
+			UINT8 *dest = out[pass & 1];
+
+			time[pass] = I_GetPreciseTime();
+			for (i = 0; i < runs; i++)
+			{
+				if (pass == 0)
+				{
+					for (j = 0; j < count; j++)
+						dest[j] = lut[bg[j]];
+				}
+				else if (pass == 1)
+					V_MapBytes(dest, bg, count, lut);
+				else if (pass == 2)
+				{
+					for (j = 0; j < count; j++)
+						dest[j] = transtable[(fg[j]<<8) + bg[j]];
+				}
+				else
+					V_BlendBytes(dest, bg, fg, count, transtable);
+			}
+			time[pass] = I_GetPreciseTime() - time[pass];
+
+			if ((pass & 1) && memcmp(out[0], out[1], count))
+				mismatches++;
+		}
+
+		CONS_Printf("%dx%d: fade %.3f ms -> %.3f ms, blend %.3f ms -> %.3f ms\n", sizes[s][0], sizes[s][1],
+			(double)time[0] * 1000.0 / I_GetPrecisePrecision() / runs,
+			(double)time[1] * 1000.0 / I_GetPrecisePrecision() / runs,
+			(double)time[2] * 1000.0 / I_GetPrecisePrecision() / runs,
+			(double)time[3] * 1000.0 / I_GetPrecisePrecision() / runs);
+
+		Z_Free(bg);
+		Z_Free(fg);
+		Z_Free(out[0]);
+		Z_Free(out[1]);
+	}
+
+	if (mismatches)
+		CONS_Alert(CONS_WARNING, "%d passes didn't match!\n", mismatches);
+}
+#endif
+
+#ifdef _DEBUG
+static void Command_ColormapStats_f(void)
+{
+	CONS_Printf(M_GetText("%u colormaps, %u of them fade steps\n"), colormapstats.colormaps, colormapstats.fadesteps);
+	CONS_Printf(M_GetText("%u light tables, %s KB\n"), colormapstats.tables, sizeu1(colormapstats.tables * LIGHTTABLESIZE / 1024));
+	CONS_Printf(M_GetText("Fade steps: %u found, %u made, %u recycled\n"), colormapstats.fadehits, colormapstats.fademisses, colormapstats.recycled);
+}
+#endif
+
 void R_RegisterEngineStuff(void)
 {
 	CV_RegisterVar(&cv_gravity);
@@ -1602,6 +1809,14 @@ void R_RegisterEngineStuff(void)
 	cv_drawdist.defaultvalue = "4096";
 #endif
 
+#ifdef _DEBUG
+	COM_AddCommand("drawerbench", Command_DrawerBench_f, 0);
+	COM_AddCommand("colorbench", Command_ColorBench_f, 0);
+	COM_AddCommand("fadebench", Command_FadeBench_f, 0);
+	COM_AddCommand("spriteclipbench", Command_SpriteClipBench_f, 0);
+	COM_AddCommand("colormapstats", Command_ColormapStats_f, 0);
+#endif
+
 	CV_RegisterVar(&cv_drawdist);
 	CV_RegisterVar(&cv_drawdist_nights);
 	CV_RegisterVar(&cv_drawdist_precip);
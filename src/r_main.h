@@ -96,6 +96,8 @@ extern ps_metric_t ps_bsptime;
 
 extern ps_metric_t ps_sw_spritecliptime;
 extern ps_metric_t ps_sw_portaltime;
+extern ps_metric_t ps_sw_skyboxtime;
+extern ps_metric_t ps_sw_maxportaltime;
 extern ps_metric_t ps_sw_planetime;
 extern ps_metric_t ps_sw_maskedtime;
 
@@ -103,6 +105,8 @@ extern ps_metric_t ps_numbspcalls;
 extern ps_metric_t ps_numsprites;
 extern ps_metric_t ps_numdrawnodes;
 extern ps_metric_t ps_numpolyobjects;
+extern ps_metric_t ps_sw_numportals;
+extern ps_metric_t ps_sw_numportalsculled;
 
 //
 // REFRESH - the actual rendering functions.
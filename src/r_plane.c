@@ -637,6 +637,7 @@ static void R_DrawSkyPlane(visplane_t *pl)
 {
 	INT32 x;
 	INT32 angle;
+	columnbatch_t batch;
 
 	// Reset column drawer function (note: couldn't we just call walldrawerfunc directly?)
 	// (that is, unless we'll need to switch drawers in future for some reason)
@@ -653,6 +654,7 @@ static void R_DrawSkyPlane(visplane_t *pl)
 	dc_texturemid = skytexturemid;
 	dc_texheight = textureheight[skytexture]
 		>>FRACBITS;
+	batch.count = 0;
 	for (x = pl->minx; x <= pl->maxx; x++)
 	{
 		dc_yl = pl->top[x];
@@ -666,9 +668,10 @@ static void R_DrawSkyPlane(visplane_t *pl)
 			dc_source =
 				R_GetColumn(texturetranslation[skytexture],
 					-angle); // get negative of angle for each column to display sky correct way round! --Monster Iestyn 27/01/18
-			colfunc();
+			R_BatchColumn(&batch);
 		}
 	}
+	R_FlushColumnBatch(&batch);
 }
 
 // Returns the height of the sloped plane at (x, y) as a 32.16 fixed_t
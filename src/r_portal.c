@@ -25,6 +25,9 @@ UINT8 portalrender;			/**< When rendering a portal, it establishes the depth of
 // Linked list for portals.
 portal_t *portal_base, *portal_cap;
 
+// Portals that were rendered already, kept to be reused by Portal_Add.
+static portal_t *portal_free;
+
 line_t *portalclipline;
 sector_t *portalcullsector;
 INT32 portalclipstart, portalclipend;
@@ -34,6 +37,14 @@ boolean portalline; // is curline a portal seg?
 void Portal_InitList (void)
 {
 	portalrender = 0;
+
+	// Anything left over from an unfinished frame can be reused.
+	if (portal_base)
+	{
+		portal_cap->next = portal_free;
+		portal_free = portal_base;
+	}
+
 	portal_base = portal_cap = NULL;
 }
 
@@ -99,10 +110,22 @@ void Portal_ClipApply (const portal_t* portal)
 
 static portal_t* Portal_Add (const INT16 x1, const INT16 x2)
 {
-	portal_t *portal		= Z_Malloc(sizeof(portal_t), PU_LEVEL, NULL);
-	INT16 *ceilingclipsave	= Z_Malloc(sizeof(INT16)*(x2-x1 + 1), PU_LEVEL, NULL);
-	INT16 *floorclipsave	= Z_Malloc(sizeof(INT16)*(x2-x1 + 1), PU_LEVEL, NULL);
-	fixed_t *frontscalesave	= Z_Malloc(sizeof(fixed_t)*(x2-x1 + 1), PU_LEVEL, NULL);
+	portal_t *portal = portal_free;
+
+	if (portal)
+		portal_free = portal->next;
+	else
+		portal = Z_Calloc(sizeof(portal_t), PU_STATIC, NULL);
+
+	// The clipping arrays are sized for the whole screen, so they only
+	// need to be reallocated when the resolution goes up.
+	if (portal->clipwidth < vid.width)
+	{
+		portal->clipwidth	= vid.width;
+		portal->ceilingclip	= Z_Realloc(portal->ceilingclip, sizeof(INT16)*vid.width, PU_STATIC, NULL);
+		portal->floorclip	= Z_Realloc(portal->floorclip, sizeof(INT16)*vid.width, PU_STATIC, NULL);
+		portal->frontscale	= Z_Realloc(portal->frontscale, sizeof(fixed_t)*vid.width, PU_STATIC, NULL);
+	}
 
 	// Linked list.
 	if (!portal_base)
@@ -117,10 +140,7 @@ static portal_t* Portal_Add (const INT16 x1, const INT16 x2)
 	}
 	portal->next = NULL;
 
-	// Store clipping values so they can be restored once the portal is rendered.
-	portal->ceilingclip	= ceilingclipsave;
-	portal->floorclip	= floorclipsave;
-	portal->frontscale	= frontscalesave;
+	// Clipping values are stored in the arrays so they can be restored once the portal is rendered.
 	portal->start	= x1;
 	portal->end		= x2;
 
@@ -134,10 +154,35 @@ void Portal_Remove (portal_t* portal)
 {
 	portalcullsector = NULL;
 	portal_base = portal->next;
-	Z_Free(portal->ceilingclip);
-	Z_Free(portal->floorclip);
-	Z_Free(portal->frontscale);
-	Z_Free(portal);
+
+	// Keep it around for the next portal.
+	portal->next = portal_free;
+	portal_free = portal;
+}
+
+/** Trims a range of screen columns to the ones that are
+ * still open in the current clipping window.
+ *
+ * Returns false if none of them are, in which case nothing
+ * would be visible through a portal in that range.
+ */
+static boolean Portal_TrimToWindow (INT32 *x1, INT32 *x2)
+{
+	INT32 start	= *x1;
+	INT32 end	= *x2;
+
+	while (start < end && floorclip[start] - ceilingclip[start] <= 1)
+		start++;
+
+	while (end > start && floorclip[end - 1] - ceilingclip[end - 1] <= 1)
+		end--;
+
+	if (start >= end)
+		return false;
+
+	*x1 = start;
+	*x2 = end;
+	return true;
 }
 
 /** Creates a portal out of two lines and a determined screen range.
@@ -152,19 +197,35 @@ void Portal_Remove (portal_t* portal)
  */
 void Portal_Add2Lines (const INT32 line1, const INT32 line2, const INT32 x1, const INT32 x2)
 {
-	portal_t* portal = Portal_Add(x1, x2);
+	portal_t* portal;
 
 	// Offset the portal view by the linedef centers
 	line_t* start	= &lines[line1];
 	line_t* dest	= &lines[line2];
 
-	angle_t dangle = R_PointToAngle2(0,0,dest->dx,dest->dy) - R_PointToAngle2(start->dx,start->dy,0,0);
+	angle_t dangle;
 
 	fixed_t disttopoint;
 	angle_t angtopoint;
 
 	vertex_t dest_c, start_c;
 
+	INT32 clipstart = x1, clipend = x2;
+
+	portalline = true; // this tells R_StoreWallRange that curline is a portal seg
+
+	// Don't render what's behind the portal at all if it's fully occluded,
+	// and only render the columns that can still be seen otherwise.
+	if (!Portal_TrimToWindow(&clipstart, &clipend))
+	{
+		ps_sw_numportalsculled.value.i++;
+		return;
+	}
+
+	portal = Portal_Add(clipstart, clipend);
+
+	dangle = R_PointToAngle2(0,0,dest->dx,dest->dy) - R_PointToAngle2(start->dx,start->dy,0,0);
+
 	// looking glass center
 	start_c.x = (start->v1->x + start->v2->x) / 2;
 	start_c.y = (start->v1->y + start->v2->y) / 2;
@@ -185,8 +246,6 @@ void Portal_Add2Lines (const INT32 line1, const INT32 line2, const INT32 x1, con
 	portal->clipline = line2;
 
 	Portal_ClipRange(portal);
-
-	portalline = true; // this tells R_StoreWallRange that curline is a portal seg
 }
 
 /** Store the clipping window for a portal using a visplane.
@@ -252,23 +311,14 @@ static boolean TrimVisplaneBounds (const visplane_t* plane, INT16* start, INT16*
 	return false;
 }
 
-/** Creates a skybox portal out of a visplane.
+/** Sets the viewpoint of a skybox portal.
  *
  * Applies the necessary offsets and rotation to give
  * a depth illusion to the skybox.
  */
-void Portal_AddSkybox (const visplane_t* plane)
+static void Portal_SetSkyboxView (portal_t* portal)
 {
-	INT16 start, end;
 	mapheader_t *mh;
-	portal_t* portal;
-
-	if (TrimVisplaneBounds(plane, &start, &end))
-		return;
-
-	portal = Portal_Add(start, end);
-
-	Portal_ClipVisplane(plane, portal);
 
 	portal->viewx = skyboxmo[0]->x;
 	portal->viewy = skyboxmo[0]->y;
@@ -306,14 +356,100 @@ void Portal_AddSkybox (const visplane_t* plane)
 	portal->clipline = -1;
 }
 
-/** Creates portals for the currently existing sky visplanes.
+/** Checks if a visplane can be added to a skybox portal's window.
+ *
+ * In every column where both are open, the visplane has to touch
+ * or overlap the window, otherwise the merged window would also
+ * cover whatever was drawn between the two.
+ */
+static boolean Portal_CanMergeVisplane (const portal_t* portal, const visplane_t* plane, INT16 start, INT16 end)
+{
+	INT32 i		= max(start, portal->start);
+	INT32 stop	= min(end, portal->end);
+
+	for (; i < stop; i++)
+	{
+		INT16 ceil	= portal->ceilingclip[i - portal->start];
+		INT16 floor	= portal->floorclip[i - portal->start];
+
+		if (plane->top[i] == 65535 || floor - ceil <= 1)
+			continue;
+
+		if (plane->top[i] > floor || plane->bottom[i] < ceil)
+			return false;
+	}
+
+	return true;
+}
+
+/** Adds a visplane to a skybox portal's window, growing it if needed.
+ */
+static void Portal_MergeVisplane (portal_t* portal, const visplane_t* plane, INT16 start, INT16 end)
+{
+	INT32 i;
+
+	if (start < portal->start)
+	{
+		INT32 shift = portal->start - start;
+		INT32 len = portal->end - portal->start;
+
+		memmove(portal->ceilingclip + shift, portal->ceilingclip, sizeof(INT16)*len);
+		memmove(portal->floorclip + shift, portal->floorclip, sizeof(INT16)*len);
+		memmove(portal->frontscale + shift, portal->frontscale, sizeof(fixed_t)*len);
+
+		for (i = 0; i < shift; i++)
+			portal->ceilingclip[i] = portal->floorclip[i] = -1;
+
+		portal->start = start;
+	}
+
+	if (end > portal->end)
+	{
+		for (i = portal->end - portal->start; i < end - portal->start; i++)
+			portal->ceilingclip[i] = portal->floorclip[i] = -1;
+
+		portal->end = end;
+	}
+
+	for (i = start; i < end; i++)
+	{
+		INT16 *ceil		= &portal->ceilingclip[i - portal->start];
+		INT16 *floor	= &portal->floorclip[i - portal->start];
+
+		// Invalid column.
+		if (plane->top[i] == 65535)
+			continue;
+
+		if (*floor - *ceil <= 1)
+		{
+			*ceil = plane->top[i] - 1;
+			*floor = plane->bottom[i] + 1;
+		}
+		else
+		{
+			*ceil = min(*ceil, plane->top[i] - 1);
+			*floor = max(*floor, plane->bottom[i] + 1);
+		}
+		portal->frontscale[i - portal->start] = INT32_MAX;
+	}
+}
+
+/** Creates skybox portals for the currently existing sky visplanes.
  * The visplanes are also removed and cleared from the list.
+ *
+ * All of them look at the same skybox from the same viewpoint,
+ * so visplanes are merged into the same portal whenever their
+ * windows can be joined, and the skybox is rendered only once
+ * for all of them.
  */
 void Portal_AddSkyboxPortals (void)
 {
 	visplane_t *pl;
+	portal_t *skybox = NULL; // first skybox portal, the ones after it in the list are too
+	portal_t *portal;
+	INT16 start, end;
 	INT32 i;
-	UINT16 count = 0;
+	UINT16 count = 0, merged = 0;
 
 	for (i = 0; i < MAXVISPLANES; i++, pl++)
 	{
@@ -321,15 +457,45 @@ void Portal_AddSkyboxPortals (void)
 		{
 			if (pl->picnum == skyflatnum)
 			{
-				Portal_AddSkybox(pl);
+				if (!TrimVisplaneBounds(pl, &start, &end))
+				{
+					for (portal = skybox; portal; portal = portal->next)
+					{
+						if (Portal_CanMergeVisplane(portal, pl, start, end))
+						{
+							Portal_MergeVisplane(portal, pl, start, end);
+							merged++;
+							break;
+						}
+					}
+
+					if (!portal)
+					{
+						portal = Portal_Add(start, end);
+						Portal_ClipVisplane(pl, portal);
+						count++;
+
+						if (skybox)
+						{
+							portal->viewx = skybox->viewx;
+							portal->viewy = skybox->viewy;
+							portal->viewz = skybox->viewz;
+							portal->viewangle = skybox->viewangle;
+							portal->clipline = -1;
+						}
+						else
+						{
+							Portal_SetSkyboxView(portal);
+							skybox = portal;
+						}
+					}
+				}
 
 				pl->minx = 0;
 				pl->maxx = -1;
-
-				count++;
 			}
 		}
 	}
 
-	CONS_Debug(DBG_RENDER, "Skybox portals: %d\n", count);
+	CONS_Debug(DBG_RENDER, "Skybox portals: %d (%d visplanes merged)\n", count, merged);
 }
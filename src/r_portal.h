@@ -39,6 +39,7 @@ typedef struct portal_s
 	INT16 *ceilingclip; /**< Temporary screen top clipping array. */
 	INT16 *floorclip;	/**< Temporary screen bottom clipping array. */
 	fixed_t *frontscale;/**< Temporary screen bottom clipping array. */
+	INT32 clipwidth;	/**< Allocated length of the clipping arrays. */
 } portal_t;
 
 extern portal_t* portal_base;
@@ -52,7 +53,6 @@ extern INT32 portalclipstart, portalclipend;
 void Portal_InitList	(void);
 void Portal_Remove		(portal_t* portal);
 void Portal_Add2Lines	(const INT32 line1, const INT32 line2, const INT32 x1, const INT32 x2);
-void Portal_AddSkybox	(const visplane_t* plane);
 
 void Portal_ClipRange (portal_t* portal);
 void Portal_ClipApply (const portal_t* portal);
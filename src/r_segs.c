@@ -1055,6 +1055,10 @@ static void R_RenderSegLoop (void)
 	INT32     bottom;
 	INT32     i;
 
+	// walls are drawn a few columns at a time, one batch per tier
+	columnbatch_t midbatch, topbatch, bottombatch;
+	midbatch.count = topbatch.count = bottombatch.count = 0;
+
 	for (; rw_x < rw_stopx; rw_x++)
 	{
 		// mark floor / ceiling areas
@@ -1300,7 +1304,7 @@ static void R_RenderSegLoop (void)
 #ifdef TIMING
 				ProfZeroTimer();
 #endif
-				colfunc();
+				R_BatchColumn(&midbatch);
 #ifdef TIMING
 				RDMSR(0x10,&mycount);
 				mytotal += mycount;      //64bit add
@@ -1356,7 +1360,7 @@ static void R_RenderSegLoop (void)
 						dc_texturemid = rw_toptexturemid;
 						dc_source = R_GetColumn(toptexture, itexturecolumn + (rw_offset_top>>FRACBITS));
 						dc_texheight = textureheight[toptexture]>>FRACBITS;
-						colfunc();
+						R_BatchColumn(&topbatch);
 						ceilingclip[rw_x] = (INT16)mid;
 					}
 					else if (!rw_ceilingmarked) // entirely off top of screen
@@ -1392,7 +1396,7 @@ static void R_RenderSegLoop (void)
 						dc_texturemid = rw_bottomtexturemid;
 						dc_source = R_GetColumn(bottomtexture, itexturecolumn + (rw_offset_bot>>FRACBITS));
 						dc_texheight = textureheight[bottomtexture]>>FRACBITS;
-						colfunc();
+						R_BatchColumn(&bottombatch);
 						floorclip[rw_x] = (INT16)mid;
 					}
 					else if (!rw_floormarked)  // entirely off bottom of screen
@@ -1449,6 +1453,10 @@ static void R_RenderSegLoop (void)
 		topfrac += topstep;
 		bottomfrac += bottomstep;
 	}
+
+	R_FlushColumnBatch(&midbatch);
+	R_FlushColumnBatch(&topbatch);
+	R_FlushColumnBatch(&bottombatch);
 }
 
 // Uses precalculated seg->length
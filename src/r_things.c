@@ -36,6 +36,7 @@
 #include "p_slopes.h"
 #include "d_netfil.h" // blargh. for nameonly().
 #include "m_cheat.h" // objectplace
+#include "v_video.h" // screens
 #ifdef HWRENDER
 #include "hardware/hw_md2.h"
 #include "hardware/hw_glob.h"
@@ -94,19 +95,27 @@ typedef struct drawseg_xrange_item_s
 	drawseg_t *user;
 } drawseg_xrange_item_t;
 
-typedef struct drawsegs_xrange_s
-{
-	drawseg_xrange_item_t *items;
-	INT32 count;
-} drawsegs_xrange_t;
-
-#define DS_RANGES_COUNT 3
-static drawsegs_xrange_t drawsegs_xranges[DS_RANGES_COUNT];
-
+// Every drawseg of the current portal pass that can clip a sprite,
+// from the last one drawn to the first.
 static drawseg_xrange_item_t *drawsegs_xrange;
 static size_t drawsegs_xrange_size = 0;
 static INT32 drawsegs_xrange_count = 0;
 
+// The same drawsegs, binned by bands of (1<<DS_BINSHIFT) screen columns.
+// A drawseg is put in every band it touches, keeping the order above, so
+// the clipping of any column only needs the band that column is in.
+#define DS_BINSHIFT 5
+#define DS_BINS ((MAXVIDWIDTH >> DS_BINSHIFT) + 1)
+static drawseg_xrange_item_t *drawsegs_bins;
+static size_t drawsegs_bins_size = 0;
+static INT32 drawsegs_binstart[DS_BINS + 1];
+static INT32 drawsegs_numbins = 0;
+#ifdef _DEBUG
+static boolean drawsegs_usebins = true; // turned off by spriteclipbench
+#else
+#define drawsegs_usebins true
+#endif
+
 // ==========================================================================
 //
 // Sprite loading routines: support sprites in pwad, dehacked sprite renaming,
@@ -2610,17 +2619,91 @@ static boolean R_SortVisSpriteFunc(vissprite_t *ds, fixed_t bestscale, INT32 bes
 	return false;
 }
 
+// Merge sorts a NULL-terminated chain of vissprites, linked through next, by
+// R_SortVisSpriteFunc. Sprites that compare equal keep their order, which
+// gives the same order as repeatedly pulling out the first best sprite.
+static vissprite_t *R_MergeSortVisSprites(vissprite_t *list)
+{
+	vissprite_t *p, *q, *e, *tail;
+	INT32 insize = 1, nmerges, psize, qsize, i;
+
+	if (!list)
+		return NULL;
+
+	do
+	{
+		p = list;
+		list = tail = NULL;
+		nmerges = 0;
+
+		while (p)
+		{
+			nmerges++;
+
+			// step insize places along from p to find q
+			for (q = p, psize = 0, i = 0; i < insize && q; i++)
+			{
+				psize++;
+				q = q->next;
+			}
+			qsize = insize;
+
+			// merge the two runs, preferring p when equal
+			while (psize > 0 || (qsize > 0 && q))
+			{
+				if (psize == 0)
+				{
+					e = q; q = q->next; qsize--;
+				}
+				else if (qsize == 0 || !q || !R_SortVisSpriteFunc(q, p->sortscale, p->dispoffset))
+				{
+					e = p; p = p->next; psize--;
+				}
+				else
+				{
+					e = q; q = q->next; qsize--;
+				}
+
+				if (tail)
+					tail->next = e;
+				else
+					list = e;
+				tail = e;
+			}
+
+			p = q;
+		}
+
+		tail->next = NULL;
+		insize *= 2;
+	} while (nmerges > 1);
+
+	return list;
+}
+
+// Hash of the sprites a linkdraw sprite may attach to, keyed by mobj.
+// Each chain runs from the last sprite in the unsorted list to the first.
+static vissprite_t *linkhash[MAXVISSPRITES*2];
+static UINT32 linkhashmask;
+
+#define LINKHASH(mobj) ((UINT32)(((size_t)(mobj) >> 4) * 2654435761u) & linkhashmask)
+
+// Returns true if a sprite can be the one a linkdraw sprite attaches to,
+// so long as it belongs to the same mobj.
+static inline boolean R_IsLinkDrawTracer(vissprite_t *ds)
+{
+	// don't connect if it's also a link, to your shadow, or to your bounding box!
+	return !(ds->cut & (SC_LINKDRAW|SC_SHADOW|SC_BBOX));
+}
+
 //
 // R_SortVisSprites
 //
 static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 end)
 {
-	UINT32       i, linkedvissprites = 0;
+	UINT32       i, numlinks = 0;
 	vissprite_t *ds, *dsprev, *dsnext, *dsfirst;
-	vissprite_t *best = NULL;
 	vissprite_t  unsorted;
-	fixed_t      bestscale;
-	INT32        bestdispoffset;
 
 	unsorted.next = unsorted.prev = &unsorted;
 
@@ -2637,6 +2720,9 @@ static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 e
 		ds->next = dsnext;
 		ds->prev = dsprev;
 		ds->linkdraw = NULL;
+
+		if (ds->cut & SC_LINKDRAW)
+			numlinks++;
 	}
 
 	// Fix first and last. ds still points to the last one after the loop
@@ -2649,6 +2735,25 @@ static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 e
 	}
 	unsorted.prev = ds;
 
+	// hash the sprites that linkdraw sprites can attach to by mobj
+	if (numlinks)
+	{
+		for (linkhashmask = 63; linkhashmask < end - start && linkhashmask < MAXVISSPRITES*2 - 1;)
+			linkhashmask = linkhashmask*2 + 1;
+
+		memset(linkhash, 0, (linkhashmask + 1) * sizeof (*linkhash));
+
+		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
+		{
+			if (R_IsLinkDrawTracer(ds))
+			{
+				UINT32 hash = LINKHASH(ds->mobj);
+				ds->linknext = linkhash[hash];
+				linkhash[hash] = ds;
+			}
+		}
+	}
+
 	// bundle linkdraw
 	for (ds = unsorted.prev; ds != &unsorted; ds = ds->prev)
 	{
@@ -2667,24 +2772,17 @@ static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 e
 			continue;
 
 		// reuse dsfirst...
-		for (dsfirst = unsorted.prev; dsfirst != &unsorted; dsfirst = dsfirst->prev)
+		// the tracer is the last sprite of the same mobj still in the list that fits
+		for (dsfirst = linkhash[LINKHASH(ds->mobj)]; dsfirst; dsfirst = dsfirst->linknext)
 		{
-			// don't connect if it's also a link
-			if (dsfirst->cut & SC_LINKDRAW)
-				continue;
-
-			// don't connect to your shadow!
-			if (dsfirst->cut & SC_SHADOW)
-				continue;
-
-			// don't connect to your bounding box!
-			if (dsfirst->cut & SC_BBOX)
-				continue;
-
 			// don't connect if it's not the tracer
 			if (dsfirst->mobj != ds->mobj)
 				continue;
 
+			// don't connect if it has already been removed as not visible
+			if (dsfirst->next->prev != dsfirst)
+				continue;
+
 			// don't connect if the tracer's top is cut off, but lower than the link's top
 			if ((dsfirst->cut & SC_TOP) && dsfirst->szt > ds->szt)
 				continue;
@@ -2707,9 +2805,7 @@ static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 e
 		if (ds->cut & SC_NOTVISIBLE)
 			continue;
 
-		linkedvissprites++;
-
-		if (dsfirst != &unsorted)
+		if (dsfirst)
 		{
 			if (!(ds->cut & SC_FULLBRIGHT))
 				ds->colormap = dsfirst->colormap;
@@ -2741,32 +2837,27 @@ static void R_SortVisSprites(vissprite_t* vsprsortedhead, UINT32 start, UINT32 e
 
 	// pull the vissprites out by scale
 	vsprsortedhead->next = vsprsortedhead->prev = vsprsortedhead;
-	for (i = start; i < end-linkedvissprites; i++)
+	if (unsorted.next == &unsorted)
+		return;
+
+	unsorted.prev->next = NULL;
+	for (ds = R_MergeSortVisSprites(unsorted.next); ds; ds = dsnext)
 	{
-		bestscale = bestdispoffset = INT32_MAX;
-		for (ds = unsorted.next; ds != &unsorted; ds = ds->next)
-		{
+		dsnext = ds->next;
+
 #ifdef PARANOIA
-			if (ds->cut & SC_LINKDRAW)
-				I_Error("R_SortVisSprites: no link or discardal made for linkdraw!");
+		if (ds->cut & SC_LINKDRAW)
+			I_Error("R_SortVisSprites: no link or discardal made for linkdraw!");
 #endif
 
-			if (R_SortVisSpriteFunc(ds, bestscale, bestdispoffset) == true)
-			{
-				bestscale = ds->sortscale;
-				bestdispoffset = ds->dispoffset;
-				best = ds;
-			}
-		}
-		if (best)
-		{
-			best->next->prev = best->prev;
-			best->prev->next = best->next;
-			best->next = vsprsortedhead;
-			best->prev = vsprsortedhead->prev;
-			vsprsortedhead->prev->next = best;
-			vsprsortedhead->prev = best;
-		}
+		// nothing sorts ahead of the starting best, so these were never picked
+		if (ds->sortscale == INT32_MAX && ds->dispoffset == INT32_MAX)
+			continue;
+
+		ds->next = vsprsortedhead;
+		ds->prev = vsprsortedhead->prev;
+		vsprsortedhead->prev->next = ds;
+		vsprsortedhead->prev = ds;
 	}
 }
 
@@ -3235,17 +3326,103 @@ static boolean R_CheckSpriteVisible(vissprite_t *spr, INT32 x1, INT32 x2)
 	return false;
 }
 
+//
+// R_ClipVisSpriteSegs
+// Clips columns x1 to x2 of a vissprite against a run of drawsegs,
+// the first drawseg in the run that obscures a column wins.
+static void R_ClipVisSpriteSegs(vissprite_t *spr, const drawseg_xrange_item_t *items, INT32 count, INT32 x1, INT32 x2)
+{
+	const drawseg_xrange_item_t *last = &items[count - 1];
+	const drawseg_xrange_item_t *curr = &items[-1];
+	drawseg_t *ds;
+	INT32 x;
+	INT32 r1;
+	INT32 r2;
+	fixed_t scale;
+	fixed_t lowscale;
+	INT32 silhouette;
+
+	while (++curr <= last)
+	{
+		// determine if the drawseg obscures the sprite
+		if (curr->x1 > x2 || curr->x2 < x1)
+		{
+			// does not cover sprite
+			continue;
+		}
+
+		ds = curr->user;
+
+		if (ds->portalpass > 0 && ds->portalpass <= portalrender)
+			continue; // is a portal
+
+		if (ds->scale1 > ds->scale2)
+		{
+			lowscale = ds->scale2;
+			scale = ds->scale1;
+		}
+		else
+		{
+			lowscale = ds->scale1;
+			scale = ds->scale2;
+		}
+
+		if (scale < spr->sortscale ||
+			(lowscale < spr->sortscale &&
+			 !R_PointOnSegSide (spr->gx, spr->gy, ds->curline)))
+		{
+			// masked mid texture?
+			/*if (ds->maskedtexturecol)
+				R_RenderMaskedSegRange (ds, r1, r2);*/
+			// seg is behind sprite
+			continue;
+		}
+
+		r1 = ds->x1 < x1 ? x1 : ds->x1;
+		r2 = ds->x2 > x2 ? x2 : ds->x2;
+
+		// clip this piece of the sprite
+		silhouette = ds->silhouette;
+
+		if (spr->gz >= ds->bsilheight)
+			silhouette &= ~SIL_BOTTOM;
+
+		if (spr->gzt <= ds->tsilheight)
+			silhouette &= ~SIL_TOP;
+
+		if (silhouette == SIL_BOTTOM)
+		{
+			// bottom sil
+			for (x = r1; x <= r2; x++)
+				if (spr->clipbot[x] == -2)
+					spr->clipbot[x] = ds->sprbottomclip[x];
+		}
+		else if (silhouette == SIL_TOP)
+		{
+			// top sil
+			for (x = r1; x <= r2; x++)
+				if (spr->cliptop[x] == -2)
+					spr->cliptop[x] = ds->sprtopclip[x];
+		}
+		else if (silhouette == (SIL_TOP|SIL_BOTTOM))
+		{
+			// both
+			for (x = r1; x <= r2; x++)
+			{
+				if (spr->clipbot[x] == -2)
+					spr->clipbot[x] = ds->sprbottomclip[x];
+				if (spr->cliptop[x] == -2)
+					spr->cliptop[x] = ds->sprtopclip[x];
+			}
+		}
+	}
+}
+
 // R_ClipVisSprite
 // Clips vissprites without drawing, so that portals can work. -Red
 static void R_ClipVisSprite(vissprite_t *spr, INT32 x1, INT32 x2, portal_t* portal)
 {
-	drawseg_t *ds;
 	INT32		x;
-	INT32		r1;
-	INT32		r2;
-	fixed_t		scale;
-	fixed_t		lowscale;
-	INT32		silhouette;
 
 	for (x = x1; x <= x2; x++)
 		spr->clipbot[x] = spr->cliptop[x] = -2;
@@ -3258,85 +3435,32 @@ static void R_ClipVisSprite(vissprite_t *spr, INT32 x1, INT32 x2, portal_t* port
 	// and buggy, by going past LEFT end of array:
 
 	// e6y: optimization
-	if (drawsegs_xrange_size)
+	if (drawsegs_xrange_count)
 	{
-		const drawseg_xrange_item_t *last = &drawsegs_xrange[drawsegs_xrange_count - 1];
-		drawseg_xrange_item_t *curr = &drawsegs_xrange[-1];
-
-		while (++curr <= last)
-		{
-			// determine if the drawseg obscures the sprite
-			if (curr->x1 > x2 || curr->x2 < x1)
-			{
-				// does not cover sprite
-				continue;
-			}
-
-			ds = curr->user;
-
-			if (ds->portalpass > 0 && ds->portalpass <= portalrender)
-				continue; // is a portal
+		INT32 b1 = x1 >> DS_BINSHIFT;
+		INT32 b2 = x2 >> DS_BINSHIFT;
+		INT32 b;
 
-			if (ds->scale1 > ds->scale2)
-			{
-				lowscale = ds->scale2;
-				scale = ds->scale1;
-			}
-			else
-			{
-				lowscale = ds->scale1;
-				scale = ds->scale2;
-			}
+		b1 = min(max(b1, 0), drawsegs_numbins - 1);
+		b2 = min(max(b2, 0), drawsegs_numbins - 1);
 
-			if (scale < spr->sortscale ||
-				(lowscale < spr->sortscale &&
-				 !R_PointOnSegSide (spr->gx, spr->gy, ds->curline)))
+		// Clip each band of the sprite against its own bin, unless the bins
+		// it spans hold more drawsegs between them than the whole list does.
+		if (drawsegs_usebins && b1 <= b2 && drawsegs_binstart[b2 + 1] - drawsegs_binstart[b1] < drawsegs_xrange_count)
+		{
+			for (b = b1; b <= b2; b++)
 			{
-				// masked mid texture?
-				/*if (ds->maskedtexturecol)
-					R_RenderMaskedSegRange (ds, r1, r2);*/
-				// seg is behind sprite
-				continue;
-			}
-
-			r1 = ds->x1 < x1 ? x1 : ds->x1;
-			r2 = ds->x2 > x2 ? x2 : ds->x2;
-
-			// clip this piece of the sprite
-			silhouette = ds->silhouette;
-
-			if (spr->gz >= ds->bsilheight)
-				silhouette &= ~SIL_BOTTOM;
-
-			if (spr->gzt <= ds->tsilheight)
-				silhouette &= ~SIL_TOP;
+				if (drawsegs_binstart[b + 1] == drawsegs_binstart[b])
+					continue;
 
-			if (silhouette == SIL_BOTTOM)
-			{
-				// bottom sil
-				for (x = r1; x <= r2; x++)
-					if (spr->clipbot[x] == -2)
-						spr->clipbot[x] = ds->sprbottomclip[x];
-			}
-			else if (silhouette == SIL_TOP)
-			{
-				// top sil
-				for (x = r1; x <= r2; x++)
-					if (spr->cliptop[x] == -2)
-						spr->cliptop[x] = ds->sprtopclip[x];
-			}
-			else if (silhouette == (SIL_TOP|SIL_BOTTOM))
-			{
-				// both
-				for (x = r1; x <= r2; x++)
-				{
-					if (spr->clipbot[x] == -2)
-						spr->clipbot[x] = ds->sprbottomclip[x];
-					if (spr->cliptop[x] == -2)
-						spr->cliptop[x] = ds->sprtopclip[x];
-				}
+				R_ClipVisSpriteSegs(spr, &drawsegs_bins[drawsegs_binstart[b]],
+					drawsegs_binstart[b + 1] - drawsegs_binstart[b],
+					(b == b1) ? x1 : (b << DS_BINSHIFT),
+					(b == b2) ? x2 : ((b + 1) << DS_BINSHIFT) - 1);
 			}
 		}
+		else
+			R_ClipVisSpriteSegs(spr, drawsegs_xrange, drawsegs_xrange_count, x1, x2);
 	}
 
 	R_HeightSecClip(spr, x1, x2);
@@ -3416,18 +3540,14 @@ static void R_ClipVisSprite(vissprite_t *spr, INT32 x1, INT32 x2, portal_t* port
 void R_ClipSprites(drawseg_t* dsstart, portal_t* portal)
 {
 	const size_t maxdrawsegs = ds_p - drawsegs;
-	const INT32 cx = viewwidth / 2;
 	drawseg_t* ds;
-	INT32 i;
+	INT32 i, b;
 
 	// e6y
 	// Reducing of cache misses in the following R_DrawSprite()
 	// Makes sense for scenes with huge amount of drawsegs.
 	// ~12% of speed improvement on epic.wad map05
-	for (i = 0; i < DS_RANGES_COUNT; i++)
-	{
-		drawsegs_xranges[i].count = 0;
-	}
+	drawsegs_xrange_count = 0;
 
 	if (visspritecount - clippedvissprites <= 0)
 	{
@@ -3437,42 +3557,50 @@ void R_ClipSprites(drawseg_t* dsstart, portal_t* portal)
 	if (drawsegs_xrange_size < maxdrawsegs)
 	{
 		drawsegs_xrange_size = 2 * maxdrawsegs;
-
-		for (i = 0; i < DS_RANGES_COUNT; i++)
-		{
-			drawsegs_xranges[i].items = Z_Realloc(
-				drawsegs_xranges[i].items,
-				drawsegs_xrange_size * sizeof(drawsegs_xranges[i].items[0]),
-				PU_STATIC, NULL
-			);
-		}
+		drawsegs_xrange = Z_Realloc(
+			drawsegs_xrange,
+			drawsegs_xrange_size * sizeof(drawsegs_xrange[0]),
+			PU_STATIC, NULL
+		);
 	}
 
+	drawsegs_numbins = (viewwidth >> DS_BINSHIFT) + 1;
+	memset(drawsegs_binstart, 0, (drawsegs_numbins + 1) * sizeof(drawsegs_binstart[0]));
+
 	for (ds = ds_p; ds-- > dsstart;)
 	{
 		if (ds->silhouette || ds->maskedtexturecol)
 		{
-			drawsegs_xranges[0].items[drawsegs_xranges[0].count].x1 = ds->x1;
-			drawsegs_xranges[0].items[drawsegs_xranges[0].count].x2 = ds->x2;
-			drawsegs_xranges[0].items[drawsegs_xranges[0].count].user = ds;
+			drawsegs_xrange[drawsegs_xrange_count].x1 = ds->x1;
+			drawsegs_xrange[drawsegs_xrange_count].x2 = ds->x2;
+			drawsegs_xrange[drawsegs_xrange_count].user = ds;
+			drawsegs_xrange_count++;
 
-			// e6y: ~13% of speed improvement on sunder.wad map10
-			if (ds->x1 < cx)
-			{
-				drawsegs_xranges[1].items[drawsegs_xranges[1].count] =
-					drawsegs_xranges[0].items[drawsegs_xranges[0].count];
-				drawsegs_xranges[1].count++;
-			}
+			for (b = ds->x1 >> DS_BINSHIFT; b <= ds->x2 >> DS_BINSHIFT; b++)
+				drawsegs_binstart[b]++;
+		}
+	}
 
-			if (ds->x2 >= cx)
-			{
-				drawsegs_xranges[2].items[drawsegs_xranges[2].count] =
-					drawsegs_xranges[0].items[drawsegs_xranges[0].count];
-				drawsegs_xranges[2].count++;
-			}
+	// Turn the counts into the end of each bin, then fill the bins back to
+	// front so that each one ends up at its start, in list order.
+	for (b = 1; b < drawsegs_numbins; b++)
+		drawsegs_binstart[b] += drawsegs_binstart[b - 1];
+	drawsegs_binstart[drawsegs_numbins] = drawsegs_binstart[drawsegs_numbins - 1];
 
-			drawsegs_xranges[0].count++;
-		}
+	if (drawsegs_bins_size < (size_t)drawsegs_binstart[drawsegs_numbins])
+	{
+		drawsegs_bins_size = 2 * drawsegs_binstart[drawsegs_numbins];
+		drawsegs_bins = Z_Realloc(
+			drawsegs_bins,
+			drawsegs_bins_size * sizeof(drawsegs_bins[0]),
+			PU_STATIC, NULL
+		);
+	}
+
+	for (i = drawsegs_xrange_count; i-- > 0;)
+	{
+		for (b = drawsegs_xrange[i].x1 >> DS_BINSHIFT; b <= drawsegs_xrange[i].x2 >> DS_BINSHIFT; b++)
+			drawsegs_bins[--drawsegs_binstart[b]] = drawsegs_xrange[i];
 	}
 
 	for (; clippedvissprites < visspritecount; clippedvissprites++)
@@ -3496,28 +3624,71 @@ void R_ClipSprites(drawseg_t* dsstart, portal_t* portal)
 		INT32 x1 = (spr->cut & SC_SPLAT) ? 0 : spr->x1;
 		INT32 x2 = (spr->cut & SC_SPLAT) ? viewwidth : spr->x2;
 
-		if (x2 < cx)
-		{
-			drawsegs_xrange = drawsegs_xranges[1].items;
-			drawsegs_xrange_count = drawsegs_xranges[1].count;
-		}
-		else if (x1 >= cx)
+		R_ClipVisSprite(spr, x1, x2, portal);
+
+		if ((spr->cut & SC_NOTVISIBLE) == 0)
+			numvisiblesprites++;
+	}
+}
+
+#ifdef _DEBUG
+// Times clipping the sprites of the frame in view again, with and without
+// the drawseg bins, and checks that both clip them the same.
+void Command_SpriteClipBench_f(void)
+{
+	INT32 runs = 100;
+	precise_t time[2];
+	UINT32 sum[2];
+	UINT32 n;
+	INT32 i, x, pass;
+
+	if (rendermode != render_soft || gamestate != GS_LEVEL || splitscreen || !players[displayplayer].mo)
+	{
+		CONS_Printf(M_GetText("You must be in a level, without splitscreen, in the Software renderer to use this.\n"));
+		return;
+	}
+
+	if (COM_Argc() > 1)
+		runs = max(atoi(COM_Argv(1)), 1);
+
+	topleft = screens[0] + viewwindowy*vid.width + viewwindowx;
+	R_RenderPlayerView(&players[displayplayer]);
+
+	// Every pass clips all of the frame's sprites against all of its
+	// drawsegs, portals included, so the passes do the same work.
+	for (pass = 0; pass < 2; pass++)
+	{
+		drawsegs_usebins = !pass;
+
+		time[pass] = I_GetPreciseTime();
+		for (i = 0; i < runs; i++)
 		{
-			drawsegs_xrange = drawsegs_xranges[2].items;
-			drawsegs_xrange_count = drawsegs_xranges[2].count;
+			clippedvissprites = numvisiblesprites = 0;
+			R_ClipSprites(drawsegs, NULL);
 		}
-		else
+		time[pass] = I_GetPreciseTime() - time[pass];
+
+		sum[pass] = numvisiblesprites;
+		for (n = 0; n < visspritecount; n++)
 		{
-			drawsegs_xrange = drawsegs_xranges[0].items;
-			drawsegs_xrange_count = drawsegs_xranges[0].count;
+			vissprite_t *spr = R_GetVisSprite(n);
+
+			for (x = max(spr->x1, 0); x <= min(spr->x2, viewwidth - 1); x++)
+				sum[pass] = sum[pass] * 31 + (UINT16)spr->clipbot[x] * 65599 + (UINT16)spr->cliptop[x];
 		}
+	}
 
-		R_ClipVisSprite(spr, x1, x2, portal);
+	drawsegs_usebins = true;
 
-		if ((spr->cut & SC_NOTVISIBLE) == 0)
-			numvisiblesprites++;
-	}
+	CONS_Printf("%u sprites, %d drawsegs: %.3f ms per clip with bins, %.3f ms without\n",
+		visspritecount, drawsegs_xrange_count,
+		(double)time[0] * 1000.0 / I_GetPrecisePrecision() / runs,
+		(double)time[1] * 1000.0 / I_GetPrecisePrecision() / runs);
+
+	if (sum[0] != sum[1])
+		CONS_Alert(CONS_WARNING, "Sprites weren't clipped the same!\n");
 }
+#endif
 
 /* Check if thing may be drawn from our current view. */
 boolean R_ThingVisible (mobj_t *thing)
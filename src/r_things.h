@@ -152,6 +152,7 @@ typedef struct vissprite_s
 
 	// Bonus linkdraw pointer.
 	struct vissprite_s *linkdraw;
+	struct vissprite_s *linknext; // next sprite in the same linkdraw hash chain, see R_SortVisSprites
 
 	mobj_t *mobj; // for easy access
 
@@ -223,6 +224,9 @@ typedef struct vissprite_s
 extern UINT32 visspritecount, numvisiblesprites;
 
 void R_ClipSprites(drawseg_t* dsstart, portal_t* portal);
+#ifdef _DEBUG
+void Command_SpriteClipBench_f(void);
+#endif
 
 boolean R_SpriteIsFlashing(vissprite_t *vis);
 
@@ -163,6 +163,9 @@ consvar_t cv_modfilter = CVAR_INIT ("modfilter", "0", CV_SAVE|CV_CALL, interpola
 static channel_t *channels = NULL;
 static INT32 numofchannels = 0;
 
+// number of channels using each sound, see S_IdPlaying
+static INT32 sfxchannels[NUMSFX];
+
 caption_t closedcaptions[NUMCAPTIONS];
 
 void S_ResetCaptions(void)
@@ -254,6 +257,7 @@ static INT32 S_getChannel(const void *origin, sfxinfo_t *sfxinfo)
 	// channel is decided to be cnum.
 	c->sfxinfo = sfxinfo;
 	c->origin = origin;
+	sfxchannels[sfxinfo - S_sfx]++;
 
 	return cnum;
 }
@@ -291,6 +295,9 @@ void S_RegisterSoundStuff(void)
 
 	COM_AddCommand("tunes", Command_Tunes_f, COM_LUA);
 	COM_AddCommand("restartaudio", Command_RestartAudio_f, COM_LUA);
+#ifdef _DEBUG
+	COM_AddCommand("soundnamebench", Command_SoundNameBench_f, 0);
+#endif
 }
 
 static void SetChannelsNum(void)
@@ -324,6 +331,7 @@ static void SetChannelsNum(void)
 	// Free all channels for use
 	for (i = 0; i < numofchannels; i++)
 		channels[i].sfxinfo = 0;
+	memset(sfxchannels, 0, sizeof(sfxchannels));
 
 	S_ResetCaptions();
 }
@@ -1050,6 +1058,7 @@ static void S_StopChannel(INT32 cnum)
 
 		// degrade usefulness of sound data
 		c->sfxinfo->usefulness--;
+		sfxchannels[c->sfxinfo - S_sfx]--;
 		c->sfxinfo = 0;
 	}
 
@@ -1225,21 +1234,15 @@ INT32 S_OriginPlaying(void *origin)
 	return 0;
 }
 
-// Searches through the channels and checks if a given id
-// is playing anywhere.
+// Checks if a given id is playing on any channel.
 INT32 S_IdPlaying(sfxenum_t id)
 {
-	INT32 cnum;
-
 #ifdef HW3SOUND
 	if (hws_mode != HWS_DEFAULT_MODE)
 		return HW3S_IdPlaying(id);
 #endif
 
-	for (cnum = 0; cnum < numofchannels; cnum++)
-		if ((size_t)(channels[cnum].sfxinfo - S_sfx) == (size_t)id)
-			return 1;
-	return 0;
+	return (sfxchannels[id] != 0);
 }
 
 // Searches through the channels and checks for
@@ -1272,18 +1275,9 @@ static sfxenum_t newsounds[MAXNEWSOUNDS] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
 void S_StartSoundName(void *mo, const char *soundname)
 {
-	INT32 i, soundnum = 0;
+	INT32 i, soundnum;
 	// Search existing sounds...
-	for (i = sfx_None + 1; i < NUMSFX; i++)
-	{
-		if (!S_sfx[i].name)
-			continue;
-		if (!stricmp(S_sfx[i].name, soundname))
-		{
-			soundnum = i;
-			break;
-		}
-	}
+	soundnum = S_FindSfxByName(soundname);
 
 	if (!soundnum)
 	{
@@ -139,6 +139,30 @@ boolean R_SSE = false;
 boolean R_3DNow = false;
 boolean R_MMXExt = false;
 boolean R_SSE2 = false;
+boolean R_NEON = false;
+
+// Picks the multi-column drawer for batched opaque columns.
+// Every other drawer is always the plain C one.
+static void SCR_SetColumnBatching(void)
+{
+	colfunc_multi = R_DrawColumns_8;
+	colfunc_multi_lanes = MAXCOLUMNLANES;
+
+#ifdef COLUMNS_SSE2
+	if (R_SSE2)
+		colfunc_multi = R_DrawColumns_8_SSE2;
+#endif
+#ifdef COLUMNS_NEON
+	if (R_NEON)
+		colfunc_multi = R_DrawColumns_8_NEON;
+#endif
+
+	if (M_CheckParm("-nocolumnbatch"))
+	{
+		colfunc_multi = NULL;
+		colfunc_multi_lanes = 0;
+	}
+}
 
 void SCR_SetDrawFuncs(void)
 {
@@ -192,6 +216,8 @@ void SCR_SetDrawFuncs(void)
 	spanfuncs_npo2[SPANDRAWFUNC_TILTEDTRANSSPRITE] = R_DrawTiltedTranslucentFloorSprite_NPO2_8;
 	spanfuncs_npo2[SPANDRAWFUNC_WATER] = R_DrawWaterSpan_NPO2_8;
 	spanfuncs_npo2[SPANDRAWFUNC_TILTEDWATER] = R_DrawTiltedWaterSpan_NPO2_8;
+
+	SCR_SetColumnBatching();
 }
 
 void SCR_SetMode(void)
@@ -239,6 +265,9 @@ void SCR_Startup(void)
 	{
 #if defined (__i386__) || defined (_M_IX86) || defined (__WATCOMC__)
 		R_486 = true;
+#endif
+#if defined (__aarch64__) || defined (_M_ARM64)
+		R_NEON = true; // always there on 64-bit ARM
 #endif
 		if (RCpuInfo->RDTSC)
 			R_586 = true;
@@ -252,7 +281,9 @@ void SCR_Startup(void)
 			R_SSE = true;
 		if (RCpuInfo->SSE2)
 			R_SSE2 = true;
-		CONS_Printf("CPU Info: 486: %i, 586: %i, MMX: %i, 3DNow: %i, MMXExt: %i, SSE2: %i\n", R_486, R_586, R_MMX, R_3DNow, R_MMXExt, R_SSE2);
+		if (RCpuInfo->NEON)
+			R_NEON = true;
+		CONS_Printf("CPU Info: 486: %i, 586: %i, MMX: %i, 3DNow: %i, MMXExt: %i, SSE2: %i, NEON: %i\n", R_486, R_586, R_MMX, R_3DNow, R_MMXExt, R_SSE2, R_NEON);
 	}
 
 	if (M_CheckParm("-486"))
@@ -273,9 +304,19 @@ void SCR_Startup(void)
 
 	if (M_CheckParm("-SSE2"))
 		R_SSE2 = true;
+	if (M_CheckParm("-noSSE2"))
+		R_SSE2 = false;
+
+	if (M_CheckParm("-noNEON"))
+		R_NEON = false;
 
 	M_SetupMemcpy();
 
+	// the video mode was set before we knew any of the above
+	SCR_SetColumnBatching();
+	if (M_CheckParm("-validatedrawers"))
+		r_validatedrawers = true;
+
 	if (dedicated)
 	{
 		V_Init();
@@ -187,6 +187,7 @@ extern boolean R_MMX;
 extern boolean R_3DNow;
 extern boolean R_MMXExt;
 extern boolean R_SSE2;
+extern boolean R_NEON;
 
 // ----------------
 // screen variables
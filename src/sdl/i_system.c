@@ -2252,7 +2252,10 @@ void I_Quit(void)
 	quitting = SDL_TRUE;
 
 	if (I_StoragePermission())
+	{
 		M_SaveConfig(NULL); //save game config, cvars..
+		saveaddonindex();
+	}
 
 #ifndef NONET
 	D_SaveBan(); // save the ban list
@@ -2371,7 +2374,10 @@ void I_Error(const char *error, ...)
 	// ---
 
 	if (I_StoragePermission())
+	{
 		M_SaveConfig(NULL); // save game config, cvars..
+		saveaddonindex();
+	}
 
 #ifndef NONET
 	D_SaveBan(); // save the ban list
@@ -3293,6 +3299,9 @@ const CPUInfoFlags *I_CPUInfo(void)
 	SDL_CPUInfo.SSE         = SDL_HasSSE();
 	SDL_CPUInfo.SSE2        = SDL_HasSSE2();
 	SDL_CPUInfo.AltiVec     = SDL_HasAltiVec();
+#if SDL_VERSION_ATLEAST(2,0,6)
+	SDL_CPUInfo.NEON        = SDL_HasNEON();
+#endif
 	return &SDL_CPUInfo;
 #else
 	return NULL; /// \todo CPUID asm
@@ -29,6 +29,7 @@
 
 #ifdef HWRENDER
 #include "../hardware/r_gles/r_gles.h"
+#include "../hardware/hw_batching.h"
 #include "ogl_es_sdl.h"
 #include "../i_system.h"
 #include "hwsym_sdl.h"
@@ -95,6 +96,7 @@ void OglSdlFinishUpdate(boolean waitvbl)
 	oldwaitvbl = waitvbl;
 
 	SDL_GetWindowSize(window, &sdlw, &sdlh);
+	HWR_Flush2DBatch();
 	GPU->MakeFinalScreenTexture();
 
 #ifdef HAVE_GL_FRAMEBUFFER
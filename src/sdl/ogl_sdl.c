@@ -37,6 +37,7 @@
 
 #ifdef HWRENDER
 #include "../hardware/r_opengl/r_opengl.h"
+#include "../hardware/hw_batching.h"
 #include "../hardware/hw_main.h"
 #include "ogl_sdl.h"
 #include "../i_system.h"
@@ -177,6 +178,7 @@ void OglSdlFinishUpdate(boolean waitvbl)
 	oldwaitvbl = waitvbl;
 
 	SDL_GetWindowSize(window, &sdlw, &sdlh);
+	HWR_Flush2DBatch();
 	GPU->MakeFinalScreenTexture();
 
 #ifdef HAVE_GL_FRAMEBUFFER
@@ -20,6 +20,8 @@
 #include "z_zone.h"
 #include "w_wad.h"
 #include "lua_script.h"
+#include "command.h" // COM_Argc
+#include "i_system.h" // I_GetPreciseTime
 
 //
 // Information about all the sfx
@@ -827,6 +829,57 @@ sfxinfo_t S_sfx[NUMSFX] =
   // initialized to NULL
 };
 
+// Case insensitive hash from sound name to the sounds with that name,
+// each chain kept in ascending order so the lowest id is found first
+#define SFXHASHSIZE 4096
+static sfxenum_t sfxhash[SFXHASHSIZE];
+static sfxenum_t sfxhashnext[NUMSFX];
+
+static UINT32 S_HashSfxName(const char *name)
+{
+	UINT32 hash = 2166136261u;
+
+	while (*name)
+		hash = (hash ^ (UINT8)tolower(*name++)) * 16777619u;
+
+	return hash & (SFXHASHSIZE - 1);
+}
+
+static void S_LinkSfxName(sfxenum_t id)
+{
+	sfxenum_t *link = &sfxhash[S_HashSfxName(S_sfx[id].name)];
+
+	while (*link && *link < id)
+		link = &sfxhashnext[*link];
+
+	sfxhashnext[id] = *link;
+	*link = id;
+}
+
+static void S_UnlinkSfxName(sfxenum_t id)
+{
+	sfxenum_t *link = &sfxhash[S_HashSfxName(S_sfx[id].name)];
+
+	while (*link && *link != id)
+		link = &sfxhashnext[*link];
+
+	if (*link)
+		*link = sfxhashnext[id];
+}
+
+// Finds the lowest numbered sound with the given name,
+// ignoring case, or returns sfx_None if there isn't one.
+sfxenum_t S_FindSfxByName(const char *name)
+{
+	sfxenum_t i;
+
+	for (i = sfxhash[S_HashSfxName(name)]; i; i = sfxhashnext[i])
+		if (!stricmp(S_sfx[i].name, name))
+			return i;
+
+	return sfx_None;
+}
+
 char freeslotnames[sfx_freeslot0 + NUMSFXFREESLOTS + NUMSKINSFXSLOTS][7];
 
 // Prepare free sfx slots to add sfx at run time
@@ -864,10 +917,19 @@ void S_InitRuntimeSounds (void)
 		//strlcpy(S_sfx[i].caption, "", 1);
 		S_sfx[i].caption[0] = '\0';
 	}
+
+	memset(sfxhash, 0, sizeof(sfxhash));
+	for (i = 1; i < NUMSFX; i++)
+		if (S_sfx[i].name)
+			S_LinkSfxName(i);
 }
 
 sfxenum_t sfxfree = sfx_freeslot0;
 
+// Free slots given back by S_RemoveSoundFx, reused before sfxfree
+static sfxenum_t sfxrecycled[NUMSFXFREESLOTS];
+static INT32 numsfxrecycled = 0;
+
 // Add a new sound fx into a free sfx slot.
 //
 sfxenum_t S_AddSoundFx(const char *name, boolean singular, INT32 flags, boolean skinsound)
@@ -883,12 +945,16 @@ sfxenum_t S_AddSoundFx(const char *name, boolean singular, INT32 flags, boolean
 			break;
 		}
 	}
+	else if (numsfxrecycled)
+		i = sfxrecycled[--numsfxrecycled];
 	else
 		i = sfxfree;
 
 	if (i < NUMSFX)
 	{
+		S_UnlinkSfxName(i);
 		strncpy(freeslotnames[i-sfx_freeslot0], name, 6);
+		S_LinkSfxName(i);
 		S_sfx[i].singularity = singular;
 		S_sfx[i].priority = 60;
 		S_sfx[i].pitch = flags;
@@ -900,7 +966,7 @@ sfxenum_t S_AddSoundFx(const char *name, boolean singular, INT32 flags, boolean
 		/// \todo if precached load it here
 		S_sfx[i].data = NULL;
 
-		if (!skinsound)
+		if (!skinsound && i == sfxfree)
 			sfxfree++;
 
 		return i;
@@ -917,5 +983,81 @@ void S_RemoveSoundFx(sfxenum_t id)
 		S_sfx[id].lumpnum = LUMPERROR;
 		I_FreeSfx(&S_sfx[id]);
 		S_sfx[id].priority = 0;
+
+		// skin sound slots are found by their priority instead
+		if (id < sfx_skinsoundslot0)
+			sfxrecycled[numsfxrecycled++] = id;
+	}
+}
+
+#ifdef _DEBUG
+// Times finding sounds that exist and ones that don't by name, and taking
+// over a free slot for a new name the way S_StartSoundName does.
+void Command_SoundNameBench_f(void)
+{
+	char names[256][7], oldname[7];
+	INT32 runs = 100000, found = 0, mismatches = 0;
+	sfxenum_t id, slot;
+	precise_t time[3];
+	INT32 i;
+
+	if (COM_Argc() > 1)
+		runs = max(atoi(COM_Argv(1)), 1);
+
+	for (i = 0; i < 256; i++)
+		sprintf(names[i], "zqb%03d", i);
+
+	// names of the built in sounds, in turn
+	time[0] = I_GetPreciseTime();
+	for (i = 0; i < runs; i++)
+	{
+		sfxenum_t want = 1 + i % (sfx_freeslot0 - 1);
+
+		id = S_FindSfxByName(S_sfx[want].name);
+		if (!id || id > want || stricmp(S_sfx[id].name, S_sfx[want].name))
+			mismatches++;
+	}
+	time[0] = I_GetPreciseTime() - time[0];
+
+	// names that most likely don't exist
+	time[1] = I_GetPreciseTime();
+	for (i = 0; i < runs; i++)
+		if (S_FindSfxByName(names[i & 255]))
+			found++;
+	time[1] = I_GetPreciseTime() - time[1];
+
+	// one slot given a new name over and over
+	slot = numsfxrecycled ? sfxrecycled[numsfxrecycled - 1] : sfxfree;
+	if (slot >= sfx_skinsoundslot0)
+	{
+		CONS_Printf(M_GetText("There are no free sound slots to test with.\n"));
+		return;
 	}
+	strlcpy(oldname, freeslotnames[slot - sfx_freeslot0], sizeof oldname);
+	S_AddSoundFx(names[0], false, 0, false);
+
+	time[2] = I_GetPreciseTime();
+	for (i = 0; i < runs; i++)
+	{
+		S_RemoveSoundFx(slot);
+		id = S_AddSoundFx(names[(i + 1) & 255], false, 0, false);
+		if (id != slot || S_FindSfxByName(names[(i + 1) & 255]) != slot)
+			mismatches++;
+	}
+	time[2] = I_GetPreciseTime() - time[2];
+
+	// put the slot back as it was
+	S_RemoveSoundFx(slot);
+	S_UnlinkSfxName(slot);
+	strcpy(freeslotnames[slot - sfx_freeslot0], oldname);
+	S_LinkSfxName(slot);
+
+	CONS_Printf("%d runs: %.3f us per hit, %.3f us per miss (%d found), %.3f us per eviction\n", runs,
+		(double)time[0] * 1000000.0 / I_GetPrecisePrecision() / runs,
+		(double)time[1] * 1000000.0 / I_GetPrecisePrecision() / runs, found,
+		(double)time[2] * 1000000.0 / I_GetPrecisePrecision() / runs);
+
+	if (mismatches)
+		CONS_Alert(CONS_WARNING, "%d lookups found the wrong sound!\n", mismatches);
 }
+#endif
@@ -889,5 +889,9 @@ void S_InitRuntimeSounds(void);
 sfxenum_t S_AddSoundFx(const char *name, boolean singular, INT32 flags, boolean skinsound);
 extern sfxenum_t sfxfree; // sound test and slotting
 void S_RemoveSoundFx(sfxenum_t id);
+sfxenum_t S_FindSfxByName(const char *name);
+#ifdef _DEBUG
+void Command_SoundNameBench_f(void);
+#endif
 
 #endif
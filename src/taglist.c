@@ -315,6 +315,108 @@ static void Taglist_AddToMapthings (const mtag_t tag, const size_t itemid)
 	Taggroup_Add_Init(tags_mapthings, tag, itemid);
 }
 
+// Line special index.
+// Every line id, sorted by special and then by id, so lines with a given
+// special can be found without going over every line. During play,
+// specials only ever get cleared, so entries are checked against the
+// line's current special and special 0 is always searched the slow way.
+static size_t *speciallines;
+static INT16 *specialkeys; // Each special in use, ascending
+static size_t *specialstarts; // Where each special's lines start in speciallines
+static size_t numspecialkeys;
+
+static int Taglist_CompareSpecialLines(const void *a, const void *b)
+{
+	const size_t la = *(const size_t *)a, lb = *(const size_t *)b;
+
+	if (lines[la].special != lines[lb].special)
+		return lines[la].special < lines[lb].special ? -1 : 1;
+
+	return la < lb ? -1 : (la > lb);
+}
+
+/// Builds the line special index from the lines' current specials.
+/// Call this again after anything gives lines new specials in bulk.
+void Taglist_InitLineSpecials(void)
+{
+	size_t i;
+
+	Z_Free(speciallines);
+	Z_Free(specialkeys);
+	Z_Free(specialstarts);
+	numspecialkeys = 0;
+
+	if (!numlines)
+		return;
+
+	Z_Malloc(numlines * sizeof(*speciallines), PU_LEVEL, &speciallines);
+	for (i = 0; i < numlines; i++)
+		speciallines[i] = i;
+	qsort(speciallines, numlines, sizeof(*speciallines), Taglist_CompareSpecialLines);
+
+	for (i = 0; i < numlines; i++)
+		if (!i || lines[speciallines[i]].special != lines[speciallines[i - 1]].special)
+			numspecialkeys++;
+
+	Z_Malloc(numspecialkeys * sizeof(*specialkeys), PU_LEVEL, &specialkeys);
+	Z_Malloc((numspecialkeys + 1) * sizeof(*specialstarts), PU_LEVEL, &specialstarts);
+
+	numspecialkeys = 0;
+	for (i = 0; i < numlines; i++)
+		if (!i || lines[speciallines[i]].special != lines[speciallines[i - 1]].special)
+		{
+			specialkeys[numspecialkeys] = lines[speciallines[i]].special;
+			specialstarts[numspecialkeys++] = i;
+		}
+	specialstarts[numspecialkeys] = numlines;
+}
+
+/// Finds the lines that had a special when the index was built.
+/// \return The ids, ascending, or NULL if the index can't answer this.
+static const size_t *Taglist_GetSpecialLines(const INT16 special, size_t *count)
+{
+	size_t lo = 0, hi = numspecialkeys;
+
+	*count = 0;
+
+	if (!special || !speciallines)
+		return NULL;
+
+	while (lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if (specialkeys[mid] < special)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo < numspecialkeys && specialkeys[lo] == special)
+	{
+		*count = specialstarts[lo + 1] - specialstarts[lo];
+		return &speciallines[specialstarts[lo]];
+	}
+
+	return speciallines; // Known, just empty
+}
+
+/// Position of the first id above the given one, in an ascending id list.
+static size_t Taglist_FirstAfter(const size_t *ids, const size_t count, const INT32 after)
+{
+	size_t lo = 0, hi = count;
+
+	while (lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if ((INT32)ids[mid] <= after)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
 /// After all taglists have been built for each element (sectors, lines, things),
 /// the global taggroups, made for iteration, are built here.
 void Taglist_InitGlobalTables(void)
@@ -345,6 +447,8 @@ void Taglist_InitGlobalTables(void)
 		for (j = 0; j < mapthings[i].tags.count; j++)
 			Taglist_AddToMapthings(mapthings[i].tags.tags[j], i);
 	}
+
+	Taglist_InitLineSpecials();
 }
 
 // Iteration, ingame search.
@@ -366,7 +470,24 @@ INT32 Tag_Iterate_Things (const mtag_t tag, const size_t p)
 
 INT32 Tag_FindLineSpecial(const INT16 special, const mtag_t tag)
 {
-	size_t i;
+	size_t i, count;
+	const size_t *special_lines = Taglist_GetSpecialLines(special, &count);
+
+	if (special_lines)
+	{
+		const taggroup_t *tagged = (tag == MTAG_GLOBAL) ? NULL : tags_lines[(UINT16)tag];
+
+		// Both lists are in ascending order, so going over either one
+		// finds the same line first. Go over the shorter one.
+		if (tag == MTAG_GLOBAL || (tagged && count < tagged->count))
+		{
+			for (i = 0; i < count; i++)
+				if (lines[special_lines[i]].special == special
+					&& (tag == MTAG_GLOBAL || Tag_Find(&lines[special_lines[i]].tags, tag)))
+					return special_lines[i];
+			return -1;
+		}
+	}
 
 	if (tag == MTAG_GLOBAL)
 	{
@@ -387,6 +508,9 @@ INT32 Tag_FindLineSpecial(const INT16 special, const mtag_t tag)
 /// Backwards compatibility iteration function for Lua scripts.
 INT32 P_FindSpecialLineFromTag(INT16 special, INT16 tag, INT32 start)
 {
+	size_t count;
+	const size_t *special_lines = Taglist_GetSpecialLines(special, &count);
+
 	if (tag == -1)
 	{
 		start++;
@@ -394,6 +518,17 @@ INT32 P_FindSpecialLineFromTag(INT16 special, INT16 tag, INT32 start)
 		if (start >= (INT32)numlines)
 			return -1;
 
+		if (special_lines)
+		{
+			size_t i;
+
+			// The old search below gives numlines when nothing is left
+			for (i = Taglist_FirstAfter(special_lines, count, start - 1); i < count; i++)
+				if (lines[special_lines[i]].special == special)
+					return special_lines[i];
+			return numlines;
+		}
+
 		while (start < (INT32)numlines && lines[start].special != special)
 			start++;
 
@@ -404,6 +539,34 @@ INT32 P_FindSpecialLineFromTag(INT16 special, INT16 tag, INT32 start)
 		size_t p = 0;
 		INT32 id;
 
+		if (special_lines)
+		{
+			const taggroup_t *tagged = tags_lines[(UINT16)tag];
+			size_t i;
+
+			if (!tagged)
+				return -1;
+
+			// Continuing from a line that doesn't have the tag finds nothing,
+			// see below
+			if (start != -1 && Taggroup_Find(tagged, start) == (size_t)-1)
+				return -1;
+
+			if (count < tagged->count - Taglist_FirstAfter(tagged->elements, tagged->count, start))
+			{
+				for (i = Taglist_FirstAfter(special_lines, count, start); i < count; i++)
+					if (lines[special_lines[i]].special == special
+						&& Tag_Find(&lines[special_lines[i]].tags, tag))
+						return special_lines[i];
+				return -1;
+			}
+
+			for (i = Taglist_FirstAfter(tagged->elements, tagged->count, start); i < tagged->count; i++)
+				if (lines[tagged->elements[i]].special == special)
+					return tagged->elements[i];
+			return -1;
+		}
+
 		// For backwards compatibility's sake, simulate the old linked taglist behavior:
 		// Iterate through the taglist and find the "start" line's position in the list,
 		// And start checking with the next one (if it exists).
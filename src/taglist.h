@@ -69,6 +69,7 @@ INT32 Taggroup_Iterate
 		const size_t p);
 
 void Taglist_InitGlobalTables(void);
+void Taglist_InitLineSpecials(void);
 
 INT32 Tag_Iterate_Sectors (const mtag_t tag, const size_t p);
 INT32 Tag_Iterate_Lines (const mtag_t tag, const size_t p);
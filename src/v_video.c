@@ -320,6 +320,7 @@ static void LoadPalette(const char *lumpname)
 
 	Z_Free(pLocalPalette);
 	Z_Free(pMasterPalette);
+	R_ClearNearestColorCache();
 
 	pLocalPalette = Z_Malloc(sizeof (*pLocalPalette)*palsize, PU_STATIC, NULL);
 	pMasterPalette = Z_Malloc(sizeof (*pMasterPalette)*palsize, PU_STATIC, NULL);
@@ -1969,6 +1970,56 @@ void V_DrawPatchFill(patch_t *pat)
 	}
 }
 
+// Maps count bytes of src through a 256-entry table into dest.
+// dest may be the same buffer as src.
+void V_MapBytes(UINT8 *dest, const UINT8 *src, size_t count, const UINT8 *lut)
+{
+	// All four lookups are done before storing anything, so the compiler
+	// doesn't have to assume every store changes the next source byte.
+	for (; count >= 4; count -= 4, src += 4, dest += 4)
+	{
+		const UINT8 a = lut[src[0]];
+		const UINT8 b = lut[src[1]];
+		const UINT8 c = lut[src[2]];
+		const UINT8 d = lut[src[3]];
+		dest[0] = a;
+		dest[1] = b;
+		dest[2] = c;
+		dest[3] = d;
+	}
+
+	while (count--)
+		*dest++ = lut[*src++];
+}
+
+// Blends count bytes of fg over bg through a translucency table into dest.
+void V_BlendBytes(UINT8 *dest, const UINT8 *bg, const UINT8 *fg, size_t count, const UINT8 *transtable)
+{
+	for (; count >= 4; count -= 4, bg += 4, fg += 4, dest += 4)
+	{
+		const UINT8 a = transtable[(fg[0]<<8) + bg[0]];
+		const UINT8 b = transtable[(fg[1]<<8) + bg[1]];
+		const UINT8 c = transtable[(fg[2]<<8) + bg[2]];
+		const UINT8 d = transtable[(fg[3]<<8) + bg[3]];
+		dest[0] = a;
+		dest[1] = b;
+		dest[2] = c;
+		dest[3] = d;
+	}
+
+	while (count--)
+		*dest++ = transtable[(*fg++<<8) + *bg++];
+}
+
+// Maps whole screen lines starting at buf through a 256-entry table.
+static void V_MapScreenLines(UINT8 *buf, INT32 height, const UINT8 *lut)
+{
+	if (height <= 0)
+		return;
+
+	V_MapBytes(buf, buf, (size_t)height * vid.rowbytes, lut);
+}
+
 //
 // Fade all the screen buffer, so that the menu is more readable,
 // especially now that we use the small hufont in the menus...
@@ -1994,20 +2045,16 @@ void V_DrawFadeScreen(UINT16 color, UINT8 strength)
 		: (((color & 0x0F00) == 0x0B00) ? fadecolormap + (256 * FADECOLORMAPROWS) // Do white fadecolormap fade.
 		: colormaps)) + strength*256) // Do COLORMAP fade.
 		: ((UINT8 *)R_GetTranslucencyTable((9-strength)+1) + color*256)); // Else, do TRANSMAP** fade.
-		const UINT8 *deststop = screens[0] + vid.rowbytes * vid.height;
-		UINT8 *buf = screens[0];
 
 		// heavily simplified -- we don't need to know x or y
 		// position when we're doing a full screen fade
-		for (; buf < deststop; ++buf)
-			*buf = fadetable[*buf];
+		V_MapScreenLines(screens[0], vid.height, fadetable);
 	}
 }
 
 // Simple translucency with one color, over a set number of lines starting from the top.
 void V_DrawFadeConsBack(INT32 plines)
 {
-	UINT8 *deststop, *buf;
 
 #ifdef HWRENDER // not win32 only 19990829 by Kin
 	if (rendermode == render_opengl)
@@ -2020,15 +2067,13 @@ void V_DrawFadeConsBack(INT32 plines)
 
 	// heavily simplified -- we don't need to know x or y position,
 	// just the stop position
-	deststop = screens[0] + vid.rowbytes * min(plines, vid.height);
-	for (buf = screens[0]; buf < deststop; ++buf)
-		*buf = consolebgmap[*buf];
+	V_MapScreenLines(screens[0], min(plines, vid.height), consolebgmap);
 }
 
 // Very similar to F_DrawFadeConsBack, except we draw from the middle(-ish) of the screen to the bottom.
 void V_DrawPromptBack(INT32 boxheight, INT32 color)
 {
-	UINT8 *deststop, *buf;
+	INT32 promptlines;
 
 	if (color >= 256 && color < 512)
 	{
@@ -2082,13 +2127,12 @@ void V_DrawPromptBack(INT32 boxheight, INT32 color)
 
 	// heavily simplified -- we don't need to know x or y position,
 	// just the start and stop positions
-	buf = deststop = screens[0] + vid.rowbytes * vid.height;
 	if (boxheight < 0)
-		buf += vid.rowbytes * boxheight;
+		promptlines = -boxheight;
 	else // 4 lines of space plus gaps between and some leeway
-		buf -= vid.rowbytes * ((boxheight * 4) + (boxheight/2)*5);
-	for (; buf < deststop; ++buf)
-		*buf = promptbgmap[*buf];
+		promptlines = (boxheight * 4) + (boxheight/2)*5;
+	promptlines = min(promptlines, vid.height);
+	V_MapScreenLines(screens[0] + vid.rowbytes * (vid.height - promptlines), promptlines, promptbgmap);
 }
 
 // Gets string colormap, used for 0x80 color codes
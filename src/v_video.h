@@ -197,6 +197,10 @@ void V_DrawFadeFill(INT32 x, INT32 y, INT32 w, INT32 h, INT32 c, UINT16 color, U
 void V_DrawFadeConsBack(INT32 plines);
 void V_DrawPromptBack(INT32 boxheight, INT32 color);
 
+// Full screen table lookups, shared by the fades above and the wipes
+void V_MapBytes(UINT8 *dest, const UINT8 *src, size_t count, const UINT8 *lut);
+void V_BlendBytes(UINT8 *dest, const UINT8 *bg, const UINT8 *fg, size_t count, const UINT8 *transtable);
+
 // draw a single character
 void V_DrawCharacter(INT32 x, INT32 y, INT32 c, boolean lowercaseallowed);
 // draw a single character, but for the chat
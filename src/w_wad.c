@@ -73,16 +73,13 @@
 #endif
 #include "m_misc.h" // M_MapNumber
 #include "g_game.h" // G_SetGameModified
+#include "console.h" // CON_FlushRefresh
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
 #include "hardware/hw_glob.h"
 #endif
 
-#ifdef _DEBUG
-#include "console.h"
-#endif
-
 #ifndef O_BINARY
 #define O_BINARY 0
 #endif
@@ -1506,6 +1503,9 @@ UINT16 W_InitFile(const char *filename, fhandletype_t handletype, boolean mainfi
 	wadfiles[numwadfiles] = wadfile;
 	numwadfiles++; // must come BEFORE W_LoadDehackedLumps, so any addfile called by COM_BufInsertText called by Lua doesn't overwrite what we just loaded
 
+	// Show what has been printed so far, loading scripts can take a while
+	CON_FlushRefresh();
+
 	// Read shaders from file
 	W_ReadFileShaders(wadfile);
 
@@ -2066,6 +2066,8 @@ void W_InitMultipleFiles(addfilelist_t *list, fhandletype_t handletype)
 		char pathsep = fn[strlen(fn) - 1];
 		boolean mainfile = numwadfiles < mainwads;
 
+		CON_FlushRefresh(); // show the last file's messages before starting on this one
+
 		if (pathsep == '\\' || pathsep == '/')
 			W_InitFolder(fn, mainfile, true);
 		else